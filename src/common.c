@@ -216,8 +216,8 @@ static int
 _transform_json2xml_subexp(const struct lys_module *module, const char *expr, char **out, size_t *out_used, size_t *out_size, int schema, int inst_id, const char ***prefixes,
                     const char ***namespaces, uint32_t *ns_count)
 {
-    const char *cur_expr, *end, *prefix, *literal;
-    char *name;
+    const char *cur_expr, *end, *prefix;
+    char *name, *literal;
     size_t name_len;
     const struct lys_module *mod = NULL, *prev_mod = NULL;
     uint32_t i, j;
@@ -331,7 +331,8 @@ _transform_json2xml_subexp(const struct lys_module *module, const char *expr, ch
             ++(*out_used);
 
             /* skip quotes */
-            literal = lydict_insert(module->ctx, cur_expr + 1, exp->tok_len[i] - 2);
+            literal = strndup(cur_expr + 1, exp->tok_len[i] - 2);
+            LY_CHECK_ERR_GOTO(!literal, LOGMEM, error);
 
             /* parse literals as subexpressions if possible, otherwise treat as a literal */
             if (_transform_json2xml_subexp(module, literal, out, out_used, out_size, schema, inst_id, prefixes, namespaces, ns_count)) {
@@ -339,7 +340,7 @@ _transform_json2xml_subexp(const struct lys_module *module, const char *expr, ch
                 *out_used += exp->tok_len[i] - 2;
             }
 
-            lydict_remove(module->ctx, literal);
+            free(literal);
 
             /* copy end quote */
             (*out)[*out_used] = cur_expr[exp->tok_len[i] - 1];
@@ -362,7 +363,7 @@ error:
     return 1;
 }
 
-static const char *
+static char *
 _transform_json2xml(const struct lys_module *module, const char *expr, int schema, int inst_id, const char ***prefixes,
                     const char ***namespaces, uint32_t *ns_count)
 {
@@ -374,7 +375,9 @@ _transform_json2xml(const struct lys_module *module, const char *expr, int schem
 
     if (!expr[0]) {
         /* empty value */
-        return lydict_insert(module->ctx, expr, 0);
+        out = strdup(expr);
+        LY_CHECK_ERR_RETURN(!out, LOGMEM, NULL);
+        return out;
     }
 
     out_size = strlen(expr) + 1;
@@ -385,21 +388,21 @@ _transform_json2xml(const struct lys_module *module, const char *expr, int schem
     ret = _transform_json2xml_subexp(module, expr, &out, &out_used, &out_size, schema, inst_id, prefixes, namespaces, ns_count);
     if (!ret) {
         out[out_used] = '\0';
-        return lydict_insert_zc(module->ctx, out);
+        return out;
     }
 
     free(out);
     return NULL;
 }
 
-const char *
+char *
 transform_json2xml(const struct lys_module *module, const char *expr, int inst_id, const char ***prefixes,
                    const char ***namespaces, uint32_t *ns_count)
 {
     return _transform_json2xml(module, expr, 0, inst_id, prefixes, namespaces, ns_count);
 }
 
-const char *
+char *
 transform_json2schema(const struct lys_module *module, const char *expr)
 {
     return _transform_json2xml(module, expr, 1, 0, NULL, NULL, NULL);
@@ -409,8 +412,8 @@ static int
 transform_xml2json_subexp(struct ly_ctx *ctx, const char *expr, char **out, size_t *out_used, size_t *out_size,
                           struct lyxml_elem *xml, int inst_id, int use_ctx_data_clb, int log)
 {
-    const char *end, *cur_expr, *literal;
-    char *prefix;
+    const char *end, *cur_expr;
+    char *prefix, *literal;
     uint16_t i;
     size_t pref_len;
     const struct lys_module *mod, *prev_mod = NULL;
@@ -506,7 +509,8 @@ transform_xml2json_subexp(struct ly_ctx *ctx, const char *expr, char **out, size
             ++(*out_used);
 
             /* skip quotes */
-            literal = lydict_insert(ctx, cur_expr + 1, exp->tok_len[i] - 2);
+            literal = strndup(cur_expr + 1, exp->tok_len[i] - 2);
+            LY_CHECK_ERR_GOTO(!literal, LOGMEM, error);
 
             /* parse literals as subexpressions if possible, otherwise treat as a literal */
             if (transform_xml2json_subexp(ctx, literal, out, out_used, out_size, xml, inst_id, use_ctx_data_clb, 0)) {
@@ -514,7 +518,7 @@ transform_xml2json_subexp(struct ly_ctx *ctx, const char *expr, char **out, size
                 *out_used += exp->tok_len[i] - 2;
             }
 
-            lydict_remove(ctx, literal);
+            free(literal);
 
             /* copy end quote */
             (*out)[*out_used] = cur_expr[exp->tok_len[i] - 1];
@@ -1211,6 +1215,127 @@ ly_strequal_(const char *s1, const char *s2)
     }
 }
 
+/* initial number of buckets of a pointer map, must be a power of 2 */
+#define LY_PTR_MAP_SIZE 16
+
+static uint32_t
+ly_ptr_map_hash(const void *key)
+{
+    uint64_t h = (uintptr_t)key;
+
+    /* the low bits of pointers are mostly the same, mix all the bits into them */
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+/* bucket of the key or the free bucket where it belongs */
+static uint32_t
+ly_ptr_map_bucket(const struct ly_ptr_map *map, const void *key)
+{
+    uint32_t i, mask = map->size - 1;
+
+    for (i = ly_ptr_map_hash(key) & mask; map->items[i].key && (map->items[i].key != key); i = (i + 1) & mask);
+    return i;
+}
+
+static int
+ly_ptr_map_resize(struct ly_ptr_map *map, uint32_t size)
+{
+    struct ly_ptr_map_item *old = map->items;
+    uint32_t i, old_size = map->size;
+
+    map->items = calloc(size, sizeof *map->items);
+    LY_CHECK_ERR_RETURN(!map->items, LOGMEM; map->items = old, EXIT_FAILURE);
+    map->size = size;
+
+    for (i = 0; i < old_size; ++i) {
+        if (old[i].key) {
+            map->items[ly_ptr_map_bucket(map, old[i].key)] = old[i];
+        }
+    }
+    free(old);
+    return EXIT_SUCCESS;
+}
+
+void *
+ly_ptr_map_get(const struct ly_ptr_map *map, const void *key)
+{
+    if (!map->used) {
+        return NULL;
+    }
+    return map->items[ly_ptr_map_bucket(map, key)].value;
+}
+
+int
+ly_ptr_map_set(struct ly_ptr_map *map, const void *key, void *value)
+{
+    uint32_t i;
+
+    assert(key && value);
+
+    /* keep at least a half of the buckets free */
+    if (((map->used + 1) << 1) > map->size) {
+        if (ly_ptr_map_resize(map, map->size ? map->size << 1 : LY_PTR_MAP_SIZE)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    i = ly_ptr_map_bucket(map, key);
+    if (!map->items[i].key) {
+        map->items[i].key = key;
+        ++map->used;
+    }
+    map->items[i].value = value;
+    return EXIT_SUCCESS;
+}
+
+void *
+ly_ptr_map_remove(struct ly_ptr_map *map, const void *key)
+{
+    uint32_t i, j, k, mask = map->size - 1;
+    void *value;
+
+    if (!map->used) {
+        return NULL;
+    }
+
+    i = ly_ptr_map_bucket(map, key);
+    if (!map->items[i].key) {
+        return NULL;
+    }
+    value = map->items[i].value;
+    --map->used;
+
+    /* move back the following items of the cluster that would not be found behind the free bucket */
+    for (j = (i + 1) & mask; map->items[j].key; j = (j + 1) & mask) {
+        k = ly_ptr_map_hash(map->items[j].key) & mask;
+        if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+            /* the item is between its home bucket and the free one */
+            continue;
+        }
+        map->items[i] = map->items[j];
+        i = j;
+    }
+    map->items[i].key = NULL;
+    map->items[i].value = NULL;
+
+    if (!map->used && (map->size > LY_PTR_MAP_SIZE)) {
+        /* release the memory of a map that was used for many items */
+        ly_ptr_map_clean(map);
+    }
+    return value;
+}
+
+void
+ly_ptr_map_clean(struct ly_ptr_map *map)
+{
+    free(map->items);
+    map->items = NULL;
+    map->size = map->used = 0;
+}
+
 int64_t
 dec_pow(uint8_t exp)
 {
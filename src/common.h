@@ -344,10 +344,10 @@ const char *transform_module_name2import_prefix(const struct lys_module *module,
  * @param[out] ns_count Number of elements in both \p prefixes and \p namespaces arrays.
  * Can be NULL.
  *
- * @return Transformed XML expression in the dictionary, NULL on error.
+ * @return Transformed XML expression to be freed by the caller, NULL on error.
  */
-const char *transform_json2xml(const struct lys_module *module, const char *expr, int inst_id, const char ***prefixes,
-                               const char ***namespaces, uint32_t *ns_count);
+char *transform_json2xml(const struct lys_module *module, const char *expr, int inst_id, const char ***prefixes,
+                         const char ***namespaces, uint32_t *ns_count);
 
 /**
  * @brief Transform expression from JSON format to schema format.
@@ -357,9 +357,9 @@ const char *transform_json2xml(const struct lys_module *module, const char *expr
  * @param[in] module Module with imports to use.
  * @param[in] expr JSON expression.
  *
- * @return Transformed XML expression in the dictionary, NULL on error.
+ * @return Transformed XML expression to be freed by the caller, NULL on error.
  */
-const char *transform_json2schema(const struct lys_module *module, const char *expr);
+char *transform_json2schema(const struct lys_module *module, const char *expr);
 
 /**
  * @brief Transform expression from XML data format (prefixes and separate NS definitions) to
@@ -433,6 +433,56 @@ int ly_strequal_(const char *s1, const char *s2);
 #define ly_strequal1(s1, s2) (s1 == s2)
 #define ly_strequal(s1, s2, d) ly_strequal##d(s1, s2)
 
+/**
+ * @brief Hash map of pointers, it attaches internal data to the public structures without changing them.
+ *
+ * The map uses open addressing with linear probing, NULL key marks a free bucket. It is not thread-safe,
+ * a map shared by threads must be protected by a lock of its owner.
+ */
+struct ly_ptr_map {
+    uint32_t size;                   /**< number of buckets, a power of 2 or 0 if not allocated */
+    uint32_t used;                   /**< number of stored items */
+    struct ly_ptr_map_item {
+        const void *key;
+        void *value;
+    } *items;                        /**< [size] buckets */
+};
+
+/**
+ * @brief Get the value stored for a key.
+ *
+ * @param[in] map Map to search in.
+ * @param[in] key Key of the item.
+ * @return Stored value, NULL if there is none.
+ */
+void *ly_ptr_map_get(const struct ly_ptr_map *map, const void *key);
+
+/**
+ * @brief Store a value for a key, the previous value of the key is replaced.
+ *
+ * @param[in] map Map to modify.
+ * @param[in] key Key of the item, must not be NULL.
+ * @param[in] value Value to store, must not be NULL.
+ * @return EXIT_SUCCESS or EXIT_FAILURE on memory allocation error.
+ */
+int ly_ptr_map_set(struct ly_ptr_map *map, const void *key, void *value);
+
+/**
+ * @brief Remove the item of a key.
+ *
+ * @param[in] map Map to modify.
+ * @param[in] key Key of the item.
+ * @return Value of the removed item, NULL if there was none.
+ */
+void *ly_ptr_map_remove(struct ly_ptr_map *map, const void *key);
+
+/**
+ * @brief Free the buckets of the map, the stored values are not touched.
+ *
+ * @param[in] map Map to clean.
+ */
+void ly_ptr_map_clean(struct ly_ptr_map *map);
+
 int64_t dec_pow(uint8_t exp);
 
 int dec64cmp(int64_t num1, uint8_t dig1, int64_t num2, uint8_t dig2);
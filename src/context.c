@@ -92,7 +92,7 @@ ly_ctx_new_old(const char *search_dir, int options)
     LY_CHECK_ERR_RETURN(!ctx, LOGMEM, NULL);
 
     /* dictionary */
-    lydict_init(&ctx->dict);
+    LY_CHECK_ERR_RETURN(lydict_init(&ctx->dict), free(ctx), NULL);
 
     /* plugins */
     lyext_load_plugins();
@@ -100,9 +100,15 @@ ly_ctx_new_old(const char *search_dir, int options)
     /* initialize thread-specific key */
     while ((i = pthread_key_create(&ctx->errlist_key, ly_err_free)) == EAGAIN);
 
+    /* lock of the lazy caches */
+    pthread_mutex_init(&ctx->cache_lock, NULL);
+
+    /* lock of the uniqueness indexes of the data */
+    pthread_mutex_init(&ctx->unique_lock, NULL);
+
     /* models list */
     ctx->models.list = calloc(16, sizeof *ctx->models.list);
-    LY_CHECK_ERR_RETURN(!ctx->models.list, LOGMEM; free(ctx), NULL);
+    LY_CHECK_ERR_RETURN(!ctx->models.list, LOGMEM; lydict_clean(&ctx->dict); free(ctx), NULL);
     ext_plugins_ref++;
     ctx->models.flags = options;
     ctx->models.used = 0;
@@ -125,6 +131,7 @@ ly_ctx_new_old(const char *search_dir, int options)
         }
     }
     ctx->models.module_set_id = 1;
+    ctx->data_gen = 1;
 
     /* load internal modules */
     if (options & LY_CTX_NOYANGLIBRARY) {
@@ -293,6 +300,39 @@ ly_ctx_unset_trusted(struct ly_ctx *ctx)
     ly_ctx_unset_option(ctx, LY_CTX_TRUSTED);
 }
 
+API void
+ly_ctx_set_stats(struct ly_ctx *ctx)
+{
+    ly_ctx_set_option(ctx, LY_CTX_STATS);
+}
+
+API void
+ly_ctx_unset_stats(struct ly_ctx *ctx)
+{
+    ly_ctx_unset_option(ctx, LY_CTX_STATS);
+}
+
+API const struct ly_ctx_stats *
+ly_ctx_get_stats(const struct ly_ctx *ctx)
+{
+    if (!ctx) {
+        ly_errno = LY_EINVAL;
+        return NULL;
+    }
+
+    return &ctx->stats;
+}
+
+API void
+ly_ctx_reset_stats(struct ly_ctx *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
+    memset(&ctx->stats, 0, sizeof ctx->stats);
+}
+
 API int
 ly_ctx_set_searchdir(struct ly_ctx *ctx, const char *search_dir)
 {
@@ -373,6 +413,9 @@ ly_ctx_unset_searchdirs(struct ly_ctx *ctx, int index)
 
     for (i = 0; ctx->models.search_paths[i]; i++) {
         if (index < 0 || index == i) {
+            pthread_mutex_lock(&ctx->cache_lock);
+            lyp_sdir_remove(ctx, ctx->models.search_paths[i]);
+            pthread_mutex_unlock(&ctx->cache_lock);
             free(ctx->models.search_paths[i]);
             ctx->models.search_paths[i] = NULL;
         } else if (i > index) {
@@ -395,6 +438,9 @@ ly_ctx_destroy(struct ly_ctx *ctx, void (*private_destructor)(const struct lys_n
         return;
     }
 
+    /* cached data of the models */
+    ly_ctx_ylib_data_free(ctx);
+
     /* models list */
     for (; ctx->models.used > 0; ctx->models.used--) {
         /* remove the applied deviations and augments */
@@ -402,17 +448,25 @@ ly_ctx_destroy(struct ly_ctx *ctx, void (*private_destructor)(const struct lys_n
         /* remove the module */
         lys_free(ctx->models.list[ctx->models.used - 1], private_destructor, 1, 0);
     }
+    /* the plans were removed with their types */
+    ly_ptr_map_clean(&ctx->type_plans);
     if (ctx->models.search_paths) {
         for(i = 0; ctx->models.search_paths[i]; i++) {
             free(ctx->models.search_paths[i]);
         }
         free(ctx->models.search_paths);
     }
+    lyp_sdir_remove(ctx, NULL);
     free(ctx->models.list);
 
     /* clean the error list */
     ly_err_clean(ctx, 0);
     pthread_key_delete(ctx->errlist_key);
+    pthread_mutex_destroy(&ctx->cache_lock);
+
+    /* the indexes of data trees not freed before the context are leaked with them */
+    ly_ptr_map_clean(&ctx->unique_idx);
+    pthread_mutex_destroy(&ctx->unique_lock);
 
     /* dictionary */
     lydict_clean(&ctx->dict);
@@ -785,6 +839,54 @@ ly_ctx_load_module(struct ly_ctx *ctx, const char *name, const char *revision)
     return mod;
 }
 
+API int
+ly_ctx_load_modules(struct ly_ctx *ctx, const char **names, const char **revisions, unsigned int count,
+                    unsigned int threads)
+{
+    struct ly_ctx *ctx_prev = ly_parser_data.ctx;
+    const char *rev;
+    unsigned int u;
+    long cpus;
+    int ret = EXIT_SUCCESS;
+
+    if (!ctx || !names) {
+        ly_errno = LY_EINVAL;
+        return EXIT_FAILURE;
+    }
+    for (u = 0; u < count; u++) {
+        if (!names[u]) {
+            ly_errno = LY_EINVAL;
+            return EXIT_FAILURE;
+        }
+    }
+
+    ly_parser_data.ctx = ctx;
+
+    if (!threads) {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? cpus : 1;
+    }
+
+    /* the modules provided by the callback are not parsed in advance, they are not searched for */
+    if ((threads > 1) && !ctx->imp_clb && lyp_preparse_modules(ctx, names, revisions, count, threads)) {
+        ly_parser_data.ctx = ctx_prev;
+        return EXIT_FAILURE;
+    }
+
+    /* load the modules with their imports in order, the parsed ones are taken by lyp_search_file() */
+    for (u = 0; u < count; u++) {
+        rev = (revisions && revisions[u] && revisions[u][0]) ? revisions[u] : NULL;
+        if (!ly_ctx_load_sub_module(ctx, NULL, names[u], rev, 1, NULL)) {
+            ret = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    lyp_preparsed_free(ctx);
+    ly_parser_data.ctx = ctx_prev;
+    return ret;
+}
+
 /*
  * mods - set of removed modules, if NULL all modules are supposed to be removed so any backlink is invalid
  */
@@ -1506,8 +1608,8 @@ ylib_submodules(struct lyd_node *parent, struct lys_module *cur_mod)
     return EXIT_SUCCESS;
 }
 
-API struct lyd_node *
-ly_ctx_info(struct ly_ctx *ctx)
+static struct lyd_node *
+ylib_data(struct ly_ctx *ctx)
 {
     int i, bis = 0;
     char id[8];
@@ -1515,11 +1617,6 @@ ly_ctx_info(struct ly_ctx *ctx)
     const struct lys_module *mod;
     struct lyd_node *root, *root_bis = NULL, *cont = NULL, *cont_bis = NULL;
 
-    if (!ctx) {
-        ly_errno = LY_EINVAL;
-        return NULL;
-    }
-
     mod = ly_ctx_get_module(ctx, "ietf-yang-library", NULL, 1);
     if (!mod || !mod->data) {
         LOGERR(LY_EINVAL, "ietf-yang-library is not implemented.");
@@ -1684,6 +1781,69 @@ error:
     return NULL;
 }
 
+void
+ly_ctx_ylib_data_free(struct ly_ctx *ctx)
+{
+    pthread_mutex_lock(&ctx->cache_lock);
+    lyd_free_withsiblings(ctx->ylib_data);
+    ctx->ylib_data = NULL;
+    LY_CACHE_STORE(ctx->ylib_set_id, 0);
+    pthread_mutex_unlock(&ctx->cache_lock);
+}
+
+API struct lyd_node *
+ly_ctx_info(struct ly_ctx *ctx)
+{
+    struct lyd_node *root = NULL, *iter, *dup, *next, *elem, *data;
+    uint16_t set_id;
+
+    if (!ctx) {
+        ly_errno = LY_EINVAL;
+        return NULL;
+    }
+
+    set_id = LY_CACHE_LOAD(ctx->ylib_set_id);
+    if (!set_id || (set_id != ctx->models.module_set_id)) {
+        /* the modules changed since the data were generated, the validation of the new data
+         * takes the cache lock itself, so they are generated first and published afterwards */
+        data = ylib_data(ctx);
+        if (!data) {
+            return NULL;
+        }
+        pthread_mutex_lock(&ctx->cache_lock);
+        if (ctx->ylib_set_id && (ctx->ylib_set_id == ctx->models.module_set_id)) {
+            /* generated by another thread meanwhile */
+            lyd_free_withsiblings(data);
+        } else {
+            lyd_free_withsiblings(ctx->ylib_data);
+            ctx->ylib_data = data;
+            LY_CACHE_STORE(ctx->ylib_set_id, ctx->models.module_set_id);
+        }
+        pthread_mutex_unlock(&ctx->cache_lock);
+    }
+
+    /* return a copy of the cached data */
+    LY_TREE_FOR(ctx->ylib_data, iter) {
+        dup = lyd_dup(iter, 1);
+        if (!dup || (root && lyd_insert_after(root->prev, dup))) {
+            lyd_free(dup);
+            lyd_free_withsiblings(root);
+            return NULL;
+        }
+        if (!root) {
+            root = dup;
+        }
+
+        /* the cached data are already validated */
+        LY_TREE_DFS_BEGIN(dup, next, elem) {
+            elem->validity = LYD_VAL_OK;
+            LY_TREE_DFS_END(dup, next, elem);
+        }
+    }
+
+    return root;
+}
+
 API const struct lys_node *
 ly_ctx_get_node(struct ly_ctx *ctx, const struct lys_node *start, const char *nodeid, int output)
 {
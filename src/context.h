@@ -16,14 +16,18 @@
 #define LY_CONTEXT_H_
 
 #include <pthread.h>
+#include <time.h>
 
 #include "libyang.h"
 #include "common.h"
 #include "dict_private.h"
 #include "tree_schema.h"
 
+struct lyp_sdir;
+
 struct ly_modules_list {
     char **search_paths;
+    struct lyp_sdir *search_index;
     int size;
     int used;
     struct lys_module **list;
@@ -34,6 +38,11 @@ struct ly_modules_list {
     uint8_t parsing_sub_modules_count;
     uint8_t parsed_submodules_count;
     uint16_t module_set_id;
+    /* module_set_id of the current LYS_MAND_SUBTREE flags in the schema nodes, 0 if they must be set again */
+    uint16_t mand_set_id;
+    /* modules parsed in advance by ly_ctx_load_modules() */
+    struct lyp_preparsed **preparsed;
+    unsigned int preparsed_count;
     int flags;
 };
 
@@ -54,6 +63,91 @@ struct ly_ctx {
     void *data_clb_data;
     pthread_key_t errlist_key;
     uint8_t internal_module_count;
+    struct ly_ctx_stats stats;
+    struct lyd_node *ylib_data;      /* cached ietf-yang-library data returned (duplicated) by ly_ctx_info() */
+    uint16_t ylib_set_id;            /* module_set_id of ylib_data, 0 if it must be generated again */
+    uint32_t data_gen;               /* generation of the data trees, changed whenever a data node is removed or
+                                        a value changed, always odd so it is never 0 */
+    pthread_mutex_t cache_lock;      /* serializes building of the lazy caches (in the schemas, ylib_data, the
+                                        LYS_MAND_SUBTREE flags, models.search_index) by the threads sharing
+                                        the context */
+    struct ly_ptr_map type_plans;    /* validation plans of the resolved types (struct lyp_type_plan), keyed by the
+                                        types, changed only together with the schemas */
+    struct ly_ptr_map unique_idx;    /* indexes of the list/leaf-list instances for the uniqueness checks (struct
+                                        lyd_unique_index), keyed by the indexed data nodes */
+    uint32_t unique_idx_used;        /* copy of unique_idx.used, read without the lock to skip an empty map */
+    pthread_mutex_t unique_lock;     /* protects unique_idx, the threads sharing the context change their data
+                                        trees at once */
 };
 
+/**
+ * @brief Note that some data tree in the context was changed, so the cached references into the data are not valid.
+ * Threads parsing their own data trees in the context may do it at once, so the generation is increased atomically,
+ * by 2 to keep it odd.
+ */
+#define LY_DATA_GEN_NEXT(CTX) __atomic_add_fetch(&(CTX)->data_gen, 2, __ATOMIC_RELAXED)
+
+/**
+ * @brief Get the current generation of the data trees in the context, see #LY_DATA_GEN_NEXT.
+ */
+#define LY_DATA_GEN(CTX) __atomic_load_n(&(CTX)->data_gen, __ATOMIC_RELAXED)
+
+/**
+ * @brief Read the pointer (or id) of a lazily built cache, which may be published by another thread.
+ * Once it is not NULL (0), all the cached content is visible to the caller.
+ */
+#define LY_CACHE_LOAD(VAR) __atomic_load_n(&(VAR), __ATOMIC_ACQUIRE)
+
+/**
+ * @brief Publish a lazily built cache after all its content was written, always under ly_ctx#cache_lock.
+ */
+#define LY_CACHE_STORE(VAR, VAL) __atomic_store_n(&(VAR), (VAL), __ATOMIC_RELEASE)
+
+/**
+ * @brief Check whether the context collects performance statistics (#LY_CTX_STATS).
+ */
+#define LY_STATS_ON(CTX) ((CTX)->models.flags & LY_CTX_STATS)
+
+/**
+ * @brief Increase a performance counter of the context if the statistics are enabled, atomically, since the
+ * context may be used by several threads.
+ */
+#define LY_STATS_INC(CTX, COUNTER) \
+    do { if (LY_STATS_ON(CTX)) { __atomic_fetch_add(&(CTX)->stats.COUNTER, 1, __ATOMIC_RELAXED); } } while (0)
+
+/**
+ * @brief Start a phase timer, \p START is 0 if the statistics are disabled (or \p CTX is NULL).
+ */
+#define LY_STATS_TIMER_START(CTX, START) START = ((CTX) && LY_STATS_ON(CTX) ? ly_stats_time() : 0)
+
+/**
+ * @brief Add the time elapsed since LY_STATS_TIMER_START() to the \p TIMER of the context. \p START is reset,
+ * so the timer can be safely stopped again on a common error path.
+ */
+#define LY_STATS_TIMER_STOP(CTX, START, TIMER) \
+    do { if (START) { __atomic_fetch_add(&(CTX)->stats.TIMER, ly_stats_time() - (START), __ATOMIC_RELAXED); \
+                      (START) = 0; } } while (0)
+
+/**
+ * @brief Get the current monotonic time for the phase timers.
+ *
+ * @return Time in nanoseconds.
+ */
+static inline uint64_t
+ly_stats_time(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief Free the cached ietf-yang-library data of ly_ctx_info(). Must be called before any module is freed, the
+ * cached data refer to the schemas (and the freed modules also change the content of the data).
+ *
+ * @param[in] ctx Context of the cached data.
+ */
+void ly_ctx_ylib_data_free(struct ly_ctx *ctx);
+
 #endif /* LY_CONTEXT_H_ */
@@ -12,6 +12,7 @@
  *     https://opensource.org/licenses/BSD-3-Clause
  */
 
+#include <assert.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -21,22 +22,26 @@
 #include "context.h"
 #include "dict_private.h"
 
-void
+int
 lydict_init(struct dict_table *dict)
 {
     if (!dict) {
         ly_errno = LY_EINVAL;
-        return;
+        return EXIT_FAILURE;
     }
 
+    dict->recs = calloc(DICT_SIZE, sizeof *dict->recs);
+    LY_CHECK_ERR_RETURN(!dict->recs, LOGMEM, EXIT_FAILURE);
     dict->hash_mask = DICT_SIZE - 1;
-    pthread_mutex_init(&dict->lock, NULL);
+    pthread_rwlock_init(&dict->lock, NULL);
+
+    return EXIT_SUCCESS;
 }
 
 void
 lydict_clean(struct dict_table *dict)
 {
-    int i;
+    uint32_t i;
     struct dict_rec *chain, *rec;
 
     if (!dict) {
@@ -44,7 +49,7 @@ lydict_clean(struct dict_table *dict)
         return;
     }
 
-    for (i = 0; i < DICT_SIZE; i++) {
+    for (i = 0; i <= dict->hash_mask; i++) {
         rec = &dict->recs[i];
         chain = rec->next;
 
@@ -57,8 +62,9 @@ lydict_clean(struct dict_table *dict)
             free(rec);
         }
     }
+    free(dict->recs);
 
-    pthread_mutex_destroy(&dict->lock);
+    pthread_rwlock_destroy(&dict->lock);
 }
 
 /*
@@ -109,28 +115,58 @@ dict_hash_multi(uint32_t hash, const char *key_part, size_t len)
     return hash;
 }
 
-API void
-lydict_remove(struct ly_ctx *ctx, const char *value)
+/*
+ * Batch of the dictionary references of a thread parsing many strings into a shared context (see
+ * lydict_batch_start()). The first insert of a string locks the dictionary as usual, the next ones take
+ * the references reserved in the dictionary record in advance (by #DICT_BATCH_REFS) without locking it.
+ * The removed references are returned to the reservation and the unused ones are dropped by lydict_batch_end().
+ */
+#define DICT_BATCH_REFS 64
+#define DICT_BATCH_SIZE 256
+
+struct dict_batch_rec {
+    char *value;                    /* string in the context dictionary */
+    uint32_t hash;
+    uint32_t len;
+    uint32_t refs;                  /* references reserved in the dictionary record and not handed out */
+};
+
+struct dict_batch {
+    struct ly_ctx *ctx;
+    struct dict_batch_rec *recs;    /* open addressing hash table */
+    uint32_t hash_mask;
+    uint32_t used;
+};
+
+static THREAD_LOCAL struct dict_batch *dict_batch;
+
+static void
+dict_lock(struct ly_ctx *ctx)
 {
-    size_t len;
-    uint32_t index;
-    struct dict_rec *record, *prev = NULL;
-
-    if (!value || !ctx) {
+    if (LY_STATS_ON(ctx)) {
+        if (!pthread_rwlock_trywrlock(&ctx->dict.lock)) {
+            return;
+        }
+        pthread_rwlock_wrlock(&ctx->dict.lock);
+        /* the readers in lydict_find() do not hold the write lock */
+        __atomic_fetch_add(&ctx->stats.dict_lock_waits, 1, __ATOMIC_RELAXED);
         return;
     }
 
-    len = strlen(value);
+    pthread_rwlock_wrlock(&ctx->dict.lock);
+}
 
-    pthread_mutex_lock(&ctx->dict.lock);
+/* drop the references of the record holding the value, the dictionary must be locked */
+static void
+dict_remove(struct ly_ctx *ctx, const char *value, uint32_t hash, uint32_t refs)
+{
+    struct dict_rec *record, *prev = NULL;
 
     if (!ctx->dict.used) {
-        pthread_mutex_unlock(&ctx->dict.lock);
         return;
     }
 
-    index = dict_hash(value, len) & ctx->dict.hash_mask;
-    record = &ctx->dict.recs[index];
+    record = &ctx->dict.recs[hash & ctx->dict.hash_mask];
 
     while (record && record->value != value) {
         prev = record;
@@ -139,11 +175,10 @@ lydict_remove(struct ly_ctx *ctx, const char *value)
 
     if (!record) {
         /* record not found */
-        pthread_mutex_unlock(&ctx->dict.lock);
         return;
     }
 
-    record->refcount--;
+    record->refcount -= refs;
     if (!record->refcount) {
         free(record->value);
         if (record->next) {
@@ -167,8 +202,111 @@ lydict_remove(struct ly_ctx *ctx, const char *value)
         }
         ctx->dict.used--;
     }
+}
+
+static int dict_batch_remove(const char *value);
+
+API void
+lydict_remove(struct ly_ctx *ctx, const char *value)
+{
+    if (!value || !ctx) {
+        return;
+    }
+
+    if (dict_batch && (dict_batch->ctx == ctx) && !dict_batch_remove(value)) {
+        return;
+    }
+
+    dict_lock(ctx);
+    dict_remove(ctx, value, dict_hash(value, strlen(value)), 1);
+    pthread_rwlock_unlock(&ctx->dict.lock);
+}
+
+/*
+ * Double the size of the hash table. The records keep their string values, only
+ * the chains are rebuilt, so the pointers returned from the dictionary stay valid.
+ * If there is not enough memory, the current table is kept.
+ */
+static void
+dict_resize(struct dict_table *dict)
+{
+    struct dict_rec *recs, *rec, *chain, *spare = NULL, *iter;
+    uint32_t i, index, mask, count;
+
+    mask = (dict->hash_mask << 1) | 1;
+    recs = calloc(mask + 1, sizeof *recs);
+    if (!recs) {
+        return;
+    }
+
+    /* count the static records moving into the new chains (marking the new heads in the same
+     * order as they are going to be filled) to prepare all the chain records before changing anything */
+    count = 0;
+    for (i = 0; i <= dict->hash_mask; i++) {
+        for (rec = &dict->recs[i]; rec && rec->value; rec = rec->next) {
+            index = dict_hash(rec->value, rec->len ? rec->len : strlen(rec->value)) & mask;
+            if (!recs[index].refcount) {
+                recs[index].refcount = 1;
+            } else if (rec == &dict->recs[i]) {
+                ++count;
+            }
+        }
+    }
+    for (; count; count--) {
+        iter = malloc(sizeof *iter);
+        if (!iter) {
+            for (; spare; spare = iter) {
+                iter = spare->next;
+                free(spare);
+            }
+            free(recs);
+            return;
+        }
+        iter->next = spare;
+        spare = iter;
+    }
+    memset(recs, 0, (mask + 1) * sizeof *recs);
+
+    /* move the records */
+    for (i = 0; i <= dict->hash_mask; i++) {
+        rec = &dict->recs[i];
+        if (!rec->value) {
+            continue;
+        }
+        chain = rec->next;
+        while (rec) {
+            index = dict_hash(rec->value, rec->len ? rec->len : strlen(rec->value)) & mask;
+            if (!recs[index].value) {
+                memcpy(&recs[index], rec, sizeof *rec);
+                recs[index].next = NULL;
+                if (rec != &dict->recs[i]) {
+                    rec->next = spare;
+                    spare = rec;
+                }
+            } else {
+                if (rec == &dict->recs[i]) {
+                    iter = spare;
+                    spare = spare->next;
+                    memcpy(iter, rec, sizeof *rec);
+                } else {
+                    iter = rec;
+                }
+                iter->next = recs[index].next;
+                recs[index].next = iter;
+            }
+
+            rec = chain;
+            chain = rec ? rec->next : NULL;
+        }
+    }
+    for (; spare; spare = iter) {
+        iter = spare->next;
+        free(spare);
+    }
 
-    pthread_mutex_unlock(&ctx->dict.lock);
+    free(dict->recs);
+    dict->recs = recs;
+    dict->hash_mask = mask;
 }
 
 static char *
@@ -178,6 +316,11 @@ dict_insert(struct ly_ctx *ctx, char *value, size_t len, int zerocopy)
     int match = 0;
     struct dict_rec *record, *new;
 
+    if (ctx->dict.used >= (ctx->dict.hash_mask + 1) * DICT_REHASH_RATIO) {
+        /* the chains are getting too long */
+        dict_resize(&ctx->dict);
+    }
+
     index = dict_hash(value, len) & ctx->dict.hash_mask;
     record = &ctx->dict.recs[index];
 
@@ -200,6 +343,7 @@ dict_insert(struct ly_ctx *ctx, char *value, size_t len, int zerocopy)
         record->next = NULL;
 
         ctx->dict.used++;
+        LY_STATS_INC(ctx, dict_misses);
 
         LOGDBG(LY_LDGDICT, "inserting \"%s\"", record->value);
         return record->value;
@@ -227,6 +371,7 @@ dict_insert(struct ly_ctx *ctx, char *value, size_t len, int zerocopy)
                 break;
             }
             record->refcount++;
+            LY_STATS_INC(ctx, dict_hits);
 
             if (zerocopy) {
                 free(value);
@@ -265,11 +410,175 @@ dict_insert(struct ly_ctx *ctx, char *value, size_t len, int zerocopy)
     record->next = new;
 
     ctx->dict.used++;
+    LY_STATS_INC(ctx, dict_misses);
 
     LOGDBG(LY_LDGDICT, "inserting \"%s\" with collision ", new->value);
     return new->value;
 }
 
+/* find the string in the batch, by the value pointer if len is 0 */
+static struct dict_batch_rec *
+dict_batch_find(struct dict_batch *batch, const char *value, size_t len, uint32_t hash)
+{
+    struct dict_batch_rec *brec;
+    uint32_t index;
+
+    for (index = hash & batch->hash_mask; batch->recs[index].value; index = (index + 1) & batch->hash_mask) {
+        brec = &batch->recs[index];
+        if (len ? ((brec->hash == hash) && (brec->len == len) && !memcmp(brec->value, value, len))
+                : (brec->value == value)) {
+            return brec;
+        }
+    }
+
+    return NULL;
+}
+
+/* add a new string into the batch, does not log, the batch just stays without it if there is not enough memory */
+static struct dict_batch_rec *
+dict_batch_add(struct dict_batch *batch, char *value, size_t len, uint32_t hash)
+{
+    struct dict_batch_rec *recs, *brec;
+    uint32_t i, index;
+
+    if ((batch->used + 1) * 2 > batch->hash_mask + 1) {
+        recs = calloc((batch->hash_mask + 1) * 2, sizeof *recs);
+        if (!recs) {
+            return NULL;
+        }
+        for (i = 0; i <= batch->hash_mask; i++) {
+            if (!batch->recs[i].value) {
+                continue;
+            }
+            for (index = batch->recs[i].hash & ((batch->hash_mask << 1) | 1); recs[index].value;
+                    index = (index + 1) & ((batch->hash_mask << 1) | 1));
+            recs[index] = batch->recs[i];
+        }
+        free(batch->recs);
+        batch->recs = recs;
+        batch->hash_mask = (batch->hash_mask << 1) | 1;
+    }
+
+    for (index = hash & batch->hash_mask; batch->recs[index].value; index = (index + 1) & batch->hash_mask);
+    brec = &batch->recs[index];
+    brec->value = value;
+    brec->hash = hash;
+    brec->len = len;
+    brec->refs = 0;
+    batch->used++;
+
+    return brec;
+}
+
+static const char *
+dict_batch_insert(struct dict_batch *batch, char *value, size_t len, int zerocopy)
+{
+    struct ly_ctx *ctx = batch->ctx;
+    struct dict_batch_rec *brec;
+    struct dict_rec *record;
+    uint32_t hash, refs;
+    char *result;
+
+    hash = dict_hash(value, len);
+    brec = dict_batch_find(batch, value, len, hash);
+    if (brec && brec->refs) {
+        brec->refs--;
+        LY_STATS_INC(ctx, dict_hits);
+        if (zerocopy) {
+            free(value);
+        }
+        return brec->value;
+    }
+
+    dict_lock(ctx);
+    if (brec) {
+        /* all the reserved references were handed out (so the record exists), reserve the next ones */
+        for (record = &ctx->dict.recs[hash & ctx->dict.hash_mask]; record->value != brec->value; record = record->next);
+        refs = DICT_REC_MAXCOUNT - record->refcount;
+        if (refs) {
+            brec->refs = (refs < DICT_BATCH_REFS ? refs : DICT_BATCH_REFS) - 1;
+            record->refcount += brec->refs + 1;
+            pthread_rwlock_unlock(&ctx->dict.lock);
+
+            LY_STATS_INC(ctx, dict_hits);
+            if (zerocopy) {
+                free(value);
+            }
+            return brec->value;
+        }
+        /* refcount overflow, the duplicated record is used from now on */
+    }
+    result = dict_insert(ctx, value, len, zerocopy);
+    pthread_rwlock_unlock(&ctx->dict.lock);
+
+    if (result) {
+        if (brec) {
+            brec->value = result;
+        } else {
+            dict_batch_add(batch, result, len, hash);
+        }
+    }
+    return result;
+}
+
+/* return the reference to the batch, non-zero if the value is not there */
+static int
+dict_batch_remove(const char *value)
+{
+    struct dict_batch_rec *brec;
+
+    brec = dict_batch_find(dict_batch, value, 0, dict_hash(value, strlen(value)));
+    if (!brec) {
+        return 1;
+    }
+
+    brec->refs++;
+    return 0;
+}
+
+int
+lydict_batch_start(struct ly_ctx *ctx)
+{
+    struct dict_batch *batch;
+
+    assert(!dict_batch);
+
+    batch = malloc(sizeof *batch);
+    LY_CHECK_ERR_RETURN(!batch, LOGMEM, EXIT_FAILURE);
+    batch->recs = calloc(DICT_BATCH_SIZE, sizeof *batch->recs);
+    LY_CHECK_ERR_RETURN(!batch->recs, LOGMEM; free(batch), EXIT_FAILURE);
+    batch->ctx = ctx;
+    batch->hash_mask = DICT_BATCH_SIZE - 1;
+    batch->used = 0;
+
+    dict_batch = batch;
+    return EXIT_SUCCESS;
+}
+
+void
+lydict_batch_end(void)
+{
+    struct dict_batch *batch = dict_batch;
+    uint32_t i;
+
+    if (!batch) {
+        return;
+    }
+    dict_batch = NULL;
+
+    /* drop the references which were not handed out */
+    dict_lock(batch->ctx);
+    for (i = 0; i <= batch->hash_mask; i++) {
+        if (batch->recs[i].refs) {
+            dict_remove(batch->ctx, batch->recs[i].value, batch->recs[i].hash, batch->recs[i].refs);
+        }
+    }
+    pthread_rwlock_unlock(&batch->ctx->dict.lock);
+
+    free(batch->recs);
+    free(batch);
+}
+
 API const char *
 lydict_insert(struct ly_ctx *ctx, const char *value, size_t len)
 {
@@ -283,9 +592,13 @@ lydict_insert(struct ly_ctx *ctx, const char *value, size_t len)
         return NULL;
     }
 
-    pthread_mutex_lock(&ctx->dict.lock);
+    if (dict_batch && (dict_batch->ctx == ctx)) {
+        return dict_batch_insert(dict_batch, (char *)value, len, 0);
+    }
+
+    dict_lock(ctx);
     result = dict_insert(ctx, (char *)value, len, 0);
-    pthread_mutex_unlock(&ctx->dict.lock);
+    pthread_rwlock_unlock(&ctx->dict.lock);
 
     return result;
 }
@@ -299,9 +612,48 @@ lydict_insert_zc(struct ly_ctx *ctx, char *value)
         return NULL;
     }
 
-    pthread_mutex_lock(&ctx->dict.lock);
+    if (dict_batch && (dict_batch->ctx == ctx)) {
+        return dict_batch_insert(dict_batch, value, strlen(value), 1);
+    }
+
+    dict_lock(ctx);
     result = dict_insert(ctx, value, strlen(value), 1);
-    pthread_mutex_unlock(&ctx->dict.lock);
+    pthread_rwlock_unlock(&ctx->dict.lock);
+
+    return result;
+}
+
+API const char *
+lydict_find(struct ly_ctx *ctx, const char *value, size_t len)
+{
+    struct dict_rec *record;
+    const char *result = NULL;
+
+    if (!ctx || !value) {
+        return NULL;
+    }
+    if (!len) {
+        len = strlen(value);
+    }
+
+    /* only readers, so the lookups in several threads do not wait for each other */
+    pthread_rwlock_rdlock(&ctx->dict.lock);
+
+    for (record = &ctx->dict.recs[dict_hash(value, len) & ctx->dict.hash_mask];
+            record && record->value;
+            record = record->next) {
+        if (record->len) {
+            if ((record->len == len) && !memcmp(value, record->value, len)) {
+                result = record->value;
+                break;
+            }
+        } else if (!strncmp(value, record->value, len) && (record->value[len] == '\0')) {
+            result = record->value;
+            break;
+        }
+    }
+
+    pthread_rwlock_unlock(&ctx->dict.lock);
 
     return result;
 }
@@ -76,6 +76,19 @@ const char *lydict_insert_zc(struct ly_ctx *ctx, char *value);
  */
 void lydict_remove(struct ly_ctx *ctx, const char *value);
 
+/**
+ * @brief Find string in the dictionary without inserting it. Neither the dictionary nor the reference
+ * counter of the string is changed, so several threads can search the dictionary at the same time.
+ *
+ * @param[in] ctx libyang context handler
+ * @param[in] value String to be found. It is not required to be NULL terminated string, see \p len.
+ * @param[in] len Number of bytes of \p value, 0 if \p value is NULL terminated.
+ * @return pointer to the string stored in the dictionary, NULL if there is no such string. The string is not
+ * referenced, so it is valid only while the caller holds another reference to it (for example, while the schema
+ * or data using it exist). The returned pointer can be compared with other dictionary strings using ==.
+ */
+const char *lydict_find(struct ly_ctx *ctx, const char *value, size_t len);
+
 /**@} dict */
 
 #ifdef __cplusplus
@@ -21,14 +21,18 @@
 #include "dict.h"
 
 /**
- * size of the dictionary for each context
+ * initial size of the dictionary for each context
  */
 #define DICT_SIZE 1024
 
+/**
+ * average number of records per hash chain causing the dictionary to be enlarged
+ */
+#define DICT_REHASH_RATIO 2
+
 /**
  * record of the dictionary
- * TODO: save the next pointer by different collision strategy, will need to
- * make dictionary size dynamic
+ * TODO: save the next pointer by different collision strategy
  */
 struct dict_rec {
     struct dict_rec *next;
@@ -40,22 +44,23 @@ struct dict_rec {
 };
 
 /**
- * dictionary to store repeating strings
- * TODO: make it variable size
+ * dictionary to store repeating strings, the table is doubled
+ * whenever it gets filled over #DICT_REHASH_RATIO
  */
 struct dict_table {
-    struct dict_rec recs[DICT_SIZE];
-    int hash_mask;
+    struct dict_rec *recs;
+    uint32_t hash_mask;
     uint32_t used;
-    pthread_mutex_t lock;
+    pthread_rwlock_t lock;          /* write-locked for inserting and removing, read-locked by lydict_find() */
 };
 
 /**
  * @brief Initiate content (non-zero values) of the dictionary
  *
  * @param[in] dict Dictionary table to initiate
+ * @return EXIT_SUCCESS or EXIT_FAILURE on memory allocation failure
  */
-void lydict_init(struct dict_table *dict);
+int lydict_init(struct dict_table *dict);
 
 /**
  * @brief Cleanup the dictionary content
@@ -64,6 +69,21 @@ void lydict_init(struct dict_table *dict);
  */
 void lydict_clean(struct dict_table *dict);
 
+/**
+ * @brief Start batching the dictionary references of the strings inserted into the context by the current
+ * thread, so that repeating strings do not lock the dictionary shared with other threads. The strings are
+ * valid dictionary strings of the context as usual.
+ *
+ * @param[in] ctx Context of the dictionary.
+ * @return EXIT_SUCCESS or EXIT_FAILURE on memory allocation failure
+ */
+int lydict_batch_start(struct ly_ctx *ctx);
+
+/**
+ * @brief Stop batching the dictionary references of the current thread started by lydict_batch_start().
+ */
+void lydict_batch_end(void);
+
 /**
  * @brief compute hash from (several) string(s)
  *
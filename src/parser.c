@@ -20,6 +20,7 @@
 #include <fcntl.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
@@ -28,6 +29,12 @@
 #include <unistd.h>
 #include <pcre.h>
 
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#elif defined(__SSE2__)
+#   include <emmintrin.h>
+#endif
+
 #include "common.h"
 #include "context.h"
 #include "libyang.h"
@@ -35,6 +42,7 @@
 #include "resolve.h"
 #include "tree_internal.h"
 #include "parser_yang.h"
+#include "xml_internal.h"
 
 #define LYP_URANGE_LEN 19
 
@@ -247,6 +255,207 @@ lyp_data_check_options(int options, const char *func)
     return 0;
 }
 
+static uint32_t
+lyp_select_hash(const struct lys_node *schema)
+{
+    return dict_hash_multi(dict_hash_multi(0, (const char *)&schema, sizeof schema), NULL, 0);
+}
+
+/* does not log, returns the item of the schema node, NULL if the node is not in the table */
+static struct lyp_select_item *
+lyp_select_find(const struct lyp_select *select, const struct lys_node *schema)
+{
+    uint32_t h;
+
+    for (h = lyp_select_hash(schema) & (select->size - 1); select->items[h].schema; h = (h + 1) & (select->size - 1)) {
+        if (select->items[h].schema == schema) {
+            return &select->items[h];
+        }
+    }
+    return NULL;
+}
+
+/* does not log, sets the state of the schema node unless it already has a higher one, returns -1 on memory error */
+static int
+lyp_select_mark(struct lyp_select *select, const struct lys_node *schema, uint8_t sel)
+{
+    struct lyp_select_item *item, *old;
+    uint32_t h, u, old_size;
+
+    item = lyp_select_find(select, schema);
+    if (item) {
+        if (item->sel < sel) {
+            item->sel = sel;
+        }
+        return 0;
+    }
+
+    if ((select->count + 1) * 2 > select->size) {
+        /* keep the table at most half full */
+        old = select->items;
+        old_size = select->size;
+        select->size <<= 1;
+        select->items = calloc(select->size, sizeof *select->items);
+        if (!select->items) {
+            select->items = old;
+            select->size = old_size;
+            return -1;
+        }
+        for (u = 0; u < old_size; u++) {
+            if (old[u].schema) {
+                for (h = lyp_select_hash(old[u].schema) & (select->size - 1); select->items[h].schema;
+                        h = (h + 1) & (select->size - 1));
+                select->items[h] = old[u];
+            }
+        }
+        free(old);
+    }
+
+    for (h = lyp_select_hash(schema) & (select->size - 1); select->items[h].schema; h = (h + 1) & (select->size - 1));
+    select->items[h].schema = schema;
+    select->items[h].sel = sel;
+    select->count++;
+    return 0;
+}
+
+struct lyp_select *
+lyp_select_new(const struct ly_set *set)
+{
+    struct lyp_select *select;
+    const struct lyp_select_item *item;
+    const struct lys_node *iter;
+    const struct lys_node_list *list;
+    unsigned int i, j;
+
+    select = calloc(1, sizeof *select);
+    LY_CHECK_ERR_RETURN(!select, LOGMEM, NULL);
+    select->size = 16;
+    select->items = calloc(select->size, sizeof *select->items);
+    LY_CHECK_ERR_GOTO(!select->items, LOGMEM, error);
+
+    for (i = 0; i < set->number; ++i) {
+        if (lyp_select_mark(select, set->set.s[i], 2)) {
+            LOGMEM;
+            goto error;
+        }
+        for (iter = lys_parent(set->set.s[i]); iter; iter = lys_parent(iter)) {
+            if (lyp_select_mark(select, iter, 1)) {
+                LOGMEM;
+                goto error;
+            }
+            if (iter->nodetype != LYS_LIST) {
+                continue;
+            }
+            /* the keys are needed to create the list instances */
+            list = (const struct lys_node_list *)iter;
+            for (j = 0; j < list->keys_size; ++j) {
+                if (lyp_select_mark(select, (struct lys_node *)list->keys[j], 1)) {
+                    LOGMEM;
+                    goto error;
+                }
+            }
+        }
+    }
+
+    /* the ancestors and keys marked inside a selected subtree are parsed with the whole subtree */
+    for (i = 0; i < select->size; ++i) {
+        if (select->items[i].sel != 1) {
+            continue;
+        }
+        for (iter = lys_parent(select->items[i].schema); iter; iter = lys_parent(iter)) {
+            item = lyp_select_find(select, iter);
+            if (item && (item->sel == 2)) {
+                select->items[i].sel = 2;
+                break;
+            }
+        }
+    }
+
+    return select;
+
+error:
+    lyp_select_free(select);
+    return NULL;
+}
+
+void
+lyp_select_free(struct lyp_select *select)
+{
+    if (!select) {
+        return;
+    }
+
+    free(select->items);
+    free(select);
+}
+
+int
+lyp_data_selected(struct lyp_select *select, const struct lys_node *schema)
+{
+    const struct lyp_select_item *item;
+    const struct lys_node *iter;
+    uint8_t sel = 0;
+
+    item = lyp_select_find(select, schema);
+    if (item) {
+        return item->sel;
+    }
+
+    /* not marked, so it is selected only as a descendant of a selected node, which is the nearest marked ancestor */
+    for (iter = lys_parent(schema); iter; iter = lys_parent(iter)) {
+        item = lyp_select_find(select, iter);
+        if (item) {
+            sel = (item->sel == 2) ? 2 : 0;
+            break;
+        }
+    }
+
+    /* remember the result, it does not matter if it fails */
+    lyp_select_mark(select, schema, sel);
+    return sel;
+}
+
+void
+lyp_data_select_prune(struct lyd_node **first, struct lyp_select *select)
+{
+    struct lyd_node *node, *next, *child;
+
+    LY_TREE_FOR_SAFE(*first, next, node) {
+        switch (lyp_data_selected(select, node->schema)) {
+        case 2:
+            /* the whole subtree is selected */
+            continue;
+        case 1:
+            if (node->schema->nodetype == LYS_LEAF) {
+                /* list key */
+                continue;
+            }
+            lyp_data_select_prune(&node->child, select);
+
+            /* keep it only if there is something more than the list keys */
+            LY_TREE_FOR(node->child, child) {
+                if ((node->schema->nodetype != LYS_LIST) || (child->schema->nodetype != LYS_LEAF)
+                        || !lys_is_key((struct lys_node_list *)node->schema, (struct lys_node_leaf *)child->schema)) {
+                    break;
+                }
+            }
+            if (child) {
+                continue;
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (node == *first) {
+            lyd_free(node);
+            *first = next;
+        } else {
+            lyd_free(node);
+        }
+    }
+}
+
 void *
 lyp_mmap(int fd, size_t addsize, size_t *length)
 {
@@ -342,6 +551,9 @@ lyp_add_ietf_netconf_annotations(struct lys_module *mod)
     (*type)->info.enums.enm[3].name = lydict_insert(ctx, "delete", 6);
     (*type)->info.enums.enm[4].value = 4;
     (*type)->info.enums.enm[4].name = lydict_insert(ctx, "remove", 6);
+    if (lyp_type_prepare(*type)) {
+        return EXIT_FAILURE;
+    }
     mod->ext_size++;
 
     /* 2) filter's type */
@@ -382,6 +594,9 @@ lyp_add_ietf_netconf_annotations(struct lys_module *mod)
             break;
         }
     }
+    if (lyp_type_prepare(*type)) {
+        return EXIT_FAILURE;
+    }
     mod->ext_size++;
 
     /* 3) filter's select */
@@ -401,36 +616,276 @@ lyp_add_ietf_netconf_annotations(struct lys_module *mod)
     (*type)->base = LY_TYPE_STRING;
     (*type)->der = ly_types[LY_TYPE_STRING];
     (*type)->parent = (struct lys_tpdf *)op;
+    if (lyp_type_prepare(*type)) {
+        return EXIT_FAILURE;
+    }
     mod->ext_size++;
 
     return EXIT_SUCCESS;
 }
 
-/* if module is !NULL, then the function searches for submodule */
-struct lys_module *
-lyp_search_file(struct ly_ctx *ctx, struct lys_module *module, const char *name, const char *revision,
-                int implement, struct unres_schema *unres)
+static void lyp_sdir_free(struct lyp_sdir *sdir);
+
+static void
+lyp_sdir_clean(struct lyp_sdir *sdir)
+{
+    uint32_t u;
+
+    for (u = 0; u < sdir->file_count; u++) {
+        free(sdir->files[u].name);
+    }
+    free(sdir->files);
+    sdir->files = NULL;
+    sdir->file_count = 0;
+    free(sdir->hash);
+    sdir->hash = NULL;
+    sdir->hash_mask = 0;
+    for (u = 0; u < sdir->subdir_count; u++) {
+        lyp_sdir_free(sdir->subdirs[u]);
+    }
+    free(sdir->subdirs);
+    sdir->subdirs = NULL;
+    sdir->subdir_count = 0;
+    sdir->indexed = 0;
+}
+
+static void
+lyp_sdir_free(struct lyp_sdir *sdir)
+{
+    if (!sdir) {
+        return;
+    }
+
+    lyp_sdir_clean(sdir);
+    free(sdir->path);
+    free(sdir);
+}
+
+static struct lyp_sdir *
+lyp_sdir_new(char *path)
+{
+    struct lyp_sdir *sdir;
+
+    sdir = calloc(1, sizeof *sdir);
+    LY_CHECK_ERR_RETURN(!sdir, LOGMEM; free(path), NULL);
+    sdir->path = path;
+
+    return sdir;
+}
+
+static uint32_t
+lyp_sfile_hash(const char *name, size_t len)
+{
+    return dict_hash_multi(dict_hash_multi(0, name, len), NULL, 0);
+}
+
+/**
+ * @brief Make sure the directory index is up-to-date, (re)build it if the directory was modified. Its subdirectories
+ * are only listed, they are indexed when the search gets to them. Called with ly_ctx#cache_lock held.
+ *
+ * @param[in] sdir Directory index to update.
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE if the directory cannot be read (only a warning is printed),
+ * -1 on memory allocation error.
+ */
+static int
+lyp_sdir_update(struct lyp_sdir *sdir)
 {
-    size_t len, flen, match_len = 0, dir_len;
-    int fd, i, implicit_cwd = 0;
-    char *wd, *wn = NULL;
-    DIR *dir = NULL;
+    DIR *dir;
     struct dirent *file;
-    char *match_name = NULL, *dot, *rev, *filename;
+    struct stat st, fst;
+    struct timespec now;
+    char *wn = NULL;
+    size_t flen;
+    LYS_INFORMAT format;
+    struct lyp_sfile *sfile;
+    void *r;
+    uint32_t u, h, size;
+
+    if (stat(sdir->path, &st) == -1) {
+        LOGWRN("Unable to open directory \"%s\" for searching (sub)modules (%s).", sdir->path, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    if (sdir->indexed && (st.st_mtim.tv_sec == sdir->mtime.tv_sec) && (st.st_mtim.tv_nsec == sdir->mtime.tv_nsec)) {
+        /* no file was added, removed or renamed in the directory since it was indexed */
+        return EXIT_SUCCESS;
+    }
+
+    lyp_sdir_clean(sdir);
+
+    dir = opendir(sdir->path);
+    if (!dir) {
+        LOGWRN("Unable to open directory \"%s\" for searching (sub)modules (%s).", sdir->path, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    while ((file = readdir(dir))) {
+        if (!strcmp(".", file->d_name) || !strcmp("..", file->d_name)) {
+            /* skip . and .. */
+            continue;
+        }
+        if (asprintf(&wn, "%s/%s", sdir->path, file->d_name) == -1) {
+            LOGMEM;
+            goto error;
+        }
+        if (stat(wn, &fst) == -1) {
+            LOGWRN("Unable to get information about \"%s\" file in \"%s\" when searching for (sub)modules (%s)",
+                   file->d_name, sdir->path, strerror(errno));
+            free(wn);
+            continue;
+        }
+        if (S_ISDIR(fst.st_mode)) {
+            /* subdirectory, indexed only when searched */
+            r = realloc(sdir->subdirs, (sdir->subdir_count + 1) * sizeof *sdir->subdirs);
+            LY_CHECK_ERR_GOTO(!r, LOGMEM; free(wn), error);
+            sdir->subdirs = r;
+            sdir->subdirs[sdir->subdir_count] = lyp_sdir_new(wn);
+            if (!sdir->subdirs[sdir->subdir_count]) {
+                goto error;
+            }
+            sdir->subdir_count++;
+            continue;
+        }
+        free(wn);
+        if (!S_ISREG(fst.st_mode)) {
+            /* not a regular file (note that we see the target of symlinks instead of symlinks */
+            continue;
+        }
+
+        /* get type according to filename suffix */
+        flen = strlen(file->d_name);
+        if ((flen > 4) && !strcmp(&file->d_name[flen - 4], ".yin")) {
+            format = LYS_IN_YIN;
+            flen -= 4;
+        } else if ((flen > 5) && !strcmp(&file->d_name[flen - 5], ".yang")) {
+            format = LYS_IN_YANG;
+            flen -= 5;
+        } else {
+            /* not supported suffix/file format */
+            continue;
+        }
+
+        r = realloc(sdir->files, (sdir->file_count + 1) * sizeof *sdir->files);
+        LY_CHECK_ERR_GOTO(!r, LOGMEM, error);
+        sdir->files = r;
+        sfile = &sdir->files[sdir->file_count];
+        sfile->name = strdup(file->d_name);
+        LY_CHECK_ERR_GOTO(!sfile->name, LOGMEM, error);
+        /* the name is followed by the revision or directly by the suffix */
+        for (sfile->mod_len = 0; (sfile->mod_len < flen) && (file->d_name[sfile->mod_len] != '@'); sfile->mod_len++);
+        sfile->format = format;
+        sfile->next = 0;
+        sdir->file_count++;
+    }
+    closedir(dir);
+
+    /* hash the files by their (sub)module name, insert them in reverse order to keep the readdir() order in chains */
+    for (size = 1; size < 2 * sdir->file_count; size <<= 1);
+    sdir->hash = calloc(size, sizeof *sdir->hash);
+    LY_CHECK_ERR_RETURN(!sdir->hash, LOGMEM; lyp_sdir_clean(sdir), -1);
+    sdir->hash_mask = size - 1;
+    for (u = sdir->file_count; u; u--) {
+        h = lyp_sfile_hash(sdir->files[u - 1].name, sdir->files[u - 1].mod_len) & sdir->hash_mask;
+        sdir->files[u - 1].next = sdir->hash[h];
+        sdir->hash[h] = u;
+    }
+
+    /* a directory modified within the timestamp granularity could have been changed after reading it without
+     * changing its timestamp, so such an index is used only for this search */
+    clock_gettime(CLOCK_REALTIME, &now);
+    sdir->mtime = st.st_mtim;
+    sdir->indexed = (now.tv_sec - st.st_mtim.tv_sec > 1) ? 1 : 0;
+
+    return EXIT_SUCCESS;
+
+error:
+    closedir(dir);
+    lyp_sdir_clean(sdir);
+    return -1;
+}
+
+/**
+ * @brief Get the index of a search directory from the context, create it (empty) if not yet present.
+ * Called with ly_ctx#cache_lock held.
+ *
+ * @param[in] ctx Context with the search directory indexes.
+ * @param[in] path Search directory path.
+ * @return Directory index, NULL on memory allocation error.
+ */
+static struct lyp_sdir *
+lyp_sdir_get(struct ly_ctx *ctx, const char *path)
+{
+    struct lyp_sdir *sdir;
+    char *dup;
+
+    for (sdir = ctx->models.search_index; sdir && strcmp(sdir->path, path); sdir = sdir->next);
+    if (!sdir) {
+        dup = strdup(path);
+        LY_CHECK_ERR_RETURN(!dup, LOGMEM, NULL);
+        sdir = lyp_sdir_new(dup);
+        if (!sdir) {
+            return NULL;
+        }
+        sdir->next = ctx->models.search_index;
+        ctx->models.search_index = sdir;
+    }
+
+    return sdir;
+}
+
+void
+lyp_sdir_remove(struct ly_ctx *ctx, const char *path)
+{
+    struct lyp_sdir **iter, *sdir;
+
+    for (iter = &ctx->models.search_index; *iter; ) {
+        if (!path || !strcmp((*iter)->path, path)) {
+            sdir = *iter;
+            *iter = sdir->next;
+            lyp_sdir_free(sdir);
+        } else {
+            iter = &(*iter)->next;
+        }
+    }
+}
+
+static char *
+lyp_sfile_path(const struct lyp_sdir *sdir, const char *name)
+{
+    char *path;
+
+    if (asprintf(&path, "%s/%s", sdir->path, name) == -1) {
+        LOGMEM;
+        return NULL;
+    }
+    return path;
+}
+
+/* find the newest (or the specific revision) file of the (sub)module in the search paths,
+ * returns 0 and the path with its format (path is NULL if not found), -1 on error */
+static int
+lyp_search_path(struct ly_ctx *ctx, const char *name, const char *revision, char **path,
+                LYS_INFORMAT *path_format)
+{
+    size_t len, match_len = 0;
+    int i, rc, ret = -1, implicit_cwd = 0;
+    char *wd, *match_name = NULL;
+    const char *fname;
     LYS_INFORMAT format, match_format = 0;
-    struct lys_module *result = NULL;
-    unsigned int u;
+    uint32_t u;
     struct ly_set *dirs;
-    struct stat st;
+    struct lyp_sdir *sdir;
 
     /* start to fill the dir fifo with the context's search path (if set)
      * and the current working directory */
     dirs = ly_set_new();
     if (!dirs) {
         LOGMEM;
-        return NULL;
+        return -1;
     }
 
+    /* the indexes are shared by all the threads searching in the context, the ones in dirs must not be changed
+     * by anyone else until the search is finished */
+    pthread_mutex_lock(&ctx->cache_lock);
+
     len = strlen(name);
     wd = get_current_dir_name();
     if (!wd) {
@@ -439,7 +894,9 @@ lyp_search_file(struct ly_ctx *ctx, struct lys_module *module, const char *name,
     } else {
         /* add implicit current working directory (./) to be searched,
          * this directory is not searched recursively */
-        if (ly_set_add(dirs, wd, 0) == -1) {
+        sdir = lyp_sdir_get(ctx, wd);
+        free(wd);
+        if (!sdir || (ly_set_add(dirs, sdir, LY_SET_OPT_USEASLIST) == -1)) {
             goto cleanup;
         }
         implicit_cwd = 1;
@@ -447,145 +904,141 @@ lyp_search_file(struct ly_ctx *ctx, struct lys_module *module, const char *name,
     if (ctx->models.search_paths) {
         for (i = 0; ctx->models.search_paths[i]; i++) {
             /* check for duplicities with the implicit current working directory */
-            if (implicit_cwd && !strcmp(dirs->set.g[0], ctx->models.search_paths[i])) {
+            if (implicit_cwd && !strcmp(((struct lyp_sdir *)dirs->set.g[0])->path, ctx->models.search_paths[i])) {
                 implicit_cwd = 0;
                 continue;
             }
-            wd = strdup(ctx->models.search_paths[i]);
-            if (!wd) {
-                LOGMEM;
-                goto cleanup;
-            } else if (ly_set_add(dirs, wd, 0) == -1) {
+            sdir = lyp_sdir_get(ctx, ctx->models.search_paths[i]);
+            if (!sdir || (ly_set_add(dirs, sdir, LY_SET_OPT_USEASLIST) == -1)) {
                 goto cleanup;
             }
         }
     }
-    wd = NULL;
 
     /* start searching */
     while (dirs->number) {
-        free(wd);
-        free(wn); wn = NULL;
-
         dirs->number--;
-        wd = (char *)dirs->set.g[dirs->number];
+        sdir = (struct lyp_sdir *)dirs->set.g[dirs->number];
         dirs->set.g[dirs->number] = NULL;
-        LOGVRB("Searching for \"%s\" in %s.", name, wd);
+        LOGVRB("Searching for \"%s\" in %s.", name, sdir->path);
 
-        if (dir) {
-            closedir(dir);
+        rc = lyp_sdir_update(sdir);
+        if (rc == -1) {
+            goto cleanup;
+        } else if (rc) {
+            continue;
         }
-        dir = opendir(wd);
-        dir_len = strlen(wd);
-        if (!dir) {
-            LOGWRN("Unable to open directory \"%s\" for searching (sub)modules (%s).", wd, strerror(errno));
-        } else {
-            while ((file = readdir(dir))) {
-                if (!strcmp(".", file->d_name) || !strcmp("..", file->d_name)) {
-                    /* skip . and .. */
-                    continue;
-                }
-                free(wn);
-                if (asprintf(&wn, "%s/%s", wd, file->d_name) == -1) {
-                    LOGMEM;
-                    goto cleanup;
-                }
-                if (stat(wn, &st) == -1) {
-                    LOGWRN("Unable to get information about \"%s\" file in \"%s\" when searching for (sub)modules (%s)",
-                           file->d_name, wd, strerror(errno));
-                    continue;
-                }
-                if (S_ISDIR(st.st_mode) && (dirs->number || !implicit_cwd)) {
-                    /* we have another subdirectory in searchpath to explore,
-                     * subdirectories are not taken into account in current working dir (dirs->set.g[0]) */
-                    if (ly_set_add(dirs, wn, 0) == -1) {
-                        goto cleanup;
-                    }
-                    /* continue with the next item in current directory */
-                    wn = NULL;
-                    continue;
-                } else if (!S_ISREG(st.st_mode)) {
-                    /* not a regular file (note that we see the target of symlinks instead of symlinks */
-                    continue;
-                }
-
-                /* here we know that the item is a file which can contain a module */
-                if (strncmp(name, file->d_name, len) ||
-                        (file->d_name[len] != '.' && file->d_name[len] != '@')) {
-                    /* different filename than the module we search for */
-                    continue;
-                }
 
-                /* get type according to filename suffix */
-                flen = strlen(file->d_name);
-                if (!strcmp(&file->d_name[flen - 4], ".yin")) {
-                    format = LYS_IN_YIN;
-                } else if (!strcmp(&file->d_name[flen - 5], ".yang")) {
-                    format = LYS_IN_YANG;
-                } else {
-                    /* not supportde suffix/file format */
-                    continue;
+        if (dirs->number || !implicit_cwd) {
+            /* we have other subdirectories in searchpath to explore,
+             * subdirectories are not taken into account in current working dir (dirs->set.g[0]) */
+            for (u = 0; u < sdir->subdir_count; u++) {
+                if (ly_set_add(dirs, sdir->subdirs[u], LY_SET_OPT_USEASLIST) == -1) {
+                    goto cleanup;
                 }
+            }
+        }
 
-                if (revision) {
-                    /* we look for the specific revision, try to get it from the filename */
-                    if (file->d_name[len] == '@') {
-                        /* check revision from the filename */
-                        if (strncmp(revision, &file->d_name[len + 1], strlen(revision))) {
-                            /* another revision */
-                            continue;
-                        } else {
-                            /* exact revision */
-                            free(match_name);
-                            match_name = wn;
-                            wn = NULL;
-                            match_len = dir_len + 1 + len;
-                            match_format = format;
-                            goto matched;
-                        }
+        for (u = sdir->hash[lyp_sfile_hash(name, len) & sdir->hash_mask]; u; u = sdir->files[u - 1].next) {
+            fname = sdir->files[u - 1].name;
+            if ((sdir->files[u - 1].mod_len != len) || strncmp(name, fname, len)) {
+                /* different filename than the module we search for */
+                continue;
+            }
+            format = sdir->files[u - 1].format;
+
+            if (revision) {
+                /* we look for the specific revision, try to get it from the filename */
+                if (fname[len] == '@') {
+                    /* check revision from the filename */
+                    if (strncmp(revision, &fname[len + 1], strlen(revision))) {
+                        /* another revision */
+                        continue;
                     } else {
-                        /* continue trying to find exact revision match, use this only if not found */
+                        /* exact revision */
                         free(match_name);
-                        match_name = wn;
-                        wn = NULL;
-                        match_len = dir_len + 1 +len;
+                        match_name = lyp_sfile_path(sdir, fname);
+                        if (!match_name) {
+                            goto cleanup;
+                        }
+                        match_len = strlen(sdir->path) + 1 + len;
                         match_format = format;
-                        continue;
+                        goto matched;
                     }
                 } else {
-                    /* remember the revision and try to find the newest one */
-                    if (match_name) {
-                        if (file->d_name[len] != '@' || lyp_check_date(&file->d_name[len + 1])) {
-                            continue;
-                        } else if (match_name[match_len] == '@' &&
-                                (strncmp(&match_name[match_len + 1], &file->d_name[len + 1], LY_REV_SIZE - 1) >= 0)) {
-                            continue;
-                        }
-                        free(match_name);
+                    /* continue trying to find exact revision match, use this only if not found */
+                    free(match_name);
+                    match_name = lyp_sfile_path(sdir, fname);
+                    if (!match_name) {
+                        goto cleanup;
                     }
-
-                    match_name = wn;
-                    wn = NULL;
-                    match_len = dir_len + 1 + len;
+                    match_len = strlen(sdir->path) + 1 + len;
                     match_format = format;
                     continue;
                 }
+            } else {
+                /* remember the revision and try to find the newest one */
+                if (match_name) {
+                    if (fname[len] != '@' || lyp_check_date(&fname[len + 1])) {
+                        continue;
+                    } else if (match_name[match_len] == '@' &&
+                            (strncmp(&match_name[match_len + 1], &fname[len + 1], LY_REV_SIZE - 1) >= 0)) {
+                        continue;
+                    }
+                    free(match_name);
+                }
+
+                match_name = lyp_sfile_path(sdir, fname);
+                if (!match_name) {
+                    goto cleanup;
+                }
+                match_len = strlen(sdir->path) + 1 + len;
+                match_format = format;
+                continue;
             }
         }
     }
 
-    if (!match_name) {
-        if (!module && !revision) {
-            /* otherwise the module would be already taken from the context */
-            result = (struct lys_module *)ly_ctx_get_module(ctx, name, NULL, 0);
-        }
-        if (!result) {
-            LOGERR(LY_ESYS, "Data model \"%s\" not found.", name);
-        }
-        goto cleanup;
+matched:
+    *path = match_name;
+    *path_format = match_format;
+    match_name = NULL;
+    ret = 0;
+
+cleanup:
+    pthread_mutex_unlock(&ctx->cache_lock);
+    free(match_name);
+    ly_set_free(dirs);
+    return ret;
+}
+
+/* if module is !NULL, then the function searches for submodule */
+struct lys_module *
+lyp_search_file(struct ly_ctx *ctx, struct lys_module *module, const char *name, const char *revision,
+                int implement, struct unres_schema *unres)
+{
+    size_t len;
+    int fd, i;
+    char *match_name = NULL, *dot, *rev, *filename;
+    LYS_INFORMAT match_format = 0;
+    struct lys_module *result = NULL;
+    struct lyp_preparsed *pre;
+
+    if (lyp_search_path(ctx, name, revision, &match_name, &match_format)) {
+        return NULL;
+    }
+
+    if (!match_name) {
+        if (!module && !revision) {
+            /* otherwise the module would be already taken from the context */
+            result = (struct lys_module *)ly_ctx_get_module(ctx, name, NULL, 0);
+        }
+        if (!result) {
+            LOGERR(LY_ESYS, "Data model \"%s\" not found.", name);
+        }
+        goto cleanup;
     }
 
-matched:
     LOGVRB("Loading schema from \"%s\" file.", match_name);
 
     /* cut the format for now */
@@ -616,20 +1069,25 @@ matched:
     /* add the format back */
     dot[1] = 'y';
 
-    /* open the file */
-    fd = open(match_name, O_RDONLY);
-    if (fd < 0) {
-        LOGERR(LY_ESYS, "Unable to open data model file \"%s\" (%s).",
-               match_name, strerror(errno));
-        goto cleanup;
-    }
-
-    if (module) {
-        result = (struct lys_module *)lys_sub_parse_fd(module, fd, match_format, unres);
+    if (!module && (pre = lyp_preparsed_get(ctx, match_name))) {
+        /* the module was already parsed by ly_ctx_load_modules() */
+        result = lys_parse_preparsed(ctx, pre, revision, implement);
     } else {
-        result = (struct lys_module *)lys_parse_fd_(ctx, fd, match_format, revision, implement);
+        /* open the file */
+        fd = open(match_name, O_RDONLY);
+        if (fd < 0) {
+            LOGERR(LY_ESYS, "Unable to open data model file \"%s\" (%s).",
+                   match_name, strerror(errno));
+            goto cleanup;
+        }
+
+        if (module) {
+            result = (struct lys_module *)lys_sub_parse_fd(module, fd, match_format, unres);
+        } else {
+            result = (struct lys_module *)lys_parse_fd_(ctx, fd, match_format, revision, implement);
+        }
+        close(fd);
     }
-    close(fd);
 
     if (!result) {
         goto cleanup;
@@ -662,20 +1120,284 @@ matched:
     /* success */
 
 cleanup:
-    free(wn);
-    free(wd);
-    if (dir) {
-        closedir(dir);
-    }
     free(match_name);
-    for (u = 0; u < dirs->number; u++) {
-        free(dirs->set.g[u]);
-    }
-    ly_set_free(dirs);
 
     return result;
 }
 
+struct lyp_preparse_job {
+    struct ly_ctx *ctx;
+    pthread_mutex_t lock;       /* protects the members below */
+    pthread_cond_t cond;        /* signaled when a module is added or the last parsing thread finishes */
+    struct lyp_preparsed **pre;
+    unsigned int count;
+    unsigned int size;
+    unsigned int next;          /* index of the next module to parse */
+    unsigned int active;        /* number of the threads parsing a module (whose imports may be added) */
+};
+
+/* add the file to be parsed if it is not there yet, the path is consumed, the job must be locked */
+static int
+lyp_preparse_add(struct lyp_preparse_job *job, char *path, LYS_INFORMAT format)
+{
+    struct lyp_preparsed **pre;
+    unsigned int u;
+
+    for (u = 0; u < job->count; u++) {
+        if (!strcmp(job->pre[u]->path, path)) {
+            free(path);
+            return EXIT_SUCCESS;
+        }
+    }
+
+    if (job->count == job->size) {
+        pre = realloc(job->pre, (job->size ? job->size * 2 : 16) * sizeof *pre);
+        LY_CHECK_ERR_RETURN(!pre, LOGMEM; free(path), EXIT_FAILURE);
+        job->pre = pre;
+        job->size = job->size ? job->size * 2 : 16;
+    }
+    job->pre[job->count] = calloc(1, sizeof **job->pre);
+    LY_CHECK_ERR_RETURN(!job->pre[job->count], LOGMEM; free(path), EXIT_FAILURE);
+    job->pre[job->count]->path = path;
+    job->pre[job->count]->format = format;
+    job->count++;
+
+    return EXIT_SUCCESS;
+}
+
+/* find the file of the module (if it is not in the context) and add it to be parsed, the job must not be locked */
+static int
+lyp_preparse_add_module(struct lyp_preparse_job *job, const char *name, const char *revision)
+{
+    char *path = NULL;
+    LYS_INFORMAT format;
+    int ret;
+
+    if (ly_ctx_get_module(job->ctx, name, revision, 0)) {
+        /* nothing to parse */
+        return EXIT_SUCCESS;
+    }
+    if (lyp_search_path(job->ctx, name, revision, &path, &format)) {
+        return EXIT_FAILURE;
+    }
+    if (!path) {
+        /* reported when the module is loaded */
+        return EXIT_SUCCESS;
+    }
+
+    pthread_mutex_lock(&job->lock);
+    ret = lyp_preparse_add(job, path, format);
+    pthread_mutex_unlock(&job->lock);
+
+    return ret;
+}
+
+/* add the modules imported by the parsed module to be parsed too */
+static void
+lyp_preparse_add_imports(struct lyp_preparse_job *job, struct lyp_preparsed *pre)
+{
+    struct lyxml_elem *child, *sub;
+    const char *name, *rev;
+    uint8_t u;
+
+    if (pre->module) {
+        /* the imports are stubs with just the names */
+        for (u = 0; u < pre->module->imp_size; u++) {
+            lyp_preparse_add_module(job, pre->module->imp[u].module->name,
+                                    pre->module->imp[u].rev[0] ? pre->module->imp[u].rev : NULL);
+        }
+    } else if (pre->yin && !strcmp(pre->yin->name, "module")) {
+        LY_TREE_FOR(pre->yin->child, child) {
+            if (!child->ns || strcmp(child->ns->value, LY_NSYIN) || strcmp(child->name, "import")
+                    || !(name = lyxml_get_attr(child, "module", NULL))) {
+                continue;
+            }
+            rev = NULL;
+            LY_TREE_FOR(child->child, sub) {
+                if (sub->ns && !strcmp(sub->ns->value, LY_NSYIN) && !strcmp(sub->name, "revision-date")) {
+                    rev = lyxml_get_attr(sub, "date", NULL);
+                }
+            }
+            lyp_preparse_add_module(job, name, rev);
+        }
+    }
+}
+
+/* parse the modules of the job until there are none left, only the dictionary is shared with the other threads
+ * (with the references batched), a module failing to parse is left to be parsed again by lyp_search_file()
+ * to log the errors */
+static void *
+lyp_preparse_thread(void *arg)
+{
+    struct lyp_preparse_job *job = arg;
+    struct lyp_preparsed *pre;
+    struct ly_ctx *ctx_prev = ly_parser_data.ctx;
+    uint8_t hide = ly_vlog_hidden;
+    size_t length;
+    char *addr;
+    int fd, batch;
+
+    ly_parser_data.ctx = job->ctx;
+    ly_vlog_hide(1);
+    /* without the batch, the dictionary is just locked for every string */
+    batch = !lydict_batch_start(job->ctx);
+
+    pthread_mutex_lock(&job->lock);
+    while ((job->next < job->count) || job->active) {
+        if (job->next == job->count) {
+            /* the modules being parsed may import some more */
+            pthread_cond_wait(&job->cond, &job->lock);
+            continue;
+        }
+        pre = job->pre[job->next++];
+        job->active++;
+        pthread_mutex_unlock(&job->lock);
+
+        fd = open(pre->path, O_RDONLY);
+        addr = NULL;
+        if (fd >= 0) {
+            addr = lyp_mmap(fd, pre->format == LYS_IN_YANG ? 1 : 0, &length);
+            close(fd);
+        }
+        if (addr && (addr != MAP_FAILED)) {
+            if (pre->format == LYS_IN_YANG) {
+                yang_parse_module_only(job->ctx, addr, &pre->module, &pre->unres, &pre->node);
+            } else {
+                pre->yin = lyxml_parse_mem(job->ctx, addr, LYXML_PARSE_NOMIXEDCONTENT);
+            }
+            lyp_munmap(addr, length);
+            lyp_preparse_add_imports(job, pre);
+        }
+
+        pthread_mutex_lock(&job->lock);
+        job->active--;
+        pthread_cond_broadcast(&job->cond);
+    }
+    pthread_mutex_unlock(&job->lock);
+
+    if (batch) {
+        lydict_batch_end();
+    }
+    ly_err_clean(job->ctx, 1);
+    ly_vlog_hide(hide);
+    ly_parser_data.ctx = ctx_prev;
+    return NULL;
+}
+
+int
+lyp_preparse_modules(struct ly_ctx *ctx, const char **names, const char **revisions, unsigned int count,
+                     unsigned int threads)
+{
+    struct lyp_preparse_job job;
+    pthread_t *tids;
+    const char *rev;
+    unsigned int u, started;
+    int ret = EXIT_SUCCESS;
+
+    assert(!ctx->models.preparsed);
+
+    memset(&job, 0, sizeof job);
+    job.ctx = ctx;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.cond, NULL);
+
+    /* the search directories are indexed on demand, so find the files first */
+    for (u = 0; u < count; u++) {
+        rev = (revisions && revisions[u] && revisions[u][0]) ? revisions[u] : NULL;
+        if (lyp_preparse_add_module(&job, names[u], rev)) {
+            ret = EXIT_FAILURE;
+            goto cleanup;
+        }
+    }
+
+    /* the current thread is one of the parsing threads */
+    tids = malloc(threads * sizeof *tids);
+    LY_CHECK_ERR_GOTO(!tids, LOGMEM; ret = EXIT_FAILURE, cleanup);
+    for (started = 0; started < threads - 1; started++) {
+        if (pthread_create(&tids[started], NULL, lyp_preparse_thread, &job)) {
+            /* the running threads parse all the modules anyway */
+            break;
+        }
+    }
+    lyp_preparse_thread(&job);
+    for (u = 0; u < started; u++) {
+        pthread_join(tids[u], NULL);
+    }
+    free(tids);
+
+cleanup:
+    ctx->models.preparsed = job.pre;
+    ctx->models.preparsed_count = job.count;
+    if (ret) {
+        lyp_preparsed_free(ctx);
+    }
+    pthread_cond_destroy(&job.cond);
+    pthread_mutex_destroy(&job.lock);
+    return ret;
+}
+
+struct lyp_preparsed *
+lyp_preparsed_get(struct ly_ctx *ctx, const char *path)
+{
+    unsigned int u;
+
+    for (u = 0; u < ctx->models.preparsed_count; u++) {
+        if ((ctx->models.preparsed[u]->module || ctx->models.preparsed[u]->yin)
+                && !strcmp(ctx->models.preparsed[u]->path, path)) {
+            return ctx->models.preparsed[u];
+        }
+    }
+
+    return NULL;
+}
+
+void
+lyp_preparsed_free(struct ly_ctx *ctx)
+{
+    struct lyp_preparsed *pre;
+    unsigned int u;
+
+    for (u = 0; u < ctx->models.preparsed_count; u++) {
+        pre = ctx->models.preparsed[u];
+        if (pre->module) {
+            yang_free_module_parsed(pre->module, pre->unres, pre->node);
+        }
+        lyxml_free(ctx, pre->yin);
+        free(pre->path);
+        free(pre);
+    }
+    free(ctx->models.preparsed);
+    ctx->models.preparsed = NULL;
+    ctx->models.preparsed_count = 0;
+}
+
+/* does not log, fast path for the plain decimal numbers (without sign and whitespaces), returns 1 and the number
+ * in ret, 0 if the string is not such a number or it does not fit into 64 bits (then strtoll() and friends are used) */
+static int
+parse_dec_digits(const char *str, uint64_t *ret)
+{
+    uint64_t u = 0;
+    unsigned int d;
+
+    if (!isdigit(str[0])) {
+        return 0;
+    }
+
+    for (; isdigit(str[0]); ++str) {
+        d = str[0] - '0';
+        if (u > (UINT64_MAX - d) / 10) {
+            return 0;
+        }
+        u = u * 10 + d;
+    }
+    if (str[0]) {
+        return 0;
+    }
+
+    *ret = u;
+    return 1;
+}
+
 /* logs directly
  * base: 0  - to accept decimal, octal, hexadecimal (in default value)
  *       10 - to accept only decimal (instance value)
@@ -684,15 +1406,29 @@ static int
 parse_int(const char *val_str, int64_t min, int64_t max, int base, int64_t *ret, struct lyd_node *node)
 {
     char *strptr;
+    uint64_t u;
 
     if (!val_str || !val_str[0]) {
-        if (node) {
-            LOGVAL(LYE_INVAL, LY_VLOG_LYD, node, "", node->schema->name);
+        goto error;
+    }
+
+    if ((base == 10) && parse_dec_digits((val_str[0] == '-') ? &val_str[1] : val_str, &u)) {
+        /* plain decimal number */
+        if (val_str[0] == '-') {
+            if (u > (uint64_t)INT64_MAX + 1) {
+                goto error;
+            }
+            *ret = (u == (uint64_t)INT64_MAX + 1) ? INT64_MIN : -(int64_t)u;
         } else {
-            ly_errno = LY_EVALID;
-            ly_vecode = LYVE_INVAL;
+            if (u > INT64_MAX) {
+                goto error;
+            }
+            *ret = u;
         }
-        return EXIT_FAILURE;
+        if ((*ret < min) || (*ret > max)) {
+            goto error;
+        }
+        return EXIT_SUCCESS;
     }
 
     /* convert to 64-bit integer, all the redundant characters are handled */
@@ -702,24 +1438,446 @@ parse_int(const char *val_str, int64_t min, int64_t max, int base, int64_t *ret,
     /* parse the value */
     *ret = strtoll(val_str, &strptr, base);
     if (errno || (*ret < min) || (*ret > max)) {
-        if (node) {
-            LOGVAL(LYE_INVAL, LY_VLOG_LYD, node, val_str, node->schema->name);
-        } else {
-            ly_errno = LY_EVALID;
-            ly_vecode = LYVE_INVAL;
+        goto error;
+    } else if (strptr && *strptr) {
+        while (isspace(*strptr)) {
+            ++strptr;
         }
-        return EXIT_FAILURE;
+        if (*strptr) {
+            goto error;
+        }
+    }
+
+    return EXIT_SUCCESS;
+
+error:
+    if (node) {
+        LOGVAL(LYE_INVAL, LY_VLOG_LYD, node, val_str ? val_str : "", node->schema->name);
+    } else {
+        ly_errno = LY_EVALID;
+        ly_vecode = LYVE_INVAL;
+    }
+    return EXIT_FAILURE;
+}
+
+/* logs directly
+ * base: 0  - to accept decimal, octal, hexadecimal (in default value)
+ *       10 - to accept only decimal (instance value)
+ */
+static int
+parse_uint(const char *val_str, uint64_t max, int base, uint64_t *ret, struct lyd_node *node)
+{
+    char *strptr;
+    uint64_t u;
+
+    if (!val_str || !val_str[0]) {
+        goto error;
+    }
+
+    if ((base == 10) && parse_dec_digits(val_str, &u)) {
+        /* plain decimal number */
+        if (u > max) {
+            goto error;
+        }
+        *ret = u;
+        return EXIT_SUCCESS;
+    }
+
+    errno = 0;
+    strptr = NULL;
+    u = strtoull(val_str, &strptr, base);
+    if (errno || (u > max)) {
+        goto error;
     } else if (strptr && *strptr) {
         while (isspace(*strptr)) {
             ++strptr;
         }
         if (*strptr) {
-            if (node) {
-                LOGVAL(LYE_INVAL, LY_VLOG_LYD, node, val_str, node->schema->name);
-            } else {
-                ly_errno = LY_EVALID;
-                ly_vecode = LYVE_INVAL;
+            goto error;
+        }
+    } else if (u != 0 && val_str[0] == '-') {
+        goto error;
+    }
+
+    *ret = u;
+    return EXIT_SUCCESS;
+
+error:
+    if (node) {
+        LOGVAL(LYE_INVAL, LY_VLOG_LYD, node, val_str ? val_str : "", node->schema->name);
+    } else {
+        ly_errno = LY_EVALID;
+        ly_vecode = LYVE_INVAL;
+    }
+    return EXIT_FAILURE;
+}
+
+static struct lys_restr *
+len_ran_restr(struct lys_type *type)
+{
+    switch (type->base) {
+    case LY_TYPE_BINARY:
+        return type->info.binary.length;
+    case LY_TYPE_DEC64:
+        return type->info.dec64.range;
+    case LY_TYPE_INT8:
+    case LY_TYPE_INT16:
+    case LY_TYPE_INT32:
+    case LY_TYPE_INT64:
+    case LY_TYPE_UINT8:
+    case LY_TYPE_UINT16:
+    case LY_TYPE_UINT32:
+    case LY_TYPE_UINT64:
+        return type->info.num.range;
+    case LY_TYPE_STRING:
+        return type->info.str.length;
+    default:
+        return NULL;
+    }
+}
+
+/* compile the intervals of a single restriction, the intervals of the superior restrictions are skipped */
+static struct len_ran_bounds *
+len_ran_compile(struct len_ran_intv *intv, struct lys_type *type)
+{
+    struct len_ran_intv *iter;
+    struct len_ran_bounds *ret;
+    uint32_t count = 0;
+
+    for (iter = intv; iter && (iter->type == type); iter = iter->next) {
+        ++count;
+    }
+    ret = malloc(sizeof *ret + 2 * count * sizeof *ret->bound);
+    LY_CHECK_ERR_RETURN(!ret, LOGMEM, NULL);
+    ret->count = count;
+    ret->kind = intv->kind;
+    ret->fdig = (type->base == LY_TYPE_DEC64) ? type->info.dec64.dig : 0;
+
+    count = 0;
+    for (iter = intv; iter && (iter->type == type); iter = iter->next) {
+        if (ret->kind == 0) {
+            ret->bound[count++].uval = iter->value.uval.min;
+            ret->bound[count++].uval = iter->value.uval.max;
+        } else if (ret->kind == 1) {
+            ret->bound[count++].sval = iter->value.sval.min;
+            ret->bound[count++].sval = iter->value.sval.max;
+        } else {
+            ret->bound[count++].fval = iter->value.fval.min;
+            ret->bound[count++].fval = iter->value.fval.max;
+        }
+    }
+
+    return ret;
+}
+
+/* compare the value with the i-th bound */
+static int
+len_ran_cmp(struct len_ran_bounds *bounds, uint32_t i, uint64_t unum, int64_t snum, int64_t fnum, uint8_t fnum_dig)
+{
+    if (bounds->kind == 0) {
+        return (unum > bounds->bound[i].uval) - (unum < bounds->bound[i].uval);
+    } else if (bounds->kind == 1) {
+        return (snum > bounds->bound[i].sval) - (snum < bounds->bound[i].sval);
+    } else if (fnum_dig != bounds->fdig) {
+        return dec64cmp(fnum, fnum_dig, bounds->bound[i].fval, bounds->fdig);
+    }
+    return (fnum > bounds->bound[i].fval) - (fnum < bounds->bound[i].fval);
+}
+
+/* binary search for the interval with the value */
+static int
+len_ran_match(struct len_ran_bounds *bounds, uint64_t unum, int64_t snum, int64_t fnum, uint8_t fnum_dig)
+{
+    uint32_t lo = 0, hi = bounds->count, mid;
+
+    /* find the first interval starting above the value */
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (len_ran_cmp(bounds, 2 * mid, unum, snum, fnum, fnum_dig) < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    /* so only the previous one can include it */
+    return lo && (len_ran_cmp(bounds, 2 * (lo - 1) + 1, unum, snum, fnum, fnum_dig) <= 0);
+}
+
+/* hash table of the enum or bit names of a type, there is index + 1 of the first item
+ * of a chain in head and index + 1 of the following item in the chain in next */
+struct lyp_names_hash {
+    uint32_t mask;
+    uint32_t *next;
+    uint32_t head[];
+};
+
+static const char *
+lyp_type_item_name(struct lys_type *type, unsigned int idx)
+{
+    return (type->base == LY_TYPE_ENUM) ? type->info.enums.enm[idx].name : type->info.bits.bit[idx].name;
+}
+
+static unsigned int
+lyp_type_item_count(struct lys_type *type)
+{
+    return (type->base == LY_TYPE_ENUM) ? type->info.enums.count : type->info.bits.count;
+}
+
+/* build the hash table of the enum or bit names of the type with their definitions */
+static struct lyp_names_hash *
+lyp_names_hash_build(struct lys_type *type)
+{
+    struct lyp_names_hash *table;
+    const char *item;
+    unsigned int count;
+    uint32_t size, u, h;
+
+    count = lyp_type_item_count(type);
+    for (size = 1; size < 2 * count; size <<= 1);
+    table = calloc(1, sizeof *table + (size + count) * sizeof *table->head);
+    LY_CHECK_ERR_RETURN(!table, LOGMEM, NULL);
+    table->mask = size - 1;
+    table->next = &table->head[size];
+    for (u = count; u; u--) {
+        item = lyp_type_item_name(type, u - 1);
+        h = dict_hash_multi(dict_hash_multi(0, item, strlen(item)), NULL, 0) & table->mask;
+        table->next[u - 1] = table->head[h];
+        table->head[h] = u;
+    }
+
+    return table;
+}
+
+/* Get the index of the enum or bit with the name in the type with their definitions, the item at the index
+ * still has to be compared with the name and if it does not match, the following items are to be checked.
+ * If there is no such item, the number of the items is returned. */
+static unsigned int
+lyp_type_item_find(struct lys_type *type, const struct lyp_names_hash *table, const char *name, size_t len)
+{
+    const char *item;
+    uint32_t u, h;
+
+    h = dict_hash_multi(dict_hash_multi(0, name, len), NULL, 0) & table->mask;
+    for (u = table->head[h]; u; u = table->next[u - 1]) {
+        item = lyp_type_item_name(type, u - 1);
+        if (!strncmp(item, name, len) && !item[len]) {
+            return u - 1;
+        }
+    }
+    return lyp_type_item_count(type);
+}
+
+/* classes of the values of the union member types, see ::lyp_type_plan#members */
+#define LYP_UNI_ANY   0              /* anything, the value must be fully parsed/resolved (patterns, leafrefs, ...) */
+#define LYP_UNI_INT   1              /* integer, optionally preceded by whitespaces */
+#define LYP_UNI_DEC64 2              /* decimal number */
+#define LYP_UNI_BOOL  3              /* "true" or "false" */
+#define LYP_UNI_EMPTY 4              /* empty value */
+#define LYP_UNI_ENUM  5              /* one of the enum names */
+
+/* member type of a union */
+struct lyp_union_member {
+    struct lys_type *type;
+    struct lys_type *items;          /* type with the enum definitions for LYP_UNI_ENUM */
+    const struct lyp_names_hash *names; /* hash table of the enum names of items */
+    uint8_t class;
+};
+
+/* all the member types of a union in the order they are tried */
+struct lyp_union_members {
+    uint32_t count;
+    struct lyp_union_member member[];
+};
+
+/**
+ * @brief Change the value into its canonical form. In libyang, additionally to the RFC,
+ * all identities have their module as a prefix in their canonical form. There is a canonicalizer
+ * for each base type with a canonical form different from the lexical one, the plan of a type refers
+ * to the one of its base type.
+ *
+ * @param[in] ctx Context of the value.
+ * @param[in,out] value Original and then canonical value.
+ * @param[in] data1 #LY_TYPE_BITS: (struct lys_type_bit **) type bit field,
+ *                  #LY_TYPE_DEC64: (int64_t *) parsed digits of the number itself without floating point,
+ *                  #LY_TYPE_IDENT: (const char *) local module name (identityref node module),
+ *                  #LY_TYPE_INT*: (int64_t *) parsed int number itself,
+ *                  #LY_TYPE_UINT*: (uint64_t *) parsed uint number itself.
+ * @param[in] data2 #LY_TYPE_BITS: (unsigned int *) type bit field length,
+ *                  #LY_TYPE_DEC64: (uint8_t *) number of fraction digits (position of the floating point),
+ *                  otherwise ignored.
+ * @return 1 if a conversion took place, 0 if the value was kept the same.
+ */
+typedef int (*lyp_canon_clb)(struct ly_ctx *ctx, const char **value, void *data1, void *data2);
+
+/* flattened validation information of a type and all its superior typedefs, stored in ::ly_ctx#type_plans,
+ * the typedefs are referenced instead of their types so that the plan can be moved with the type */
+struct lyp_type_plan {
+    lyp_canon_clb canon;             /* canonicalizer of the values of the base type, NULL if there is none */
+    struct lys_tpdf *items_tpdf;     /* typedef with the enum/bit definitions, NULL for the type itself */
+    struct lyp_names_hash *names;    /* hash table of the enum/bit names of the type with the definitions */
+    struct lyp_union_members *members; /* all the member types of a union (including the ones of the nested unions)
+                                        with the classes of their values to skip the types a value cannot be of */
+    uint8_t own_names;               /* names were built for this type, otherwise they belong to the items_tpdf plan */
+    uint8_t own_members;             /* members were built for this type, otherwise they belong to a typedef plan */
+    uint8_t xpath;                   /* derived from ietf-yang-types:xpath1.0 */
+    uint32_t intv_count;             /* number of the length/range restrictions in intv */
+    struct {
+        struct lys_tpdf *tpdf;       /* typedef with the restriction, NULL for the type itself */
+        struct len_ran_bounds *bounds;
+    } *intv;                         /* compiled length/range restrictions, the least derived one first, each
+                                        one is a subset of the previous one */
+    uint32_t pat_count;              /* number of patterns in pat */
+    struct {
+        pcre *comp;                  /* compiled pattern, NULL if the patterns are not precompiled */
+        pcre_extra *extra;
+        struct lys_restr *restr;
+    } pat[];                         /* patterns of all the typedefs, the ones of the built-in type first */
+};
+
+static int make_canonical_bits(struct ly_ctx *ctx, const char **value, void *data1, void *data2);
+static int make_canonical_ident(struct ly_ctx *ctx, const char **value, void *data1, void *data2);
+static int make_canonical_dec64(struct ly_ctx *ctx, const char **value, void *data1, void *data2);
+static int make_canonical_int(struct ly_ctx *ctx, const char **value, void *data1, void *data2);
+static int make_canonical_uint(struct ly_ctx *ctx, const char **value, void *data1, void *data2);
+
+/* get the plan of a prepared type, does not log */
+static struct lyp_type_plan *
+lyp_type_plan(struct lys_type *type)
+{
+    return ly_ptr_map_get(&type->parent->module->ctx->type_plans, type);
+}
+
+static void
+lyp_union_member_init(struct lyp_union_member *member, struct lys_type *type)
+{
+    struct lyp_type_plan *plan;
+
+    member->type = type;
+    member->items = NULL;
+    member->names = NULL;
+
+    switch (type->base) {
+    case LY_TYPE_INT8:
+    case LY_TYPE_INT16:
+    case LY_TYPE_INT32:
+    case LY_TYPE_INT64:
+    case LY_TYPE_UINT8:
+    case LY_TYPE_UINT16:
+    case LY_TYPE_UINT32:
+    case LY_TYPE_UINT64:
+        member->class = LYP_UNI_INT;
+        break;
+    case LY_TYPE_DEC64:
+        member->class = LYP_UNI_DEC64;
+        break;
+    case LY_TYPE_BOOL:
+        member->class = LYP_UNI_BOOL;
+        break;
+    case LY_TYPE_EMPTY:
+        member->class = LYP_UNI_EMPTY;
+        break;
+    case LY_TYPE_ENUM:
+        /* the member types are prepared before the union */
+        plan = lyp_type_plan(type);
+        member->items = plan->items_tpdf ? &plan->items_tpdf->type : type;
+        member->names = plan->names;
+        member->class = LYP_UNI_ENUM;
+        break;
+    default:
+        member->class = LYP_UNI_ANY;
+        break;
+    }
+}
+
+/* does not log, cannot fail; lexical pre-check of a value against a union member type, only the values that
+ * surely cannot be parsed as the type are refused so that the full (and failing) parse can be skipped */
+static int
+lyp_union_member_mismatch(struct lyp_union_member *member, const char *value)
+{
+    unsigned int i;
+    size_t len;
+
+    switch (member->class) {
+    case LYP_UNI_INT:
+        if (!value) {
+            return 1;
+        }
+        /* strtoll() skips leading whitespaces, empty and whitespace-only values are left to the parser */
+        while (isspace(value[0])) {
+            ++value;
+        }
+        return value[0] && !isdigit(value[0]) && (value[0] != '-') && (value[0] != '+');
+    case LYP_UNI_DEC64:
+        return !value || (!isdigit(value[0]) && (value[0] != '-') && (value[0] != '+'));
+    case LYP_UNI_BOOL:
+        return !value || (strcmp(value, "true") && strcmp(value, "false"));
+    case LYP_UNI_EMPTY:
+        return value && value[0];
+    case LYP_UNI_ENUM:
+        if (!value) {
+            return 1;
+        }
+        len = strlen(value);
+        for (i = lyp_type_item_find(member->items, member->names, value, len);
+                i < member->items->info.enums.count; i++) {
+            if (!strcmp(value, member->items->info.enums.enm[i].name)) {
+                return 0;
             }
+        }
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* fill the member types of the union (and its nested unions) in the order of lyp_get_next_union_type(),
+ * only count them if members is NULL */
+static void
+lyp_union_members_fill(struct lys_type *type, struct lyp_union_members *members, uint32_t *count)
+{
+    unsigned int u;
+
+    for (; !type->info.uni.count; type = &type->der->type);
+
+    for (u = 0; u < type->info.uni.count; u++) {
+        if (type->info.uni.types[u].base == LY_TYPE_UNION) {
+            lyp_union_members_fill(&type->info.uni.types[u], members, count);
+        } else {
+            if (members) {
+                lyp_union_member_init(&members->member[*count], &type->info.uni.types[u]);
+            }
+            ++(*count);
+        }
+    }
+}
+
+#ifdef LY_ENABLED_CACHE
+
+/* compile the type's own patterns if not yet done */
+static int
+lyp_type_compile_patterns(struct lys_type *type)
+{
+    unsigned int i;
+
+    if (type->info.str.patterns_pcre || !type->info.str.pat_count) {
+        return EXIT_SUCCESS;
+    }
+
+    type->info.str.patterns_pcre = malloc(2 * type->info.str.pat_count * sizeof *type->info.str.patterns_pcre);
+    LY_CHECK_ERR_RETURN(!type->info.str.patterns_pcre, LOGMEM, EXIT_FAILURE);
+
+    for (i = 0; i < type->info.str.pat_count; ++i) {
+        if (lyp_precompile_pattern(&type->info.str.patterns[i].expr[1],
+                                   (pcre**)&type->info.str.patterns_pcre[i * 2],
+                                   (pcre_extra**)&type->info.str.patterns_pcre[i * 2 + 1])) {
+            /* free the already compiled ones */
+            while (i--) {
+                pcre_free((pcre *)type->info.str.patterns_pcre[i * 2]);
+                pcre_free_study((pcre_extra *)type->info.str.patterns_pcre[i * 2 + 1]);
+            }
+            free(type->info.str.patterns_pcre);
+            type->info.str.patterns_pcre = NULL;
             return EXIT_FAILURE;
         }
     }
@@ -727,47 +1885,295 @@ parse_int(const char *val_str, int64_t min, int64_t max, int base, int64_t *ret,
     return EXIT_SUCCESS;
 }
 
-/* logs directly
- * base: 0  - to accept decimal, octal, hexadecimal (in default value)
- *       10 - to accept only decimal (instance value)
- */
-static int
-parse_uint(const char *val_str, uint64_t max, int base, uint64_t *ret, struct lyd_node *node)
+#endif
+
+/* compile all the length/range restrictions of the type and its superior typedefs */
+static int
+lyp_type_plan_intervals(struct lys_type *type, struct lyp_type_plan *plan)
+{
+    struct len_ran_intv *intv = NULL, *iter;
+    struct lys_type *level;
+    struct lys_tpdf *tpdf;
+    uint32_t i;
+    int ret = EXIT_FAILURE;
+
+    if (resolve_len_ran_interval(NULL, type, &intv) || !intv) {
+        /* already done during schema parsing */
+        LOGINT;
+        goto cleanup;
+    }
+
+    plan->intv = calloc(plan->intv_count, sizeof *plan->intv);
+    LY_CHECK_ERR_GOTO(!plan->intv, LOGMEM, cleanup);
+
+    /* all the intervals of a single restriction share one type pointer */
+    for (i = 0, iter = intv; iter && (i < plan->intv_count); ++i) {
+        for (tpdf = NULL, level = type; level != iter->type; tpdf = level->der, level = &tpdf->type);
+        plan->intv[i].tpdf = tpdf;
+        plan->intv[i].bounds = len_ran_compile(iter, level);
+        if (!plan->intv[i].bounds) {
+            goto cleanup;
+        }
+        for (; iter && (iter->type == level); iter = iter->next);
+    }
+    if (iter || (i < plan->intv_count)) {
+        LOGINT;
+        goto cleanup;
+    }
+    ret = EXIT_SUCCESS;
+
+cleanup:
+    while (intv) {
+        iter = intv->next;
+        free(intv);
+        intv = iter;
+    }
+    return ret;
+}
+
+/* collect the member types of the union, they are resolved together with the union */
+static int
+lyp_type_plan_members(struct lys_type *type, struct lyp_type_plan *plan)
+{
+    struct lyp_type_plan *der_plan;
+    struct lys_type *iter;
+    uint32_t count;
+    unsigned int u;
+
+    if (!type->info.uni.count) {
+        /* the members are defined in a typedef */
+        for (iter = &type->der->type; !iter->info.uni.count; iter = &iter->der->type);
+        der_plan = lyp_type_plan(iter);
+        if (!der_plan) {
+            LOGINT;
+            return EXIT_FAILURE;
+        }
+        plan->members = der_plan->members;
+        return EXIT_SUCCESS;
+    }
+
+    for (u = 0; u < type->info.uni.count; u++) {
+        if (lyp_type_prepare(&type->info.uni.types[u])) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    count = 0;
+    lyp_union_members_fill(type, NULL, &count);
+    plan->members = malloc(sizeof *plan->members + count * sizeof *plan->members->member);
+    LY_CHECK_ERR_RETURN(!plan->members, LOGMEM, EXIT_FAILURE);
+    plan->own_members = 1;
+    plan->members->count = 0;
+    lyp_union_members_fill(type, plan->members, &plan->members->count);
+    return EXIT_SUCCESS;
+}
+
+static void
+lyp_type_plan_free(struct lyp_type_plan *plan)
+{
+    uint32_t i;
+
+    if (!plan) {
+        return;
+    }
+
+    if (plan->intv) {
+        for (i = 0; i < plan->intv_count; ++i) {
+            free(plan->intv[i].bounds);
+        }
+        free(plan->intv);
+    }
+    if (plan->own_names) {
+        free(plan->names);
+    }
+    if (plan->own_members) {
+        free(plan->members);
+    }
+    free(plan);
+}
+
+/* build the validation plan of the type */
+static struct lyp_type_plan *
+lyp_type_plan_build(struct lys_type *type)
+{
+    struct lyp_type_plan *plan, *items_plan;
+    struct lys_type *iter;
+    struct lys_tpdf *tpdf;
+    uint32_t count = 0, i, j;
+    int items = 0;
+
+    for (iter = type; iter; iter = iter->der ? &iter->der->type : NULL) {
+        if (iter->base == LY_TYPE_STRING) {
+#ifdef LY_ENABLED_CACHE
+            if (lyp_type_compile_patterns(iter)) {
+                return NULL;
+            }
+#endif
+            count += iter->info.str.pat_count;
+        }
+    }
+
+    plan = calloc(1, sizeof *plan + count * sizeof *plan->pat);
+    LY_CHECK_ERR_RETURN(!plan, LOGMEM, NULL);
+    plan->pat_count = count;
+
+    for (tpdf = NULL, iter = type; iter; tpdf = iter->der, iter = tpdf ? &tpdf->type : NULL) {
+        if (len_ran_restr(iter)) {
+            ++plan->intv_count;
+        }
+
+        if (!items && (((iter->base == LY_TYPE_ENUM) && iter->info.enums.count)
+                || ((iter->base == LY_TYPE_BITS) && iter->info.bits.count))) {
+            items = 1;
+            plan->items_tpdf = tpdf;
+        }
+
+        if (iter->der && iter->der->module && !strcmp(iter->der->name, "xpath1.0")
+                && !strcmp(iter->der->module->name, "ietf-yang-types")) {
+            plan->xpath = 1;
+        }
+
+        /* the patterns of the superior types are checked first */
+        if (iter->base == LY_TYPE_STRING) {
+            for (j = iter->info.str.pat_count; j; --j) {
+                i = --count;
+#ifdef LY_ENABLED_CACHE
+                plan->pat[i].comp = (pcre *)iter->info.str.patterns_pcre[2 * (j - 1)];
+                plan->pat[i].extra = (pcre_extra *)iter->info.str.patterns_pcre[2 * (j - 1) + 1];
+#endif
+                plan->pat[i].restr = &iter->info.str.patterns[j - 1];
+            }
+        }
+    }
+
+    if (plan->intv_count && lyp_type_plan_intervals(type, plan)) {
+        goto error;
+    }
+
+    switch (type->base) {
+    case LY_TYPE_BITS:
+        plan->canon = make_canonical_bits;
+        /* falls through */
+    case LY_TYPE_ENUM:
+        if (!plan->items_tpdf) {
+            plan->names = lyp_names_hash_build(type);
+            if (!plan->names) {
+                goto error;
+            }
+            plan->own_names = 1;
+        } else {
+            /* the typedef is resolved before the types derived from it */
+            items_plan = lyp_type_plan(&plan->items_tpdf->type);
+            if (!items_plan) {
+                LOGINT;
+                goto error;
+            }
+            plan->names = items_plan->names;
+        }
+        break;
+    case LY_TYPE_UNION:
+        if (lyp_type_plan_members(type, plan)) {
+            goto error;
+        }
+        break;
+    case LY_TYPE_IDENT:
+        plan->canon = make_canonical_ident;
+        break;
+    case LY_TYPE_DEC64:
+        plan->canon = make_canonical_dec64;
+        break;
+    case LY_TYPE_INT8:
+    case LY_TYPE_INT16:
+    case LY_TYPE_INT32:
+    case LY_TYPE_INT64:
+        plan->canon = make_canonical_int;
+        break;
+    case LY_TYPE_UINT8:
+    case LY_TYPE_UINT16:
+    case LY_TYPE_UINT32:
+    case LY_TYPE_UINT64:
+        plan->canon = make_canonical_uint;
+        break;
+    default:
+        break;
+    }
+
+    return plan;
+
+error:
+    lyp_type_plan_free(plan);
+    return NULL;
+}
+
+int
+lyp_type_prepare(struct lys_type *type)
+{
+    struct ly_ctx *ctx = type->parent->module->ctx;
+    struct lyp_type_plan *plan;
+
+    if (ly_ptr_map_get(&ctx->type_plans, type)) {
+        /* already done */
+        return EXIT_SUCCESS;
+    }
+
+    plan = lyp_type_plan_build(type);
+    if (!plan) {
+        return EXIT_FAILURE;
+    }
+    if (ly_ptr_map_set(&ctx->type_plans, type, plan)) {
+        LOGMEM;
+        lyp_type_plan_free(plan);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void
+lyp_type_unprepare(struct ly_ctx *ctx, struct lys_type *type)
 {
-    char *strptr;
-    uint64_t u;
+    lyp_type_plan_free(ly_ptr_map_remove(&ctx->type_plans, type));
+}
 
-    if (!val_str || !val_str[0]) {
-        goto error;
+int
+lyp_type_plan_move(struct ly_ctx *ctx, struct lys_type *from, struct lys_type *to)
+{
+    struct lyp_type_plan *plan;
+
+    plan = ly_ptr_map_remove(&ctx->type_plans, from);
+    if (plan && ly_ptr_map_set(&ctx->type_plans, to, plan)) {
+        LOGMEM;
+        lyp_type_plan_free(plan);
+        return EXIT_FAILURE;
     }
 
-    errno = 0;
-    strptr = NULL;
-    u = strtoull(val_str, &strptr, base);
-    if (errno || (u > max)) {
-        goto error;
-    } else if (strptr && *strptr) {
-        while (isspace(*strptr)) {
-            ++strptr;
-        }
-        if (*strptr) {
-            goto error;
+    return EXIT_SUCCESS;
+}
+
+static struct lys_type *
+lyp_union_next_member(struct lyp_union_members *members, const char *value, unsigned int *idx)
+{
+    for (; *idx < members->count; ++(*idx)) {
+        if (!lyp_union_member_mismatch(&members->member[*idx], value)) {
+            return members->member[(*idx)++].type;
         }
-    } else if (u != 0 && val_str[0] == '-') {
-        goto error;
     }
+    return NULL;
+}
 
-    *ret = u;
-    return EXIT_SUCCESS;
+struct lys_type *
+lyp_get_next_union_member(struct lys_type *type, const char *value, unsigned int *idx)
+{
+    struct lyp_type_plan *plan;
 
-error:
-    if (node) {
-        LOGVAL(LYE_INVAL, LY_VLOG_LYD, node, val_str ? val_str : "", node->schema->name);
-    } else {
-        ly_errno = LY_EVALID;
-        ly_vecode = LYVE_INVAL;
+    plan = lyp_type_plan(type);
+    if (!plan) {
+        /* the type was not resolved */
+        LOGINT;
+        return NULL;
     }
-    return EXIT_FAILURE;
+
+    return lyp_union_next_member(plan->members, value, idx);
 }
 
 /* logs directly
@@ -776,153 +2182,82 @@ error:
  */
 static int
 validate_length_range(uint8_t kind, uint64_t unum, int64_t snum, int64_t fnum, uint8_t fnum_dig, struct lys_type *type,
-                      const char *val_str, struct lyd_node *node)
+                      struct lyp_type_plan *plan, const char *val_str, struct lyd_node *node)
 {
-    struct lys_restr *restr = NULL;
-    struct len_ran_intv *intv = NULL, *tmp_intv;
-    struct lys_type *cur_type;
-    int match;
+    struct lys_restr *restr;
+    uint32_t i;
 
-    if (resolve_len_ran_interval(NULL, type, &intv)) {
-        /* already done during schema parsing */
-        LOGINT;
-        return EXIT_FAILURE;
-    }
-    if (!intv) {
+    /* the restriction of the most derived type is always a subset of the superior ones */
+    if (!plan->intv_count
+            || len_ran_match(plan->intv[plan->intv_count - 1].bounds, unum, snum, fnum, fnum_dig)) {
         return EXIT_SUCCESS;
     }
+    assert(plan->intv[0].bounds->kind == kind);
+    (void)kind;
 
-    /* I know that all intervals belonging to a single restriction share one type pointer */
-    tmp_intv = intv;
-    cur_type = intv->type;
-    do {
-        match = 0;
-        for (; tmp_intv && (tmp_intv->type == cur_type); tmp_intv = tmp_intv->next) {
-            if (match) {
-                /* just iterate through the rest of this restriction intervals */
-                continue;
-            }
-
-            if (((kind == 0) && (unum < tmp_intv->value.uval.min))
-                    || ((kind == 1) && (snum < tmp_intv->value.sval.min))
-                    || ((kind == 2) && (dec64cmp(fnum, fnum_dig, tmp_intv->value.fval.min, cur_type->info.dec64.dig) < 0))) {
-                break;
-            }
+    /* report the least derived restriction the value does not match */
+    for (i = 0; len_ran_match(plan->intv[i].bounds, unum, snum, fnum, fnum_dig); ++i);
+    restr = len_ran_restr(plan->intv[i].tpdf ? &plan->intv[i].tpdf->type : type);
 
-            if (((kind == 0) && (unum >= tmp_intv->value.uval.min) && (unum <= tmp_intv->value.uval.max))
-                    || ((kind == 1) && (snum >= tmp_intv->value.sval.min) && (snum <= tmp_intv->value.sval.max))
-                    || ((kind == 2) && (dec64cmp(fnum, fnum_dig, tmp_intv->value.fval.min, cur_type->info.dec64.dig) > -1)
-                    && (dec64cmp(fnum, fnum_dig, tmp_intv->value.fval.max, cur_type->info.dec64.dig) < 1))) {
-                match = 1;
-            }
-        }
+    LOGVAL(LYE_NOCONSTR, LY_VLOG_LYD, node, (val_str ? val_str : ""), restr ? restr->expr : "");
+    if (restr && restr->emsg) {
+        LOGVAL(LYE_SPEC, LY_VLOG_PREV, NULL, restr->emsg);
+    }
+    if (restr && restr->eapptag) {
+        strncpy(((struct ly_err *)&ly_errno)->apptag, restr->eapptag, LY_APPTAG_LEN - 1);
+    }
+    return EXIT_FAILURE;
+}
 
-        if (!match) {
-            break;
-        } else if (tmp_intv) {
-            cur_type = tmp_intv->type;
-        }
-    } while (tmp_intv);
+/* logs directly, the pattern is compiled now if comp is NULL */
+static int
+validate_pattern_restr(const char *val_str, size_t len, struct lys_restr *pattern, pcre *comp, pcre_extra *extra,
+                       struct lyd_node *node)
+{
+    pcre *precomp = NULL;
+    int rc;
 
-    while (intv) {
-        tmp_intv = intv->next;
-        free(intv);
-        intv = tmp_intv;
+    if (node) {
+        LY_STATS_INC(node->schema->module->ctx, pattern_execs);
     }
-
-    if (!match) {
-        switch (cur_type->base) {
-        case LY_TYPE_BINARY:
-            restr = cur_type->info.binary.length;
-            break;
-        case LY_TYPE_DEC64:
-            restr = cur_type->info.dec64.range;
-            break;
-        case LY_TYPE_INT8:
-        case LY_TYPE_INT16:
-        case LY_TYPE_INT32:
-        case LY_TYPE_INT64:
-        case LY_TYPE_UINT8:
-        case LY_TYPE_UINT16:
-        case LY_TYPE_UINT32:
-        case LY_TYPE_UINT64:
-            restr = cur_type->info.num.range;
-            break;
-        case LY_TYPE_STRING:
-            restr = cur_type->info.str.length;
-            break;
-        default:
-            LOGINT;
+    if (!comp) {
+        if (lyp_check_pattern(&pattern->expr[1], &precomp)) {
             return EXIT_FAILURE;
         }
+        comp = precomp;
+    }
+    rc = pcre_exec(comp, extra, val_str, len, 0, 0, NULL, 0);
+    free(precomp);
 
-        LOGVAL(LYE_NOCONSTR, LY_VLOG_LYD, node, (val_str ? val_str : ""), restr ? restr->expr : "");
-        if (restr && restr->emsg) {
-            LOGVAL(LYE_SPEC, LY_VLOG_PREV, NULL, restr->emsg);
+    if ((rc && pattern->expr[0] == 0x06) || (!rc && pattern->expr[0] == 0x15)) {
+        LOGVAL(LYE_NOCONSTR, LY_VLOG_LYD, node, val_str, &pattern->expr[1]);
+        if (pattern->emsg) {
+            LOGVAL(LYE_SPEC, LY_VLOG_PREV, NULL, pattern->emsg);
         }
-        if (restr && restr->eapptag) {
-            strncpy(((struct ly_err *)&ly_errno)->apptag, restr->eapptag, LY_APPTAG_LEN - 1);
+        if (pattern->eapptag) {
+            strncpy(((struct ly_err *)&ly_errno)->apptag, pattern->eapptag, LY_APPTAG_LEN - 1);
         }
         return EXIT_FAILURE;
     }
+
     return EXIT_SUCCESS;
 }
 
 /* logs directly */
 static int
-validate_pattern(const char *val_str, struct lys_type *type, struct lyd_node *node)
+validate_pattern(const char *val_str, struct lyp_type_plan *plan, struct lyd_node *node)
 {
-    int rc;
     unsigned int i;
-#ifndef LY_ENABLED_CACHE
-    pcre *precomp;
-#endif
-
-    assert(type->base == LY_TYPE_STRING);
+    size_t len;
 
     if (!val_str) {
         val_str = "";
     }
+    len = strlen(val_str);
 
-    if (type->der && validate_pattern(val_str, &type->der->type, node)) {
-        return EXIT_FAILURE;
-    }
-
-#ifdef LY_ENABLED_CACHE
-    /* there is no cache, build it */
-    if (!type->info.str.patterns_pcre && type->info.str.pat_count) {
-        type->info.str.patterns_pcre = malloc(2 * type->info.str.pat_count * sizeof *type->info.str.patterns_pcre);
-        LY_CHECK_ERR_RETURN(!type->info.str.patterns_pcre, LOGMEM, -1);
-
-        for (i = 0; i < type->info.str.pat_count; ++i) {
-            if (lyp_precompile_pattern(&type->info.str.patterns[i].expr[1],
-                                       (pcre**)&type->info.str.patterns_pcre[i * 2],
-                                       (pcre_extra**)&type->info.str.patterns_pcre[i * 2 + 1])) {
-                return EXIT_FAILURE;
-            }
-        }
-    }
-#endif
-
-    for (i = 0; i < type->info.str.pat_count; ++i) {
-#ifdef LY_ENABLED_CACHE
-        rc = pcre_exec((pcre *)type->info.str.patterns_pcre[2 * i], (pcre_extra *)type->info.str.patterns_pcre[2 * i + 1],
-                       val_str, strlen(val_str), 0, 0, NULL, 0);
-#else
-        if (lyp_check_pattern(&type->info.str.patterns[i].expr[1], &precomp)) {
-            return EXIT_FAILURE;
-        }
-        rc = pcre_exec(precomp, NULL, val_str, strlen(val_str), 0, 0, NULL, 0);
-        free(precomp);
-#endif
-        if ((rc && type->info.str.patterns[i].expr[0] == 0x06) || (!rc && type->info.str.patterns[i].expr[0] == 0x15)) {
-            LOGVAL(LYE_NOCONSTR, LY_VLOG_LYD, node, val_str, &type->info.str.patterns[i].expr[1]);
-            if (type->info.str.patterns[i].emsg) {
-                LOGVAL(LYE_SPEC, LY_VLOG_PREV, NULL, type->info.str.patterns[i].emsg);
-            }
-            if (type->info.str.patterns[i].eapptag) {
-                strncpy(((struct ly_err *)&ly_errno)->apptag, type->info.str.patterns[i].eapptag, LY_APPTAG_LEN - 1);
-            }
+    /* all the patterns of the type and its superior typedefs are in the plan, precompiled with the cache */
+    for (i = 0; i < plan->pat_count; ++i) {
+        if (validate_pattern_restr(val_str, len, plan->pat[i].restr, plan->pat[i].comp, plan->pat[i].extra, node)) {
             return EXIT_FAILURE;
         }
     }
@@ -1219,139 +2554,197 @@ lyp_precompile_pattern(const char *pattern, pcre** pcre_cmp, pcre_extra **pcre_s
     return EXIT_SUCCESS;
 }
 
-/**
- * @brief Change the value into its canonical form. In libyang, additionally to the RFC,
- * all identities have their module as a prefix in their canonical form.
- *
- * @param[in] ctx
- * @param[in] type Type of the value.
- * @param[in,out] value Original and then canonical value.
- * @param[in] data1 If \p type is #LY_TYPE_BITS: (struct lys_type_bit **) type bit field,
- *                                #LY_TYPE_DEC64: (int64_t *) parsed digits of the number itself without floating point,
- *                                #LY_TYPE_IDENT: (const char *) local module name (identityref node module),
- *                                #LY_TYPE_INT*: (int64_t *) parsed int number itself,
- *                                #LY_TYPE_UINT*: (uint64_t *) parsed uint number itself,
- *                                otherwise ignored.
- * @param[in] data2 If \p type is #LY_TYPE_BITS: (int *) type bit field length,
- *                                #LY_TYPE_DEC64: (uint8_t *) number of fraction digits (position of the floating point),
- *                                otherwise ignored.
- * @return 1 if a conversion took place, 0 if the value was kept the same.
- */
+/* check whether the already parsed integer or decimal64 value is in its canonical form, so it does not have
+ * to be printed and compared */
 static int
-make_canonical(struct ly_ctx *ctx, int type, const char **value, void *data1, void *data2)
+make_canonical_is_num(int type, const char *value, int64_t num)
 {
-    char *buf = ly_buf(), *buf_backup = NULL, *str;
-    struct lys_type_bit **bits = NULL;
-    const char *module_name;
-    int i, j, count, ret = 0;
-    int64_t num;
-    uint64_t unum;
-    uint8_t c;
+    const char *ptr = value;
+
+    if (ptr[0] == '-') {
+        ++ptr;
+    }
+
+    /* integer (part) without leading zeros */
+    if (ptr[0] == '0') {
+        ++ptr;
+    } else if ((ptr[0] >= '1') && (ptr[0] <= '9')) {
+        for (++ptr; isdigit(ptr[0]); ++ptr);
+    } else {
+        return 0;
+    }
+
+    if (type != LY_TYPE_DEC64) {
+        /* negative zero is not canonical */
+        return !ptr[0] && strcmp(value, "-0");
+    }
+
+    if (!num) {
+        return !strcmp(value, "0.0");
+    }
+
+    /* fraction without trailing zeros, but at least one digit */
+    if ((ptr[0] != '.') || !isdigit(ptr[1])) {
+        return 0;
+    }
+    for (ptr += 2; isdigit(ptr[0]); ++ptr);
+    return !ptr[0] && ((ptr[-1] != '0') || (ptr[-2] == '.'));
+}
+
+/* replace the value with its canonical form if they differ */
+static int
+make_canonical_set(struct ly_ctx *ctx, const char **value, const char *canon)
+{
+    if (!strcmp(canon, *value)) {
+        return 0;
+    }
 
-    /* prepare buffer for creating canonical representation */
+    lydict_remove(ctx, *value);
+    *value = lydict_insert(ctx, canon, 0);
+    return 1;
+}
+
+/* get the internal buffer to create a canonical value in, its previous content is backed up */
+static char *
+make_canonical_buf_get(char **backup)
+{
+    char *buf;
+
+    buf = ly_buf();
+    *backup = NULL;
     if (ly_buf_used && buf[0]) {
-        buf_backup = strndup(buf, LY_BUF_SIZE - 1);
+        *backup = strndup(buf, LY_BUF_SIZE - 1);
     }
     ly_buf_used++;
 
-    switch (type) {
-    case LY_TYPE_BITS:
-        bits = (struct lys_type_bit **)data1;
-        count = *((int *)data2);
-        /* in canonical form, the bits are ordered by their position */
-        buf[0] = '\0';
-        for (i = 0; i < count; i++) {
-            if (!bits[i]) {
-                /* bit not set */
-                continue;
-            }
-            if (buf[0]) {
-                str = strdup(buf);
-                LY_CHECK_ERR_GOTO(!str, LOGMEM, cleanup);
-                sprintf(buf, "%s %s", str, bits[i]->name);
-                free(str);
-            } else {
-                sprintf(buf, "%s", bits[i]->name);
-            }
-        }
-        break;
+    return buf;
+}
 
-    case LY_TYPE_IDENT:
-        module_name = (const char *)data1;
-        /* identity must always have a prefix */
-        if (!strchr(*value, ':')) {
-            sprintf(buf, "%s:%s", module_name, *value);
-        } else {
-            strcpy(buf, *value);
+/* return the internal buffer got by make_canonical_buf_get() */
+static void
+make_canonical_buf_put(char *buf, char *backup)
+{
+    if (backup) {
+        /* return previous internal buffer content */
+        strcpy(buf, backup);
+        free(backup);
+    }
+    ly_buf_used--;
+}
+
+static int
+make_canonical_bits(struct ly_ctx *ctx, const char **value, void *data1, void *data2)
+{
+    struct lys_type_bit **bits = (struct lys_type_bit **)data1;
+    unsigned int count = *((unsigned int *)data2), i;
+    char *buf, *backup;
+    int len = 0, ret;
+
+    buf = make_canonical_buf_get(&backup);
+
+    /* in canonical form, the bits are ordered by their position */
+    buf[0] = '\0';
+    for (i = 0; i < count; i++) {
+        if (!bits[i]) {
+            /* bit not set */
+            continue;
         }
-        break;
+        len += sprintf(buf + len, "%s%s", len ? " " : "", bits[i]->name);
+    }
 
-    case LY_TYPE_DEC64:
-        num = *((int64_t *)data1);
-        c = *((uint8_t *)data2);
-        if (num) {
-            count = sprintf(buf, "%"PRId64" ", num);
-            if ( (num > 0 && (count - 1) <= c)
-                 || (count - 2) <= c ) {
-                /* we have 0. value, print the value with the leading zeros
-                 * (one for 0. and also keep the correct with of num according
-                 * to fraction-digits value)
-                 * for (num<0) - extra character for '-' sign */
-                count = sprintf(buf, "%0*"PRId64" ", (num > 0) ? (c + 1) : (c + 2), num);
-            }
-            for (i = c, j = 1; i > 0 ; i--) {
-                if (j && i > 1 && buf[count - 2] == '0') {
-                    /* we have trailing zero to skip */
-                    buf[count - 1] = '\0';
-                } else {
-                    j = 0;
-                    buf[count - 1] = buf[count - 2];
-                }
-                count--;
+    ret = make_canonical_set(ctx, value, buf);
+    make_canonical_buf_put(buf, backup);
+    return ret;
+}
+
+static int
+make_canonical_ident(struct ly_ctx *ctx, const char **value, void *data1, void *UNUSED(data2))
+{
+    const char *module_name = (const char *)data1;
+    char *buf, *backup;
+    int ret;
+
+    /* identity must always have a prefix */
+    if (strchr(*value, ':')) {
+        return 0;
+    }
+
+    buf = make_canonical_buf_get(&backup);
+    sprintf(buf, "%s:%s", module_name, *value);
+    ret = make_canonical_set(ctx, value, buf);
+    make_canonical_buf_put(buf, backup);
+    return ret;
+}
+
+static int
+make_canonical_dec64(struct ly_ctx *ctx, const char **value, void *data1, void *data2)
+{
+    int64_t num = *((int64_t *)data1);
+    uint8_t c = *((uint8_t *)data2);
+    /* sign, 19 digits, the floating point and the leading zeros of a number with 18 fraction digits */
+    char buf[48];
+    int i, j, count;
+
+    if (make_canonical_is_num(LY_TYPE_DEC64, *value, num)) {
+        /* the usual case, nothing to change */
+        return 0;
+    }
+
+    if (num) {
+        count = sprintf(buf, "%"PRId64" ", num);
+        if ( (num > 0 && (count - 1) <= c)
+             || (count - 2) <= c ) {
+            /* we have 0. value, print the value with the leading zeros
+             * (one for 0. and also keep the correct with of num according
+             * to fraction-digits value)
+             * for (num<0) - extra character for '-' sign */
+            count = sprintf(buf, "%0*"PRId64" ", (num > 0) ? (c + 1) : (c + 2), num);
+        }
+        for (i = c, j = 1; i > 0 ; i--) {
+            if (j && i > 1 && buf[count - 2] == '0') {
+                /* we have trailing zero to skip */
+                buf[count - 1] = '\0';
+            } else {
+                j = 0;
+                buf[count - 1] = buf[count - 2];
             }
-            buf[count - 1] = '.';
-        } else {
-            /* zero */
-            sprintf(buf, "0.0");
+            count--;
         }
-        break;
+        buf[count - 1] = '.';
+    } else {
+        /* zero */
+        sprintf(buf, "0.0");
+    }
 
-    case LY_TYPE_INT8:
-    case LY_TYPE_INT16:
-    case LY_TYPE_INT32:
-    case LY_TYPE_INT64:
-        num = *((int64_t *)data1);
-        sprintf(buf, "%"PRId64, num);
-        break;
+    return make_canonical_set(ctx, value, buf);
+}
 
-    case LY_TYPE_UINT8:
-    case LY_TYPE_UINT16:
-    case LY_TYPE_UINT32:
-    case LY_TYPE_UINT64:
-        unum = *((uint64_t *)data1);
-        sprintf(buf, "%"PRIu64, unum);
-        break;
+static int
+make_canonical_int(struct ly_ctx *ctx, const char **value, void *data1, void *UNUSED(data2))
+{
+    char buf[24];
 
-    default:
-        /* should not be even called - just do nothing */
-        goto cleanup;
+    if (make_canonical_is_num(LY_TYPE_INT64, *value, 0)) {
+        /* the usual case, nothing to change */
+        return 0;
     }
 
-    if (strcmp(buf, *value)) {
-        lydict_remove(ctx, *value);
-        *value = lydict_insert(ctx, buf, 0);
-        ret = 1;
-    }
+    sprintf(buf, "%"PRId64, *((int64_t *)data1));
+    return make_canonical_set(ctx, value, buf);
+}
 
-cleanup:
-    if (buf_backup) {
-        /* return previous internal buffer content */
-        strcpy(buf, buf_backup);
-        free(buf_backup);
+static int
+make_canonical_uint(struct ly_ctx *ctx, const char **value, void *data1, void *UNUSED(data2))
+{
+    char buf[24];
+
+    if (make_canonical_is_num(LY_TYPE_UINT64, *value, 0)) {
+        /* the usual case, nothing to change */
+        return 0;
     }
-    ly_buf_used--;
 
-    return ret;
+    sprintf(buf, "%"PRIu64, *((uint64_t *)data1));
+    return make_canonical_set(ctx, value, buf);
 }
 
 static const char *
@@ -1409,7 +2802,6 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
                 int store, int dflt)
 {
     struct lys_type *ret = NULL, *t;
-    struct lys_tpdf *tpdf;
     int c, len, found = 0, hidden;
     unsigned int i, j;
     int64_t num;
@@ -1420,9 +2812,17 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
     lyd_val *val;
     uint16_t *val_type;
     struct lyd_node *contextnode;
+    struct lyp_type_plan *plan;
 
     assert(leaf || attr);
 
+    plan = lyp_type_plan(type);
+    if (!plan) {
+        /* the type was not resolved */
+        LOGINT;
+        return NULL;
+    }
+
     if (leaf) {
         assert(!attr);
         if (!local_mod) {
@@ -1500,7 +2900,7 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
         /* length of the encoded string */
         len = ((unum / 4) * 3) - found;
-        if (validate_length_range(0, len, 0, 0, 0, type, value, contextnode)) {
+        if (validate_length_range(0, len, 0, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
@@ -1522,7 +2922,7 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
         /* locate bits structure with the bits definitions
          * since YANG 1.1 allows restricted bits, it is the first
          * bits type with some explicit bit specification */
-        for (; !type->info.bits.count; type = &type->der->type);
+        type = plan->items_tpdf ? &plan->items_tpdf->type : type;
 
         if (value || store) {
             /* allocate the array of pointers to bits definition */
@@ -1559,7 +2959,7 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
             c = c - len;
 
             /* find bit definition, identifiers appear ordered by their posititon */
-            for (found = i = 0; i < type->info.bits.count; i++) {
+            for (found = 0, i = lyp_type_item_find(type, plan->names, &value[c], len); i < type->info.bits.count; i++) {
                 if (!strncmp(type->info.bits.bit[i].name, &value[c], len) && !type->info.bits.bit[i].name[len]) {
                     /* we have match, check if the value is enabled ... */
                     for (j = 0; j < type->info.bits.bit[i].iffeature_size; j++) {
@@ -1610,7 +3010,7 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
             c = c + len;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_BITS, value_, bits, &type->info.bits.count);
+        plan->canon(type->parent->module->ctx, value_, bits, &type->info.bits.count);
 
         if (store) {
             /* store the result */
@@ -1664,11 +3064,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
             goto cleanup;
         }
 
-        if (validate_length_range(2, 0, 0, num, type->info.dec64.dig, type, value, contextnode)) {
+        if (validate_length_range(2, 0, 0, num, type->info.dec64.dig, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_DEC64, value_, &num, &type->info.dec64.dig);
+        plan->canon(type->parent->module->ctx, value_, &num, &type->info.dec64.dig);
 
         if (store) {
             /* store the result */
@@ -1696,10 +3096,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
         /* locate enums structure with the enumeration definitions,
          * since YANG 1.1 allows restricted enums, it is the first
          * enum type with some explicit enum specification */
-        for (; !type->info.enums.count; type = &type->der->type);
+        type = plan->items_tpdf ? &plan->items_tpdf->type : type;
 
         /* find matching enumeration value */
-        for (i = found = 0; i < type->info.enums.count; i++) {
+        i = value ? lyp_type_item_find(type, plan->names, value, strlen(value)) : type->info.enums.count;
+        for (found = 0; i < type->info.enums.count; i++) {
             if (value && !strcmp(value, type->info.enums.enm[i].name)) {
                 /* we have match, check if the value is enabled ... */
                 for (j = 0; j < type->info.enums.enm[i].iffeature_size; j++) {
@@ -1801,8 +3202,7 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
             *val_type = LY_TYPE_IDENT;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_IDENT, &value,
-                       (void*)lys_main_module(local_mod)->name, NULL);
+        plan->canon(type->parent->module->ctx, &value, (void*)lys_main_module(local_mod)->name, NULL);
 
         /* replace the old value with the new one (even if they may be the same) */
         lydict_remove(type->parent->module->ctx, *value_);
@@ -1905,19 +3305,16 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
         break;
 
     case LY_TYPE_STRING:
-        if (validate_length_range(0, (value ? strlen(value) : 0), 0, 0, 0, type, value, contextnode)) {
+        if (validate_length_range(0, (value ? strlen(value) : 0), 0, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        if (validate_pattern(value, type, contextnode)) {
+        if (validate_pattern(value, plan, contextnode)) {
             goto cleanup;
         }
 
         /* special handling of ietf-yang-types xpath1.0 */
-        for (tpdf = type->der;
-             tpdf->module && (strcmp(tpdf->name, "xpath1.0") || strcmp(tpdf->module->name, "ietf-yang-types"));
-             tpdf = tpdf->type.der);
-        if (tpdf->module && xml) {
+        if (xml && plan->xpath) {
             /* convert value into the json format */
             value = transform_xml2json(type->parent->module->ctx, value, xml, 1, 1, 0);
             if (!value) {
@@ -1946,11 +3343,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
     case LY_TYPE_INT8:
         if (parse_int(value, __INT64_C(-128), __INT64_C(127), dflt ? 0 : 10, &num, contextnode)
-                || validate_length_range(1, 0, num, 0, 0, type, value, contextnode)) {
+                || validate_length_range(1, 0, num, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_INT8, value_, &num, NULL);
+        plan->canon(type->parent->module->ctx, value_, &num, NULL);
 
         if (store) {
             /* store the result */
@@ -1961,11 +3358,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
     case LY_TYPE_INT16:
         if (parse_int(value, __INT64_C(-32768), __INT64_C(32767), dflt ? 0 : 10, &num, contextnode)
-                || validate_length_range(1, 0, num, 0, 0, type, value, contextnode)) {
+                || validate_length_range(1, 0, num, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_INT16, value_, &num, NULL);
+        plan->canon(type->parent->module->ctx, value_, &num, NULL);
 
         if (store) {
             /* store the result */
@@ -1976,11 +3373,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
     case LY_TYPE_INT32:
         if (parse_int(value, __INT64_C(-2147483648), __INT64_C(2147483647), dflt ? 0 : 10, &num, contextnode)
-                || validate_length_range(1, 0, num, 0, 0, type, value, contextnode)) {
+                || validate_length_range(1, 0, num, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_INT32, value_, &num, NULL);
+        plan->canon(type->parent->module->ctx, value_, &num, NULL);
 
         if (store) {
             /* store the result */
@@ -1992,11 +3389,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
     case LY_TYPE_INT64:
         if (parse_int(value, __INT64_C(-9223372036854775807) - __INT64_C(1), __INT64_C(9223372036854775807),
                       dflt ? 0 : 10, &num, contextnode)
-                || validate_length_range(1, 0, num, 0, 0, type, value, contextnode)) {
+                || validate_length_range(1, 0, num, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_INT64, value_, &num, NULL);
+        plan->canon(type->parent->module->ctx, value_, &num, NULL);
 
         if (store) {
             /* store the result */
@@ -2007,11 +3404,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
     case LY_TYPE_UINT8:
         if (parse_uint(value, __UINT64_C(255), dflt ? 0 : 10, &unum, contextnode)
-                || validate_length_range(0, unum, 0, 0, 0, type, value, contextnode)) {
+                || validate_length_range(0, unum, 0, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_UINT8, value_, &unum, NULL);
+        plan->canon(type->parent->module->ctx, value_, &unum, NULL);
 
         if (store) {
             /* store the result */
@@ -2022,11 +3419,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
     case LY_TYPE_UINT16:
         if (parse_uint(value, __UINT64_C(65535), dflt ? 0 : 10, &unum, contextnode)
-                || validate_length_range(0, unum, 0, 0, 0, type, value, contextnode)) {
+                || validate_length_range(0, unum, 0, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_UINT16, value_, &unum, NULL);
+        plan->canon(type->parent->module->ctx, value_, &unum, NULL);
 
         if (store) {
             /* store the result */
@@ -2037,11 +3434,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
     case LY_TYPE_UINT32:
         if (parse_uint(value, __UINT64_C(4294967295), dflt ? 0 : 10, &unum, contextnode)
-                || validate_length_range(0, unum, 0, 0, 0, type, value, contextnode)) {
+                || validate_length_range(0, unum, 0, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_UINT32, value_, &unum, NULL);
+        plan->canon(type->parent->module->ctx, value_, &unum, NULL);
 
         if (store) {
             /* store the result */
@@ -2052,11 +3449,11 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
 
     case LY_TYPE_UINT64:
         if (parse_uint(value, __UINT64_C(18446744073709551615), dflt ? 0 : 10, &unum, contextnode)
-                || validate_length_range(0, unum, 0, 0, 0, type, value, contextnode)) {
+                || validate_length_range(0, unum, 0, 0, 0, type, plan, value, contextnode)) {
             goto cleanup;
         }
 
-        make_canonical(type->parent->module->ctx, LY_TYPE_UINT64, value_, &unum, NULL);
+        plan->canon(type->parent->module->ctx, value_, &unum, NULL);
 
         if (store) {
             /* store the result */
@@ -2086,15 +3483,13 @@ lyp_parse_value(struct lys_type *type, const char **value_, struct lyxml_elem *x
             break;
         }
 
-        t = NULL;
-        found = 0;
-
         /* turn logging off, we are going to try to validate the value with all the types in order */
         hidden = ly_vlog_hidden;
         ly_vlog_hide(1);
 
-        while ((t = lyp_get_next_union_type(type, t, &found))) {
-            found = 0;
+        /* the member types the value cannot be of are skipped */
+        i = 0;
+        while ((t = lyp_union_next_member(plan->members, *value_, &i))) {
             ret = lyp_parse_value(t, value_, xml, leaf, attr, NULL, store, dflt);
             if (ret) {
                 /* we have the result */
@@ -3909,6 +5304,106 @@ copyutf8(char *dst, const char *src)
     }
 }
 
+#if defined(__AVX2__)
+#   define LY_VEC_SIZE 32
+#   define ly_vec __m256i
+#   define ly_vec_load(p) _mm256_loadu_si256((const __m256i *)(p))
+#   define ly_vec_set(c) _mm256_set1_epi8(c)
+#   define ly_vec_eq(a, b) _mm256_cmpeq_epi8(a, b)
+#   define ly_vec_lt(a, b) _mm256_cmpgt_epi8(b, a)
+#   define ly_vec_or(a, b) _mm256_or_si256(a, b)
+#   define ly_vec_andnot(a, b) _mm256_andnot_si256(a, b)
+#   define ly_vec_mask(a) (uint32_t)_mm256_movemask_epi8(a)
+#elif defined(__SSE2__)
+#   define LY_VEC_SIZE 16
+#   define ly_vec __m128i
+#   define ly_vec_load(p) _mm_loadu_si128((const __m128i *)(p))
+#   define ly_vec_set(c) _mm_set1_epi8(c)
+#   define ly_vec_eq(a, b) _mm_cmpeq_epi8(a, b)
+#   define ly_vec_lt(a, b) _mm_cmplt_epi8(a, b)
+#   define ly_vec_or(a, b) _mm_or_si128(a, b)
+#   define ly_vec_andnot(a, b) _mm_andnot_si128(a, b)
+#   define ly_vec_mask(a) (uint32_t)_mm_movemask_epi8(a)
+#endif
+
+static int
+ascii_plain(unsigned char c, const char *stop, int ws)
+{
+    if ((c < 0x20) || (c & 0x80)) {
+        return ws && ((c == 0x09) || (c == 0x0a) || (c == 0x0d));
+    }
+    return !strchr(stop, c);
+}
+
+unsigned int
+lyp_ascii_span(const char *data, size_t len, const char *stop, int ws)
+{
+    const char *p = data, *end = data + len;
+#ifdef LY_VEC_SIZE
+    ly_vec v, special, stops[4], ctrl, tab, lf, cr;
+    uint32_t mask;
+    int i, stop_count;
+
+    if (len >= LY_VEC_SIZE) {
+        stop_count = strlen(stop);
+        assert(stop_count <= 4);
+        for (i = 0; i < stop_count; ++i) {
+            stops[i] = ly_vec_set(stop[i]);
+        }
+        /* signed comparison, bytes >= 0x80 are negative so they are caught as well as the NULL byte */
+        ctrl = ly_vec_set(0x20);
+        tab = ly_vec_set(0x09);
+        lf = ly_vec_set(0x0a);
+        cr = ly_vec_set(0x0d);
+
+        /* only whole vectors inside the known length are loaded */
+        for (; end - p >= LY_VEC_SIZE; p += LY_VEC_SIZE) {
+            v = ly_vec_load(p);
+            special = ly_vec_lt(v, ctrl);
+            if (ws) {
+                special = ly_vec_andnot(ly_vec_or(ly_vec_eq(v, tab), ly_vec_or(ly_vec_eq(v, lf), ly_vec_eq(v, cr))),
+                                        special);
+            }
+            for (i = 0; i < stop_count; ++i) {
+                special = ly_vec_or(special, ly_vec_eq(v, stops[i]));
+            }
+            mask = ly_vec_mask(special);
+            if (mask) {
+                return (p - data) + __builtin_ctz(mask);
+            }
+        }
+    }
+#endif
+
+    /* the rest shorter than a vector byte by byte */
+    for (; (p < end) && *p && ascii_plain(*p, stop, ws); ++p);
+    return p - data;
+}
+
+unsigned int
+lyp_ws_span(const char *data, size_t len)
+{
+    const char *p = data, *end = data + len;
+#ifdef LY_VEC_SIZE
+    ly_vec v, space;
+    uint32_t mask;
+
+    for (; end - p >= LY_VEC_SIZE; p += LY_VEC_SIZE) {
+        v = ly_vec_load(p);
+        space = ly_vec_or(ly_vec_or(ly_vec_eq(v, ly_vec_set(0x20)), ly_vec_eq(v, ly_vec_set(0x09))),
+                          ly_vec_or(ly_vec_eq(v, ly_vec_set(0x0a)), ly_vec_eq(v, ly_vec_set(0x0d))));
+        /* NULL byte is not a whitespace, so the scan always stops in its vector */
+        mask = ~ly_vec_mask(space) & (uint32_t)((1ULL << LY_VEC_SIZE) - 1);
+        if (mask) {
+            return (p - data) + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    for (; (p < end) && is_xmlws(*p); ++p);
+    return p - data;
+}
+
 const struct lys_module *
 lyp_get_module(const struct lys_module *module, const char *prefix, int pref_len, const char *name, int name_len, int in_data)
 {
@@ -17,6 +17,7 @@
 
 #include <pcre.h>
 #include <sys/mman.h>
+#include <time.h>
 
 #include "libyang.h"
 #include "tree_schema.h"
@@ -27,6 +28,7 @@
  * @{
  */
 struct lys_module *yin_read_module(struct ly_ctx *ctx, const char *data, const char *revision, int implement);
+struct lys_module *yin_read_module_(struct ly_ctx *ctx, struct lyxml_elem *yin, const char *revision, int implement);
 struct lys_submodule *yin_read_submodule(struct lys_module *module, const char *data,struct unres_schema *unres);
 
 /**@} yin */
@@ -37,6 +39,46 @@ struct lys_submodule *yin_read_submodule(struct lys_module *module, const char *
  */
 struct lyd_node *xml_read_data(struct ly_ctx *ctx, const char *data, int options);
 
+struct xml_push_frame;
+
+/**
+ * @brief Context of the incremental (push) data parser, see lyd_parse_push_new().
+ */
+struct lyd_parse_push {
+    struct ly_ctx *ctx;
+    int options;
+    const struct lyd_node *rpc_act;
+    const struct lyd_node *data_tree;
+    const struct ly_set *select;      /**< #LYD_OPT_SELECT schema nodes */
+    char *buf;                        /**< input not processed yet, always NUL-terminated */
+    size_t used;                      /**< number of bytes in buf */
+    size_t size;                      /**< size of the buf allocation */
+    size_t wait;                      /**< incomplete element at the beginning of buf is not scanned again
+                                           until there are at least this many bytes */
+    uint8_t error;                    /**< the parser failed, the rest of the input is refused */
+    uint8_t ignore;                   /**< the rest of the input is ignored (#LYD_OPT_NOSIBLINGS) */
+    uint32_t roots;                   /**< number of completely processed top-level elements */
+
+    /* XML parser state */
+    struct lyd_node *result;          /**< first top-level node */
+    struct lyd_node *last;            /**< last top-level node */
+    struct lyd_node *act_notif;
+    struct lyd_node *reply_top;
+    struct lyd_node *reply_parent;
+    struct unres_data *unres;
+    struct xml_push_frame *frames;    /**< stack of the elements opened but not closed yet */
+    uint32_t frame_count;
+    uint32_t frame_size;
+};
+
+int xml_push_init(struct lyd_parse_push *push);
+
+int xml_push_parse(struct lyd_parse_push *push, int finish);
+
+struct lyd_node *xml_push_finish(struct lyd_parse_push *push);
+
+void xml_push_clean(struct lyd_parse_push *push);
+
 /**@} xmldata */
 
 /**
@@ -44,7 +86,7 @@ struct lyd_node *xml_read_data(struct ly_ctx *ctx, const char *data, int options
  * @{
  */
 struct lyd_node *lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct lyd_node *rpc_act,
-                                const struct lyd_node *data_tree);
+                                const struct lyd_node *data_tree, const struct ly_set *select);
 
 /**@} jsondata */
 
@@ -92,11 +134,124 @@ int lyp_yin_parse_complex_ext(struct lys_module *mod, struct lys_ext_instance_co
 int lyp_yin_parse_subnode_ext(struct lys_module *mod, void *elem, LYEXT_PAR elem_type,
                               struct lyxml_elem *yin, LYEXT_SUBSTMT type, uint8_t i, struct unres_schema *unres);
 
+/**
+ * @brief (Sub)module file in an indexed search directory.
+ */
+struct lyp_sfile {
+    char *name;                 /**< file name */
+    uint16_t mod_len;           /**< length of the (sub)module name at the beginning of the file name */
+    LYS_INFORMAT format;        /**< format according to the file name suffix */
+    uint32_t next;              /**< index + 1 of the next file in the same hash chain, 0 if the last */
+};
+
+/**
+ * @brief Index of a directory searched for (sub)modules, it is rebuilt when the directory's
+ * modification time changes.
+ */
+struct lyp_sdir {
+    char *path;                 /**< directory path */
+    struct timespec mtime;      /**< modification time of the directory the index was built from */
+    int indexed;                /**< flag that the index content is valid for mtime */
+    struct lyp_sfile *files;    /**< YANG and YIN files in the directory (in the readdir() order) */
+    uint32_t file_count;        /**< number of items in files */
+    uint32_t *hash;             /**< hash table of the files by (sub)module name, index + 1 of the first file */
+    uint32_t hash_mask;         /**< size of the hash table - 1 */
+    struct lyp_sdir **subdirs;  /**< subdirectories (in the readdir() order) */
+    uint32_t subdir_count;      /**< number of items in subdirs */
+    struct lyp_sdir *next;      /**< next indexed search directory in the context */
+};
+
+/**
+ * @brief Free the index of a search directory stored in the context, the caller must hold ly_ctx#cache_lock
+ * if the context may be shared by other threads.
+ *
+ * @param[in] ctx Context with the search directory indexes.
+ * @param[in] path Search directory path, NULL to free all the indexes.
+ */
+void lyp_sdir_remove(struct ly_ctx *ctx, const char *path);
+
 struct lys_module *lyp_search_file(struct ly_ctx *ctx, struct lys_module *module, const char *name,
                                    const char *revision, int implement, struct unres_schema *unres);
 
+/**
+ * @brief Module found in the search paths and parsed in advance (in parallel with other modules) by
+ * ly_ctx_load_modules(), lyp_search_file() finishes it instead of reading the file.
+ */
+struct lyp_preparsed {
+    char *path;                 /**< path of the module file */
+    LYS_INFORMAT format;        /**< format of the module file */
+    struct lyxml_elem *yin;     /**< YIN module parsed into the XML tree */
+    struct lys_module *module;  /**< YANG module parsed by yang_parse_module_only() */
+    struct unres_schema *unres; /**< unresolved items of the YANG module */
+    struct lys_node *node;      /**< data definition nodes of the YANG module to be checked */
+};
+
+/**
+ * @brief Find the files of the modules in the search paths and parse them in several threads. The parsed
+ * modules are stored in the context to be used by lyp_search_file(), free them by lyp_preparsed_free().
+ *
+ * @param[in] ctx Context to parse the modules into.
+ * @param[in] names Names of the modules.
+ * @param[in] revisions Revisions of the modules, NULL items (or NULL) for the newest revisions.
+ * @param[in] count Number of the modules.
+ * @param[in] threads Number of the parsing threads including the current one.
+ * @return EXIT_SUCCESS (even if some modules failed to parse, they are read again to log the errors) or EXIT_FAILURE.
+ */
+int lyp_preparse_modules(struct ly_ctx *ctx, const char **names, const char **revisions, unsigned int count,
+                         unsigned int threads);
+
+/**
+ * @brief Get the module parsed in advance from the file, NULL if there is no such module.
+ */
+struct lyp_preparsed *lyp_preparsed_get(struct ly_ctx *ctx, const char *path);
+
+/**
+ * @brief Free the modules parsed in advance which were not added into the context.
+ */
+void lyp_preparsed_free(struct ly_ctx *ctx);
+
 struct lys_type *lyp_get_next_union_type(struct lys_type *type, struct lys_type *prev_type, int *found);
 
+/**
+ * @brief Get the next member type of a union the value can be of, the member types the value surely cannot be of
+ * (wrong lexical form) are skipped. Does not log, cannot fail.
+ *
+ * @param[in] type Union type.
+ * @param[in] value Value to be parsed/resolved.
+ * @param[in,out] idx Position of the next member type to check, 0 to start.
+ * @return Member type or NULL if there are no more member types.
+ */
+struct lys_type *lyp_get_next_union_member(struct lys_type *type, const char *value, unsigned int *idx);
+
+/**
+ * @brief Prepare the plan optimizing the validation of the values of a resolved type (the flattened
+ * typedef chain with the compiled patterns and length/range intervals, the hash table of the enum and bit names,
+ * the member types of a union, the canonicalizer of the values). The plan is stored in the context keyed by the type.
+ * Called once the type is resolved, the type must not be changed afterwards.
+ *
+ * @param[in] type Resolved type.
+ * @return EXIT_SUCCESS or EXIT_FAILURE on memory allocation or pattern compilation failure.
+ */
+int lyp_type_prepare(struct lys_type *type);
+
+/**
+ * @brief Remove the plan of a type prepared by lyp_type_prepare(), the type does not have to be prepared.
+ *
+ * @param[in] ctx Context of the type.
+ * @param[in] type Type being freed.
+ */
+void lyp_type_unprepare(struct ly_ctx *ctx, struct lys_type *type);
+
+/**
+ * @brief Move the plan of a prepared type together with the type structure.
+ *
+ * @param[in] ctx Context of the type.
+ * @param[in] from Original location of the type.
+ * @param[in] to New location of the type, must not be prepared.
+ * @return EXIT_SUCCESS or EXIT_FAILURE on memory allocation failure.
+ */
+int lyp_type_plan_move(struct ly_ctx *ctx, struct lys_type *from, struct lys_type *to);
+
 /* return: 0 - ret set, ok; 1 - ret not set, no log, unknown meta; -1 - ret not set, log, fatal error */
 int lyp_fill_attr(struct ly_ctx *ctx, struct lyd_node *parent, const char *module_ns, const char *module_name,
                   const char *attr_name, const char *attr_value, struct lyxml_elem *xml, struct lyd_attr **ret);
@@ -142,6 +297,54 @@ int lyp_is_rpc_action(struct lys_node *node);
  */
 int lyp_data_check_options(int options, const char *func);
 
+/**
+ * @brief Schema nodes selected by #LYD_OPT_SELECT, hashed by their address with the state returned by
+ * lyp_data_selected(). The selected nodes, their ancestors and the keys of the ancestor lists are inserted
+ * before parsing, the other nodes are added as they are looked up.
+ */
+struct lyp_select {
+    struct lyp_select_item {
+        const struct lys_node *schema;
+        uint8_t sel;
+    } *items;                   /**< open addressing hash table */
+    uint32_t size;              /**< size of items, a power of 2 */
+    uint32_t count;             /**< number of the used items */
+};
+
+/**
+ * @brief Prepare the selection of #LYD_OPT_SELECT for the parser.
+ *
+ * @param[in] set Set of the selected schema nodes.
+ * @return Selection to be freed with lyp_select_free(), NULL on memory allocation error.
+ */
+struct lyp_select *lyp_select_new(const struct ly_set *set);
+
+/**
+ * @brief Free the selection of #LYD_OPT_SELECT.
+ *
+ * @param[in] select Selection to free.
+ */
+void lyp_select_free(struct lyp_select *select);
+
+/**
+ * @brief Learn whether instances of the schema node are supposed to be parsed with #LYD_OPT_SELECT.
+ *
+ * @param[in] select Selection of the schema nodes, the result is remembered in it.
+ * @param[in] schema Schema node of the data node to be parsed.
+ * @return 0 - skip the instance, 1 - keep the instance as an ancestor of some selected nodes or a key of such
+ * list, 2 - keep the instance with all its descendants.
+ */
+int lyp_data_selected(struct lyp_select *select, const struct lys_node *schema);
+
+/**
+ * @brief Remove the nodes not selected by #LYD_OPT_SELECT from the parsed data (defaults added into the skipped
+ * parts of the tree and ancestors of the selected nodes with no selected node instantiated).
+ *
+ * @param[in,out] first First sibling to check, it is updated in case it is removed.
+ * @param[in] select Selection of the schema nodes.
+ */
+void lyp_data_select_prune(struct lyd_node **first, struct lyp_select *select);
+
 int lyp_check_identifier(const char *id, enum LY_IDENT type, struct lys_module *module, struct lys_node *parent);
 int lyp_check_date(const char *date);
 int lyp_check_mandatory_augment(struct lys_node_augment *node, const struct lys_node *target);
@@ -213,6 +416,30 @@ int lyp_munmap(void *addr, size_t length);
 unsigned int pututf8(char *dst, int32_t value);
 unsigned int copyutf8(char *dst, const char *src);
 
+/**
+ * @brief Get length of the leading run of plain ASCII characters in a string, which can be copied as they are.
+ *
+ * The run ends with a NULL byte, a non-ASCII byte (UTF-8 sequence), a control character (except tab, LF and CR
+ * if \p ws is set) or any of the \p stop characters. SSE2/AVX2 is used when available, but only the first \p len
+ * bytes of \p data are ever read.
+ *
+ * @param[in] data String to scan.
+ * @param[in] len Number of bytes of \p data to scan at most, the scan ends earlier on a NULL byte.
+ * @param[in] stop Characters ending the run (at most 4).
+ * @param[in] ws Whether the XML whitespace control characters are part of the run.
+ * @return Number of bytes in the run.
+ */
+unsigned int lyp_ascii_span(const char *data, size_t len, const char *stop, int ws);
+
+/**
+ * @brief Get length of the leading run of whitespaces (space, tab, LF, CR) in a string.
+ *
+ * @param[in] data String to scan.
+ * @param[in] len Number of bytes of \p data to scan at most, the scan ends earlier on a NULL byte.
+ * @return Number of whitespace bytes.
+ */
+unsigned int lyp_ws_span(const char *data, size_t len);
+
 /*
  * Internal functions implementing YANG extensions support
  * - implemented in extensions.c
@@ -44,20 +44,14 @@ lyjson_isspace(int c)
 }
 
 static unsigned int
-skip_ws(const char *data)
+skip_ws(const char *data, const char *end)
 {
-    unsigned int len = 0;
-
     /* skip leading whitespaces */
-    while (data[len] && lyjson_isspace(data[len])) {
-        len++;
-    }
-
-    return len;
+    return lyp_ws_span(data, end - data);
 }
 
 static char *
-lyjson_parse_text(const char *data, unsigned int *len)
+lyjson_parse_text(const char *data, const char *end, unsigned int *len)
 {
 #define BUFSIZE 1024
 
@@ -155,10 +149,19 @@ lyjson_parse_text(const char *data, unsigned int *len)
             LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "control character (unescaped)");
             goto error;
         } else {
-            /* unescaped character */
-            r = copyutf8(&buf[o], &data[*len]);
-            if (!r) {
-                goto error;
+            /* unescaped characters, copy the run of plain ASCII characters at once */
+            r = end - &data[*len];
+            if (r > (unsigned int)(BUFSIZE - o)) {
+                r = BUFSIZE - o;
+            }
+            r = lyp_ascii_span(&data[*len], r, "\"\\", 0);
+            if (r) {
+                memcpy(&buf[o], &data[*len], r);
+            } else {
+                r = copyutf8(&buf[o], &data[*len]);
+                if (!r) {
+                    goto error;
+                }
             }
 
             o += r - 1;     /* o is ++ in for loop */
@@ -365,7 +368,7 @@ lyjson_parse_boolean(const char *data)
 }
 
 static unsigned int
-json_get_anydata(struct lyd_node_anydata *any, const char *data)
+json_get_anydata(struct lyd_node_anydata *any, const char *data, const char *end)
 {
     unsigned int len = 0, start, stop, c = 0;
     char *str;
@@ -375,7 +378,7 @@ json_get_anydata(struct lyd_node_anydata *any, const char *data)
      * not clear how they are supposed to be represented/converted into an internal representation */
     if (data[len] == '"' && any->schema->nodetype == LYS_ANYXML) {
         len = 1;
-        str = lyjson_parse_text(&data[len], &c);
+        str = lyjson_parse_text(&data[len], end, &c);
         if (!str) {
             return 0;
         }
@@ -396,7 +399,7 @@ json_get_anydata(struct lyd_node_anydata *any, const char *data)
 
     /* count opening '{' and closing '}' brackets to get the end of the object without its parsing */
     c = len = 1;
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
     start = len;
     stop = start - 1;
     while (data[len] && c) {
@@ -427,8 +430,8 @@ json_get_anydata(struct lyd_node_anydata *any, const char *data)
 }
 
 static unsigned int
-json_get_value(struct lyd_node_leaf_list *leaf, struct lyd_node **first_sibling, const char *data, int options,
-               struct unres_data *unres)
+json_get_value(struct lyd_node_leaf_list *leaf, struct lyd_node **first_sibling, const char *data, const char *end,
+               int options, struct unres_data *unres)
 {
     struct lyd_node_leaf_list *new;
     struct lys_type *stype;
@@ -449,7 +452,7 @@ json_get_value(struct lyd_node_leaf_list *leaf, struct lyd_node **first_sibling,
         }
 
 repeat:
-        len += skip_ws(&data[len]);
+        len += skip_ws(&data[len], end);
     }
 
     /* will be changed in case of union */
@@ -458,7 +461,7 @@ repeat:
     if (data[len] == '"') {
         /* string representations */
         ++len;
-        str = lyjson_parse_text(&data[len], &r);
+        str = lyjson_parse_text(&data[len], end, &r);
         if (!str) {
             LOGPATH(LY_VLOG_LYD, leaf);
             return 0;
@@ -516,7 +519,7 @@ repeat:
 
     if (leaf->schema->nodetype == LYS_LEAFLIST) {
         /* repeat until end-array */
-        len += skip_ws(&data[len]);
+        len += skip_ws(&data[len], end);
         if (data[len] == ',') {
             /* various validation checks */
             if (lyv_data_context((struct lyd_node*)leaf, options, unres)) {
@@ -534,6 +537,7 @@ repeat:
             /* another instance of the leaf-list */
             new = calloc(1, sizeof(struct lyd_node_leaf_list));
             LY_CHECK_ERR_RETURN(!new, LOGMEM, 0);
+            LY_STATS_INC(leaf->schema->module->ctx, node_allocs);
 
             new->parent = leaf->parent;
             new->prev = (struct lyd_node *)leaf;
@@ -554,7 +558,7 @@ repeat:
             goto repeat;
         } else if (data[len] == ']') {
             len++;
-            len += skip_ws(&data[len]);
+            len += skip_ws(&data[len], end);
         } else {
             /* something unexpected */
             LOGVAL(LYE_XML_INVAL, LY_VLOG_LYD, leaf, "JSON data (expecting value-separator or end-array)");
@@ -562,12 +566,13 @@ repeat:
         }
     }
 
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
     return len;
 }
 
 static unsigned int
-json_parse_attr(struct lys_module *parent_module, struct lyd_attr **attr, const char *data, int options)
+json_parse_attr(struct lys_module *parent_module, struct lyd_attr **attr, const char *data, const char *end,
+                int options)
 {
     unsigned int len = 0, r;
     char *str = NULL, *name, *prefix = NULL, *value;
@@ -580,7 +585,7 @@ json_parse_attr(struct lys_module *parent_module, struct lyd_attr **attr, const
     if (data[len] != '{') {
         if (!strncmp(&data[len], "null", 4)) {
             len += 4;
-            len += skip_ws(&data[len]);
+            len += skip_ws(&data[len], end);
             return len;
         }
         LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing begin-object)");
@@ -590,14 +595,14 @@ json_parse_attr(struct lys_module *parent_module, struct lyd_attr **attr, const
 repeat:
     prefix = NULL;
     len++;
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
 
     if (data[len] != '"') {
         LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing quotation-mark at the begining of string)");
         return 0;
     }
     len++;
-    str = lyjson_parse_text(&data[len], &r);
+    str = lyjson_parse_text(&data[len], end, &r);
     if (!r) {
         goto error;
     } else if (data[len + r] != '"') {
@@ -619,20 +624,20 @@ repeat:
 
     /* prepare data for parsing node content */
     len += r + 1;
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
     if (data[len] != ':') {
         LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing name-separator)");
         goto error;
     }
     len++;
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
 
     if (data[len] != '"') {
         LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing quotation-mark at the beginning of string)");
         goto error;
     }
     len++;
-    value = lyjson_parse_text(&data[len], &r);
+    value = lyjson_parse_text(&data[len], end, &r);
     if (!r) {
         goto error;
     } else if (data[len + r] != '"') {
@@ -641,7 +646,7 @@ repeat:
         goto error;
     }
     len += r + 1;
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
 
     ret = lyp_fill_attr(parent_module->ctx, NULL, NULL, prefix, name, value, NULL, &attr_new);
     if (ret == -1) {
@@ -679,7 +684,7 @@ next:
         goto error;
     }
     len++;
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
 
     return len;
 
@@ -699,6 +704,45 @@ struct attr_cont {
     unsigned int index;    /** non-zero only in case of leaf-list */
 };
 
+/* returns length of the JSON value without checking its content, 0 on error */
+static unsigned int
+json_skip_value(const char *data)
+{
+    unsigned int len = 0, depth = 0;
+
+    while (depth || ((data[len] != ',') && (data[len] != '}') && (data[len] != ']'))) {
+        switch (data[len]) {
+        case '\0':
+            LOGVAL(LYE_EOF, LY_VLOG_NONE, NULL);
+            return 0;
+        case '"':
+            for (++len; data[len] != '"'; ++len) {
+                if (!data[len]) {
+                    LOGVAL(LYE_EOF, LY_VLOG_NONE, NULL);
+                    return 0;
+                } else if ((data[len] == '\\') && data[len + 1]) {
+                    ++len;
+                }
+            }
+            break;
+        case '{':
+        case '[':
+            ++depth;
+            break;
+        case '}':
+        case ']':
+            --depth;
+            break;
+        }
+        ++len;
+    }
+
+    if (!len) {
+        LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing value)");
+    }
+    return len;
+}
+
 static int
 store_attrs(struct ly_ctx *ctx, struct attr_cont *attrs, struct lyd_node *first, int options)
 {
@@ -771,9 +815,9 @@ error:
 }
 
 static unsigned int
-json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *schema_parent, struct lyd_node **parent,
-                struct lyd_node *first_sibling, struct lyd_node *prev, struct attr_cont **attrs, int options,
-                struct unres_data *unres, struct lyd_node **act_notif)
+json_parse_data(struct ly_ctx *ctx, const char *data, const char *end, const struct lys_node *schema_parent,
+                struct lyd_node **parent, struct lyd_node *first_sibling, struct lyd_node *prev, struct attr_cont **attrs,
+                int options, struct unres_data *unres, struct lyd_node **act_notif)
 {
     unsigned int len = 0;
     unsigned int r;
@@ -794,7 +838,7 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
     }
     len++;
 
-    str = lyjson_parse_text(&data[len], &r);
+    str = lyjson_parse_text(&data[len], end, &r);
     if (!r) {
         goto error;
     } else if (data[len + r] != '"') {
@@ -818,13 +862,13 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
 
     /* prepare data for parsing node content */
     len += r + 1;
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
     if (data[len] != ':') {
         LOGVAL(LYE_XML_INVAL, LY_VLOG_LYD, (*parent), "JSON data (missing name-separator)");
         goto error;
     }
     len++;
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
 
     if (str[0] == '@' && !str[1]) {
         /* process attribute of the parent object (container or list) */
@@ -833,7 +877,7 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
             goto error;
         }
 
-        r = json_parse_attr((*parent)->schema->module, &attr, &data[len], options);
+        r = json_parse_attr((*parent)->schema->module, &attr, &data[len], end, options);
         if (!r) {
             LOGPATH(LY_VLOG_LYD, *parent);
             goto error;
@@ -929,16 +973,28 @@ json_parse_data(struct ly_ctx *ctx, const char *data, const struct lys_node *sch
         goto error;
     }
 
+    if (unres->select && !lyp_data_selected(unres->select, schema)) {
+        /* not selected to be parsed, skip the value (or the attributes) */
+        r = json_skip_value(&data[len]);
+        if (!r) {
+            goto error;
+        }
+        len += r;
+
+        free(str);
+        return len;
+    }
+
     if (str[0] == '@') {
         /* attribute for some sibling node */
         if (data[len] == '[') {
             flag_leaflist = 1;
             len++;
-            len += skip_ws(&data[len]);
+            len += skip_ws(&data[len], end);
         }
 
 attr_repeat:
-        r = json_parse_attr((struct lys_module *)module, &attr, &data[len], options);
+        r = json_parse_attr((struct lys_module *)module, &attr, &data[len], end, options);
         if (!r) {
             LOGPATH(LY_VLOG_LYD, (*parent));
             goto error;
@@ -958,7 +1014,7 @@ attr_repeat:
         if (flag_leaflist) {
             if (data[len] == ',') {
                 len++;
-                len += skip_ws(&data[len]);
+                len += skip_ws(&data[len], end);
                 flag_leaflist++;
                 goto attr_repeat;
             } else if (data[len] != ']') {
@@ -966,7 +1022,7 @@ attr_repeat:
                 goto error;
             }
             len++;
-            len += skip_ws(&data[len]);
+            len += skip_ws(&data[len], end);
         }
 
         free(str);
@@ -994,6 +1050,7 @@ attr_repeat:
         goto error;
     }
     LY_CHECK_ERR_GOTO(!result, LOGMEM, error);
+    LY_STATS_INC(ctx, node_allocs);
 
     result->prev = result;
     result->schema = schema;
@@ -1045,7 +1102,7 @@ attr_repeat:
     /* type specific processing */
     if (schema->nodetype & (LYS_LEAF | LYS_LEAFLIST)) {
         /* type detection and assigning the value */
-        r = json_get_value((struct lyd_node_leaf_list *)result, &first_sibling, &data[len], options, unres);
+        r = json_get_value((struct lyd_node_leaf_list *)result, &first_sibling, &data[len], end, options, unres);
         if (!r) {
             goto error;
         }
@@ -1054,14 +1111,14 @@ attr_repeat:
         }
 
         len += r;
-        len += skip_ws(&data[len]);
+        len += skip_ws(&data[len], end);
     } else if (schema->nodetype & LYS_ANYDATA) {
-        r = json_get_anydata((struct lyd_node_anydata *)result, &data[len]);
+        r = json_get_anydata((struct lyd_node_anydata *)result, &data[len], end);
         if (!r) {
             goto error;
         }
         len += r;
-        len += skip_ws(&data[len]);
+        len += skip_ws(&data[len], end);
     } else if (schema->nodetype & (LYS_CONTAINER | LYS_RPC | LYS_ACTION | LYS_NOTIF)) {
         if (schema->nodetype & (LYS_RPC | LYS_ACTION)) {
             if (!(options & LYD_OPT_RPC) || *act_notif) {
@@ -1085,7 +1142,7 @@ attr_repeat:
             goto error;
         }
         len++;
-        len += skip_ws(&data[len]);
+        len += skip_ws(&data[len], end);
 
         if (data[len] != '}') {
             /* non-empty container */
@@ -1094,9 +1151,9 @@ attr_repeat:
             attrs_aux = NULL;
             do {
                 len++;
-                len += skip_ws(&data[len]);
+                len += skip_ws(&data[len], end);
 
-                r = json_parse_data(ctx, &data[len], NULL, &result, result->child, diter, &attrs_aux, options, unres, act_notif);
+                r = json_parse_data(ctx, &data[len], end, NULL, &result, result->child, diter, &attrs_aux, options, unres, act_notif);
                 if (!r) {
                     goto error;
                 }
@@ -1118,7 +1175,7 @@ attr_repeat:
             goto error;
         }
         len++;
-        len += skip_ws(&data[len]);
+        len += skip_ws(&data[len], end);
 
         /* if we have empty non-presence container, mark it as default */
         if (schema->nodetype == LYS_CONTAINER && !result->child &&
@@ -1135,7 +1192,7 @@ attr_repeat:
         list = result;
         do {
             len++;
-            len += skip_ws(&data[len]);
+            len += skip_ws(&data[len], end);
 
             if (data[len] != '{') {
                 LOGVAL(LYE_XML_INVAL, LY_VLOG_LYD, result,
@@ -1146,9 +1203,9 @@ attr_repeat:
             attrs_aux = NULL;
             do {
                 len++;
-                len += skip_ws(&data[len]);
+                len += skip_ws(&data[len], end);
 
-                r = json_parse_data(ctx, &data[len], NULL, &list, list->child, diter, &attrs_aux, options, unres, act_notif);
+                r = json_parse_data(ctx, &data[len], end, NULL, &list, list->child, diter, &attrs_aux, options, unres, act_notif);
                 if (!r) {
                     goto error;
                 }
@@ -1171,7 +1228,7 @@ attr_repeat:
                 goto error;
             }
             len++;
-            len += skip_ws(&data[len]);
+            len += skip_ws(&data[len], end);
 
             if (data[len] == ',') {
                 /* various validation checks */
@@ -1190,6 +1247,7 @@ attr_repeat:
                 /* another instance of the list */
                 new = calloc(1, sizeof *new);
                 LY_CHECK_ERR_GOTO(!new, LOGMEM, error);
+                LY_STATS_INC(ctx, node_allocs);
                 new->parent = list->parent;
                 new->prev = list;
                 list->next = new;
@@ -1212,7 +1270,7 @@ attr_repeat:
             goto error;
         }
         len++;
-        len += skip_ws(&data[len]);
+        len += skip_ws(&data[len], end);
     }
 
     /* various validation checks */
@@ -1266,14 +1324,16 @@ error:
 
 struct lyd_node *
 lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct lyd_node *rpc_act,
-               const struct lyd_node *data_tree)
+               const struct lyd_node *data_tree, const struct ly_set *select)
 {
     struct lyd_node *result = NULL, *next, *iter, *reply_parent = NULL, *reply_top = NULL, *act_notif = NULL;
     struct unres_data *unres = NULL;
+    const char *end;
     unsigned int len = 0, r;
     int i, act_cont = 0;
     struct attr_cont *attrs = NULL;
     struct ly_set *set;
+    uint64_t start = 0;
 
     ly_err_clean(ly_parser_data.ctx, 1);
 
@@ -1281,9 +1341,10 @@ lyd_parse_json(struct ly_ctx *ctx, const char *data, int options, const struct l
         LOGERR(LY_EINVAL, "%s: Invalid parameter.", __func__);
         return NULL;
     }
+    end = data + strlen(data);
 
     /* skip leading whitespaces */
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
 
     /* no data (or whitespaces only) are fine */
     if (!data[len]) {
@@ -1303,13 +1364,19 @@ empty:
 
     /* check for empty object */
     r = len + 1;
-    r += skip_ws(&data[r]);
+    r += skip_ws(&data[r], end);
     if (data[r] == '}') {
         goto empty;
     }
 
     unres = calloc(1, sizeof *unres);
     LY_CHECK_ERR_RETURN(!unres, LOGMEM, NULL);
+    if (select) {
+        unres->select = lyp_select_new(select);
+        if (!unres->select) {
+            goto error;
+        }
+    }
 
     /* create RPC/action reply part that is not in the parsed data */
     if (rpc_act) {
@@ -1334,28 +1401,29 @@ empty:
         }
     }
 
+    LY_STATS_TIMER_START(ctx, start);
     iter = NULL;
     next = reply_parent;
     do {
         len++;
-        len += skip_ws(&data[len]);
+        len += skip_ws(&data[len], end);
 
         if (!act_cont) {
             if (!strncmp(&data[len], "\"yang:action\"", 13)) {
                 len += 13;
-                len += skip_ws(&data[len]);
+                len += skip_ws(&data[len], end);
                 if (data[len] != ':') {
                     LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing top-level begin-object)");
                     goto error;
                 }
                 ++len;
-                len += skip_ws(&data[len]);
+                len += skip_ws(&data[len], end);
                 if (data[len] != '{') {
                     LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "JSON data (missing top level yang:action object)");
                     goto error;
                 }
                 ++len;
-                len += skip_ws(&data[len]);
+                len += skip_ws(&data[len], end);
 
                 act_cont = 1;
             } else {
@@ -1363,7 +1431,7 @@ empty:
             }
         }
 
-        r = json_parse_data(ctx, &data[len], NULL, &next, result, iter, &attrs, options, unres, &act_notif);
+        r = json_parse_data(ctx, &data[len], end, NULL, &next, result, iter, &attrs, options, unres, &act_notif);
         if (!r) {
             goto error;
         }
@@ -1396,7 +1464,7 @@ empty:
         goto error;
     }
     len++;
-    len += skip_ws(&data[len]);
+    len += skip_ws(&data[len], end);
 
     if (act_cont == 1) {
         if (data[len] != '}') {
@@ -1404,19 +1472,20 @@ empty:
             goto error;
         }
         len++;
-        len += skip_ws(&data[len]);
+        len += skip_ws(&data[len], end);
     }
 
     /* store attributes */
     if (store_attrs(ctx, attrs, result, options)) {
         goto error;
     }
+    LY_STATS_TIMER_STOP(ctx, start, time_parse);
 
     if (reply_top) {
         result = reply_top;
     }
 
-    if (!result) {
+    if (!result && !select) {
         LOGERR(LY_EVALID, "Model for the data to be linked with not found.");
         goto error;
     }
@@ -1453,6 +1522,11 @@ empty:
             continue;
         }
 
+        if (unres->select && (lyp_data_selected(unres->select, iter->schema) != 2)) {
+            /* only an ancestor of the selected nodes, its instances are not complete */
+            continue;
+        }
+
         if (lyv_data_unique(iter, result)) {
             ly_set_free(set);
             goto error;
@@ -1467,23 +1541,31 @@ empty:
 
     /* check for missing top level mandatory nodes */
     if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER))
-            && lyd_check_mandatory_tree((act_notif ? act_notif : result), ctx, options)) {
+            && lyd_check_mandatory_tree((act_notif ? act_notif : result), ctx, options, unres->select)) {
         goto error;
     }
 
+    if (select) {
+        /* remove the defaults added out of the selection and the ancestors with nothing selected inside */
+        lyp_data_select_prune(reply_parent ? &reply_parent->child : &result, unres->select);
+    }
+
     free(unres->node);
     free(unres->type);
+    lyp_select_free(unres->select);
     free(unres);
 
     return result;
 
 error:
+    LY_STATS_TIMER_STOP(ctx, start, time_parse);
     lyd_free_withsiblings(result);
     if (reply_top && result != reply_top) {
         lyd_free_withsiblings(reply_top);
     }
     free(unres->node);
     free(unres->type);
+    lyp_select_free(unres->select);
     free(unres);
 
     return NULL;
@@ -28,6 +28,9 @@
 #include "validation.h"
 #include "xml_internal.h"
 
+/* schema node types whose data instances have children */
+#define XML_DATA_INNER (LYS_CONTAINER | LYS_LIST | LYS_NOTIF | LYS_RPC | LYS_ACTION)
+
 /* does not log */
 static struct lys_node *
 xml_data_search_schemanode(struct lyxml_elem *xml, struct lys_node *start, int options)
@@ -111,26 +114,16 @@ xml_get_value(struct lyd_node *node, struct lyxml_elem *xml, int editbits)
     return EXIT_SUCCESS;
 }
 
-/* logs directly */
+/* logs directly, returns -1 on error, 0 if the element is supposed to be ignored and 1 if its schema node was found */
 static int
-xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *parent, struct lyd_node *first_sibling,
-               struct lyd_node *prev, int options, struct unres_data *unres, struct lyd_node **result,
-               struct lyd_node **act_notif)
+xml_data_schema(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *parent, int options,
+                struct lyp_select *select, struct lys_node **result)
 {
     const struct lys_module *mod = NULL;
-    struct lyd_node *diter, *dlast;
     struct lys_node *schema = NULL, *target;
     struct lys_node_augment *aug;
-    struct lyd_attr *dattr, *dattr_iter;
-    struct lyxml_attr *attr;
-    struct lyxml_elem *child, *next;
-    int i, j, havechildren, r, editbits = 0, pos, filterflag = 0, found;
-    int ret = 0;
-    const char *str = NULL;
-    char *msg;
+    int j;
 
-    assert(xml);
-    assert(result);
     *result = NULL;
 
     if (xml->flags & LYXML_ELEM_MIXED) {
@@ -220,6 +213,45 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
         }
     }
 
+    if (select && !lyp_data_selected(select, schema)) {
+        /* not selected to be parsed */
+        return 0;
+    }
+
+    *result = schema;
+    return 1;
+}
+
+/* does not log, removes the node being parsed from the tree together with its unresolved items */
+static void
+xml_parse_data_free(struct unres_data *unres, struct lyd_node **result)
+{
+    int i;
+
+    for (i = unres->count - 1; i >= 0; i--) {
+        /* remove unres items connected with the node being removed */
+        if (unres->node[i] == *result) {
+            unres_data_del(unres, i);
+        }
+    }
+    lyd_free(*result);
+    *result = NULL;
+}
+
+/* logs directly, creates the node and does everything that does not depend on its children */
+static int
+xml_parse_data_open(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lys_node *schema, struct lyd_node *parent,
+                    struct lyd_node **first_sibling, struct lyd_node *prev, int options, struct unres_data *unres,
+                    struct lyd_node **result, struct lyd_node **act_notif)
+{
+    struct lyd_node *diter;
+    struct lyd_attr *dattr, *dattr_iter;
+    struct lyxml_attr *attr;
+    struct lyxml_elem *child, *next;
+    int i, r, editbits = 0, pos, filterflag = 0, found;
+    const char *str = NULL;
+    char *msg;
+
     /* create the element structure */
     switch (schema->nodetype) {
     case LYS_CONTAINER:
@@ -236,23 +268,21 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
             return -1;
         }
         *result = calloc(1, sizeof **result);
-        havechildren = 1;
         break;
     case LYS_LEAF:
     case LYS_LEAFLIST:
         *result = calloc(1, sizeof(struct lyd_node_leaf_list));
-        havechildren = 0;
         break;
     case LYS_ANYXML:
     case LYS_ANYDATA:
         *result = calloc(1, sizeof(struct lyd_node_anydata));
-        havechildren = 0;
         break;
     default:
         LOGINT;
         return -1;
     }
     LY_CHECK_ERR_RETURN(!(*result), LOGMEM, -1);
+    LY_STATS_INC(ctx, node_allocs);
 
     (*result)->prev = *result;
     (*result)->schema = schema;
@@ -280,7 +310,7 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
             if (parent->child == diter) {
                 parent->child = *result;
                 /* update first_sibling */
-                first_sibling = *result;
+                *first_sibling = *result;
             }
             if (diter->prev->next) {
                 diter->prev->next = *result;
@@ -300,10 +330,10 @@ xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *pare
             prev->next = *result;
 
             /* fix the "last" pointer */
-            first_sibling->prev = *result;
+            (*first_sibling)->prev = *result;
         } else {
             (*result)->prev = *result;
-            first_sibling = *result;
+            *first_sibling = *result;
         }
     }
     (*result)->validity = ly_new_node_validity((*result)->schema);
@@ -494,13 +524,75 @@ attr_error:
         goto error;
     }
 
+    return 0;
+
+error:
+    xml_parse_data_free(unres, result);
+    return -1;
+}
+
+/* logs directly, finishes the node after all its children were parsed */
+static int
+xml_parse_data_close(struct lyd_node **first_sibling, struct lyd_node *prev, int options, struct unres_data *unres,
+                     struct lyd_node **result)
+{
+    struct lys_node *schema = (*result)->schema;
+
+    /* if we have empty non-presence container, we keep it, but mark it as default */
+    if (schema->nodetype == LYS_CONTAINER && !(*result)->child &&
+            !(*result)->attr && !((struct lys_node_container *)schema)->presence) {
+        (*result)->dflt = 1;
+    }
+
+    /* rest of validation checks */
+    ly_err_clean(ly_parser_data.ctx, 1);
+    if (lyv_data_content(*result, options, unres) ||
+             lyv_multicases(*result, NULL, prev ? first_sibling : NULL, 0, NULL)) {
+        xml_parse_data_free(unres, result);
+        return ly_errno ? -1 : 0;
+    }
+
+    /* validation successful */
+    if ((*result)->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) {
+        /* postpone checking when there will be all list/leaflist instances */
+        (*result)->validity |= LYD_VAL_UNIQUE;
+    }
+
+    return 0;
+}
+
+/* logs directly */
+static int
+xml_parse_data(struct ly_ctx *ctx, struct lyxml_elem *xml, struct lyd_node *parent, struct lyd_node *first_sibling,
+               struct lyd_node *prev, int options, struct unres_data *unres, struct lyd_node **result,
+               struct lyd_node **act_notif)
+{
+    struct lys_node *schema;
+    struct lyd_node *diter, *dlast;
+    struct lyxml_elem *child, *next;
+    int r;
+
+    assert(xml);
+    assert(result);
+    *result = NULL;
+
+    r = xml_data_schema(ctx, xml, parent, options, unres->select, &schema);
+    if (r < 1) {
+        return r;
+    }
+
+    if (xml_parse_data_open(ctx, xml, schema, parent, &first_sibling, prev, options, unres, result, act_notif)) {
+        return -1;
+    }
+
     /* process children */
-    if (havechildren && xml->child) {
+    if ((schema->nodetype & XML_DATA_INNER) && xml->child) {
         diter = dlast = NULL;
         LY_TREE_FOR_SAFE(xml->child, next, child) {
             r = xml_parse_data(ctx, child, *result, (*result)->child, dlast, options, unres, &diter, act_notif);
             if (r) {
-                goto error;
+                xml_parse_data_free(unres, result);
+                return -1;
             } else if (options & LYD_OPT_DESTRUCT) {
                 lyxml_free(ctx, child);
             }
@@ -512,59 +604,129 @@ attr_error:
         }
     }
 
-    /* if we have empty non-presence container, we keep it, but mark it as default */
-    if (schema->nodetype == LYS_CONTAINER && !(*result)->child &&
-            !(*result)->attr && !((struct lys_node_container *)schema)->presence) {
-        (*result)->dflt = 1;
-    }
+    return xml_parse_data_close(&first_sibling, prev, options, unres, result);
+}
 
-    /* rest of validation checks */
-    ly_err_clean(ly_parser_data.ctx, 1);
-    if (lyv_data_content(*result, options, unres) ||
-             lyv_multicases(*result, NULL, prev ? &first_sibling : NULL, 0, NULL)) {
-        if (ly_errno) {
-            goto error;
-        } else {
-            goto clear;
+/* logs directly, connects the RPC/action reply nodes to the copy of their request */
+static int
+xml_parse_reply_tree(const struct lyd_node *rpc_act, struct lyd_node **reply_top, struct lyd_node **reply_parent)
+{
+    struct lyd_node *iter;
+
+    if (rpc_act->schema->nodetype == LYS_RPC) {
+        /* RPC request */
+        *reply_top = *reply_parent = _lyd_new(NULL, rpc_act->schema, 0);
+    } else {
+        /* action request */
+        *reply_top = lyd_dup(rpc_act, 1);
+        LY_TREE_DFS_BEGIN(*reply_top, iter, *reply_parent) {
+            if ((*reply_parent)->schema->nodetype == LYS_ACTION) {
+                break;
+            }
+            LY_TREE_DFS_END(*reply_top, iter, *reply_parent);
         }
+        if (!*reply_parent) {
+            LOGERR(LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
+            lyd_free_withsiblings(*reply_top);
+            *reply_top = NULL;
+            return -1;
+        }
+        lyd_free_withsiblings((*reply_parent)->child);
     }
 
-    /* validation successful */
-    if ((*result)->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) {
-        /* postpone checking when there will be all list/leaflist instances */
-        (*result)->validity |= LYD_VAL_UNIQUE;
+    return 0;
+}
+
+/* logs directly, finishes the tree once all the top-level elements were parsed, on error the caller is
+ * supposed to free the (possibly changed) result */
+static int
+xml_parse_finalize(struct ly_ctx *ctx, int options, const struct lyd_node *rpc_act, const struct lyd_node *data_tree,
+                   struct lyd_node *reply_top, struct lyd_node *reply_parent, struct lyd_node *act_notif,
+                   struct unres_data *unres, struct lyd_node **result)
+{
+    struct lyd_node *iter;
+    struct ly_set *set;
+    int i;
+
+    if (reply_top) {
+        *result = reply_top;
     }
 
-    return ret;
+    if ((options & LYD_OPT_RPCREPLY) && (rpc_act->schema->nodetype != LYS_RPC)) {
+        /* action reply */
+        act_notif = reply_parent;
+    } else if ((options & (LYD_OPT_RPC | LYD_OPT_NOTIF)) && !act_notif) {
+        ly_vecode = LYVE_INELEM;
+        LOGVAL(LYE_SPEC, LY_VLOG_LYD, *result, "Missing %s node.", (options & LYD_OPT_RPC ? "action" : "notification"));
+        return -1;
+    }
 
-error:
-    ret--;
+    /* add missing ietf-yang-library if requested */
+    if (options & LYD_OPT_DATA_ADD_YANGLIB) {
+        if (!*result) {
+            *result = ly_ctx_info(ctx);
+        } else if (lyd_merge(*result, ly_ctx_info(ctx), LYD_OPT_DESTRUCT | LYD_OPT_EXPLICIT)) {
+            LOGERR(LY_EINT, "Adding ietf-yang-library data failed.");
+            return -1;
+        }
+    }
 
-clear:
-    /* cleanup */
-    for (i = unres->count - 1; i >= 0; i--) {
-        /* remove unres items connected with the node being removed */
-        if (unres->node[i] == *result) {
-            unres_data_del(unres, i);
+    /* check for uniqueness of top-level lists/leaflists because
+     * only the inner instances were tested in lyv_data_content() */
+    set = ly_set_new();
+    LY_TREE_FOR(*result, iter) {
+        if (!(iter->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) || !(iter->validity & LYD_VAL_UNIQUE)) {
+            continue;
+        }
+
+        /* check each list/leaflist only once */
+        i = set->number;
+        if (ly_set_add(set, iter->schema, 0) != i) {
+            /* already checked */
+            continue;
+        }
+
+        if (unres->select && (lyp_data_selected(unres->select, iter->schema) != 2)) {
+            /* only an ancestor of the selected nodes, its instances are not complete */
+            continue;
+        }
+
+        if (lyv_data_unique(iter, *result)) {
+            ly_set_free(set);
+            return -1;
         }
     }
-    lyd_free(*result);
-    *result = NULL;
+    ly_set_free(set);
+
+    /* add default values, resolve unres and check for mandatory nodes in final tree */
+    if (lyd_defaults_add_unres(result, options, ctx, data_tree, act_notif, unres)) {
+        return -1;
+    }
+    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER))
+            && lyd_check_mandatory_tree((act_notif ? act_notif : *result), ctx, options, unres->select)) {
+        return -1;
+    }
+
+    if (unres->select) {
+        /* remove the defaults added out of the selection and the ancestors with nothing selected inside */
+        lyp_data_select_prune(reply_parent ? &reply_parent->child : result, unres->select);
+    }
 
-    return ret;
+    return 0;
 }
 
 API struct lyd_node *
 lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
 {
     va_list ap;
-    int r, i;
+    int r;
     struct unres_data *unres = NULL;
     const struct lyd_node *rpc_act = NULL, *data_tree = NULL;
+    const struct ly_set *select;
     struct lyd_node *result = NULL, *iter, *last, *reply_parent = NULL, *reply_top = NULL, *act_notif = NULL;
     struct lyxml_elem *xmlstart, *xmlelem, *xmlaux, *xmlfree = NULL;
-    struct ly_set *set;
     struct ly_ctx *ctx_prev = ly_parser_data.ctx;
+    uint64_t start = 0;
 
     ly_err_clean(ctx, 1);
 
@@ -608,24 +770,8 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
             LOGERR(LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
             goto error;
         }
-        if (rpc_act->schema->nodetype == LYS_RPC) {
-            /* RPC request */
-            reply_top = reply_parent = _lyd_new(NULL, rpc_act->schema, 0);
-        } else {
-            /* action request */
-            reply_top = lyd_dup(rpc_act, 1);
-            LY_TREE_DFS_BEGIN(reply_top, iter, reply_parent) {
-                if (reply_parent->schema->nodetype == LYS_ACTION) {
-                    break;
-                }
-                LY_TREE_DFS_END(reply_top, iter, reply_parent);
-            }
-            if (!reply_parent) {
-                LOGERR(LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
-                lyd_free_withsiblings(reply_top);
-                goto error;
-            }
-            lyd_free_withsiblings(reply_parent->child);
+        if (xml_parse_reply_tree(rpc_act, &reply_top, &reply_parent)) {
+            goto error;
         }
     }
     if (options & (LYD_OPT_RPC | LYD_OPT_NOTIF | LYD_OPT_RPCREPLY)) {
@@ -655,6 +801,17 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
             }
         }
     }
+    if (options & LYD_OPT_SELECT) {
+        select = va_arg(ap, const struct ly_set *);
+        if (!select) {
+            LOGERR(LY_EINVAL, "%s: invalid variable parameter (const struct ly_set *select).", __func__);
+            goto error;
+        }
+        unres->select = lyp_select_new(select);
+        if (!unres->select) {
+            goto error;
+        }
+    }
 
     if ((*root) && !(options & LYD_OPT_NOSIBLINGS)) {
         /* locate the first root to process */
@@ -680,6 +837,7 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
         }
     }
 
+    LY_STATS_TIMER_START(ctx, start);
     iter = last = NULL;
     LY_TREE_FOR_SAFE(xmlstart, xmlaux, xmlelem) {
         r = xml_parse_data(ctx, xmlelem, reply_parent, result, last, options, unres, &iter, &act_notif);
@@ -708,58 +866,9 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
             break;
         }
     }
+    LY_STATS_TIMER_STOP(ctx, start, time_parse);
 
-    if (reply_top) {
-        result = reply_top;
-    }
-
-    if ((options & LYD_OPT_RPCREPLY) && (rpc_act->schema->nodetype != LYS_RPC)) {
-        /* action reply */
-        act_notif = reply_parent;
-    } else if ((options & (LYD_OPT_RPC | LYD_OPT_NOTIF)) && !act_notif) {
-        ly_vecode = LYVE_INELEM;
-        LOGVAL(LYE_SPEC, LY_VLOG_LYD, result, "Missing %s node.", (options & LYD_OPT_RPC ? "action" : "notification"));
-        goto error;
-    }
-
-    /* add missing ietf-yang-library if requested */
-    if (options & LYD_OPT_DATA_ADD_YANGLIB) {
-        if (!result) {
-            result = ly_ctx_info(ctx);
-        } else if (lyd_merge(result, ly_ctx_info(ctx), LYD_OPT_DESTRUCT | LYD_OPT_EXPLICIT)) {
-            LOGERR(LY_EINT, "Adding ietf-yang-library data failed.");
-            goto error;
-        }
-    }
-
-    /* check for uniqueness of top-level lists/leaflists because
-     * only the inner instances were tested in lyv_data_content() */
-    set = ly_set_new();
-    LY_TREE_FOR(result, iter) {
-        if (!(iter->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) || !(iter->validity & LYD_VAL_UNIQUE)) {
-            continue;
-        }
-
-        /* check each list/leaflist only once */
-        i = set->number;
-        if (ly_set_add(set, iter->schema, 0) != i) {
-            /* already checked */
-            continue;
-        }
-
-        if (lyv_data_unique(iter, result)) {
-            ly_set_free(set);
-            goto error;
-        }
-    }
-    ly_set_free(set);
-
-    /* add default values, resolve unres and check for mandatory nodes in final tree */
-    if (lyd_defaults_add_unres(&result, options, ctx, data_tree, act_notif, unres)) {
-        goto error;
-    }
-    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER))
-            && lyd_check_mandatory_tree((act_notif ? act_notif : result), ctx, options)) {
+    if (xml_parse_finalize(ctx, options, rpc_act, data_tree, reply_top, reply_parent, act_notif, unres, &result)) {
         goto error;
     }
 
@@ -768,6 +877,7 @@ lyd_parse_xml(struct ly_ctx *ctx, struct lyxml_elem **root, int options, ...)
     }
     free(unres->node);
     free(unres->type);
+    lyp_select_free(unres->select);
     free(unres);
     va_end(ap);
 
@@ -778,12 +888,14 @@ success:
     return result;
 
 error:
+    LY_STATS_TIMER_STOP(ctx, start, time_parse);
     lyd_free_withsiblings(result);
     if (xmlfree) {
         lyxml_free(ctx, xmlfree);
     }
     free(unres->node);
     free(unres->type);
+    lyp_select_free(unres->select);
     free(unres);
     va_end(ap);
 
@@ -792,3 +904,568 @@ error:
 
     return NULL;
 }
+
+/*
+ * incremental (push) parser
+ */
+
+#define XML_PUSH_NODE 0     /* element of a data node */
+#define XML_PUSH_SKIP 1     /* ignored element, all its descendants are ignored as well */
+#define XML_PUSH_ACTION 2   /* yang:action wrapper of an action */
+
+struct xml_push_frame {
+    struct lyxml_elem *xml;     /* start tag of the element parsed as an empty element, child of the parent frame's xml */
+    char *name;                 /* qualified name as used in the start tag */
+    struct lyd_node *node;      /* data node of the element */
+    struct lyd_node *prev;      /* last sibling of the node when the node was created */
+    struct lyd_node *last;      /* last child of the node parsed in the correct order */
+    uint8_t type;
+};
+
+/* does not log, returns 1 if data starts with str, 0 if not and -1 if there is not enough data to decide */
+static int
+xml_push_match(const char *data, size_t len, const char *str)
+{
+    size_t i;
+
+    for (i = 0; str[i]; ++i) {
+        if (i == len) {
+            return -1;
+        } else if (data[i] != str[i]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* does not log, returns length of data up to the end of endstr, 0 if it is not there (yet) */
+static size_t
+xml_push_find(const char *data, const char *endstr)
+{
+    const char *end;
+
+    end = strstr(data, endstr);
+    return end ? (end - data) + strlen(endstr) : 0;
+}
+
+/* does not log, returns length of the tag starting in data, 0 if it is incomplete */
+static size_t
+xml_push_tag(const char *data, size_t len)
+{
+    size_t i;
+    char quot = 0;
+
+    for (i = 1; i < len; ++i) {
+        if (quot) {
+            if (data[i] == quot) {
+                quot = 0;
+            }
+        } else if ((data[i] == '"') || (data[i] == '\'')) {
+            quot = data[i];
+        } else if (data[i] == '>') {
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+/* does not log, returns length of the whole element starting in data, 0 if it is incomplete,
+ * the markup itself is checked later by lyxml_parse_elem() */
+static size_t
+xml_push_elem(const char *data, size_t len)
+{
+    const char *c;
+    size_t i = 0, l;
+    int depth = 0;
+
+    while ((c = memchr(data + i, '<', len - i))) {
+        i = c - data;
+        if (xml_push_match(c, len - i, "<!--") == 1) {
+            l = xml_push_find(c, "-->");
+        } else if (xml_push_match(c, len - i, "<![CDATA[") == 1) {
+            l = xml_push_find(c, "]]>");
+        } else if ((xml_push_match(c, len - i, "<!--") == -1) || (xml_push_match(c, len - i, "<![CDATA[") == -1)) {
+            /* cannot decide yet */
+            l = 0;
+        } else if (xml_push_match(c, len - i, "<?") == 1) {
+            l = xml_push_find(c, "?>");
+        } else if (xml_push_match(c, len - i, "</") == 1) {
+            l = xml_push_tag(c, len - i);
+            if (l && !--depth) {
+                return i + l;
+            }
+        } else {
+            l = xml_push_tag(c, len - i);
+            if (l && (c[l - 2] != '/')) {
+                ++depth;
+            } else if (l && !depth) {
+                /* empty element */
+                return i + l;
+            }
+        }
+        if (!l) {
+            break;
+        }
+        i += l;
+    }
+
+    return 0;
+}
+
+static struct xml_push_frame *
+xml_push_frame_add(struct lyd_parse_push *push, struct lyxml_elem *xml, const char *tag, uint8_t type)
+{
+    struct xml_push_frame *frame;
+    size_t len;
+
+    if (push->frame_count == push->frame_size) {
+        frame = realloc(push->frames, (push->frame_size ? push->frame_size * 2 : 8) * sizeof *frame);
+        LY_CHECK_ERR_RETURN(!frame, LOGMEM, NULL);
+        push->frames = frame;
+        push->frame_size = push->frame_size ? push->frame_size * 2 : 8;
+    }
+
+    frame = &push->frames[push->frame_count];
+    memset(frame, 0, sizeof *frame);
+    for (len = 1; tag[len] && !is_xmlws(tag[len]) && (tag[len] != '/') && (tag[len] != '>'); ++len);
+    frame->name = strndup(tag + 1, len - 1);
+    LY_CHECK_ERR_RETURN(!frame->name, LOGMEM, NULL);
+    frame->xml = xml;
+    frame->type = type;
+    ++push->frame_count;
+
+    return frame;
+}
+
+/* the (top-level or child) node was completely parsed, NULL if it was ignored or removed */
+static void
+xml_push_node_done(struct lyd_parse_push *push, struct xml_push_frame *frame, struct lyd_node *node)
+{
+    if (frame && (frame->type == XML_PUSH_NODE)) {
+        if (node && !node->next) {
+            /* the child was parsed/created and it was placed as the last child. The child can be inserted
+             * out of order (not as the last one) in case it is a list's key present out of the correct order */
+            frame->last = node;
+        }
+        return;
+    }
+
+    /* top-level node */
+    ++push->roots;
+    if (node) {
+        push->last = node;
+        if (!push->result) {
+            push->result = node;
+        }
+        if ((push->options & LYD_OPT_DATA_ADD_YANGLIB)
+                && (node->schema->module == push->ctx->models.list[push->ctx->internal_module_count - 1])) {
+            /* ietf-yang-library data present, so ignore the option to add them */
+            push->options &= ~LYD_OPT_DATA_ADD_YANGLIB;
+        }
+    }
+    if (!frame && (push->options & LYD_OPT_NOSIBLINGS)) {
+        /* stop after the first processed root */
+        push->ignore = 1;
+    }
+}
+
+/* logs directly, data points to the start tag of an element, returns number of processed bytes, 0 if more data are needed */
+static int
+xml_push_elem_start(struct lyd_parse_push *push, const char *data, size_t len, int finish, size_t *processed)
+{
+    struct ly_ctx *ctx = push->ctx;
+    struct xml_push_frame *frame;
+    struct lyxml_elem *xml;
+    struct lys_node *schema;
+    struct lyd_node *parent, *first, *prev, *node = NULL;
+    unsigned int xlen;
+    size_t l, elen;
+    int selfclosed, r;
+    char *tag;
+
+    *processed = 0;
+    frame = push->frame_count ? &push->frames[push->frame_count - 1] : NULL;
+
+    if (!finish && (len < push->wait)) {
+        /* there is still not enough data for the element being waited for */
+        return 0;
+    }
+
+    l = xml_push_tag(data, len);
+    if (!l) {
+        return 0;
+    }
+    selfclosed = (data[l - 2] == '/');
+
+    /* parse the start tag alone, a non-empty element is closed to be self-closed (one character longer) */
+    tag = malloc(l + 2);
+    LY_CHECK_ERR_RETURN(!tag, LOGMEM, -1);
+    memcpy(tag, data, l - 1);
+    strcpy(tag + l - 1, selfclosed ? ">" : "/>");
+    xml = lyxml_parse_elem(ctx, tag, tag + (selfclosed ? l : l + 1), &xlen, frame ? frame->xml : NULL, 0);
+    free(tag);
+    if (!xml) {
+        return -1;
+    }
+
+    if (frame && (frame->type == XML_PUSH_SKIP)) {
+        /* the whole subtree is ignored */
+        goto skip;
+    }
+
+    if (!frame && !push->roots && (push->options & LYD_OPT_RPC) && xml->ns && !strcmp(xml->name, "action")
+            && !strcmp(xml->ns->value, "urn:ietf:params:xml:ns:yang:1")) {
+        /* it's an action, not a simple RPC */
+        if (selfclosed) {
+            lyxml_free(ctx, xml);
+        } else if (!xml_push_frame_add(push, xml, data, XML_PUSH_ACTION)) {
+            lyxml_free(ctx, xml);
+            return -1;
+        }
+        *processed = l;
+        return 0;
+    }
+
+    if (frame && (frame->type == XML_PUSH_NODE)) {
+        parent = frame->node;
+        first = parent->child;
+        prev = frame->last;
+    } else {
+        parent = push->reply_parent;
+        first = parent ? parent->child : push->result;
+        prev = push->last;
+    }
+
+    r = xml_data_schema(ctx, xml, parent, push->options, push->unres->select, &schema);
+    if (r == -1) {
+        lyxml_free(ctx, xml);
+        return -1;
+    } else if (!r) {
+        goto skip;
+    }
+
+    if ((schema->nodetype & XML_DATA_INNER) && !selfclosed) {
+        /* create the node now, its children will follow */
+        if (xml_parse_data_open(ctx, xml, schema, parent, &first, prev, push->options, push->unres, &node,
+                                &push->act_notif)) {
+            lyxml_free(ctx, xml);
+            return -1;
+        }
+        if (!parent && !push->result) {
+            push->result = node;
+        }
+        frame = xml_push_frame_add(push, xml, data, XML_PUSH_NODE);
+        if (!frame) {
+            lyxml_free(ctx, xml);
+            return -1;
+        }
+        frame->node = node;
+        frame->prev = prev;
+        *processed = l;
+        return 0;
+    }
+
+    if (!selfclosed) {
+        /* the element is parsed at once, so wait for all of it */
+        lyxml_free(ctx, xml);
+        l = xml_push_elem(data, len);
+        if (!l) {
+            push->wait = len * 2;
+            return 0;
+        }
+        push->wait = 0;
+
+        xml = lyxml_parse_elem(ctx, data, data + len, &xlen, frame ? frame->xml : NULL, 0);
+        if (!xml) {
+            return -1;
+        }
+        if (xml->flags & LYXML_ELEM_MIXED) {
+            if (push->options & LYD_OPT_STRICT) {
+                LOGVAL(LYE_XML_INVAL, LY_VLOG_XML, xml, "XML element with mixed content");
+                lyxml_free(ctx, xml);
+                return -1;
+            }
+            lyxml_free(ctx, xml);
+            xml_push_node_done(push, frame, NULL);
+            *processed = l;
+            return 0;
+        }
+    }
+
+    r = xml_parse_data_open(ctx, xml, schema, parent, &first, prev, push->options, push->unres, &node, &push->act_notif);
+    if (!r) {
+        r = xml_parse_data_close(&first, prev, push->options, push->unres, &node);
+    }
+    lyxml_free(ctx, xml);
+    if (!parent && prev) {
+        /* the first sibling may have been removed (even on error) */
+        push->result = first;
+    }
+    if (r) {
+        return -1;
+    }
+    xml_push_node_done(push, frame, node);
+    *processed = l;
+    return 0;
+
+skip:
+    if (selfclosed) {
+        lyxml_free(ctx, xml);
+        if (!frame || (frame->type == XML_PUSH_ACTION)) {
+            xml_push_node_done(push, frame, NULL);
+        }
+    } else if (push->unres->select && (elen = xml_push_elem(data, len))) {
+        /* with a selection, the skipped content is not checked, so jump over the whole element if available */
+        lyxml_free(ctx, xml);
+        if (!frame || (frame->type == XML_PUSH_ACTION)) {
+            xml_push_node_done(push, frame, NULL);
+        }
+        l = elen;
+    } else if (!xml_push_frame_add(push, xml, data, XML_PUSH_SKIP)) {
+        lyxml_free(ctx, xml);
+        return -1;
+    }
+    *processed = l;
+    return 0;
+}
+
+/* logs directly, data points to an end tag, returns number of processed bytes, 0 if more data are needed */
+static int
+xml_push_elem_end(struct lyd_parse_push *push, const char *data, size_t len, size_t *processed)
+{
+    struct xml_push_frame *frame, *parent_frame;
+    struct lyd_node *node, *parent, *first;
+    const char *end;
+    size_t l, nlen;
+    int r;
+    char *str;
+
+    *processed = 0;
+
+    end = memchr(data, '>', len);
+    if (!end) {
+        return 0;
+    }
+    l = (end - data) + 1;
+
+    if (!push->frame_count) {
+        LOGVAL(LYE_XML_INCHAR, LY_VLOG_NONE, NULL, data);
+        return -1;
+    }
+    frame = &push->frames[push->frame_count - 1];
+    parent_frame = (push->frame_count > 1) ? &push->frames[push->frame_count - 2] : NULL;
+
+    /* check that it corresponds to the start tag */
+    for (nlen = 0; (nlen < l - 3) && !is_xmlws(data[2 + nlen]); ++nlen);
+    for (r = 2 + nlen; (size_t)r < l - 1; ++r) {
+        if (!is_xmlws(data[r])) {
+            LOGVAL(LYE_SPEC, LY_VLOG_XML, frame->xml, "Data after closing element tag \"%s\".", frame->xml->name);
+            return -1;
+        }
+    }
+    if ((nlen != strlen(frame->name)) || strncmp(data + 2, frame->name, nlen)) {
+        str = strndup(data + 2, nlen);
+        LY_CHECK_ERR_RETURN(!str, LOGMEM, -1);
+        LOGVAL(LYE_SPEC, LY_VLOG_XML, frame->xml, "Invalid (mixed names) opening (%s) and closing (%s) element tags.",
+               frame->name, str);
+        free(str);
+        return -1;
+    }
+
+    r = 0;
+    node = NULL;
+    if (frame->type == XML_PUSH_NODE) {
+        node = frame->node;
+        parent = node->parent;
+        first = parent ? parent->child : push->result;
+        r = xml_parse_data_close(&first, frame->prev, push->options, push->unres, &node);
+        if (!parent) {
+            /* the node may have been removed (freed also on error), as well as the first sibling */
+            push->result = frame->prev ? first : node;
+        }
+    }
+
+    lyxml_free(push->ctx, frame->xml);
+    free(frame->name);
+    --push->frame_count;
+    if (r) {
+        return -1;
+    }
+
+    if ((frame->type != XML_PUSH_ACTION) && (!parent_frame || (parent_frame->type != XML_PUSH_SKIP))) {
+        xml_push_node_done(push, parent_frame, node);
+    }
+    *processed = l;
+    return 0;
+}
+
+int
+xml_push_init(struct lyd_parse_push *push)
+{
+    push->unres = calloc(1, sizeof *push->unres);
+    LY_CHECK_ERR_RETURN(!push->unres, LOGMEM, -1);
+    if (push->select) {
+        push->unres->select = lyp_select_new(push->select);
+        if (!push->unres->select) {
+            return -1;
+        }
+    }
+
+    if ((push->options & LYD_OPT_RPCREPLY)
+            && xml_parse_reply_tree(push->rpc_act, &push->reply_top, &push->reply_parent)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int
+xml_push_parse(struct lyd_parse_push *push, int finish)
+{
+    struct xml_push_frame *frame;
+    const char *data, *c;
+    size_t pos = 0, len, l;
+    int r = 0, m;
+    uint64_t start;
+
+    LY_STATS_TIMER_START(push->ctx, start);
+    while (pos < push->used) {
+        data = push->buf + pos;
+        len = push->used - pos;
+        frame = push->frame_count ? &push->frames[push->frame_count - 1] : NULL;
+        l = 0;
+
+        if (push->ignore) {
+            for (l = 0; (l < len) && is_xmlws(data[l]); ++l);
+            if (l < len) {
+                LOGWRN("There are some not parsed data:\n%s", data + l);
+            }
+            pos = push->used;
+            break;
+        } else if (is_xmlws(*data)) {
+            for (l = 1; (l < len) && is_xmlws(data[l]); ++l);
+        } else if (*data != '<') {
+            /* text content */
+            if (!frame) {
+                LOGVAL(LYE_XML_INCHAR, LY_VLOG_NONE, NULL, data);
+                r = -1;
+                break;
+            } else if ((frame->type == XML_PUSH_NODE) && (push->options & LYD_OPT_STRICT)) {
+                LOGVAL(LYE_XML_INVAL, LY_VLOG_XML, frame->xml, "node with text data");
+                r = -1;
+                break;
+            }
+            c = memchr(data, '<', len);
+            l = c ? (size_t)(c - data) : len;
+        } else if (xml_push_match(data, len, "<?") == 1) {
+            /* XMLDecl or PI - ignore it */
+            l = xml_push_find(data, "?>");
+        } else if ((m = xml_push_match(data, len, "<!--")) == 1) {
+            /* comment - ignore it */
+            l = xml_push_find(data, "-->");
+        } else if ((m == -1) || ((m = xml_push_match(data, len, "<![CDATA[")) == -1)) {
+            /* cannot decide yet */
+        } else if (m == 1) {
+            if (!frame || ((frame->type == XML_PUSH_NODE) && (push->options & LYD_OPT_STRICT))) {
+                LOGVAL(LYE_XML_INVAL, frame ? LY_VLOG_XML : LY_VLOG_NONE, frame ? frame->xml : NULL, "node with text data");
+                r = -1;
+                break;
+            }
+            l = xml_push_find(data, "]]>");
+        } else if (data[1] == '!') {
+            LOGERR(LY_EINVAL, "DOCTYPE not supported in XML documents.");
+            r = -1;
+            break;
+        } else if (data[1] == '/') {
+            r = xml_push_elem_end(push, data, len, &l);
+        } else {
+            r = xml_push_elem_start(push, data, len, finish, &l);
+        }
+
+        if (r) {
+            break;
+        } else if (!l) {
+            /* incomplete, more data are needed */
+            break;
+        }
+        pos += l;
+    }
+    LY_STATS_TIMER_STOP(push->ctx, start, time_parse);
+
+    if (!r && finish && (pos < push->used)) {
+        LOGVAL(LYE_EOF, LY_VLOG_NONE, NULL);
+        r = -1;
+    }
+    if (r) {
+        push->error = 1;
+        return -1;
+    }
+
+    if (pos) {
+        /* drop the processed data */
+        memmove(push->buf, push->buf + pos, push->used - pos + 1);
+        push->used -= pos;
+    }
+
+    return 0;
+}
+
+struct lyd_node *
+xml_push_finish(struct lyd_parse_push *push)
+{
+    struct lyd_node *result = NULL, *reply_top;
+
+    if (xml_push_parse(push, 1)) {
+        return NULL;
+    }
+    if (push->frame_count) {
+        LOGVAL(LYE_XML_MISS, LY_VLOG_XML, push->frames[push->frame_count - 1].xml, "closing element tag",
+               push->frames[push->frame_count - 1].xml->name);
+        push->error = 1;
+        return NULL;
+    }
+
+    if (!push->roots && !(push->options & (LYD_OPT_RPC | LYD_OPT_NOTIF | LYD_OPT_RPCREPLY))) {
+        /* empty tree, just check for missing mandatory nodes */
+        lyd_validate(&result, push->options, push->ctx);
+        return result;
+    }
+
+    /* the tree is passed to the caller */
+    result = push->result;
+    reply_top = push->reply_top;
+    push->result = push->reply_top = NULL;
+    if (xml_parse_finalize(push->ctx, push->options, push->rpc_act, push->data_tree, reply_top, push->reply_parent,
+                           push->act_notif, push->unres, &result)) {
+        lyd_free_withsiblings(result);
+        push->error = 1;
+        return NULL;
+    }
+
+    return result;
+}
+
+void
+xml_push_clean(struct lyd_parse_push *push)
+{
+    uint32_t i;
+
+    if (push->frame_count) {
+        /* all the other frames are its descendants */
+        lyxml_free(push->ctx, push->frames[0].xml);
+    }
+    for (i = 0; i < push->frame_count; ++i) {
+        free(push->frames[i].name);
+    }
+    free(push->frames);
+
+    lyd_free_withsiblings(push->reply_top ? push->reply_top : push->result);
+    if (push->unres) {
+        free(push->unres->node);
+        free(push->unres->type);
+        lyp_select_free(push->unres->select);
+        free(push->unres);
+    }
+}
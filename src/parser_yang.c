@@ -2516,9 +2516,76 @@ store_config_flag(struct lys_node *node, int options)
     return EXIT_SUCCESS;
 }
 
+/* get back the names of the imported modules and the included submodules from the first imp_count and inc_count
+ * stubs */
+static int
+yang_unstub_imports(struct lys_module *module, uint8_t imp_count, uint8_t inc_count)
+{
+    struct lys_module *stub;
+    struct lys_submodule *substub;
+    uint8_t i;
+    int ret = EXIT_SUCCESS;
+
+    for (i = 0; i < imp_count; ++i) {
+        stub = module->imp[i].module;
+        module->imp[i].module = (struct lys_module *)strdup(stub->name);
+        if (!module->imp[i].module) {
+            LOGMEM;
+            ret = EXIT_FAILURE;
+        }
+        lydict_remove(module->ctx, stub->name);
+        free(stub);
+    }
+    for (i = 0; i < inc_count; ++i) {
+        substub = module->inc[i].submodule;
+        module->inc[i].submodule = (struct lys_submodule *)strdup(substub->name);
+        if (!module->inc[i].submodule) {
+            LOGMEM;
+            ret = EXIT_FAILURE;
+        }
+        lydict_remove(module->ctx, substub->name);
+        free(substub);
+    }
+
+    return ret;
+}
+
+int
+yang_stub_imports(struct lys_module *module)
+{
+    struct lys_module *stub;
+    struct lys_submodule *substub;
+    uint8_t i, j = 0;
+
+    for (i = 0; i < module->imp_size; ++i) {
+        stub = calloc(1, sizeof *stub);
+        LY_CHECK_ERR_GOTO(!stub, LOGMEM, error);
+        stub->ctx = module->ctx;
+        stub->name = lydict_insert(module->ctx, (char *)module->imp[i].module, 0);
+        free((char *)module->imp[i].module);
+        module->imp[i].module = stub;
+    }
+    for (j = 0; j < module->inc_size; ++j) {
+        substub = calloc(1, sizeof *substub);
+        LY_CHECK_ERR_GOTO(!substub, LOGMEM, error);
+        substub->ctx = module->ctx;
+        substub->type = 1;
+        substub->belongsto = module;
+        substub->name = lydict_insert(module->ctx, (char *)module->inc[j].submodule, 0);
+        free((char *)module->inc[j].submodule);
+        module->inc[j].submodule = substub;
+    }
+
+    return EXIT_SUCCESS;
+
+error:
+    yang_unstub_imports(module, i, j);
+    return EXIT_FAILURE;
+}
+
 int
 yang_parse_mem(struct lys_module *module, struct lys_submodule *submodule, struct unres_schema *unres,
-               const char *data, unsigned int size_data, struct lys_node **node)
+               const char *data, unsigned int size_data, struct lys_node **node, int flags)
 {
     unsigned int size;
     YY_BUFFER_STATE bp;
@@ -2536,8 +2603,11 @@ yang_parse_mem(struct lys_module *module, struct lys_submodule *submodule, struc
     param.submodule = submodule;
     param.unres = unres;
     param.node = node;
-    param.flags |= YANG_REMOVE_IMPORT;
+    param.flags |= YANG_REMOVE_IMPORT | flags;
     if (yyparse(scanner, &param)) {
+        if (param.flags & YANG_STUB_IMPORT) {
+            yang_unstub_imports(module, module->imp_size, module->inc_size);
+        }
         if (param.flags & YANG_REMOVE_IMPORT) {
             trg = (submodule) ? (struct lys_module *)submodule : module;
             yang_free_import(trg->ctx, trg->imp, 0, trg->imp_size);
@@ -2591,41 +2661,39 @@ yang_parse_ext_substatement(struct lys_module *module, struct unres_schema *unre
     return ret;
 }
 
-struct lys_module *
-yang_read_module(struct ly_ctx *ctx, const char* data, unsigned int size, const char *revision, int implement)
+/* free the module which was not added into the context, logs the error */
+static void
+yang_read_module_error(struct ly_ctx *ctx, struct lys_module *module, struct unres_schema *unres)
 {
+    unres_schema_free(module, &unres, 1);
+    if (!module) {
+        if (ly_vecode != LYVE_SUBMODULE) {
+            LOGERR(ly_errno, "Module parsing failed.");
+        }
+        return;
+    }
 
-    struct lys_module *module = NULL, *tmp_mod;
-    struct unres_schema *unres = NULL;
-    struct lys_node *node = NULL;
-    int ret;
-
-    unres = calloc(1, sizeof *unres);
-    LY_CHECK_ERR_GOTO(!unres, LOGMEM, error);
-
-    module = calloc(1, sizeof *module);
-    LY_CHECK_ERR_GOTO(!module, LOGMEM, error);
+    if (module->name) {
+        LOGERR(ly_errno, "Module \"%s\" parsing failed.", module->name);
+    } else {
+        LOGERR(ly_errno, "Module parsing failed.");
+    }
 
-    /* initiale module */
-    module->ctx = ctx;
-    module->type = 0;
-    module->implemented = (implement ? 1 : 0);
+    lyp_check_circmod_pop(ctx);
+    lys_sub_module_remove_devs_augs(module);
+    lyp_del_includedup(module, 1);
+    lys_free(module, NULL, 0, 1);
+}
 
-    /* add into the list of processed modules */
-    if (lyp_check_circmod_add(module)) {
-        goto error;
-    }
+/* check, resolve and add into the context the module parsed by yang_parse_mem() (exist set if the
+ * module is already in the context), the module is in the list of the processed modules */
+static struct lys_module *
+yang_read_module_finish(struct ly_ctx *ctx, struct lys_module *module, struct unres_schema *unres,
+                        struct lys_node *node, int exist, const char *revision)
+{
+    struct lys_module *tmp_mod;
 
-    ret = yang_parse_mem(module, NULL, unres, data, size, &node);
-    if (ret == -1) {
-        if (ly_vecode == LYVE_SUBMODULE) {
-            free(module);
-            module = NULL;
-        } else {
-            free_yang_common(module, node);
-        }
-        goto error;
-    } else if (ret == 1) {
+    if (exist) {
         assert(!unres->count);
     } else {
         if (yang_check_sub_module(module, unres, node)) {
@@ -2649,7 +2717,7 @@ yang_read_module(struct ly_ctx *ctx, const char* data, unsigned int size, const
     }
 
     /* add into context if not already there */
-    if (!ret) {
+    if (!exist) {
         /* check correctness of includes */
         if (lyp_check_include_missing(module)) {
             goto error;
@@ -2692,26 +2760,146 @@ yang_read_module(struct ly_ctx *ctx, const char* data, unsigned int size, const
     return module;
 
 error:
-    /* cleanup */
-    unres_schema_free(module, &unres, 1);
-    if (!module) {
+    yang_read_module_error(ctx, module, unres);
+    return NULL;
+}
+
+struct lys_module *
+yang_read_module(struct ly_ctx *ctx, const char* data, unsigned int size, const char *revision, int implement)
+{
+    struct lys_module *module = NULL;
+    struct unres_schema *unres = NULL;
+    struct lys_node *node = NULL;
+    int ret;
+
+    unres = calloc(1, sizeof *unres);
+    LY_CHECK_ERR_GOTO(!unres, LOGMEM, error);
+
+    module = calloc(1, sizeof *module);
+    LY_CHECK_ERR_GOTO(!module, LOGMEM, error);
+
+    /* initiale module */
+    module->ctx = ctx;
+    module->type = 0;
+    module->implemented = (implement ? 1 : 0);
+
+    /* add into the list of processed modules */
+    if (lyp_check_circmod_add(module)) {
+        goto error;
+    }
+
+    ret = yang_parse_mem(module, NULL, unres, data, size, &node, 0);
+    if (ret == -1) {
+        if (ly_vecode == LYVE_SUBMODULE) {
+            free(module);
+            module = NULL;
+        } else {
+            free_yang_common(module, node);
+        }
+        goto error;
+    }
+
+    return yang_read_module_finish(ctx, module, unres, node, ret, revision);
+
+error:
+    yang_read_module_error(ctx, module, unres);
+    return NULL;
+}
+
+int
+yang_parse_module_only(struct ly_ctx *ctx, const char *data, struct lys_module **module, struct unres_schema **unres,
+                       struct lys_node **node)
+{
+    *node = NULL;
+    *unres = calloc(1, sizeof **unres);
+    *module = calloc(1, sizeof **module);
+    if (!*unres || !*module) {
+        LOGMEM;
+        goto error;
+    }
+    (*module)->ctx = ctx;
+    (*module)->type = 0;
+
+    if (yang_parse_mem(*module, NULL, *unres, data, 0, node, YANG_PARSE_ONLY)) {
         if (ly_vecode != LYVE_SUBMODULE) {
-            LOGERR(ly_errno, "Module parsing failed.");
+            free_yang_common(*module, *node);
         }
-        return NULL;
+        goto error;
     }
 
-    if (module->name) {
-        LOGERR(ly_errno, "Module \"%s\" parsing failed.", module->name);
+    return EXIT_SUCCESS;
+
+error:
+    unres_schema_free(*module, unres, 1);
+    if (*module && (ly_vecode != LYVE_SUBMODULE)) {
+        lys_free(*module, NULL, 0, 1);
     } else {
-        LOGERR(ly_errno, "Module parsing failed.");
+        free(*module);
     }
+    *module = NULL;
+    *node = NULL;
+    return EXIT_FAILURE;
+}
 
-    lyp_check_circmod_pop(ctx);
-    lys_sub_module_remove_devs_augs(module);
-    lyp_del_includedup(module, 1);
+/* free the module parsed by yang_parse_module_only() with the names of the imported modules */
+static void
+yang_free_parsed(struct lys_module *module, struct unres_schema *unres, struct lys_node *node)
+{
+    yang_free_import(module->ctx, module->imp, 0, module->imp_size);
+    yang_free_include(module->ctx, module->inc, 0, module->inc_size);
+    module->imp_size = 0;
+    module->inc_size = 0;
+    free_yang_common(module, node);
+    unres_schema_free(module, &unres, 1);
     lys_free(module, NULL, 0, 1);
-    return NULL;
+}
+
+struct lys_module *
+yang_read_module_parsed(struct ly_ctx *ctx, struct lys_module *module, struct unres_schema *unres,
+                        struct lys_node *node, const char *revision, int implement)
+{
+    int exist;
+
+    if (yang_unstub_imports(module, module->imp_size, module->inc_size)) {
+        yang_free_parsed(module, unres, node);
+        return NULL;
+    }
+    module->implemented = (implement ? 1 : 0);
+
+    /* add into the list of processed modules */
+    if (lyp_check_circmod_add(module)) {
+        exist = -1;
+    } else {
+        /* the parser skipped the checks of the module header with respect to the context */
+        exist = lyp_ctx_check_module(module);
+    }
+
+    if (exist) {
+        /* the imports are not filled yet */
+        yang_free_import(ctx, module->imp, 0, module->imp_size);
+        yang_free_include(ctx, module->inc, 0, module->inc_size);
+        module->imp_size = 0;
+        module->inc_size = 0;
+        free_yang_common(module, node);
+        if (exist == -1) {
+            yang_read_module_error(ctx, module, unres);
+            return NULL;
+        }
+        node = NULL;
+    } else if (yang_check_imports(module, unres)) {
+        free_yang_common(module, node);
+        yang_read_module_error(ctx, module, unres);
+        return NULL;
+    }
+
+    return yang_read_module_finish(ctx, module, unres, node, exist, revision);
+}
+
+void
+yang_free_module_parsed(struct lys_module *module, struct unres_schema *unres, struct lys_node *node)
+{
+    yang_unstub_imports(module, module->imp_size, module->inc_size);
+    yang_free_parsed(module, unres, node);
 }
 
 struct lys_submodule *
@@ -2734,7 +2922,7 @@ yang_read_submodule(struct lys_module *module, const char *data, unsigned int si
     }
 
     /* module cannot be changed in this case and 1 cannot be returned */
-    if (yang_parse_mem(module, submodule, unres, data, size, &node)) {
+    if (yang_parse_mem(module, submodule, unres, data, size, &node, 0)) {
         free_yang_common((struct lys_module *)submodule, node);
         goto error;
     }
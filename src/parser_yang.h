@@ -38,6 +38,8 @@
 #define YANG_REMOVE_IMPORT 0x01
 #define YANG_EXIST_MODULE 0x02
 #define EXT_INSTANCE_SUBSTMT 0x04
+#define YANG_PARSE_ONLY 0x08
+#define YANG_STUB_IMPORT 0x10
 
 struct type_node {
     union {
@@ -206,13 +208,54 @@ int yang_fill_extcomplex_module(struct ly_ctx *ctx, struct lys_ext_instance_comp
  * @param[in] data Pointer to a NULL-terminated string containing YANG data to parse.
  * @param[in] size_data Size of input string
  * @param[in/out] node Pointer to node
+ * @param[in] flags Parser flags, #YANG_PARSE_ONLY to skip the checks of the module header with respect to the
+ * context and loading the imports.
  * @return 0 on success, -1 on error, 1 on module is already in context.
  */
 int yang_parse_mem(struct lys_module *module, struct lys_submodule *submodule, struct unres_schema *unres,
-                   const char *data, unsigned int size_data, struct lys_node **node);
+                   const char *data, unsigned int size_data, struct lys_node **node, int flags);
 
 struct lys_module *yang_read_module(struct ly_ctx *ctx, const char* data, unsigned int size, const char *revision, int implement);
 
+/**
+ * @brief Replace the names of the imported modules and the included submodules by stubs with just the names. In
+ * the parse-only mode, the prefixes are then transformed into the module names, but the definitions in the imported
+ * modules and in the submodules are resolved later.
+ *
+ * @param[in] module Module with the imports and includes not loaded yet.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int yang_stub_imports(struct lys_module *module);
+
+/**
+ * @brief Only parse a YANG module, without accessing the other modules in the context, so it can be done
+ * in parallel with parsing other modules into the same context. Finish it by yang_read_module_parsed().
+ *
+ * @param[in] ctx Context of the module.
+ * @param[in] data YANG module ending with 2 zero bytes.
+ * @param[out] module Parsed module, its imports and includes are not loaded, they are just stubs (see
+ * yang_stub_imports()).
+ * @param[out] unres Unresolved items of the module.
+ * @param[out] node Data definition nodes of the module to be checked.
+ * @return EXIT_SUCCESS or EXIT_FAILURE (the data are then to be read by yang_read_module() to log the errors).
+ */
+int yang_parse_module_only(struct ly_ctx *ctx, const char *data, struct lys_module **module, struct unres_schema **unres,
+                           struct lys_node **node);
+
+/**
+ * @brief Load the imports of a module parsed by yang_parse_module_only(), check it and add it into the context.
+ * The parsed data are always consumed.
+ *
+ * @return The module from the context, NULL on error.
+ */
+struct lys_module *yang_read_module_parsed(struct ly_ctx *ctx, struct lys_module *module, struct unres_schema *unres,
+                                           struct lys_node *node, const char *revision, int implement);
+
+/**
+ * @brief Free a module parsed by yang_parse_module_only() which is not going to be added into the context.
+ */
+void yang_free_module_parsed(struct lys_module *module, struct unres_schema *unres, struct lys_node *node);
+
 struct lys_submodule *yang_read_submodule(struct lys_module *module, const char *data, unsigned int size, struct unres_schema *unres);
 
 #endif /* LY_PARSER_YANG_H_ */
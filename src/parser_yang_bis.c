@@ -3714,22 +3714,29 @@ yyreduce:
 
   case 78:
 
-    { /* check the module with respect to the context now */
-                         if (!param->submodule) {
-                           switch (lyp_ctx_check_module(trg)) {
-                           case -1:
-                             YYABORT;
-                           case 0:
-                             break;
-                           case 1:
-                             /* it's already there */
-                             param->flags |= YANG_EXIST_MODULE;
+    { /* check the module with respect to the context now (in yang_read_module_parsed() if only parsed) */
+                         if (!(param->flags & YANG_PARSE_ONLY)) {
+                           if (!param->submodule) {
+                             switch (lyp_ctx_check_module(trg)) {
+                             case -1:
+                               YYABORT;
+                             case 0:
+                               break;
+                             case 1:
+                               /* it's already there */
+                               param->flags |= YANG_EXIST_MODULE;
+                               YYABORT;
+                             }
+                           }
+                           param->flags &= (~YANG_REMOVE_IMPORT);
+                           if (yang_check_imports(trg, param->unres)) {
                              YYABORT;
                            }
-                         }
-                         param->flags &= (~YANG_REMOVE_IMPORT);
-                         if (yang_check_imports(trg, param->unres)) {
+                         } else if (yang_stub_imports(trg)) {
                            YYABORT;
+                         } else {
+                           /* the imports and includes are loaded later, only their names are known now */
+                           param->flags |= YANG_STUB_IMPORT;
                          }
                          actual = NULL;
                        }
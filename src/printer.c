@@ -429,6 +429,108 @@ lyd_print_clb(ssize_t (*writeclb)(void *arg, const void *buf, size_t count), voi
     return lyd_print_(&out, root, format, options);
 }
 
+struct lyd_print_frame *
+lyd_print_iter_push(struct lyd_print_iter *iter, const struct lyd_node *node, const struct lyd_node *next, int level,
+                    uint8_t type, uint8_t flags)
+{
+    struct lyd_print_frame *frame;
+
+    if (iter->frame_count == iter->frame_size) {
+        frame = realloc(iter->frames, (iter->frame_size ? iter->frame_size * 2 : 16) * sizeof *iter->frames);
+        LY_CHECK_ERR_RETURN(!frame, LOGMEM, NULL);
+        iter->frames = frame;
+        iter->frame_size = iter->frame_size ? iter->frame_size * 2 : 16;
+    }
+
+    frame = &iter->frames[iter->frame_count++];
+    frame->node = node;
+    frame->next = next;
+    frame->level = level;
+    frame->type = type;
+    frame->flags = flags;
+
+    return frame;
+}
+
+API struct lyd_print_iter *
+lyd_print_iter_new(const struct lyd_node *root, LYD_FORMAT format, int options)
+{
+    struct lyd_print_iter *iter;
+
+    if ((format != LYD_XML) && (format != LYD_JSON)) {
+        LOGERR(LY_EINVAL, "Unknown output format.");
+        return NULL;
+    }
+
+    iter = calloc(1, sizeof *iter);
+    LY_CHECK_ERR_RETURN(!iter, LOGMEM, NULL);
+    iter->out.type = LYOUT_MEMORY;
+    iter->root = root;
+    iter->format = format;
+    iter->options = options;
+    if (!root) {
+        /* no data to print, but even empty tree is valid */
+        iter->state = LYD_PRINT_ITER_DONE;
+    }
+
+    return iter;
+}
+
+API ssize_t
+lyd_print_iter_next(struct lyd_print_iter *iter, char *buf, size_t size)
+{
+    size_t len = 0, n;
+    int r;
+
+    if (!iter || !buf || !size || (iter->state == LYD_PRINT_ITER_ERROR)) {
+        ly_errno = LY_EINVAL;
+        return -1;
+    }
+
+    while (len < size) {
+        if (iter->offset == iter->out.method.mem.len) {
+            /* the current fragment consumed, generate the next one */
+            iter->printed += iter->out.method.mem.len;
+            iter->offset = iter->out.method.mem.len = 0;
+            if (iter->state == LYD_PRINT_ITER_DONE) {
+                break;
+            }
+            if (iter->format == LYD_XML) {
+                r = xml_print_iter(iter);
+            } else {
+                r = json_print_iter(iter);
+            }
+            if (r) {
+                iter->state = LYD_PRINT_ITER_ERROR;
+                return -1;
+            }
+            continue;
+        }
+
+        n = iter->out.method.mem.len - iter->offset;
+        if (n > size - len) {
+            n = size - len;
+        }
+        memcpy(buf + len, iter->out.method.mem.buf + iter->offset, n);
+        iter->offset += n;
+        len += n;
+    }
+
+    return len;
+}
+
+API void
+lyd_print_iter_free(struct lyd_print_iter *iter)
+{
+    if (!iter) {
+        return;
+    }
+
+    free(iter->out.method.mem.buf);
+    free(iter->frames);
+    free(iter);
+}
+
 int
 lyd_wd_toprint(const struct lyd_node *node, int options)
 {
@@ -72,6 +72,45 @@ int json_print_data(struct lyout *out, const struct lyd_node *root, int options)
 int xml_print_data(struct lyout *out, const struct lyd_node *root, int options);
 int xml_print_node(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options);
 
+/* states of the resumable data printer */
+#define LYD_PRINT_ITER_START   0 /**< nothing printed yet */
+#define LYD_PRINT_ITER_CONTENT 1 /**< printing the data nodes driven by the frame stack */
+#define LYD_PRINT_ITER_END     2 /**< all the data nodes printed, the closing part remains */
+#define LYD_PRINT_ITER_DONE    3 /**< the whole output generated */
+#define LYD_PRINT_ITER_ERROR   4 /**< printing failed */
+
+/**
+ * @brief Frame of the resumable data printer, there is a few of them per a printed tree level.
+ */
+struct lyd_print_frame {
+    const struct lyd_node *node;   /**< node the frame belongs to (meaning is given by the format-specific type) */
+    const struct lyd_node *next;   /**< the next node to be printed in the frame, NULL when finished */
+    int level;                     /**< indentation level of the frame */
+    uint8_t type;                  /**< format-specific frame type */
+    uint8_t flags;                 /**< format-specific frame flags */
+};
+
+struct lyd_print_iter {
+    struct lyout out;              /**< LYOUT_MEMORY output holding the current fragment of the output */
+    size_t offset;                 /**< part of the current fragment already returned to the caller */
+    size_t printed;                /**< length of all the previous fragments */
+    const struct lyd_node *root;   /**< (possibly adjusted) root of the printed data */
+    LYD_FORMAT format;
+    int options;
+    int level;                     /**< indentation level of the top-level data nodes */
+    uint8_t state;                 /**< LYD_PRINT_ITER_* */
+    uint8_t action_input;          /**< NETCONF action wrapper is printed around the data */
+    struct lyd_print_frame *frames;
+    uint32_t frame_count;
+    uint32_t frame_size;
+};
+
+/* print the next non-empty fragment of the output into iter->out or move the iterator into the done state */
+int xml_print_iter(struct lyd_print_iter *iter);
+int json_print_iter(struct lyd_print_iter *iter);
+struct lyd_print_frame *lyd_print_iter_push(struct lyd_print_iter *iter, const struct lyd_node *node,
+                                            const struct lyd_node *next, int level, uint8_t type, uint8_t flags);
+
 /**
  * get know if the node is supposed to be printed according to the specified with-default mode
  * return 1 - print, 0 - do not print
@@ -249,8 +249,9 @@ contentprint:
     return EXIT_SUCCESS;
 }
 
+/* prints the member name and the start of the container object with its attributes */
 static int
-json_print_container(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options)
+json_print_container_open(struct lyout *out, int level, const struct lyd_node *node, int toplevel)
 {
     const char *schema;
 
@@ -274,82 +275,143 @@ json_print_container(struct lyout *out, int level, const struct lyd_node *node,
             ly_print(out, ",%s", (level ? "\n" : ""));
         }
     }
-    if (json_print_nodes(out, level, node->child, 1, 0, options)) {
+
+    return EXIT_SUCCESS;
+}
+
+static int
+json_print_container(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options)
+{
+    if (json_print_container_open(out, level, node, toplevel)) {
         return EXIT_FAILURE;
     }
-    if (level) {
-        level--;
+    if (json_print_nodes(out, level ? level + 1 : 0, node->child, 1, 0, options)) {
+        return EXIT_FAILURE;
     }
     ly_print(out, "%*s}", LEVEL, INDENT);
 
     return EXIT_SUCCESS;
 }
 
+/* prints the member name and the start of the array, returns 0 if the (empty) list was printed as null */
 static int
-json_print_leaf_list(struct lyout *out, int level, const struct lyd_node *node, int is_list, int toplevel, int options)
+json_print_array_open(struct lyout *out, int level, const struct lyd_node *node, int is_list, int toplevel)
 {
-    const char *schema = NULL;
-    const struct lyd_node *list = node;
-    int flag_empty = 0, flag_attrs = 0;
-
-    if (is_list && !list->child) {
-        /* empty, e.g. in case of filter */
-        flag_empty = 1;
-    }
-
     if (toplevel || !node->parent || nscmp(node, node->parent)) {
         /* print "namespace" */
-        schema = lys_node_module(node->schema)->name;
-        ly_print(out, "%*s\"%s:%s\":", LEVEL, INDENT, schema, node->schema->name);
+        ly_print(out, "%*s\"%s:%s\":", LEVEL, INDENT, lys_node_module(node->schema)->name, node->schema->name);
     } else {
         ly_print(out, "%*s\"%s\":", LEVEL, INDENT, node->schema->name);
     }
 
-    if (flag_empty) {
+    if (is_list && !node->child) {
+        /* empty, e.g. in case of filter */
         ly_print(out, "%snull", (level ? " " : ""));
-        return EXIT_SUCCESS;
+        return 0;
     }
     ly_print(out, "%s[%s", (level ? " " : ""), (level ? "\n" : ""));
 
-    if (!is_list && level) {
+    return 1;
+}
+
+/* prints the start of a list instance object with its attributes, level is the level of the array items */
+static int
+json_print_list_open(struct lyout *out, int level, const struct lyd_node *list)
+{
+    ly_print(out, "%*s{%s", LEVEL, INDENT, (level ? "\n" : ""));
+    if (level) {
         ++level;
     }
+    if (list->attr) {
+        ly_print(out, "%*s\"@\":%s{%s", LEVEL, INDENT, (level ? " " : ""), (level ? "\n" : ""));
+        if (json_print_attrs(out, (level ? level + 1 : level), list, NULL)) {
+            return EXIT_FAILURE;
+        }
+        if (list->child) {
+            ly_print(out, "%*s},%s", LEVEL, INDENT, (level ? "\n" : ""));
+        } else {
+            ly_print(out, "%*s}", LEVEL, INDENT);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static void
+json_print_object_close(struct lyout *out, int level)
+{
+    ly_print(out, "%*s}", LEVEL, INDENT);
+}
+
+static void
+json_print_array_close(struct lyout *out, int level)
+{
+    ly_print(out, "%s%*s]", (level ? "\n" : ""), LEVEL, INDENT);
+}
+
+/* prints the start of the array with attributes of the leaf-list instances */
+static void
+json_print_attrs_array_open(struct lyout *out, int level, const struct lyd_node *node, int toplevel)
+{
+    if (toplevel || !node->parent || nscmp(node, node->parent)) {
+        ly_print(out, ",%s%*s\"@%s:%s\":%s[%s", (level ? "\n" : ""), LEVEL, INDENT, lys_node_module(node->schema)->name,
+                 node->schema->name, (level ? " " : ""), (level ? "\n" : ""));
+    } else {
+        ly_print(out, ",%s%*s\"@%s\":%s[%s", (level ? "\n" : ""), LEVEL, INDENT, node->schema->name,
+                 (level ? " " : ""), (level ? "\n" : ""));
+    }
+}
+
+/* prints attributes of a single leaf-list instance, level is the level of the array items */
+static int
+json_print_attrs_array_item(struct lyout *out, int level, const struct lyd_node *list)
+{
+    if (list->attr) {
+        ly_print(out, "%*s{%s", LEVEL, INDENT, (level ? " " : ""));
+        if (json_print_attrs(out, 0, list, NULL)) {
+            return EXIT_FAILURE;
+        }
+        ly_print(out, "%*s}", LEVEL, INDENT);
+    } else {
+        ly_print(out, "%*snull", LEVEL, INDENT);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static const struct lyd_node *
+json_print_array_next(const struct lyd_node *list)
+{
+    const struct lyd_node *next;
+
+    for (next = list->next; next && next->schema != list->schema; next = next->next);
+    return next;
+}
+
+static int
+json_print_leaf_list(struct lyout *out, int level, const struct lyd_node *node, int is_list, int toplevel, int options)
+{
+    const struct lyd_node *list = node;
+    int flag_attrs = 0, ilevel = (level ? level + 1 : 0);
+
+    if (!json_print_array_open(out, level, node, is_list, toplevel)) {
+        return EXIT_SUCCESS;
+    }
 
     while (list) {
         if (is_list) {
             /* list print */
-            if (level) {
-                ++level;
-            }
-            ly_print(out, "%*s{%s", LEVEL, INDENT, (level ? "\n" : ""));
-            if (level) {
-                ++level;
-            }
-            if (list->attr) {
-                ly_print(out, "%*s\"@\":%s{%s", LEVEL, INDENT, (level ? " " : ""), (level ? "\n" : ""));
-                if (json_print_attrs(out, (level ? level + 1 : level), list, NULL)) {
-                    return EXIT_FAILURE;
-                }
-                if (list->child) {
-                    ly_print(out, "%*s},%s", LEVEL, INDENT, (level ? "\n" : ""));
-                } else {
-                    ly_print(out, "%*s}", LEVEL, INDENT);
-                }
-            }
-            if (json_print_nodes(out, level, list->child, 1, 0, options)) {
+            if (json_print_list_open(out, ilevel, list)) {
                 return EXIT_FAILURE;
             }
-            if (level) {
-                --level;
-            }
-            ly_print(out, "%*s}", LEVEL, INDENT);
-            if (level) {
-                --level;
+            if (json_print_nodes(out, ilevel ? ilevel + 1 : 0, list->child, 1, 0, options)) {
+                return EXIT_FAILURE;
             }
+            json_print_object_close(out, ilevel);
         } else {
             /* leaf-list print */
-            ly_print(out, "%*s", LEVEL, INDENT);
-            if (json_print_leaf(out, level, list, 1, toplevel, options)) {
+            ly_print(out, "%*s", ilevel * 2, INDENT);
+            if (json_print_leaf(out, ilevel, list, 1, toplevel, options)) {
                 return EXIT_FAILURE;
             }
             if (list->attr) {
@@ -360,51 +422,27 @@ json_print_leaf_list(struct lyout *out, int level, const struct lyd_node *node,
             /* if initially called without LYP_WITHSIBLINGS do not print other list entries */
             break;
         }
-        for (list = list->next; list && list->schema != node->schema; list = list->next);
+        list = json_print_array_next(list);
         if (list) {
             ly_print(out, ",%s", (level ? "\n" : ""));
         }
     }
 
-    if (!is_list && level) {
-        --level;
-    }
-
-    ly_print(out, "%s%*s]", (level ? "\n" : ""), LEVEL, INDENT);
+    json_print_array_close(out, level);
 
     /* attributes */
     if (!is_list && flag_attrs) {
-        if (schema) {
-            ly_print(out, ",%s%*s\"@%s:%s\":%s[%s", (level ? "\n" : ""), LEVEL, INDENT, schema, node->schema->name,
-                     (level ? " " : ""), (level ? "\n" : ""));
-        } else {
-            ly_print(out, ",%s%*s\"@%s\":%s[%s", (level ? "\n" : ""), LEVEL, INDENT, node->schema->name,
-                     (level ? " " : ""), (level ? "\n" : ""));
-        }
-        if (level) {
-            level++;
-        }
+        json_print_attrs_array_open(out, level, node, toplevel);
         for (list = node; list; ) {
-            if (list->attr) {
-                ly_print(out, "%*s{%s", LEVEL, INDENT, (level ? " " : ""));
-                if (json_print_attrs(out, 0, list, NULL)) {
-                    return EXIT_FAILURE;
-                }
-                ly_print(out, "%*s}", LEVEL, INDENT);
-            } else {
-                ly_print(out, "%*snull", LEVEL, INDENT);
+            if (json_print_attrs_array_item(out, ilevel, list)) {
+                return EXIT_FAILURE;
             }
-
-
-            for (list = list->next; list && list->schema != node->schema; list = list->next);
+            list = json_print_array_next(list);
             if (list) {
                 ly_print(out, ",%s", (level ? "\n" : ""));
             }
         }
-        if (level) {
-            level--;
-        }
-        ly_print(out, "%s%*s]", (level ? "\n" : ""), LEVEL, INDENT);
+        json_print_array_close(out, level);
     }
 
     return EXIT_SUCCESS;
@@ -542,6 +580,9 @@ json_print_nodes(struct lyout *out, int level, const struct lyd_node *root, int
     LY_TREE_FOR(root, node) {
         if (!lyd_wd_toprint(node, options)) {
             /* wd says do not print */
+            if (!withsiblings) {
+                break;
+            }
             continue;
         }
 
@@ -618,16 +659,13 @@ json_print_nodes(struct lyout *out, int level, const struct lyd_node *root, int
     return ret;
 }
 
-int
-json_print_data(struct lyout *out, const struct lyd_node *root, int options)
+/* learn what is actually printed as the data root and whether it is wrapped into the yang:action object */
+static const struct lyd_node *
+json_print_root(const struct lyd_node *root, int options, int *action_input)
 {
     const struct lyd_node *node, *next;
-    int level = 0, action_input = 0;
-
-    if (options & LYP_FORMAT) {
-        ++level;
-    }
 
+    *action_input = 0;
     if (options & LYP_NETCONF) {
         if (root->schema->nodetype != LYS_RPC) {
             /* learn whether we are printing an action */
@@ -646,11 +684,25 @@ json_print_data(struct lyout *out, const struct lyd_node *root, int options)
                 /* skip the container */
                 root = node->child;
             } else if (node->schema->nodetype == LYS_ACTION) {
-                action_input = 1;
+                *action_input = 1;
             }
         }
     }
 
+    return root;
+}
+
+int
+json_print_data(struct lyout *out, const struct lyd_node *root, int options)
+{
+    int level = 0, action_input;
+
+    if (options & LYP_FORMAT) {
+        ++level;
+    }
+
+    root = json_print_root(root, options, &action_input);
+
     /* start */
     ly_print(out, "{%s", (level ? "\n" : ""));
 
@@ -679,3 +731,237 @@ json_print_data(struct lyout *out, const struct lyd_node *root, int options)
     ly_print_flush(out);
     return EXIT_SUCCESS;
 }
+
+/* frame types of the resumable printer */
+#define JSON_ITER_NODES     0 /* siblings starting at node, as json_print_nodes() */
+#define JSON_ITER_CONTAINER 1 /* container object waiting for its closing brace */
+#define JSON_ITER_ARRAY     2 /* instances of the list/leaf-list node, as json_print_leaf_list() */
+#define JSON_ITER_ATTRS     3 /* attributes of the leaf-list node instances */
+
+/* frame flags of the resumable printer */
+#define JSON_ITER_TOPLEVEL  0x01 /* printing top-level nodes */
+#define JSON_ITER_SIBLINGS  0x02 /* printing all the siblings, not just the first node */
+#define JSON_ITER_HASATTRS  0x04 /* some of the leaf-list instances has attributes */
+#define JSON_ITER_INSTANCE  0x08 /* list instance children printed, the instance object is to be closed */
+
+static int
+json_print_iter_nodes(struct lyd_print_iter *iter, struct lyd_print_frame *frame)
+{
+    struct lyout *out = &iter->out;
+    const struct lyd_node *node = frame->next, *prev;
+    int level = frame->level, toplevel = frame->flags & JSON_ITER_TOPLEVEL, is_list, r;
+
+    if (!node) {
+        if (frame->node && level) {
+            ly_print(out, "\n");
+        }
+        --iter->frame_count;
+        return EXIT_SUCCESS;
+    }
+    frame->next = (frame->flags & JSON_ITER_SIBLINGS) ? node->next : NULL;
+
+    if (!lyd_wd_toprint(node, iter->options)) {
+        /* wd says do not print */
+        return EXIT_SUCCESS;
+    }
+
+    switch (node->schema->nodetype) {
+    case LYS_RPC:
+    case LYS_ACTION:
+    case LYS_NOTIF:
+    case LYS_CONTAINER:
+        /* the same condition as in json_print_nodes(), just counting all the output generated so far */
+        if (node->prev->next && node->parent && (iter->printed + out->method.mem.len > 6)) {
+            ly_print(out, ",%s", (level ? "\n" : ""));
+        }
+        if (json_print_container_open(out, level, node, toplevel)
+                || !lyd_print_iter_push(iter, node, NULL, level, JSON_ITER_CONTAINER, 0)
+                || !lyd_print_iter_push(iter, node->child, node->child, level ? level + 1 : 0, JSON_ITER_NODES,
+                                        JSON_ITER_SIBLINGS)) {
+            return EXIT_FAILURE;
+        }
+        break;
+    case LYS_LEAFLIST:
+    case LYS_LIST:
+        /* is it already printed? */
+        for (prev = node->prev; prev->next && (prev->schema != node->schema); prev = prev->prev);
+        if (prev->next) {
+            break;
+        }
+        if (node->prev->next) {
+            /* print the previous comma */
+            ly_print(out, ",%s", (level ? "\n" : ""));
+        }
+        is_list = (node->schema->nodetype == LYS_LIST ? 1 : 0);
+        if (json_print_array_open(out, level, node, is_list, toplevel)
+                && !lyd_print_iter_push(iter, node, node, level, JSON_ITER_ARRAY, toplevel ? JSON_ITER_TOPLEVEL : 0)) {
+            return EXIT_FAILURE;
+        }
+        break;
+    case LYS_LEAF:
+    case LYS_ANYXML:
+    case LYS_ANYDATA:
+        if (node->prev->next) {
+            /* print the previous comma */
+            ly_print(out, ",%s", (level ? "\n" : ""));
+        }
+        if (node->schema->nodetype == LYS_LEAF) {
+            r = json_print_leaf(out, level, node, 0, toplevel, iter->options);
+        } else if (node->schema->nodetype == LYS_ANYXML) {
+            r = json_print_anyxml(out, level, node, toplevel, iter->options);
+        } else {
+            r = json_print_anydata(out, level, node, toplevel, iter->options);
+        }
+        if (r) {
+            return EXIT_FAILURE;
+        }
+        break;
+    default:
+        LOGINT;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int
+json_print_iter_array(struct lyd_print_iter *iter, struct lyd_print_frame *frame)
+{
+    struct lyout *out = &iter->out;
+    const struct lyd_node *list = frame->next;
+    int level = frame->level, ilevel = (level ? level + 1 : 0);
+
+    if (frame->type == JSON_ITER_ATTRS) {
+        if (!list) {
+            json_print_array_close(out, level);
+            --iter->frame_count;
+        } else {
+            if (json_print_attrs_array_item(out, ilevel, list)) {
+                return EXIT_FAILURE;
+            }
+            frame->next = json_print_array_next(list);
+            if (frame->next) {
+                ly_print(out, ",%s", (level ? "\n" : ""));
+            }
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (!list) {
+        json_print_array_close(out, level);
+        if (frame->flags & JSON_ITER_HASATTRS) {
+            json_print_attrs_array_open(out, level, frame->node, frame->flags & JSON_ITER_TOPLEVEL);
+            frame->type = JSON_ITER_ATTRS;
+            frame->next = frame->node;
+        } else {
+            --iter->frame_count;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (frame->node->schema->nodetype == LYS_LIST) {
+        if (!(frame->flags & JSON_ITER_INSTANCE)) {
+            /* open the instance and continue with its children */
+            frame->flags |= JSON_ITER_INSTANCE;
+            if (json_print_list_open(out, ilevel, list)
+                    || !lyd_print_iter_push(iter, list->child, list->child, ilevel ? ilevel + 1 : 0, JSON_ITER_NODES,
+                                            JSON_ITER_SIBLINGS)) {
+                return EXIT_FAILURE;
+            }
+            return EXIT_SUCCESS;
+        }
+        frame->flags &= ~JSON_ITER_INSTANCE;
+        json_print_object_close(out, ilevel);
+    } else {
+        ly_print(out, "%*s", ilevel * 2, INDENT);
+        if (json_print_leaf(out, ilevel, list, 1, frame->flags & JSON_ITER_TOPLEVEL, iter->options)) {
+            return EXIT_FAILURE;
+        }
+        if (list->attr) {
+            frame->flags |= JSON_ITER_HASATTRS;
+        }
+    }
+
+    if ((frame->flags & JSON_ITER_TOPLEVEL) && !(iter->options & LYP_WITHSIBLINGS)) {
+        /* if initially called without LYP_WITHSIBLINGS do not print other list entries */
+        frame->next = NULL;
+    } else {
+        frame->next = json_print_array_next(list);
+        if (frame->next) {
+            ly_print(out, ",%s", (level ? "\n" : ""));
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int
+json_print_iter(struct lyd_print_iter *iter)
+{
+    struct lyout *out = &iter->out;
+    struct lyd_print_frame *frame;
+    int level, r;
+
+    while (!out->method.mem.len) {
+        switch (iter->state) {
+        case LYD_PRINT_ITER_START:
+            level = (iter->options & LYP_FORMAT ? 1 : 0);
+            iter->root = json_print_root(iter->root, iter->options, &r);
+            iter->action_input = r;
+
+            ly_print(out, "{%s", (level ? "\n" : ""));
+            if (iter->action_input) {
+                ly_print(out, "%*s\"yang:action\":%s{%s", LEVEL, INDENT, (level ? " " : ""), (level ? "\n" : ""));
+                if (level) {
+                    ++level;
+                }
+            }
+            iter->level = level;
+
+            if (!lyd_print_iter_push(iter, iter->root, iter->root, level, JSON_ITER_NODES,
+                                     JSON_ITER_TOPLEVEL | (iter->options & LYP_WITHSIBLINGS ? JSON_ITER_SIBLINGS : 0))) {
+                return EXIT_FAILURE;
+            }
+            iter->state = LYD_PRINT_ITER_CONTENT;
+            break;
+        case LYD_PRINT_ITER_CONTENT:
+            if (!iter->frame_count) {
+                iter->state = LYD_PRINT_ITER_END;
+                break;
+            }
+            frame = &iter->frames[iter->frame_count - 1];
+            switch (frame->type) {
+            case JSON_ITER_NODES:
+                r = json_print_iter_nodes(iter, frame);
+                break;
+            case JSON_ITER_CONTAINER:
+                json_print_object_close(out, frame->level);
+                --iter->frame_count;
+                r = EXIT_SUCCESS;
+                break;
+            default:
+                r = json_print_iter_array(iter, frame);
+                break;
+            }
+            if (r) {
+                return EXIT_FAILURE;
+            }
+            break;
+        case LYD_PRINT_ITER_END:
+            level = iter->level;
+            if (iter->action_input) {
+                if (level) {
+                    --level;
+                }
+                ly_print(out, "%*s}%s", LEVEL, INDENT, (level ? "\n" : ""));
+            }
+            ly_print(out, "}%s", (level ? "\n" : ""));
+            iter->state = LYD_PRINT_ITER_DONE;
+            /* fallthrough */
+        default:
+            return EXIT_SUCCESS;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
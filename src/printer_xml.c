@@ -131,11 +131,11 @@ xml_print_attrs(struct lyout *out, const struct lyd_node *node, int options)
 {
     struct lyd_attr *attr;
     const char **prefs, **nss;
-    const char *xml_expr = NULL, *mod_name;
+    const char *mod_name;
     uint32_t ns_count, i;
     int rpc_filter = 0;
     const struct lys_module *wdmod = NULL;
-    char *p;
+    char *p, *xml_expr = NULL;
     size_t len;
 
     /* with-defaults */
@@ -233,7 +233,6 @@ printinst:
             free(nss);
 
             lyxml_dump_text(out, xml_expr);
-            lydict_remove(node->schema->module->ctx, xml_expr);
             break;
 
         /* LY_TYPE_LEAFREF not allowed */
@@ -243,14 +242,14 @@ printinst:
         default:
             /* error */
             ly_print(out, "(!error!)");
+            free(xml_expr);
             return EXIT_FAILURE;
         }
 
         ly_print(out, "\"");
 
-        if (xml_expr) {
-            lydict_remove(node->schema->module->ctx, xml_expr);
-        }
+        free(xml_expr);
+        xml_expr = NULL;
     }
 
     return EXIT_SUCCESS;
@@ -264,10 +263,9 @@ xml_print_leaf(struct lyout *out, int level, const struct lyd_node *node, int to
     struct lys_tpdf *tpdf;
     const char *ns, *mod_name;
     const char **prefs, **nss;
-    const char *xml_expr;
     uint32_t ns_count, i;
     LY_DATA_TYPE datatype;
-    char *p;
+    char *p, *xml_expr;
     size_t len;
 
     if (toplevel || !node->parent || nscmp(node, node->parent)) {
@@ -368,7 +366,7 @@ printvalue:
         } else {
             ly_print(out, "/>");
         }
-        lydict_remove(node->schema->module->ctx, xml_expr);
+        free(xml_expr);
         break;
 
     case LY_TYPE_LEAFREF:
@@ -407,10 +405,11 @@ printvalue:
     return EXIT_SUCCESS;
 }
 
+/* prints the start tag of a container, list, notification, RPC or action, returns 1 if the children are supposed
+ * to follow, 0 if the element was closed, -1 on error */
 static int
-xml_print_container(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options)
+xml_print_inner_open(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options)
 {
-    struct lyd_node *child;
     const char *ns;
 
     if (toplevel || !node->parent || nscmp(node, node->parent)) {
@@ -426,67 +425,43 @@ xml_print_container(struct lyout *out, int level, const struct lyd_node *node, i
     }
 
     if (xml_print_attrs(out, node, options)) {
-        return EXIT_FAILURE;
+        return -1;
     }
 
     if (!node->child) {
         ly_print(out, "/>%s", level ? "\n" : "");
-        return EXIT_SUCCESS;
+        return 0;
     }
     ly_print(out, ">%s", level ? "\n" : "");
 
-    LY_TREE_FOR(node->child, child) {
-        if (xml_print_node(out, level ? level + 1 : 0, child, 0, options)) {
-            return EXIT_FAILURE;
-        }
-    }
+    return 1;
+}
 
+static void
+xml_print_inner_close(struct lyout *out, int level, const struct lyd_node *node)
+{
     ly_print(out, "%*s</%s>%s", LEVEL, INDENT, node->schema->name, level ? "\n" : "");
-
-    return EXIT_SUCCESS;
 }
 
 static int
-xml_print_list(struct lyout *out, int level, const struct lyd_node *node, int is_list, int toplevel, int options)
+xml_print_inner(struct lyout *out, int level, const struct lyd_node *node, int toplevel, int options)
 {
     struct lyd_node *child;
-    const char *ns;
+    int r;
 
-    if (is_list) {
-        /* list print */
-        if (toplevel || !node->parent || nscmp(node, node->parent)) {
-            /* print "namespace" */
-            ns = lyd_node_module(node)->ns;
-            ly_print(out, "%*s<%s xmlns=\"%s\"", LEVEL, INDENT, node->schema->name, ns);
-        } else {
-            ly_print(out, "%*s<%s", LEVEL, INDENT, node->schema->name);
-        }
+    r = xml_print_inner_open(out, level, node, toplevel, options);
+    if (r < 1) {
+        return r ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
 
-        if (toplevel) {
-            xml_print_ns(out, node, options);
-        }
-        if (xml_print_attrs(out, node, options)) {
+    LY_TREE_FOR(node->child, child) {
+        if (xml_print_node(out, level ? level + 1 : 0, child, 0, options)) {
             return EXIT_FAILURE;
         }
-
-        if (!node->child) {
-            ly_print(out, "/>%s", level ? "\n" : "");
-            return EXIT_SUCCESS;
-        }
-        ly_print(out, ">%s", level ? "\n" : "");
-
-        LY_TREE_FOR(node->child, child) {
-            if (xml_print_node(out, level ? level + 1 : 0, child, 0, options)) {
-                return EXIT_FAILURE;
-            }
-        }
-
-        ly_print(out, "%*s</%s>%s", LEVEL, INDENT, node->schema->name, level ? "\n" : "");
-    } else {
-        /* leaf-list print */
-        xml_print_leaf(out, level, node, toplevel, options);
     }
 
+    xml_print_inner_close(out, level, node);
+
     return EXIT_SUCCESS;
 }
 
@@ -585,16 +560,12 @@ xml_print_node(struct lyout *out, int level, const struct lyd_node *node, int to
     case LYS_RPC:
     case LYS_ACTION:
     case LYS_CONTAINER:
-        ret = xml_print_container(out, level, node, toplevel, options);
+    case LYS_LIST:
+        ret = xml_print_inner(out, level, node, toplevel, options);
         break;
     case LYS_LEAF:
-        ret = xml_print_leaf(out, level, node, toplevel, options);
-        break;
     case LYS_LEAFLIST:
-        ret = xml_print_list(out, level, node, 0, toplevel, options);
-        break;
-    case LYS_LIST:
-        ret = xml_print_list(out, level, node, 1, toplevel, options);
+        ret = xml_print_leaf(out, level, node, toplevel, options);
         break;
     case LYS_ANYXML:
     case LYS_ANYDATA:
@@ -609,17 +580,14 @@ xml_print_node(struct lyout *out, int level, const struct lyd_node *node, int to
     return ret;
 }
 
-int
-xml_print_data(struct lyout *out, const struct lyd_node *root, int options)
+/* learn what is actually printed as the data root and whether it is wrapped into the NETCONF action element */
+static const struct lyd_node *
+xml_print_root(const struct lyd_node *root, int options, int *action_input)
 {
     const struct lyd_node *node, *next;
     struct lys_node *parent = NULL;
-    int level, action_input = 0;
-
-    assert(root);
-
-    level = (options & LYP_FORMAT ? 1 : 0);
 
+    *action_input = 0;
     if (options & LYP_NETCONF) {
         if (root->schema->nodetype != LYS_RPC) {
             /* learn whether we are printing an action */
@@ -633,7 +601,7 @@ xml_print_data(struct lyout *out, const struct lyd_node *root, int options)
             node = root;
         }
 
-        if (node) {
+        if (node && (node->schema->nodetype & (LYS_RPC | LYS_ACTION))) {
             if (node->child) {
                 for (parent = lys_parent(node->child->schema); parent && (parent->nodetype == LYS_USES); parent = lys_parent(parent));
             }
@@ -642,11 +610,26 @@ xml_print_data(struct lyout *out, const struct lyd_node *root, int options)
                 root = node->child;
             } else if (node->schema->nodetype == LYS_ACTION) {
                 /* action input - print top-level action element */
-                action_input = 1;
+                *action_input = 1;
             }
         }
     }
 
+    return root;
+}
+
+int
+xml_print_data(struct lyout *out, const struct lyd_node *root, int options)
+{
+    const struct lyd_node *node;
+    int level, action_input;
+
+    assert(root);
+
+    level = (options & LYP_FORMAT ? 1 : 0);
+
+    root = xml_print_root(root, options, &action_input);
+
     if (action_input) {
         ly_print(out, "%*s<action xmlns=\"urn:ietf:params:xml:ns:yang:1\">%s", LEVEL, INDENT, level ? "\n" : "");
         if (level) {
@@ -676,3 +659,89 @@ xml_print_data(struct lyout *out, const struct lyd_node *root, int options)
     return EXIT_SUCCESS;
 }
 
+int
+xml_print_iter(struct lyd_print_iter *iter)
+{
+    struct lyout *out = &iter->out;
+    struct lyd_print_frame *frame;
+    const struct lyd_node *node;
+    int level, r;
+
+    while (!out->method.mem.len) {
+        switch (iter->state) {
+        case LYD_PRINT_ITER_START:
+            level = (iter->options & LYP_FORMAT ? 1 : 0);
+            iter->root = xml_print_root(iter->root, iter->options, &r);
+            iter->action_input = r;
+            if (iter->action_input) {
+                ly_print(out, "%*s<action xmlns=\"urn:ietf:params:xml:ns:yang:1\">%s", LEVEL, INDENT, level ? "\n" : "");
+                if (level) {
+                    ++level;
+                }
+            }
+            iter->level = level;
+
+            /* the bottom frame iterates over the top-level nodes, the other ones over children of an open element */
+            if (!lyd_print_iter_push(iter, NULL, iter->root, level, 0, 0)) {
+                return EXIT_FAILURE;
+            }
+            iter->state = LYD_PRINT_ITER_CONTENT;
+            break;
+        case LYD_PRINT_ITER_CONTENT:
+            frame = &iter->frames[iter->frame_count - 1];
+            node = frame->next;
+            if (!node) {
+                /* all the children printed */
+                if (frame->node) {
+                    xml_print_inner_close(out, frame->level, frame->node);
+                } else {
+                    iter->state = LYD_PRINT_ITER_END;
+                }
+                --iter->frame_count;
+                break;
+            }
+
+            if (frame->node) {
+                level = frame->level ? frame->level + 1 : 0;
+                frame->next = node->next;
+            } else {
+                level = frame->level;
+                frame->next = (iter->options & LYP_WITHSIBLINGS) ? node->next : NULL;
+            }
+
+            if (!lyd_wd_toprint(node, iter->options)) {
+                /* wd says do not print */
+                break;
+            }
+            if (!(node->schema->nodetype & (LYS_NOTIF | LYS_RPC | LYS_ACTION | LYS_CONTAINER | LYS_LIST))) {
+                /* terminal node, print it as a whole */
+                if (xml_print_node(out, level, node, frame->node ? 0 : 1, iter->options)) {
+                    return EXIT_FAILURE;
+                }
+                break;
+            }
+
+            r = xml_print_inner_open(out, level, node, frame->node ? 0 : 1, iter->options);
+            if (r == -1) {
+                return EXIT_FAILURE;
+            } else if (r && !lyd_print_iter_push(iter, node, node->child, level, 0, 0)) {
+                return EXIT_FAILURE;
+            }
+            break;
+        case LYD_PRINT_ITER_END:
+            level = iter->level;
+            if (iter->action_input) {
+                if (level) {
+                    --level;
+                }
+                ly_print(out, "%*s</action>%s", LEVEL, INDENT, level ? "\n" : "");
+            }
+            iter->state = LYD_PRINT_ITER_DONE;
+            /* fallthrough */
+        default:
+            return EXIT_SUCCESS;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -391,7 +391,7 @@ static void
 yang_print_when(struct lyout *out, int level, const struct lys_module *module, const struct lys_when *when)
 {
     int flag = 0;
-    const char *str;
+    char *str;
 
     str = transform_json2schema(module, when->cond);
     if (!str) {
@@ -402,7 +402,7 @@ yang_print_when(struct lyout *out, int level, const struct lys_module *module, c
     ly_print(out, "%*swhen \"", LEVEL, INDENT);
     yang_encode(out, str, -1);
     ly_print(out, "\"");
-    lydict_remove(module->ctx, str);
+    free(str);
 
     level++;
 
@@ -455,7 +455,7 @@ yang_print_type(struct lyout *out, int level, const struct lys_module *module, c
 {
     unsigned int i;
     int flag = 0, flag2;
-    const char *str;
+    char *str;
     char *s;
     struct lys_module *mod;
 
@@ -576,7 +576,7 @@ yang_print_type(struct lyout *out, int level, const struct lys_module *module, c
             yang_print_open(out, &flag);
             str = transform_json2schema(module, type->info.lref.path);
             yang_print_substmt(out, level, LYEXT_SUBSTMT_PATH, 0, str, module, type->ext, type->ext_size);
-            lydict_remove(module->ctx, str);
+            free(str);
         }
         if (type->info.lref.req == 1) {
             yang_print_open(out, &flag);
@@ -615,7 +615,7 @@ yang_print_type(struct lyout *out, int level, const struct lys_module *module, c
 static void
 yang_print_must(struct lyout *out, int level, const struct lys_module *module, const struct lys_restr *must)
 {
-    const char *str;
+    char *str;
 
     str = transform_json2schema(module, must->expr);
     if (!str) {
@@ -623,7 +623,7 @@ yang_print_must(struct lyout *out, int level, const struct lys_module *module, c
         return;
     }
     yang_print_restr(out, level, module, must, "must", str);
-    lydict_remove(module->ctx, str);
+    free(str);
 }
 
 static void
@@ -642,11 +642,11 @@ static void
 yang_print_refine(struct lyout *out, int level, const struct lys_module *module, const struct lys_refine *refine)
 {
     int i, flag = 0;
-    const char *str;
+    char *str;
 
     str = transform_json2schema(module, refine->target_name);
     ly_print(out, "%*srefine \"%s\"", LEVEL, INDENT, str);
-    lydict_remove(module->ctx, str);
+    free(str);
     level++;
 
     yang_print_snode_common(out, level, (struct lys_node *)refine, module, &flag, SNODE_COMMON_EXT | SNODE_COMMON_IFF);
@@ -704,11 +704,11 @@ yang_print_deviation(struct lyout *out, int level, const struct lys_module *modu
                      const struct lys_deviation *deviation)
 {
     int i, j, p;
-    const char *str;
+    char *str;
 
     str = transform_json2schema(module, deviation->target_name);
     ly_print(out, "%*sdeviation \"%s\" {\n", LEVEL, INDENT, str);
-    lydict_remove(module->ctx, str);
+    free(str);
     level++;
 
     if (deviation->ext_size) {
@@ -838,11 +838,11 @@ static void
 yang_print_augment(struct lyout *out, int level, const struct lys_node_augment *augment)
 {
     struct lys_node *sub;
-    const char *str;
+    char *str;
 
     str = transform_json2schema(augment->module, augment->target_name);
     ly_print(out, "%*saugment \"%s\" {\n", LEVEL, INDENT, str);
-    lydict_remove(augment->module->ctx, str);
+    free(str);
     level++;
 
     yang_print_snode_common(out, level, (struct lys_node *)augment, augment->module, NULL, SNODE_COMMON_EXT);
@@ -870,6 +870,7 @@ static void
 yang_print_typedef(struct lyout *out, int level, const struct lys_module *module, const struct lys_tpdf *tpdf)
 {
     const char *dflt;
+    char *str = NULL;
 
     ly_print(out, "%*stypedef %s {\n", LEVEL, INDENT, tpdf->name);
     level++;
@@ -884,17 +885,15 @@ yang_print_typedef(struct lyout *out, int level, const struct lys_module *module
             assert(strchr(tpdf->dflt, ':'));
             if (!strncmp(tpdf->dflt, module->name, strchr(tpdf->dflt, ':') - tpdf->dflt)) {
                 /* local module */
-                dflt = lydict_insert(module->ctx, strchr(tpdf->dflt, ':') + 1, 0);
+                dflt = strchr(tpdf->dflt, ':') + 1;
             } else {
-                dflt = transform_json2schema(module, tpdf->dflt);
+                dflt = str = transform_json2schema(module, tpdf->dflt);
             }
         } else {
             dflt = tpdf->dflt;
         }
         yang_print_substmt(out, level, LYEXT_SUBSTMT_DEFAULT, 0, dflt, module, tpdf->ext, tpdf->ext_size);
-        if (tpdf->flags & LYS_DFLTJSON) {
-            lydict_remove(module->ctx, dflt);
-        }
+        free(str);
     }
     yang_print_snode_common(out, level, (struct lys_node *)tpdf, module, NULL,
                             SNODE_COMMON_STATUS | SNODE_COMMON_DSC | SNODE_COMMON_REF);
@@ -1099,6 +1098,7 @@ yang_print_leaf(struct lyout *out, int level, const struct lys_node *node)
     int i;
     struct lys_node_leaf *leaf = (struct lys_node_leaf *)node;
     const char *dflt;
+    char *str = NULL;
 
     ly_print(out, "%*sleaf %s {\n", LEVEL, INDENT, node->name);
     level++;
@@ -1121,18 +1121,16 @@ yang_print_leaf(struct lyout *out, int level, const struct lys_node *node)
             assert(strchr(leaf->dflt, ':'));
             if (!strncmp(leaf->dflt, lys_node_module(node)->name, strchr(leaf->dflt, ':') - leaf->dflt)) {
                 /* local module */
-                dflt = lydict_insert(node->module->ctx, strchr(leaf->dflt, ':') + 1, 0);
+                dflt = strchr(leaf->dflt, ':') + 1;
             } else {
-                dflt = transform_json2schema(node->module, leaf->dflt);
+                dflt = str = transform_json2schema(node->module, leaf->dflt);
             }
         } else {
             dflt = leaf->dflt;
         }
         yang_print_substmt(out, level, LYEXT_SUBSTMT_DEFAULT, 0, dflt,
                            node->module, node->ext, node->ext_size);
-        if (leaf->flags & LYS_DFLTJSON) {
-            lydict_remove(node->module->ctx, dflt);
-        }
+        free(str);
     }
     yang_print_snode_common(out, level, node, node->module, NULL, SNODE_COMMON_CONFIG | SNODE_COMMON_MAND |
                             SNODE_COMMON_STATUS | SNODE_COMMON_DSC | SNODE_COMMON_REF);
@@ -1174,6 +1172,7 @@ yang_print_leaflist(struct lyout *out, int level, const struct lys_node *node)
     int i;
     struct lys_node_leaflist *llist = (struct lys_node_leaflist *)node;
     const char *dflt;
+    char *str = NULL;
 
     ly_print(out, "%*sleaf-list %s {\n", LEVEL, INDENT, node->name);
     level++;
@@ -1195,18 +1194,17 @@ yang_print_leaflist(struct lyout *out, int level, const struct lys_node *node)
             assert(strchr(llist->dflt[i], ':'));
             if (!strncmp(llist->dflt[i], lys_node_module(node)->name, strchr(llist->dflt[i], ':') - llist->dflt[i])) {
                 /* local module */
-                dflt = lydict_insert(node->module->ctx, strchr(llist->dflt[i], ':') + 1, 0);
+                dflt = strchr(llist->dflt[i], ':') + 1;
             } else {
-                dflt = transform_json2schema(node->module, llist->dflt[i]);
+                dflt = str = transform_json2schema(node->module, llist->dflt[i]);
             }
         } else {
             dflt = llist->dflt[i];
         }
         yang_print_substmt(out, level, LYEXT_SUBSTMT_DEFAULT, i, dflt,
                            node->module, node->ext, node->ext_size);
-        if (llist->flags & LYS_DFLTJSON) {
-            lydict_remove(node->module->ctx, dflt);
-        }
+        free(str);
+        str = NULL;
     }
     yang_print_snode_common(out, level, node, node->module, NULL, SNODE_COMMON_CONFIG);
     if (llist->min > 0) {
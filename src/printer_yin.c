@@ -362,7 +362,7 @@ static void
 yin_print_when(struct lyout *out, int level, const struct lys_module *module, const struct lys_when *when)
 {
     int flag = 0;
-    const char *str;
+    char *str;
 
     str = transform_json2schema(module, when->cond);
     if (!str) {
@@ -373,7 +373,7 @@ yin_print_when(struct lyout *out, int level, const struct lys_module *module, co
     ly_print(out, "%*s<when condition=\"", LEVEL, INDENT);
     lyxml_dump_text(out, str);
     ly_print(out, "\"");
-    lydict_remove(module->ctx, str);
+    free(str);
 
     level++;
 
@@ -426,7 +426,7 @@ yin_print_type(struct lyout *out, int level, const struct lys_module *module, co
 {
     unsigned int i;
     int content = 0, content2 = 0;
-    const char *str;
+    char *str;
     char *s;
     struct lys_module *mod;
 
@@ -544,7 +544,7 @@ yin_print_type(struct lyout *out, int level, const struct lys_module *module, co
             yin_print_close_parent(out, &content);
             str = transform_json2schema(module, type->info.lref.path);
             yin_print_substmt(out, level, LYEXT_SUBSTMT_PATH, 0, str, module, type->ext, type->ext_size);
-            lydict_remove(module->ctx, str);
+            free(str);
         }
         if (type->info.lref.req == 1) {
             yin_print_close_parent(out, &content);
@@ -582,7 +582,7 @@ yin_print_type(struct lyout *out, int level, const struct lys_module *module, co
 static void
 yin_print_must(struct lyout *out, int level, const struct lys_module *module, const struct lys_restr *must)
 {
-    const char *str;
+    char *str;
     int content = 0;
 
     str = transform_json2schema(module, must->expr);
@@ -594,7 +594,7 @@ yin_print_must(struct lyout *out, int level, const struct lys_module *module, co
     ly_print(out, "%*s<must condition=\"", LEVEL, INDENT);
     lyxml_dump_text(out, str);
     ly_print(out, "\"");
-    lydict_remove(module->ctx, str);
+    free(str);
 
     yin_print_restr(out, level + 1, module, must, &content);
     yin_print_close(out, level, NULL, "must", content);
@@ -616,11 +616,11 @@ static void
 yin_print_refine(struct lyout *out, int level, const struct lys_module *module, const struct lys_refine *refine)
 {
     int i, content = 0;
-    const char *str;
+    char *str;
 
     str = transform_json2xml(module, refine->target_name, 0, NULL, NULL, NULL);
     yin_print_open(out, level, NULL, "refine", "target-node", str, content);
-    lydict_remove(module->ctx, str);
+    free(str);
 
     level++;
     yin_print_snode_common(out, level, (struct lys_node *)refine, module, &content,
@@ -682,11 +682,11 @@ yin_print_deviation(struct lyout *out, int level, const struct lys_module *modul
                     const struct lys_deviation *deviation)
 {
     int i, j, p, content;
-    const char *str;
+    char *str;
 
     str = transform_json2schema(module, deviation->target_name);
     yin_print_open(out, level, NULL, "deviation", "target-node", str, 1);
-    lydict_remove(module->ctx, str);
+    free(str);
 
     level++;
 
@@ -816,11 +816,11 @@ yin_print_augment(struct lyout *out, int level, const struct lys_module *module,
                   const struct lys_node_augment *augment)
 {
     struct lys_node *sub;
-    const char *str;
+    char *str;
 
     str = transform_json2schema(module, augment->target_name);
     yin_print_open(out, level, NULL, "augment", "target-node", str, 1);
-    lydict_remove(module->ctx, str);
+    free(str);
     level++;
 
     yin_print_snode_common(out, level, (struct lys_node *)augment, augment->module, NULL, SNODE_COMMON_EXT);
@@ -849,6 +849,7 @@ static void
 yin_print_typedef(struct lyout *out, int level, const struct lys_module *module, const struct lys_tpdf *tpdf)
 {
     const char *dflt;
+    char *str = NULL;
 
     yin_print_open(out, level, NULL, "typedef", "name", tpdf->name, 1);
     level++;
@@ -863,17 +864,15 @@ yin_print_typedef(struct lyout *out, int level, const struct lys_module *module,
             assert(strchr(tpdf->dflt, ':'));
             if (!strncmp(tpdf->dflt, module->name, strchr(tpdf->dflt, ':') - tpdf->dflt)) {
                 /* local module */
-                dflt = lydict_insert(module->ctx, strchr(tpdf->dflt, ':') + 1, 0);
+                dflt = strchr(tpdf->dflt, ':') + 1;
             } else {
-                dflt = transform_json2schema(module, tpdf->dflt);
+                dflt = str = transform_json2schema(module, tpdf->dflt);
             }
         } else {
             dflt = tpdf->dflt;
         }
         yin_print_substmt(out, level, LYEXT_SUBSTMT_DEFAULT, 0, dflt, module, tpdf->ext, tpdf->ext_size);
-        if (tpdf->flags & LYS_DFLTJSON) {
-            lydict_remove(module->ctx, dflt);
-        }
+        free(str);
     }
     yin_print_snode_common(out, level, (struct lys_node *)tpdf, module, NULL,
                            SNODE_COMMON_STATUS | SNODE_COMMON_DSC | SNODE_COMMON_REF);
@@ -1082,6 +1081,7 @@ yin_print_leaf(struct lyout *out, int level, const struct lys_node *node)
     int i;
     struct lys_node_leaf *leaf = (struct lys_node_leaf *)node;
     const char *dflt;
+    char *str = NULL;
 
     yin_print_open(out, level, NULL, "leaf", "name", node->name, 1);
     level++;
@@ -1104,18 +1104,16 @@ yin_print_leaf(struct lyout *out, int level, const struct lys_node *node)
             assert(strchr(leaf->dflt, ':'));
             if (!strncmp(leaf->dflt, lys_node_module(node)->name, strchr(leaf->dflt, ':') - leaf->dflt)) {
                 /* local module */
-                dflt = lydict_insert(node->module->ctx, strchr(leaf->dflt, ':') + 1, 0);
+                dflt = strchr(leaf->dflt, ':') + 1;
             } else {
-                dflt = transform_json2schema(node->module, leaf->dflt);
+                dflt = str = transform_json2schema(node->module, leaf->dflt);
             }
         } else {
             dflt = leaf->dflt;
         }
         yin_print_substmt(out, level, LYEXT_SUBSTMT_DEFAULT, 0, dflt,
                           node->module, node->ext, node->ext_size);
-        if (leaf->flags & LYS_DFLTJSON) {
-            lydict_remove(node->module->ctx, dflt);
-        }
+        free(str);
     }
     yin_print_snode_common(out, level, node, node->module, NULL, SNODE_COMMON_CONFIG | SNODE_COMMON_MAND |
                            SNODE_COMMON_STATUS | SNODE_COMMON_DSC | SNODE_COMMON_REF);
@@ -1161,6 +1159,7 @@ yin_print_leaflist(struct lyout *out, int level, const struct lys_node *node)
     int i;
     struct lys_node_leaflist *llist = (struct lys_node_leaflist *)node;
     const char *dflt;
+    char *str = NULL;
 
     yin_print_open(out, level, NULL, "leaf-list", "name", node->name, 1);
     level++;
@@ -1183,18 +1182,17 @@ yin_print_leaflist(struct lyout *out, int level, const struct lys_node *node)
             assert(strchr(llist->dflt[i], ':'));
             if (!strncmp(llist->dflt[i], lys_node_module(node)->name, strchr(llist->dflt[i], ':') - llist->dflt[i])) {
                 /* local module */
-                dflt = lydict_insert(node->module->ctx, strchr(llist->dflt[i], ':') + 1, 0);
+                dflt = strchr(llist->dflt[i], ':') + 1;
             } else {
-                dflt = transform_json2schema(node->module, llist->dflt[i]);
+                dflt = str = transform_json2schema(node->module, llist->dflt[i]);
             }
         } else {
             dflt = llist->dflt[i];
         }
         yin_print_substmt(out, level, LYEXT_SUBSTMT_DEFAULT, i, dflt,
                           node->module, node->ext, node->ext_size);
-        if (llist->flags & LYS_DFLTJSON) {
-            lydict_remove(node->module->ctx, dflt);
-        }
+        free(str);
+        str = NULL;
     }
     yin_print_snode_common(out, level, node, node->module, NULL, SNODE_COMMON_CONFIG);
     if (llist->min > 0) {
@@ -29,8 +29,35 @@
 #include "xml_internal.h"
 #include "dict_private.h"
 #include "tree_internal.h"
+#include "context.h"
 #include "extensions.h"
 
+/**
+ * @brief What an unresolved schema item waits for. It is set by the resolving functions
+ * when they detect a forward reference and used by resolve_unres_schema() to postpone
+ * the item until the dependency is available.
+ */
+struct unres_wait {
+    enum {
+        UNRES_WAIT_NONE = 0,     /**< unknown dependency, retry after any progress */
+        UNRES_WAIT_GRP,          /**< grouping with unresolved uses (lys_node_grp::unres_count) */
+        UNRES_WAIT_TPDF,         /**< typedef with not yet resolved type */
+        UNRES_WAIT_ITEM          /**< another unres schema item (identity) */
+    } type;
+    const void *obj;             /**< grouping or typedef */
+    uint32_t idx;                /**< index of the unres schema item */
+};
+
+static THREAD_LOCAL struct unres_wait unres_wait;
+
+static void
+unres_wait_set(int type, const void *obj, uint32_t idx)
+{
+    unres_wait.type = type;
+    unres_wait.obj = obj;
+    unres_wait.idx = idx;
+}
+
 int
 parse_range_dec64(const char **str_num, uint8_t dig, int64_t *num)
 {
@@ -3077,7 +3104,7 @@ resolve_superior_type(const char *name, const char *mod_name, const struct lys_m
                       const struct lys_node *parent, struct lys_tpdf **ret)
 {
     int i, j;
-    struct lys_tpdf *tpdf, *match;
+    struct lys_tpdf *tpdf, *match, *wait = NULL;
     int tpdf_size;
 
     if (!mod_name) {
@@ -3139,9 +3166,13 @@ resolve_superior_type(const char *name, const char *mod_name, const struct lys_m
             }
 
             for (i = 0; i < tpdf_size; i++) {
-                if (!strcmp(tpdf[i].name, name) && tpdf[i].type.base > 0) {
-                    match = &tpdf[i];
-                    goto check_leafref;
+                if (!strcmp(tpdf[i].name, name)) {
+                    if (tpdf[i].type.base > 0) {
+                        match = &tpdf[i];
+                        goto check_leafref;
+                    } else if (!wait) {
+                        wait = &tpdf[i];
+                    }
                 }
             }
 
@@ -3157,22 +3188,34 @@ resolve_superior_type(const char *name, const char *mod_name, const struct lys_m
 
     /* search in top level typedefs */
     for (i = 0; i < module->tpdf_size; i++) {
-        if (!strcmp(module->tpdf[i].name, name) && module->tpdf[i].type.base > 0) {
-            match = &module->tpdf[i];
-            goto check_leafref;
+        if (!strcmp(module->tpdf[i].name, name)) {
+            if (module->tpdf[i].type.base > 0) {
+                match = &module->tpdf[i];
+                goto check_leafref;
+            } else if (!wait) {
+                wait = &module->tpdf[i];
+            }
         }
     }
 
     /* search in submodules */
     for (i = 0; i < module->inc_size && module->inc[i].submodule; i++) {
         for (j = 0; j < module->inc[i].submodule->tpdf_size; j++) {
-            if (!strcmp(module->inc[i].submodule->tpdf[j].name, name) && module->inc[i].submodule->tpdf[j].type.base > 0) {
-                match = &module->inc[i].submodule->tpdf[j];
-                goto check_leafref;
+            if (!strcmp(module->inc[i].submodule->tpdf[j].name, name)) {
+                if (module->inc[i].submodule->tpdf[j].type.base > 0) {
+                    match = &module->inc[i].submodule->tpdf[j];
+                    goto check_leafref;
+                } else if (!wait) {
+                    wait = &module->inc[i].submodule->tpdf[j];
+                }
             }
         }
     }
 
+    if (wait) {
+        /* the typedef exists, but its type is not resolved yet */
+        unres_wait_set(UNRES_WAIT_TPDF, wait, 0);
+    }
     return EXIT_FAILURE;
 
 check_leafref:
@@ -3906,21 +3949,44 @@ get_next_augment:
 }
 
 /**
- * @brief Compare 2 data node values.
+ * @brief Canonical values of the predicates of a single instance-identifier node. They are the same
+ * for all the data instances of the node, so they are transformed into the canonical form only once.
+ */
+struct instid_vals {
+    struct lys_node **schema;        /**< leaf/leaf-list the value was made canonical for */
+    const char **value;              /**< canonical value in the dictionary */
+    int count;                       /**< number of predicates */
+};
+
+/**
+ * @brief Forget all the canonical values of the predicates, they belong to another instance-identifier node.
  *
- * Comparison performed on canonical forms, the first value
- * is first transformed into canonical form.
+ * @param[in] ctx Context of the values.
+ * @param[in] vals Canonical values to clear.
+ */
+static void
+instid_vals_clear(struct ly_ctx *ctx, struct instid_vals *vals)
+{
+    int i;
+
+    for (i = 0; i < vals->count; ++i) {
+        lydict_remove(ctx, vals->value[i]);
+        vals->value[i] = NULL;
+        vals->schema[i] = NULL;
+    }
+}
+
+/**
+ * @brief Transform a value of a leaf/leaf-list into the canonical form.
  *
- * @param[in] node Leaf/leaf-list with these values.
+ * @param[in] node Leaf/leaf-list with the value.
  * @param[in] noncan_val Non-canonical value.
  * @param[in] noncan_val_len Length of \p noncal_val.
- * @param[in] can_val Canonical value.
- * @return 1 if equal, 0 if not, -1 on error (logged).
+ * @return Canonical value in the dictionary, NULL on error (logged).
  */
-static int
-valequal(struct lys_node *node, const char *noncan_val, int noncan_val_len, const char *can_val)
+static const char *
+valcanonical(struct lys_node *node, const char *noncan_val, int noncan_val_len)
 {
-    int ret;
     struct lyd_node_leaf_list leaf;
     struct lys_node_leaf *sleaf = (struct lys_node_leaf*)node;
 
@@ -3936,27 +4002,70 @@ repeat:
         if (!sleaf->type.info.lref.target) {
             /* it should either be unresolved leafref (leaf.value_type are ORed flags) or it will be resolved */
             LOGINT;
-            ret = -1;
-            goto finish;
+            goto error;
         }
         sleaf = sleaf->type.info.lref.target;
         goto repeat;
     } else {
         if (!lyp_parse_value(&sleaf->type, &leaf.value_str, NULL, &leaf, NULL, NULL, 0, 0)) {
-            ret = -1;
-            goto finish;
+            goto error;
         }
     }
 
-    if (!strcmp(leaf.value_str, can_val)) {
-        ret = 1;
-    } else {
-        ret = 0;
-    }
+    return leaf.value_str;
 
-finish:
+error:
     lydict_remove(node->module->ctx, leaf.value_str);
-    return ret;
+    return NULL;
+}
+
+/**
+ * @brief Compare 2 data node values.
+ *
+ * Comparison performed on canonical forms, the first value
+ * is first transformed into canonical form (only once for
+ * all the instances of the node).
+ *
+ * @param[in] node Leaf/leaf-list with these values.
+ * @param[in] noncan_val Non-canonical value.
+ * @param[in] noncan_val_len Length of \p noncal_val.
+ * @param[in] can_val Canonical value.
+ * @param[in] vals Canonical values of the predicates already transformed.
+ * @param[in] idx Index of the predicate with \p noncan_val.
+ * @return 1 if equal, 0 if not, -1 on error (logged).
+ */
+static int
+valequal(struct lys_node *node, const char *noncan_val, int noncan_val_len, const char *can_val,
+         struct instid_vals *vals, int idx)
+{
+    struct lys_node **schema;
+    const char **value;
+
+    if (idx >= vals->count) {
+        schema = realloc(vals->schema, (idx + 1) * sizeof *vals->schema);
+        LY_CHECK_ERR_RETURN(!schema, LOGMEM, -1);
+        vals->schema = schema;
+        value = realloc(vals->value, (idx + 1) * sizeof *vals->value);
+        LY_CHECK_ERR_RETURN(!value, LOGMEM, -1);
+        vals->value = value;
+        for (; vals->count <= idx; ++vals->count) {
+            vals->schema[vals->count] = NULL;
+            vals->value[vals->count] = NULL;
+        }
+    }
+
+    if (vals->schema[idx] != node) {
+        lydict_remove(node->module->ctx, vals->value[idx]);
+        vals->value[idx] = valcanonical(node, noncan_val, noncan_val_len);
+        if (!vals->value[idx]) {
+            vals->schema[idx] = NULL;
+            return -1;
+        }
+        vals->schema[idx] = node;
+    }
+
+    /* both the values are in the dictionary */
+    return ly_strequal(vals->value[idx], can_val, 1);
 }
 
 /**
@@ -3968,28 +4077,33 @@ finish:
  * @param[in,out] node Node matching the restriction without
  *                     the predicate. If it does not satisfy the predicate,
  *                     it is set to NULL.
+ * @param[in] cur_idx Position of \p node among the instances of the node.
+ * @param[in] vals Canonical values of the predicates, shared by all the instances of the node.
  *
  * @return Number of characters successfully parsed,
  *         positive on success, negative on failure.
  */
 static int
-resolve_instid_predicate(const struct lys_module *prev_mod, const char *pred, struct lyd_node **node, int cur_idx)
+resolve_instid_predicate(const struct lys_module *prev_mod, const char *pred, struct lyd_node **node, int cur_idx,
+                         struct instid_vals *vals)
 {
     /* ... /node[key=value] ... */
     struct lyd_node_leaf_list *key;
     struct lys_node_leaf **list_keys = NULL;
     struct lys_node_list *slist = NULL;
     const char *model, *name, *value;
-    int mod_len, nam_len, val_len, i, has_predicate, parsed;
+    int mod_len, nam_len, val_len, i, has_predicate, parsed, pred_idx;
 
     assert(pred && node && *node);
 
     parsed = 0;
+    pred_idx = -1;
     do {
         if ((i = parse_predicate(pred + parsed, &model, &mod_len, &name, &nam_len, &value, &val_len, &has_predicate)) < 1) {
             return -parsed + i;
         }
         parsed += i;
+        ++pred_idx;
 
         if (!(*node)) {
             /* just parse it all */
@@ -4007,7 +4121,7 @@ resolve_instid_predicate(const struct lys_module *prev_mod, const char *pred, st
             }
 
             /* check the value */
-            if (!valequal((*node)->schema, value, val_len, ((struct lyd_node_leaf_list *)*node)->value_str)) {
+            if (!valequal((*node)->schema, value, val_len, ((struct lyd_node_leaf_list *)*node)->value_str, vals, pred_idx)) {
                 *node = NULL;
                 goto cleanup;
             }
@@ -4100,7 +4214,7 @@ resolve_instid_predicate(const struct lys_module *prev_mod, const char *pred, st
             }
 
             /* check the value */
-            if (!valequal(key->schema, value, val_len, key->value_str)) {
+            if (!valequal(key->schema, value, val_len, key->value_str, vals, pred_idx)) {
                 *node = NULL;
                 /* we still want to parse the whole predicate */
                 continue;
@@ -5169,6 +5283,7 @@ matchfound:
                     return -1;
                 }
 
+                unres_wait_set(UNRES_WAIT_ITEM, NULL, i);
                 return EXIT_FAILURE;
             }
         }
@@ -5525,6 +5640,7 @@ resolve_unres_schema_uses(struct lys_node_uses *uses, struct unres_schema *unres
     }
 
     if (uses->grp->unres_count) {
+        unres_wait_set(UNRES_WAIT_GRP, uses->grp, 0);
         if (par_grp && !(uses->flags & LYS_USESGRP)) {
             if (++((struct lys_node_grp *)par_grp)->unres_count == 0) {
                 LOGERR(LY_EINT, "Too many unresolved items (uses) inside a grouping.");
@@ -5832,139 +5948,95 @@ resolve_when_ctx_node(struct lyd_node *node, struct lys_node *schema, struct lyd
 }
 
 /**
- * @brief Temporarily unlink nodes as per YANG 1.1 RFC section 7.21.5 for when XPath evaluation.
- * The context node is adjusted if needed.
- *
- * @param[in] snode Schema node, whose children instances need to be unlinked.
- * @param[in,out] node Data siblings where to look for the children of \p snode. If it is unlinked,
- * it is moved to point to another sibling still in the original tree.
- * @param[in,out] ctx_node When context node, adjusted if needed.
- * @param[in] ctx_node_type Context node type, just for information to detect invalid situations.
- * @param[out] unlinked_nodes Unlinked siblings. Can be safely appended to \p node afterwards.
- * Ordering may change, but there will be no semantic change.
+ * @brief Hide (or show again) nodes as per YANG 1.1 RFC section 7.21.5 for when XPath evaluation.
+ * The hidden nodes are skipped by the XPath evaluation, the data tree itself is not changed.
  *
- * @return EXIT_SUCCESS on success, -1 on error.
+ * @param[in] snode Schema node, whose children instances are hidden.
+ * @param[in] node Data siblings where to look for the children of \p snode.
+ * @param[in] hide Whether to hide the nodes or show them again.
  */
-static int
-resolve_when_unlink_nodes(struct lys_node *snode, struct lyd_node **node, struct lyd_node **ctx_node,
-                          enum lyxp_node_type ctx_node_type, struct lyd_node **unlinked_nodes)
+static void
+resolve_when_hide_nodes(const struct lys_node *snode, struct lyd_node *node, int hide)
 {
-    struct lyd_node *next, *elem;
-    const struct lys_node *slast;
-
-    switch (snode->nodetype) {
-    case LYS_AUGMENT:
-    case LYS_USES:
-    case LYS_CHOICE:
-    case LYS_CASE:
-        slast = NULL;
-        while ((slast = lys_getnext(slast, snode, NULL, LYS_GETNEXT_PARENTUSES))) {
-            if (slast->nodetype & (LYS_ACTION | LYS_NOTIF)) {
-                continue;
-            }
+    struct lyd_node *elem;
+    const struct lys_node *sparent;
 
-            if (resolve_when_unlink_nodes((struct lys_node *)slast, node, ctx_node, ctx_node_type, unlinked_nodes)) {
-                return -1;
+    LY_TREE_FOR(lyd_first_sibling(node), elem) {
+        /* is the node defined in snode? */
+        for (sparent = elem->schema->parent; sparent && (sparent != snode); ) {
+            if (sparent->nodetype & (LYS_USES | LYS_CHOICE | LYS_CASE)) {
+                sparent = sparent->parent;
+            } else if (sparent->nodetype == LYS_AUGMENT) {
+                sparent = ((struct lys_node_augment *)sparent)->target;
+            } else {
+                sparent = NULL;
             }
         }
-        break;
-    case LYS_CONTAINER:
-    case LYS_LIST:
-    case LYS_LEAF:
-    case LYS_LEAFLIST:
-    case LYS_ANYXML:
-    case LYS_ANYDATA:
-        LY_TREE_FOR_SAFE(lyd_first_sibling(*node), next, elem) {
-            if (elem->schema == snode) {
-
-                if (elem == *ctx_node) {
-                    /* We are going to unlink our context node! This normally cannot happen,
-                     * but we use normal top-level data nodes for faking a document root node,
-                     * so if this is the context node, we just use the next top-level node.
-                     * Additionally, it can even happen that there are no top-level data nodes left,
-                     * all were unlinked, so in this case we pass NULL as the context node/data tree,
-                     * lyxp_eval() can handle this special situation.
-                     */
-                    if (ctx_node_type == LYXP_NODE_ELEM) {
-                        LOGINT;
-                        return -1;
-                    }
-
-                    if (elem->prev == elem) {
-                        /* unlinking last top-level element, use an empty data tree */
-                        *ctx_node = NULL;
-                    } else {
-                        /* in this case just use the previous/last top-level data node */
-                        *ctx_node = elem->prev;
-                    }
-                } else if (elem == *node) {
-                    /* We are going to unlink the currently processed node. This does not matter that
-                     * much, but we would lose access to the original data tree, so just move our
-                     * pointer somewhere still inside it.
-                     */
-                    if ((*node)->prev != *node) {
-                        *node = (*node)->prev;
-                    } else {
-                        /* the processed node with sibings were all unlinked, oh well */
-                        *node = NULL;
-                    }
-                }
-
-                /* temporarily unlink the node */
-                lyd_unlink_internal(elem, 0);
-                if (*unlinked_nodes) {
-                    if (lyd_insert_after((*unlinked_nodes)->prev, elem)) {
-                        LOGINT;
-                        return -1;
-                    }
-                } else {
-                    *unlinked_nodes = elem;
-                }
+        if (!sparent) {
+            continue;
+        }
 
-                if (snode->nodetype & (LYS_CONTAINER | LYS_LEAF | LYS_ANYDATA)) {
-                    /* there can be only one instance */
-                    break;
-                }
-            }
+        if (hide) {
+            elem->validity |= LYD_VAL_HIDDEN;
+        } else {
+            elem->validity &= ~LYD_VAL_HIDDEN;
         }
-        break;
-    default:
-        LOGINT;
-        return -1;
     }
-
-    return EXIT_SUCCESS;
 }
 
 /**
- * @brief Relink the unlinked nodes back.
+ * @brief Evaluate the when condition of an augment, uses, choice or case node.
+ * Logs directly.
  *
- * @param[in] node Data node to link the nodes back to. It can actually be the adjusted context node,
- * we simply need a sibling from the original data tree.
- * @param[in] unlinked_nodes Unlinked nodes to relink to \p node.
- * @param[in] ctx_node_type Context node type to distinguish between \p node being the parent
- * or the sibling of \p unlinked_nodes.
+ * @param[in] snode Schema node with the when condition.
+ * @param[in] when When condition of \p snode.
+ * @param[in] node Data node, whose conditional definition is being decided.
+ * @param[in] ctx_node When context node.
+ * @param[in] ctx_node_type Context node type.
+ * @param[in] cache Results of the conditions evaluated before, NULL to always evaluate the condition.
+ * @param[out] result Boolean result of the condition.
  *
- * @return EXIT_SUCCESS on success, -1 on error.
+ * @return EXIT_SUCCESS on success, EXIT_FAILURE on unresolved when dependency, -1 on error.
  */
 static int
-resolve_when_relink_nodes(struct lyd_node *node, struct lyd_node *unlinked_nodes, enum lyxp_node_type ctx_node_type)
+resolve_when_snode(struct lys_node *snode, struct lys_when *when, struct lyd_node *node, struct lyd_node *ctx_node,
+                   enum lyxp_node_type ctx_node_type, struct unres_when_cache *cache, int *result)
 {
-    struct lyd_node *elem;
+    struct ly_ctx *ctx = node->schema->module->ctx;
+    struct lyxp_set set;
+    uint32_t idx = 0;
+    int rc;
 
-    LY_TREE_FOR_SAFE(unlinked_nodes, unlinked_nodes, elem) {
-        lyd_unlink_internal(elem, 0);
-        if (ctx_node_type == LYXP_NODE_ELEM) {
-            if (lyd_insert_common(node, NULL, elem, 0)) {
-                return -1;
-            }
-        } else {
-            if (lyd_insert_nextto(node, elem, 0, 0)) {
-                return -1;
-            }
+    if (cache) {
+        idx = (((uintptr_t)snode ^ (uintptr_t)ctx_node) >> 4) % UNRES_WHEN_CACHE_SIZE;
+        if ((cache->item[idx].snode == snode) && (cache->item[idx].ctx_node == ctx_node)
+                && (cache->item[idx].data_gen == LY_DATA_GEN(ctx))) {
+            *result = cache->item[idx].result;
+            return EXIT_SUCCESS;
         }
     }
 
+    memset(&set, 0, sizeof set);
+    resolve_when_hide_nodes(snode, node, 1);
+    rc = lyxp_eval(when->cond, ctx_node, ctx_node_type, lys_node_module(snode), &set, LYXP_WHEN);
+    resolve_when_hide_nodes(snode, node, 0);
+    if (rc) {
+        if (rc == 1) {
+            LOGVAL(LYE_INWHEN, LY_VLOG_LYD, node, when->cond);
+        }
+        lyxp_set_cast(&set, LYXP_SET_EMPTY, ctx_node, NULL, 0);
+        return rc;
+    }
+
+    lyxp_set_cast(&set, LYXP_SET_BOOLEAN, ctx_node, lys_node_module(snode), LYXP_WHEN);
+    *result = set.val.bool;
+
+    if (cache) {
+        cache->item[idx].snode = snode;
+        cache->item[idx].ctx_node = ctx_node;
+        cache->item[idx].data_gen = LY_DATA_GEN(ctx);
+        cache->item[idx].result = *result;
+    }
     return EXIT_SUCCESS;
 }
 
@@ -6070,6 +6142,7 @@ check_augment:
  * @param[in] node Data node, whose conditional reference, if such, is being decided.
  * @param[in] ignore_fail 1 if when does not have to be satisfied, 2 if it does not have to be satisfied
  * only when requiring external dependencies.
+ * @param[in] cache Results of the augment, uses, choice and case conditions evaluated before, can be NULL.
  *
  * @return
  *  -1 - error, ly_errno is set
@@ -6078,13 +6151,13 @@ check_augment:
  *   1, ly_vecode = LYVE_INWHEN - nodes needed to resolve are conditional and not yet resolved (under another "when")
  */
 int
-resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_when)
+resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_when, struct unres_when_cache *cache)
 {
-    struct lyd_node *ctx_node = NULL, *unlinked_nodes, *tmp_node;
+    struct lyd_node *ctx_node = NULL;
     struct lys_node *sparent;
     struct lyxp_set set;
     enum lyxp_node_type ctx_node_type;
-    int rc = 0;
+    int rc = 0, result;
 
     assert(node);
     memset(&set, 0, sizeof set);
@@ -6137,33 +6210,13 @@ resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_wh
                 }
             }
 
-            unlinked_nodes = NULL;
-            /* we do not want our node pointer to change */
-            tmp_node = node;
-            rc = resolve_when_unlink_nodes(sparent, &tmp_node, &ctx_node, ctx_node_type, &unlinked_nodes);
+            rc = resolve_when_snode(sparent, ((struct lys_node_uses *)sparent)->when, node, ctx_node, ctx_node_type,
+                                    cache, &result);
             if (rc) {
                 goto cleanup;
             }
 
-            rc = lyxp_eval(((struct lys_node_uses *)sparent)->when->cond, ctx_node, ctx_node_type, lys_node_module(sparent),
-                           &set, LYXP_WHEN);
-
-            if (unlinked_nodes && ctx_node) {
-                if (resolve_when_relink_nodes(ctx_node, unlinked_nodes, ctx_node_type)) {
-                    rc = -1;
-                    goto cleanup;
-                }
-            }
-
-            if (rc) {
-                if (rc == 1) {
-                    LOGVAL(LYE_INWHEN, LY_VLOG_LYD, node, ((struct lys_node_uses *)sparent)->when->cond);
-                }
-                goto cleanup;
-            }
-
-            lyxp_set_cast(&set, LYXP_SET_BOOLEAN, ctx_node, lys_node_module(sparent), LYXP_WHEN);
-            if (!set.val.bool) {
+            if (!result) {
                 if ((ignore_fail == 1)
                         || ((((struct lys_node_uses *)sparent)->when->flags & LYS_XPATH_DEP) || (ignore_fail == 2))) {
                     LOGVRB("When condition \"%s\" is not satisfied, but it is not required.",
@@ -6177,9 +6230,6 @@ resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_wh
                     goto cleanup;
                 }
             }
-
-            /* free xpath set content */
-            lyxp_set_cast(&set, LYXP_SET_EMPTY, ctx_node, lys_node_module(sparent), 0);
         }
 
 check_augment:
@@ -6192,35 +6242,13 @@ check_augment:
                 }
             }
 
-            unlinked_nodes = NULL;
-            tmp_node = node;
-            rc = resolve_when_unlink_nodes(sparent->parent, &tmp_node, &ctx_node, ctx_node_type, &unlinked_nodes);
+            rc = resolve_when_snode(sparent->parent, ((struct lys_node_augment *)sparent->parent)->when, node, ctx_node,
+                                    ctx_node_type, cache, &result);
             if (rc) {
                 goto cleanup;
             }
 
-            rc = lyxp_eval(((struct lys_node_augment *)sparent->parent)->when->cond, ctx_node, ctx_node_type,
-                           lys_node_module(sparent->parent), &set, LYXP_WHEN);
-
-            /* reconnect nodes, if ctx_node is NULL then all the nodes were unlinked, but linked together,
-             * so the tree did not actually change and there is nothing for us to do
-             */
-            if (unlinked_nodes && ctx_node) {
-                if (resolve_when_relink_nodes(ctx_node, unlinked_nodes, ctx_node_type)) {
-                    rc = -1;
-                    goto cleanup;
-                }
-            }
-
-            if (rc) {
-                if (rc == 1) {
-                    LOGVAL(LYE_INWHEN, LY_VLOG_LYD, node, ((struct lys_node_augment *)sparent->parent)->when->cond);
-                }
-                goto cleanup;
-            }
-
-            lyxp_set_cast(&set, LYXP_SET_BOOLEAN, ctx_node, lys_node_module(sparent->parent), LYXP_WHEN);
-            if (!set.val.bool) {
+            if (!result) {
                 node->when_status |= LYD_WHEN_FALSE;
                 if ((ignore_fail == 1)
                         || ((((struct lys_node_augment *)sparent->parent)->when->flags & LYS_XPATH_DEP) && (ignore_fail == 2))) {
@@ -6234,9 +6262,6 @@ check_augment:
                     goto cleanup;
                 }
             }
-
-            /* free xpath set content */
-            lyxp_set_cast(&set, LYXP_SET_EMPTY, ctx_node, lys_node_module(sparent->parent), 0);
         }
 
         sparent = lys_parent(sparent);
@@ -6541,6 +6566,11 @@ resolve_unres_schema_item(struct lys_module *mod, void *item, enum UNRES_ITEM ty
                     return -1;
                 }
             }
+
+            /* the type is complete, it is only read from now on */
+            if (lyp_type_prepare(stype)) {
+                return -1;
+            }
         } else if (rc == EXIT_FAILURE && stype->base != LY_TYPE_ERR) {
             /* forward reference - in case the type is in grouping, we have to make the grouping unusable
              * by uses statement until the type is resolved. We do that the same way as uses statements inside
@@ -6891,9 +6921,10 @@ print_unres_schema_item_fail(void *item, enum UNRES_ITEM type, void *str_node)
 int
 resolve_unres_schema(struct lys_module *mod, struct unres_schema *unres)
 {
-    uint32_t i, resolved = 0, unres_count, res_count;
+    uint32_t i, resolved = 0, unres_count, res_count, wait_size = 0;
     struct lyxml_elem *yin;
     struct yang_type *yang;
+    struct unres_wait *wait = NULL, *w;
     int rc, log_hidden;
 
     assert(unres);
@@ -6911,6 +6942,22 @@ resolve_unres_schema(struct lys_module *mod, struct unres_schema *unres)
         unres_count = 0;
         res_count = 0;
 
+        if (wait_size < unres->count) {
+            /* new items could have been added by the resolved uses */
+            w = realloc(wait, unres->count * sizeof *wait);
+            if (!w) {
+                LOGMEM;
+                free(wait);
+                if (!log_hidden) {
+                    ly_vlog_hide(0);
+                }
+                return -1;
+            }
+            wait = w;
+            memset(&wait[wait_size], 0, (unres->count - wait_size) * sizeof *wait);
+            wait_size = unres->count;
+        }
+
         for (i = 0; i < unres->count; ++i) {
             /* UNRES_TYPE_LEAFREF must be resolved (for storing leafref target pointers);
              * if-features are resolved here to make sure that we will have all if-features for
@@ -6922,12 +6969,22 @@ resolve_unres_schema(struct lys_module *mod, struct unres_schema *unres)
              * UNRES_AUGMENT, UNRES_CHOICE_DFLT and UNRES_IDENT */
 
             ++unres_count;
+
+            /* do not try the item again until the object it is waiting for is available */
+            if (((wait[i].type == UNRES_WAIT_GRP) && ((struct lys_node_grp *)wait[i].obj)->unres_count)
+                    || ((wait[i].type == UNRES_WAIT_TPDF) && (((struct lys_tpdf *)wait[i].obj)->type.base <= 0))
+                    || ((wait[i].type == UNRES_WAIT_ITEM) && (unres->type[wait[i].idx] == UNRES_IDENT))) {
+                continue;
+            }
+
+            unres_wait_set(UNRES_WAIT_NONE, NULL, 0);
             rc = resolve_unres_schema_item(unres->module[i], unres->item[i], unres->type[i], unres->str_snode[i], unres);
             if (!rc) {
                 unres->type[i] = UNRES_RESOLVED;
                 ++resolved;
                 ++res_count;
             } else if (rc == -1) {
+                free(wait);
                 if (!log_hidden) {
                     ly_vlog_hide(0);
                 }
@@ -6935,11 +6992,13 @@ resolve_unres_schema(struct lys_module *mod, struct unres_schema *unres)
                 ly_err_repeat(ly_parser_data.ctx);
                 return -1;
             } else {
-                /* forward reference, erase ly_errno */
+                /* forward reference, remember what the item waits for and erase ly_errno */
+                wait[i] = unres_wait;
                 ly_err_clean(ly_parser_data.ctx, 1);
             }
         }
     } while (res_count && (res_count < unres_count));
+    free(wait);
 
     if (res_count < unres_count) {
         /* just print the errors */
@@ -7399,6 +7458,49 @@ check_instid_ext_dep(const struct lys_node *sleaf, const char *json_instid)
     return ret;
 }
 
+/**
+ * @brief Check whether an instance-identifier target can be kept until the data change
+ * (::ly_ctx#data_gen). Positional predicates and leaf-lists without a value predicate
+ * may select another node (or more nodes) even when some node is only inserted.
+ *
+ * @param[in] path Instance-identifier node value.
+ * @param[in] target Resolved instance.
+ * @return 1 if the target can be remembered, 0 otherwise.
+ */
+static int
+instid_target_cacheable(const char *path, struct lyd_node *target)
+{
+    const char *ptr;
+    char quot = 0;
+
+    for (ptr = path; *ptr; ++ptr) {
+        if (quot) {
+            if (*ptr == quot) {
+                quot = 0;
+            }
+        } else if ((*ptr == '\'') || (*ptr == '"')) {
+            quot = *ptr;
+        } else if (*ptr == '[') {
+            while (isspace(ptr[1])) {
+                ++ptr;
+            }
+            if (isdigit(ptr[1])) {
+                return 0;
+            }
+        }
+    }
+
+    if (target->schema->nodetype == LYS_LEAFLIST) {
+        /* the last node must have the value predicate */
+        for (--ptr; (ptr > path) && isspace(*ptr); --ptr);
+        if (*ptr != ']') {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
 /**
  * @brief Resolve instance-identifier in JSON data format. Logs directly.
  *
@@ -7419,8 +7521,10 @@ resolve_instid(struct lyd_node *data, const char *path, int req_inst, struct lyd
     char *str;
     int mod_len, name_len, has_predicate;
     struct unres_data node_match;
+    struct instid_vals vals;
 
     memset(&node_match, 0, sizeof node_match);
+    memset(&vals, 0, sizeof vals);
     *ret = NULL;
 
     /* we need root to resolve absolute path */
@@ -7479,7 +7583,7 @@ resolve_instid(struct lyd_node *data, const char *path, int req_inst, struct lyd
             cur_idx = 1;
             while (j < (signed)node_match.count) {
                 node = node_match.node[j];
-                parsed = resolve_instid_predicate(mod, &path[i], &node, cur_idx);
+                parsed = resolve_instid_predicate(mod, &path[i], &node, cur_idx, &vals);
                 if (parsed < 1) {
                     LOGVAL(LYE_INPRED, LY_VLOG_LYD, data, &path[i - parsed]);
                     goto error;
@@ -7510,6 +7614,10 @@ resolve_instid(struct lyd_node *data, const char *path, int req_inst, struct lyd
         prev_mod = mod;
     }
 
+    instid_vals_clear(ctx, &vals);
+    free(vals.schema);
+    free(vals.value);
+
     if (!node_match.count) {
         /* no instance exists */
         if (req_inst > -1) {
@@ -7521,7 +7629,8 @@ resolve_instid(struct lyd_node *data, const char *path, int req_inst, struct lyd
     } else if (node_match.count > 1) {
         /* instance identifier must resolve to a single node */
         LOGVAL(LYE_TOOMANY, LY_VLOG_LYD, data, path, "data tree");
-        goto error;
+        free(node_match.node);
+        return -1;
     } else {
         /* we have required result, remember it and cleanup */
         *ret = node_match.node[0];
@@ -7531,6 +7640,9 @@ resolve_instid(struct lyd_node *data, const char *path, int req_inst, struct lyd
 
 error:
     /* cleanup */
+    instid_vals_clear(ctx, &vals);
+    free(vals.schema);
+    free(vals.value);
     free(node_match.node);
     return -1;
 }
@@ -7585,7 +7697,8 @@ resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store,
 {
     struct lys_type *t;
     struct lyd_node *ret;
-    int found, hidden, success = 0, ext_dep, req_inst;
+    int hidden, success = 0, ext_dep, req_inst;
+    unsigned int u;
     const char *json_val = NULL;
 
     assert(type->base == LY_TYPE_UNION);
@@ -7606,11 +7719,9 @@ resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store,
     hidden = ly_vlog_hidden;
     ly_vlog_hide(1);
 
-    t = NULL;
-    found = 0;
-    while ((t = lyp_get_next_union_type(type, t, &found))) {
-        found = 0;
-
+    /* the member types the value cannot be of are skipped */
+    u = 0;
+    while ((t = lyp_get_next_union_member(type, leaf->value_str, &u))) {
         switch (t->base) {
         case LY_TYPE_LEAFREF:
             if ((ignore_fail == 1) || ((leaf->schema->flags & LYS_LEAFREF_DEP) && (ignore_fail == 2))) {
@@ -7735,11 +7846,14 @@ resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store,
  * @param[in] node Data node to resolve.
  * @param[in] type Type of the unresolved item.
  * @param[in] ignore_fail 0 - no, 1 - yes, 2 - yes, but only for external dependencies.
+ * @param[out] failed_when The false when condition of an UNRES_WHEN item.
+ * @param[in] when_cache Results of the when conditions evaluated before, can be NULL.
  *
  * @return EXIT_SUCCESS on success, EXIT_FAILURE on forward reference, -1 on error.
  */
 int
-resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_fail, struct lys_when **failed_when)
+resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_fail, struct lys_when **failed_when,
+                        struct unres_when_cache *when_cache)
 {
     int rc, req_inst, ext_dep;
     struct lyd_node_leaf_list *leaf;
@@ -7748,6 +7862,7 @@ resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_
 
     leaf = (struct lyd_node_leaf_list *)node;
     sleaf = (struct lys_node_leaf *)leaf->schema;
+    LY_STATS_INC(sleaf->module->ctx, unres_data_items);
 
     switch (type) {
     case UNRES_LEAFREF:
@@ -7783,6 +7898,12 @@ resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_
 
     case UNRES_INSTID:
         assert(sleaf->type.base == LY_TYPE_INST);
+        if ((leaf->value_type == LY_TYPE_INST) && leaf->value.instance
+                && (leaf->value_gen == LY_DATA_GEN(leaf->schema->module->ctx))) {
+            /* no data were removed or changed since the last resolution */
+            break;
+        }
+
         ext_dep = check_instid_ext_dep(leaf->schema, leaf->value_str);
         if (ext_dep == -1) {
             return -1;
@@ -7799,6 +7920,7 @@ resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_
                 /* valid resolved */
                 leaf->value.instance = ret;
                 leaf->value_type = LY_TYPE_INST;
+                leaf->value_gen = instid_target_cacheable(leaf->value_str, ret) ? LY_DATA_GEN(leaf->schema->module->ctx) : 0;
             } else {
                 /* valid unresolved */
                 leaf->value.instance = NULL;
@@ -7814,7 +7936,7 @@ resolve_unres_data_item(struct lyd_node *node, enum UNRES_ITEM type, int ignore_
         return resolve_union(leaf, &sleaf->type, 1, ignore_fail, NULL);
 
     case UNRES_WHEN:
-        if ((rc = resolve_when(node, ignore_fail, failed_when))) {
+        if ((rc = resolve_when(node, ignore_fail, failed_when, when_cache))) {
             return rc;
         }
         break;
@@ -7870,37 +7992,20 @@ unres_data_add(struct unres_data *unres, struct lyd_node *node, enum UNRES_ITEM
     return EXIT_SUCCESS;
 }
 
-/**
- * @brief Resolve every unres data item in the structure. Logs directly.
- *
- * If options includes LYD_OPT_TRUSTED, the data are considered trusted (when, must conditions are not expected,
- * unresolved leafrefs/instids are accepted).
- *
- * If options includes LYD_OPT_NOAUTODEL, the false resulting when condition on non-default nodes, the error is raised.
- *
- * @param[in] unres Unres data structure to use.
- * @param[in,out] root Root node of the data tree, can be changed due to autodeletion.
- * @param[in] options Data options as described above.
- *
- * @return EXIT_SUCCESS on success, -1 on error.
- */
-int
-resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options)
+static int
+resolve_unres_data_rounds(struct unres_data *unres, struct lyd_node **root, int options, struct ly_ctx *ctx)
 {
     uint32_t i, j, first, resolved, del_items, stmt_count;
     int rc, progress, ignore_fail;
     struct lyd_node *parent;
     struct lys_when *when;
-
-    assert(root);
-    assert(unres);
-
-    if (!unres->count) {
-        return EXIT_SUCCESS;
-    }
+    struct unres_when_cache when_cache;
 
     if (options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER | LYD_OPT_GET | LYD_OPT_GETCONFIG | LYD_OPT_EDIT)) {
         ignore_fail = 1;
+    } else if (options & LYD_OPT_SELECT) {
+        /* leafref and instance-identifier targets may be in the skipped data */
+        ignore_fail = 1;
     } else if (options & LYD_OPT_NOEXTDEPS) {
         ignore_fail = 2;
     } else {
@@ -7915,7 +8020,9 @@ resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options
     stmt_count = 0;
     resolved = 0;
     del_items = 0;
+    memset(&when_cache, 0, sizeof when_cache);
     do {
+        LY_STATS_INC(ctx, unres_data_rounds);
         ly_err_clean(ly_parser_data.ctx, 1);
         progress = 0;
         for (i = 0; i < unres->count; i++) {
@@ -7945,7 +8052,7 @@ resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options
                 continue;
             }
 
-            rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, &when);
+            rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, &when, &when_cache);
             if (!rc) {
                 /* finish with error/delete the node only if when was false, an external dependency was not required,
                  * or it was not provided (the flag would not be passed down otherwise, checked in upper functions) */
@@ -8013,7 +8120,7 @@ resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options
             } else if (rc == -1) {
                 ly_vlog_hide(0);
                 /* print only this last error */
-                resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL);
+                resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL, NULL);
                 return -1;
             } /* else forward reference */
         }
@@ -8049,6 +8156,7 @@ resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options
     stmt_count = 0;
     resolved = 0;
     do {
+        LY_STATS_INC(ctx, unres_data_rounds);
         progress = 0;
         for (i = 0; i < unres->count; i++) {
             if (unres->type[i] != UNRES_LEAFREF) {
@@ -8059,7 +8167,7 @@ resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options
                 stmt_count++;
             }
 
-            rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL);
+            rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL, NULL);
             if (!rc) {
                 unres->type[i] = UNRES_RESOLVED;
                 ly_err_clean(ly_parser_data.ctx, 1);
@@ -8068,7 +8176,7 @@ resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options
             } else if (rc == -1) {
                 ly_vlog_hide(0);
                 /* print only this last error */
-                resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL);
+                resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL, NULL);
                 return -1;
             } /* else forward reference */
         }
@@ -8085,13 +8193,14 @@ resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options
     ly_vlog_hide(0);
 
     /* rest */
+    LY_STATS_INC(ctx, unres_data_rounds);
     for (i = 0; i < unres->count; ++i) {
         if (unres->type[i] == UNRES_RESOLVED) {
             continue;
         }
         assert(!(options & LYD_OPT_TRUSTED) || ((unres->type[i] != UNRES_MUST) && (unres->type[i] != UNRES_MUST_INOUT)));
 
-        rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL);
+        rc = resolve_unres_data_item(unres->node[i], unres->type[i], ignore_fail, NULL, NULL);
         if (rc) {
             /* since when was already resolved, a forward reference is an error */
             return -1;
@@ -8104,3 +8213,39 @@ resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options
     unres->count = 0;
     return EXIT_SUCCESS;
 }
+
+/**
+ * @brief Resolve every unres data item in the structure. Logs directly.
+ *
+ * If options includes LYD_OPT_TRUSTED, the data are considered trusted (when, must conditions are not expected,
+ * unresolved leafrefs/instids are accepted).
+ *
+ * If options includes LYD_OPT_NOAUTODEL, the false resulting when condition on non-default nodes, the error is raised.
+ *
+ * @param[in] unres Unres data structure to use.
+ * @param[in,out] root Root node of the data tree, can be changed due to autodeletion.
+ * @param[in] options Data options as described above.
+ *
+ * @return EXIT_SUCCESS on success, -1 on error.
+ */
+int
+resolve_unres_data(struct unres_data *unres, struct lyd_node **root, int options)
+{
+    struct ly_ctx *ctx;
+    uint64_t start;
+    int rc;
+
+    assert(root);
+    assert(unres);
+
+    if (!unres->count) {
+        return EXIT_SUCCESS;
+    }
+
+    ctx = unres->node[0]->schema->module->ctx;
+    LY_STATS_TIMER_START(ctx, start);
+    rc = resolve_unres_data_rounds(unres, root, options, ctx);
+    LY_STATS_TIMER_STOP(ctx, start, time_unres);
+
+    return rc;
+}
@@ -85,6 +85,8 @@ struct unres_list_uniq {
     uint8_t *trg_type;
 };
 
+struct lyp_select;
+
 /**
  * @brief Unresolved items in DATA
  */
@@ -92,6 +94,22 @@ struct unres_data {
     struct lyd_node **node;
     enum UNRES_ITEM *type;
     uint32_t count;
+    struct lyp_select *select;      /* schema nodes selected to be parsed (#LYD_OPT_SELECT), NULL to parse all */
+};
+
+/**
+ * @brief Results of the when conditions of augment, uses, choice and case nodes evaluated while resolving
+ * unresolved data items. All the instances of the nodes defined in such a schema node share the context node,
+ * so the condition is evaluated only once for them. Valid only while ::ly_ctx#data_gen does not change.
+ */
+#define UNRES_WHEN_CACHE_SIZE 64
+struct unres_when_cache {
+    struct {
+        const struct lys_node *snode;   /* schema node with the when condition */
+        const struct lyd_node *ctx_node; /* context node of the evaluation */
+        uint32_t data_gen;              /* data generation of the result */
+        uint8_t result;                 /* boolean result of the condition */
+    } item[UNRES_WHEN_CACHE_SIZE];
 };
 
 /**
@@ -129,6 +147,19 @@ struct len_ran_intv {
     struct len_ran_intv *next;
 };
 
+/* compiled intervals of a single length/range restriction, sorted and disjoint,
+ * the minimum of the i-th interval is in bound[2 * i], its maximum in bound[2 * i + 1] */
+struct len_ran_bounds {
+    uint32_t count;            /* number of intervals */
+    uint8_t kind;              /* 0 - unsigned, 1 - signed, 2 - floating point */
+    uint8_t fdig;              /* fraction digits of the floating point bounds */
+    union {
+        uint64_t uval;
+        int64_t sval;
+        int64_t fval;
+    } bound[];
+};
+
 /**
  * @brief Convert a string with a decimal64 value into our representation.
  * Syntax is expected to be correct. Does not log.
@@ -208,7 +239,7 @@ struct lys_ident *resolve_identref(struct lys_type *type, const char *ident_name
 
 int resolve_unres_schema(struct lys_module *mod, struct unres_schema *unres);
 
-int resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_when);
+int resolve_when(struct lyd_node *node, int ignore_fail, struct lys_when **failed_when, struct unres_when_cache *cache);
 
 int unres_schema_add_str(struct lys_module *mod, struct unres_schema *unres, void *item, enum UNRES_ITEM type,
                          const char *str);
@@ -230,7 +261,8 @@ void unres_schema_free(struct lys_module *module, struct unres_schema **unres, i
 int resolve_union(struct lyd_node_leaf_list *leaf, struct lys_type *type, int store, int ignore_fail,
                   struct lys_type **resolved_type);
 
-int resolve_unres_data_item(struct lyd_node *dnode, enum UNRES_ITEM type, int ignore_fail, struct lys_when **failed_when);
+int resolve_unres_data_item(struct lyd_node *dnode, enum UNRES_ITEM type, int ignore_fail, struct lys_when **failed_when,
+                            struct unres_when_cache *when_cache);
 
 int unres_data_addonly(struct unres_data *unres, struct lyd_node *node, enum UNRES_ITEM type);
 int unres_data_add(struct unres_data *unres, struct lyd_node *node, enum UNRES_ITEM type);
@@ -93,6 +93,11 @@ lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
         } else {
             if ((!(options & LYD_OPT_TYPEMASK) || (options & (LYD_OPT_CONFIG | LYD_OPT_RPC | LYD_OPT_RPCREPLY | LYD_OPT_NOTIF)))
                     && resolve_applies_when(schema, 1, last_parent ? last_parent->schema : NULL)) {
+                if (options & LYD_OPT_SELECT) {
+                    /* the condition may refer to the data skipped by the parser */
+                    return EXIT_SUCCESS;
+                }
+
                 /* evaluate when statements */
                 dummy = lyd_new_dummy(root, last_parent, schema, NULL, 0);
                 if (!dummy) {
@@ -105,7 +110,7 @@ lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
                 }
                 for (current = dummy; current; current = current->child) {
                     ly_vlog_hide(1);
-                    resolve_when(current, 0, NULL);
+                    resolve_when(current, 0, NULL, NULL);
                     ly_vlog_hide(0);
                     if (current->when_status & LYD_WHEN_FALSE) {
                         /* when evaluates to false */
@@ -176,6 +181,88 @@ lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
     return EXIT_SUCCESS;
 }
 
+/**
+ * @brief Mark the schema nodes whose subtrees are supposed to be checked by lyd_check_mandatory_subtree()
+ * with #LYS_MAND_SUBTREE.
+ *
+ * @param[in] siblings First of the schema siblings to mark.
+ * @return Whether any of the siblings checked as a part of its parent's subtree was marked.
+ */
+static int
+lyd_mandatory_plan_r(struct lys_node *siblings)
+{
+    struct lys_node *siter;
+    int ret = 0, mand;
+
+    LY_TREE_FOR(siblings, siter) {
+        switch (siter->nodetype) {
+        case LYS_LEAF:
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+        case LYS_CHOICE:
+            mand = siter->flags & LYS_MAND_TRUE;
+            break;
+        case LYS_LIST:
+            mand = ((struct lys_node_list *)siter)->min || ((struct lys_node_list *)siter)->max;
+            break;
+        case LYS_LEAFLIST:
+            mand = ((struct lys_node_leaflist *)siter)->min || ((struct lys_node_leaflist *)siter)->max;
+            break;
+        case LYS_GROUPING:
+            /* not instantiated */
+            continue;
+        default:
+            mand = 0;
+            break;
+        }
+        if (!(siter->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) && lyd_mandatory_plan_r(siter->child)) {
+            mand = 1;
+        }
+
+        /* the flags are written only if changed, other threads may be reading them */
+        if (mand && !(siter->flags & LYS_MAND_SUBTREE)) {
+            siter->flags |= LYS_MAND_SUBTREE;
+        } else if (!mand && (siter->flags & LYS_MAND_SUBTREE)) {
+            siter->flags &= ~LYS_MAND_SUBTREE;
+        }
+        if (mand && !(siter->nodetype & (LYS_RPC | LYS_ACTION))) {
+            /* RPCs and actions are checked separately, not as a part of their parent */
+            ret = 1;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Update the #LYS_MAND_SUBTREE flags in the schemas of the context if the modules changed since
+ * the last time, since an augment or a deviation can add a mandatory node into any module.
+ *
+ * @param[in] ctx Context to update.
+ */
+static void
+lyd_mandatory_plan(struct ly_ctx *ctx)
+{
+    int i;
+    uint16_t set_id;
+
+    set_id = LY_CACHE_LOAD(ctx->models.mand_set_id);
+    if (set_id && (set_id == ctx->models.module_set_id)) {
+        /* up to date */
+        return;
+    }
+
+    pthread_mutex_lock(&ctx->cache_lock);
+    if (!ctx->models.mand_set_id || (ctx->models.mand_set_id != ctx->models.module_set_id)) {
+        /* not updated by another thread meanwhile */
+        for (i = 0; i < ctx->models.used; i++) {
+            lyd_mandatory_plan_r(ctx->models.list[i]->data);
+        }
+        LY_CACHE_STORE(ctx->models.mand_set_id, ctx->models.module_set_id);
+    }
+    pthread_mutex_unlock(&ctx->cache_lock);
+}
+
 /**
  * @brief Check the specific subtree, specified by \p schema node, for presence of mandatory nodes. Function goes
  * recursively into the subtree.
@@ -193,11 +280,13 @@ lyd_check_mandatory_data(struct lyd_node *root, struct lyd_node *last_parent,
  * @param[in] schema The schema node being checked for mandatory nodes
  * @param[in] toplevel, see the \p root parameter description
  * @param[in] options @ref parseroptions to specify the type of the data tree.
+ * @param[in] select Selection of the parsed schema nodes (#LYD_OPT_SELECT), only the selected subtrees are checked,
+ * NULL to check everything.
  * @return EXIT_SUCCESS or EXIT_FAILURE if there are missing mandatory nodes
  */
 static int
 lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, struct lyd_node *last_parent,
-                            struct lys_node *schema, int toplevel, int options)
+                            struct lys_node *schema, int toplevel, int options, struct lyp_select *select)
 {
     struct lys_node *siter, *siter_prev;
     struct lyd_node *iter;
@@ -207,6 +296,26 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
 
     assert(schema);
 
+    if (!(schema->flags & LYS_MAND_SUBTREE)) {
+        /* nothing to check in the subtree */
+        return EXIT_SUCCESS;
+    }
+
+    if (select) {
+        switch (lyp_data_selected(select, schema)) {
+        case 0:
+            /* not parsed */
+            return EXIT_SUCCESS;
+        case 2:
+            /* the whole subtree was parsed */
+            select = NULL;
+            break;
+        default:
+            /* only an ancestor of the selected nodes, which are checked in its subtree */
+            break;
+        }
+    }
+
     if (schema->nodetype & (LYS_LEAF | LYS_LIST | LYS_LEAFLIST | LYS_ANYDATA | LYS_CONTAINER)) {
         /* data node */
         present = ly_set_new();
@@ -228,20 +337,20 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
     case LYS_ANYXML:
     case LYS_ANYDATA:
         /* check the schema item */
-        if (lyd_check_mandatory_data(tree, last_parent, present, schema, options)) {
+        if (!select && lyd_check_mandatory_data(tree, last_parent, present, schema, options)) {
             goto error;
         }
         break;
     case LYS_LIST:
         /* check the schema item */
-        if (lyd_check_mandatory_data(tree, last_parent, present, schema, options)) {
+        if (!select && lyd_check_mandatory_data(tree, last_parent, present, schema, options)) {
             goto error;
         }
 
         /* go recursively */
         for (u = 0; u < present->number; u++) {
             LY_TREE_FOR(schema->child, siter) {
-                if (lyd_check_mandatory_subtree(tree, present->set.d[u], present->set.d[u], siter, 0, options)) {
+                if (lyd_check_mandatory_subtree(tree, present->set.d[u], present->set.d[u], siter, 0, options, select)) {
                     goto error;
                 }
             }
@@ -254,7 +363,7 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
             LY_TREE_FOR(schema->child, siter) {
                 if (lyd_check_mandatory_subtree(tree, present->number ? present->set.d[0] : NULL,
                                                 present->number ? present->set.d[0] : last_parent,
-                                                siter, 0, options)) {
+                                                siter, 0, options, select)) {
                     goto error;
                 }
             }
@@ -286,10 +395,10 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
             if (((struct lys_node_choice *)schema)->dflt) {
                 /* there is a default case */
                 if (lyd_check_mandatory_subtree(tree, subtree, last_parent, ((struct lys_node_choice *)schema)->dflt,
-                                                toplevel, options)) {
+                                                toplevel, options, select)) {
                     goto error;
                 }
-            } else if (schema->flags & LYS_MAND_TRUE) {
+            } else if (!select && (schema->flags & LYS_MAND_TRUE)) {
                 /* choice requires some data to be instantiated */
                 LOGVAL(LYE_NOMANDCHOICE, LY_VLOG_LYD, last_parent, schema->name);
                 goto error;
@@ -299,7 +408,7 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
             /* since iter != NULL, siter must be also != NULL and we also know siter_prev
              * which points to the child of schema leading towards the instantiated data */
             assert(siter && siter_prev);
-            if (lyd_check_mandatory_subtree(tree, subtree, last_parent, siter_prev, toplevel, options)) {
+            if (lyd_check_mandatory_subtree(tree, subtree, last_parent, siter_prev, toplevel, options, select)) {
                 goto error;
             }
         }
@@ -311,7 +420,7 @@ lyd_check_mandatory_subtree(struct lyd_node *tree, struct lyd_node *subtree, str
     case LYS_NOTIF:
         /* go recursively */
         LY_TREE_FOR(schema->child, siter) {
-            if (lyd_check_mandatory_subtree(tree, subtree, last_parent, siter, toplevel, options)) {
+            if (lyd_check_mandatory_subtree(tree, subtree, last_parent, siter, toplevel, options, select)) {
                 goto error;
             }
         }
@@ -329,7 +438,7 @@ error:
 }
 
 int
-lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, int options)
+lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, int options, struct lyp_select *select)
 {
     struct lys_node *siter;
     int i;
@@ -346,10 +455,11 @@ lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, int options)
         /* get context */
         ctx = root->schema->module->ctx;
     }
+    lyd_mandatory_plan(ctx);
 
     if (!(options & LYD_OPT_TYPEMASK) || (options & (LYD_OPT_DATA | LYD_OPT_CONFIG))) {
         if (options & LYD_OPT_NOSIBLINGS) {
-            if (root && lyd_check_mandatory_subtree(root, NULL, NULL, root->schema, 1, options)) {
+            if (root && lyd_check_mandatory_subtree(root, NULL, NULL, root->schema, 1, options, select)) {
                 return EXIT_FAILURE;
             }
         } else {
@@ -362,7 +472,7 @@ lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, int options)
                 }
                 LY_TREE_FOR(ctx->models.list[i]->data, siter) {
                     if (!(siter->nodetype & (LYS_RPC | LYS_NOTIF)) &&
-                            lyd_check_mandatory_subtree(root, NULL, NULL, siter, 1, options)) {
+                            lyd_check_mandatory_subtree(root, NULL, NULL, siter, 1, options, select)) {
                         return EXIT_FAILURE;
                     }
                 }
@@ -373,7 +483,7 @@ lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, int options)
             LOGERR(LY_EINVAL, "Subtree is not a single notification.");
             return EXIT_FAILURE;
         }
-        if (root->schema->child && lyd_check_mandatory_subtree(root, root, root, root->schema, 0, options)) {
+        if (root->schema->child && lyd_check_mandatory_subtree(root, root, root, root->schema, 0, options, select)) {
             return EXIT_FAILURE;
         }
     } else if (options & (LYD_OPT_RPC | LYD_OPT_RPCREPLY)) {
@@ -386,7 +496,7 @@ lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, int options)
         } else { /* LYD_OPT_RPCREPLY */
             for (siter = root->schema->child; siter && siter->nodetype != LYS_OUTPUT; siter = siter->next);
         }
-        if (siter && lyd_check_mandatory_subtree(root, root, root, siter, 0, options)) {
+        if (siter && lyd_check_mandatory_subtree(root, root, root, siter, 0, options, select)) {
             return EXIT_FAILURE;
         }
     } else {
@@ -397,14 +507,19 @@ lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, int options)
     return EXIT_SUCCESS;
 }
 
+static struct lyd_parse_push *lyd_parse_push_create(struct ly_ctx *ctx, int options, const struct lyd_node *rpc_act,
+                                                    const struct lyd_node *data_tree, const struct ly_set *select);
+
 static struct lyd_node *
 lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data, LYD_FORMAT format, int options,
-           const struct lyd_node *data_tree)
+           const struct lyd_node *data_tree, const struct ly_set *select)
 {
     struct lyxml_elem *xml;
+    struct lyd_parse_push *push;
     struct lyd_node *result = NULL;
     int xmlopt = LYXML_PARSE_MULTIROOT;
     struct ly_ctx *ctx_prev = ly_parser_data.ctx;
+    uint64_t start;
 
     if (!ctx || !data) {
         LOGERR(LY_EINVAL, "%s: Invalid parameter.", __func__);
@@ -414,13 +529,29 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
     /* set parser context */
     ly_parser_data.ctx = ctx;
 
+    /* update the schema flags before the parser reads them, so it is not done while other threads parse */
+    lyd_mandatory_plan(ctx);
+
     if (options & LYD_OPT_NOSIBLINGS) {
         xmlopt = 0;
     }
 
     switch (format) {
     case LYD_XML:
+        if (select) {
+            /* the push parser skips the elements not selected without building their XML tree */
+            push = lyd_parse_push_create(ctx, options, rpc_act, data_tree, select);
+            if (push && !lyd_parse_push_feed(push, data, strlen(data))) {
+                result = lyd_parse_push_finish(push);
+            } else {
+                lyd_parse_push_free(push);
+            }
+            break;
+        }
+
+        LY_STATS_TIMER_START(ctx, start);
         xml = lyxml_parse_mem(ctx, data, xmlopt);
+        LY_STATS_TIMER_STOP(ctx, start, time_parse);
         if (ly_errno) {
             break;
         }
@@ -434,7 +565,7 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
         lyxml_free_withsiblings(ctx, xml);
         break;
     case LYD_JSON:
-        result = lyd_parse_json(ctx, data, options, rpc_act, data_tree);
+        result = lyd_parse_json(ctx, data, options, rpc_act, data_tree, select);
         break;
     default:
         /* error */
@@ -452,51 +583,72 @@ lyd_parse_(struct ly_ctx *ctx, const struct lyd_node *rpc_act, const char *data,
     }
 }
 
-static struct lyd_node *
-lyd_parse_data_(struct ly_ctx *ctx, const char *data, LYD_FORMAT format, int options, va_list ap)
+static int
+lyd_parse_args_(int options, va_list ap, const struct lyd_node **rpc_act, const struct lyd_node **data_tree,
+                const struct ly_set **select, const char *func)
 {
-    const struct lyd_node *rpc_act = NULL, *data_tree = NULL, *iter;
+    const struct lyd_node *iter;
 
-    if (lyp_data_check_options(options, __func__)) {
-        return NULL;
+    if (lyp_data_check_options(options, func)) {
+        return EXIT_FAILURE;
     }
 
     if (options & LYD_OPT_RPCREPLY) {
-        rpc_act = va_arg(ap, const struct lyd_node *);
-        if (!rpc_act || rpc_act->parent || !(rpc_act->schema->nodetype & (LYS_RPC | LYS_LIST | LYS_CONTAINER))) {
-            LOGERR(LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", __func__);
-            return NULL;
+        *rpc_act = va_arg(ap, const struct lyd_node *);
+        if (!*rpc_act || (*rpc_act)->parent || !((*rpc_act)->schema->nodetype & (LYS_RPC | LYS_LIST | LYS_CONTAINER))) {
+            LOGERR(LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *rpc_act).", func);
+            return EXIT_FAILURE;
         }
     }
     if (options & (LYD_OPT_RPC | LYD_OPT_NOTIF | LYD_OPT_RPCREPLY)) {
-        data_tree = va_arg(ap, const struct lyd_node *);
-        if (data_tree) {
+        *data_tree = va_arg(ap, const struct lyd_node *);
+        if (*data_tree) {
             if (options & LYD_OPT_NOEXTDEPS) {
                 LOGERR(LY_EINVAL, "%s: invalid parameter (variable arg const struct lyd_node *data_tree and LYD_OPT_NOEXTDEPS set).",
-                       __func__);
-                return NULL;
+                       func);
+                return EXIT_FAILURE;
             }
 
-            LY_TREE_FOR(data_tree, iter) {
+            LY_TREE_FOR(*data_tree, iter) {
                 if (iter->parent) {
                     /* a sibling is not top-level */
-                    LOGERR(LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *data_tree).", __func__);
-                    return NULL;
+                    LOGERR(LY_EINVAL, "%s: invalid variable parameter (const struct lyd_node *data_tree).", func);
+                    return EXIT_FAILURE;
                 }
             }
 
             /* move it to the beginning */
-            for (; data_tree->prev->next; data_tree = data_tree->prev);
+            for (; (*data_tree)->prev->next; *data_tree = (*data_tree)->prev);
 
             /* LYD_OPT_NOSIBLINGS cannot be set in this case */
             if (options & LYD_OPT_NOSIBLINGS) {
-                LOGERR(LY_EINVAL, "%s: invalid parameter (variable arg const struct lyd_node *data_tree with LYD_OPT_NOSIBLINGS).", __func__);
-                return NULL;
+                LOGERR(LY_EINVAL, "%s: invalid parameter (variable arg const struct lyd_node *data_tree with LYD_OPT_NOSIBLINGS).", func);
+                return EXIT_FAILURE;
             }
         }
     }
+    if (options & LYD_OPT_SELECT) {
+        *select = va_arg(ap, const struct ly_set *);
+        if (!*select) {
+            LOGERR(LY_EINVAL, "%s: invalid variable parameter (const struct ly_set *select).", func);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static struct lyd_node *
+lyd_parse_data_(struct ly_ctx *ctx, const char *data, LYD_FORMAT format, int options, va_list ap)
+{
+    const struct lyd_node *rpc_act = NULL, *data_tree = NULL;
+    const struct ly_set *select = NULL;
+
+    if (lyd_parse_args_(options, ap, &rpc_act, &data_tree, &select, __func__)) {
+        return NULL;
+    }
 
-    return lyd_parse_(ctx, rpc_act, data, format, options, data_tree);
+    return lyd_parse_(ctx, rpc_act, data, format, options, data_tree, select);
 }
 
 API struct lyd_node *
@@ -512,18 +664,205 @@ lyd_parse_mem(struct ly_ctx *ctx, const char *data, LYD_FORMAT format, int optio
     return result;
 }
 
+static struct lyd_parse_push *
+lyd_parse_push_create(struct ly_ctx *ctx, int options, const struct lyd_node *rpc_act, const struct lyd_node *data_tree,
+                      const struct ly_set *select)
+{
+    struct lyd_parse_push *push;
+
+    push = calloc(1, sizeof *push);
+    LY_CHECK_ERR_RETURN(!push, LOGMEM, NULL);
+    push->ctx = ctx;
+    push->options = options;
+    push->rpc_act = rpc_act;
+    push->data_tree = data_tree;
+    push->select = select;
+
+    /* as in lyd_parse_(), the schema flags are updated before the parser reads them */
+    lyd_mandatory_plan(ctx);
+
+    if (xml_push_init(push)) {
+        lyd_parse_push_free(push);
+        return NULL;
+    }
+
+    return push;
+}
+
+static struct lyd_parse_push *
+lyd_parse_push_new_(struct ly_ctx *ctx, LYD_FORMAT format, int options, va_list ap)
+{
+    const struct lyd_node *rpc_act = NULL, *data_tree = NULL;
+    const struct ly_set *select = NULL;
+
+    if (!ctx) {
+        LOGERR(LY_EINVAL, "%s: Invalid parameter.", __func__);
+        return NULL;
+    } else if (format != LYD_XML) {
+        LOGERR(LY_EINVAL, "%s: Only XML data can be parsed incrementally.", __func__);
+        return NULL;
+    }
+
+    if (lyd_parse_args_(options, ap, &rpc_act, &data_tree, &select, __func__)) {
+        return NULL;
+    }
+
+    return lyd_parse_push_create(ctx, options, rpc_act, data_tree, select);
+}
+
+API struct lyd_parse_push *
+lyd_parse_push_new(struct ly_ctx *ctx, LYD_FORMAT format, int options, ...)
+{
+    struct lyd_parse_push *push;
+    va_list ap;
+
+    va_start(ap, options);
+    push = lyd_parse_push_new_(ctx, format, options, ap);
+    va_end(ap);
+
+    return push;
+}
+
+API int
+lyd_parse_push_feed(struct lyd_parse_push *push, const char *data, size_t len)
+{
+    struct ly_ctx *ctx_prev = ly_parser_data.ctx;
+    char *buf;
+    size_t size;
+    int ret = EXIT_SUCCESS;
+
+    if (!push || (!data && len)) {
+        LOGERR(LY_EINVAL, "%s: Invalid parameter.", __func__);
+        return EXIT_FAILURE;
+    } else if (push->error) {
+        LOGERR(LY_EINVAL, "%s: The parser has already failed.", __func__);
+        return EXIT_FAILURE;
+    }
+
+    if (push->used + len + 1 > push->size) {
+        for (size = push->size ? push->size : 4096; size < push->used + len + 1; size *= 2);
+        buf = realloc(push->buf, size);
+        LY_CHECK_ERR_RETURN(!buf, LOGMEM; push->error = 1, EXIT_FAILURE);
+        push->buf = buf;
+        push->size = size;
+    }
+    memcpy(push->buf + push->used, data, len);
+    push->used += len;
+    push->buf[push->used] = '\0';
+
+    /* set parser context */
+    ly_parser_data.ctx = push->ctx;
+    if (xml_push_parse(push, 0)) {
+        ret = EXIT_FAILURE;
+    }
+    ly_parser_data.ctx = ctx_prev;
+
+    return ret;
+}
+
+API struct lyd_node *
+lyd_parse_push_finish(struct lyd_parse_push *push)
+{
+    struct ly_ctx *ctx_prev = ly_parser_data.ctx;
+    struct lyd_node *result = NULL;
+
+    if (!push) {
+        LOGERR(LY_EINVAL, "%s: Invalid parameter.", __func__);
+        return NULL;
+    }
+
+    if (!push->error) {
+        /* set parser context */
+        ly_parser_data.ctx = push->ctx;
+        result = xml_push_finish(push);
+        ly_parser_data.ctx = ctx_prev;
+        if (ly_errno) {
+            lyd_free_withsiblings(result);
+            result = NULL;
+        }
+    }
+
+    lyd_parse_push_free(push);
+    return result;
+}
+
+API void
+lyd_parse_push_free(struct lyd_parse_push *push)
+{
+    if (!push) {
+        return;
+    }
+
+    xml_push_clean(push);
+    free(push->buf);
+    free(push);
+}
+
 static struct lyd_node *
 lyd_parse_fd_(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int options, va_list ap)
 {
     struct lyd_node *ret;
-    size_t length;
-    char *data;
+    struct lyd_parse_push *push;
+    struct stat sb;
+    size_t length, size;
+    ssize_t r;
+    char *data, *buf, chunk[4096];
 
     if (!ctx || (fd == -1)) {
         LOGERR(LY_EINVAL, "%s: Invalid parameter.", __func__);
         return NULL;
     }
 
+    if (!fstat(fd, &sb) && !S_ISREG(sb.st_mode)) {
+        if (format != LYD_XML) {
+            /* pipe, socket, ... cannot be mapped and only XML can be parsed as the data come, so read all of them */
+            length = 0;
+            size = sizeof chunk;
+            data = malloc(size);
+            LY_CHECK_ERR_RETURN(!data, LOGMEM, NULL);
+            while ((r = read(fd, data + length, size - length - 1))) {
+                if ((r == -1) && (errno == EINTR)) {
+                    continue;
+                } else if (r == -1) {
+                    LOGERR(LY_ESYS, "Reading data from the file descriptor failed (%s).", strerror(errno));
+                    free(data);
+                    return NULL;
+                }
+                length += r;
+                if (length + 1 == size) {
+                    size *= 2;
+                    buf = realloc(data, size);
+                    LY_CHECK_ERR_RETURN(!buf, LOGMEM; free(data), NULL);
+                    data = buf;
+                }
+            }
+            data[length] = '\0';
+
+            ret = lyd_parse_data_(ctx, data, format, options, ap);
+            free(data);
+            return ret;
+        }
+
+        /* XML data are parsed as they come */
+        push = lyd_parse_push_new_(ctx, format, options, ap);
+        if (!push) {
+            return NULL;
+        }
+        while ((r = read(fd, chunk, sizeof chunk))) {
+            if ((r == -1) && (errno == EINTR)) {
+                continue;
+            } else if (r == -1) {
+                LOGERR(LY_ESYS, "Reading data from the file descriptor failed (%s).", strerror(errno));
+                lyd_parse_push_free(push);
+                return NULL;
+            } else if (lyd_parse_push_feed(push, chunk, r)) {
+                lyd_parse_push_free(push);
+                return NULL;
+            }
+        }
+        return lyd_parse_push_finish(push);
+    }
+
     data = lyp_mmap(fd, 0, &length);
     if (data == MAP_FAILED) {
         LOGERR(LY_ESYS, "Mapping file descriptor into memory failed (%s()).", __func__);
@@ -610,6 +949,7 @@ _lyd_new(struct lyd_node *parent, const struct lys_node *schema, int dflt)
 
     ret = calloc(1, sizeof *ret);
     LY_CHECK_ERR_RETURN(!ret, LOGMEM, NULL);
+    LY_STATS_INC(schema->module->ctx, node_allocs);
 
     ret->schema = (struct lys_node *)schema;
     ret->validity = ly_new_node_validity(schema);
@@ -659,6 +999,7 @@ lyd_create_leaf(const struct lys_node *schema, const char *val_str, int dflt)
 
     ret = calloc(1, sizeof *ret);
     LY_CHECK_ERR_RETURN(!ret, LOGMEM, NULL);
+    LY_STATS_INC(schema->module->ctx, node_allocs);
 
     ret->schema = (struct lys_node *)schema;
     ret->validity = ly_new_node_validity(schema);
@@ -704,7 +1045,7 @@ _lyd_new_leaf(struct lyd_node *parent, const struct lys_node *schema, const char
 
         /* set flag for future validation */
         if (parent) {
-            parent->validity |= LYD_VAL_UNIQUE;
+            lyv_unique_invalidate(parent);
         }
     }
 
@@ -816,7 +1157,7 @@ check_leaf_list_backlinks(struct lyd_node *node, int op)
 
     /* invalidate parent to make sure it will be checked in future validation */
     if (validity_changed && node->parent) {
-        node->parent->validity = LYD_VAL_MAND;
+        node->parent->validity |= LYD_VAL_MAND;
     }
 }
 
@@ -843,6 +1184,8 @@ lyd_change_leaf(struct lyd_node_leaf_list *leaf, const char *val_str)
         leaf->value_str = backup;
         return -1;
     }
+    /* the value was reparsed, any resolved instance-identifier is invalid */
+    LY_DATA_GEN_NEXT(leaf->schema->module->ctx);
 
     if (!strcmp(backup, leaf->value_str)) {
         /* the value remains the same */
@@ -875,6 +1218,10 @@ lyd_change_leaf(struct lyd_node_leaf_list *leaf, const char *val_str)
 
     /* make the node non-validate */
     leaf->validity = ly_new_node_validity(leaf->schema);
+    if (leaf->schema->nodetype == LYS_LEAFLIST) {
+        /* the instance may duplicate another one now */
+        lyv_unique_invalidate((struct lyd_node *)leaf);
+    }
 
     /* check possible leafref backlinks */
     check_leaf_list_backlinks((struct lyd_node *)leaf, 2);
@@ -885,7 +1232,7 @@ lyd_change_leaf(struct lyd_node_leaf_list *leaf, const char *val_str)
 
         /* set flag for future validation */
         if (parent) {
-            parent->validity |= LYD_VAL_UNIQUE;
+            lyv_unique_invalidate(parent);
         }
     }
 
@@ -901,6 +1248,7 @@ lyd_create_anydata(struct lyd_node *parent, const struct lys_node *schema, void
 
     ret = calloc(1, sizeof *ret);
     LY_CHECK_ERR_RETURN(!ret, LOGMEM, NULL);
+    LY_STATS_INC(schema->module->ctx, node_allocs);
 
     ret->schema = (struct lys_node *)schema;
     ret->validity = ly_new_node_validity(schema);
@@ -1215,14 +1563,73 @@ lyd_new_path_update(struct lyd_node *node, void *value, LYD_ANYDATA_VALUETYPE va
     return NULL;
 }
 
+/**
+ * @brief Find the data schema child matching a single node identifier of a simple data path.
+ *
+ * @param[in] sparent Schema parent, NULL for top-level nodes.
+ * @param[in] module Module to search in for top-level nodes.
+ * @param[in] prev_mod Module of the previous path node, used for unprefixed node names.
+ * @param[in] mod_name Module name of the node, NULL if not prefixed.
+ * @param[in] mod_name_len Length of \p mod_name.
+ * @param[in] name Node name.
+ * @param[in] nam_len Length of \p name.
+ * @param[in] options Bitmask of options flags, see @ref pathoptions.
+ * @return Found schema node, NULL if there is none.
+ */
+static const struct lys_node *
+lyd_new_path_schema_child(const struct lys_node *sparent, const struct lys_module *module, const struct lys_module *prev_mod,
+                          const char *mod_name, int mod_name_len, const char *name, int nam_len, int options)
+{
+    const struct lys_node *schild = NULL, *tmp;
+    const char *node_mod_name;
+
+    while ((schild = lys_getnext(schild, sparent, module, 0))) {
+        if (schild->nodetype & (LYS_CONTAINER | LYS_LEAF | LYS_LEAFLIST | LYS_LIST
+                                | LYS_ANYDATA | LYS_NOTIF | LYS_RPC | LYS_ACTION)) {
+            /* module comparison */
+            if (mod_name) {
+                node_mod_name = lys_node_module(schild)->name;
+                if (strncmp(node_mod_name, mod_name, mod_name_len) || node_mod_name[mod_name_len]) {
+                    continue;
+                }
+            } else if (lys_node_module(schild) != prev_mod) {
+                continue;
+            }
+
+            /* name check */
+            if (strncmp(schild->name, name, nam_len) || schild->name[nam_len]) {
+                continue;
+            }
+
+            /* RPC/action in/out check */
+            for (tmp = lys_parent(schild); tmp && (tmp->nodetype == LYS_USES); tmp = lys_parent(tmp));
+            if (tmp) {
+                if (options & LYD_PATH_OPT_OUTPUT) {
+                    if (tmp->nodetype == LYS_INPUT) {
+                        continue;
+                    }
+                } else {
+                    if (tmp->nodetype == LYS_OUTPUT) {
+                        continue;
+                    }
+                }
+            }
+
+            return schild;
+        }
+    }
+
+    return NULL;
+}
+
 API struct lyd_node *
 lyd_new_path(struct lyd_node *data_tree, struct ly_ctx *ctx, const char *path, void *value,
              LYD_ANYDATA_VALUETYPE value_type, int options)
 {
     char *module_name = ly_buf(), *buf_backup = NULL, *str;
-    const char *mod_name, *name, *val_name, *val, *node_mod_name, *id;
+    const char *mod_name, *name, *val_name, *val, *id;
     struct lyd_node *ret = NULL, *node, *parent = NULL;
-    const struct lys_node *schild, *sparent, *tmp;
+    const struct lys_node *schild, *sparent;
     const struct lys_node_list *slist;
     const struct lys_module *module, *prev_mod;
     int r, i, parsed = 0, mod_name_len, nam_len, val_name_len, val_len;
@@ -1328,43 +1735,7 @@ lyd_new_path(struct lyd_node *data_tree, struct ly_ctx *ctx, const char *path, v
     /* create nodes in a loop */
     while (1) {
         /* find the schema node */
-        schild = NULL;
-        while ((schild = lys_getnext(schild, sparent, module, 0))) {
-            if (schild->nodetype & (LYS_CONTAINER | LYS_LEAF | LYS_LEAFLIST | LYS_LIST
-                                    | LYS_ANYDATA | LYS_NOTIF | LYS_RPC | LYS_ACTION)) {
-                /* module comparison */
-                if (mod_name) {
-                    node_mod_name = lys_node_module(schild)->name;
-                    if (strncmp(node_mod_name, mod_name, mod_name_len) || node_mod_name[mod_name_len]) {
-                        continue;
-                    }
-                } else if (lys_node_module(schild) != prev_mod) {
-                    continue;
-                }
-
-                /* name check */
-                if (strncmp(schild->name, name, nam_len) || schild->name[nam_len]) {
-                    continue;
-                }
-
-                /* RPC/action in/out check */
-                for (tmp = lys_parent(schild); tmp && (tmp->nodetype == LYS_USES); tmp = lys_parent(tmp));
-                if (tmp) {
-                    if (options & LYD_PATH_OPT_OUTPUT) {
-                        if (tmp->nodetype == LYS_INPUT) {
-                            continue;
-                        }
-                    } else {
-                        if (tmp->nodetype == LYS_OUTPUT) {
-                            continue;
-                        }
-                    }
-                }
-
-                break;
-            }
-        }
-
+        schild = lyd_new_path_schema_child(sparent, module, prev_mod, mod_name, mod_name_len, name, nam_len, options);
         if (!schild) {
             str = strndup(path, (name + nam_len) - path);
             LOGVAL(LYE_PATH_INNODE, LY_VLOG_STR, str);
@@ -1524,6 +1895,422 @@ lyd_new_path(struct lyd_node *data_tree, struct ly_ctx *ctx, const char *path, v
     return NULL;
 }
 
+API struct lyd_path_tmpl *
+lyd_path_tmpl_compile(struct ly_ctx *ctx, const char *path, int options)
+{
+    struct lyd_path_tmpl *tmpl;
+    const struct lys_node *schild, *sparent = NULL, **steps;
+    const struct lys_module *module, *prev_mod;
+    const char *id, *mod_name, *name;
+    char *str;
+    int r, mod_name_len, nam_len, is_relative = -1, has_predicate;
+
+    if (!ctx || !path) {
+        ly_errno = LY_EINVAL;
+        return NULL;
+    }
+
+    id = path;
+    if ((r = parse_schema_nodeid(id, &mod_name, &mod_name_len, &name, &nam_len, &is_relative, &has_predicate, NULL, 0)) < 1) {
+        LOGVAL(LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[-r], &id[-r]);
+        return NULL;
+    }
+    if (is_relative) {
+        LOGERR(LY_EINVAL, "%s: path template (%s) must be absolute.", __func__, path);
+        return NULL;
+    } else if (!mod_name) {
+        str = strndup(path, (name + nam_len) - path);
+        LOGVAL(LYE_PATH_MISSMOD, LY_VLOG_STR, str);
+        free(str);
+        return NULL;
+    }
+
+    str = strndup(mod_name, mod_name_len);
+    LY_CHECK_ERR_RETURN(!str, LOGMEM, NULL);
+    module = ly_ctx_get_module(ctx, str, NULL, 1);
+    free(str);
+    if (!module) {
+        str = strndup(path, (mod_name + mod_name_len) - path);
+        LOGVAL(LYE_PATH_INMOD, LY_VLOG_STR, str);
+        free(str);
+        return NULL;
+    }
+    mod_name = NULL;
+    mod_name_len = 0;
+    prev_mod = module;
+
+    tmpl = calloc(1, sizeof *tmpl);
+    LY_CHECK_ERR_RETURN(!tmpl, LOGMEM, NULL);
+    tmpl->ctx = ctx;
+    tmpl->options = options & LYD_PATH_OPT_OUTPUT;
+
+    while (1) {
+        id += r;
+        if (has_predicate) {
+            LOGVAL(LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[0], id);
+            goto error;
+        }
+
+        schild = lyd_new_path_schema_child(sparent, module, prev_mod, mod_name, mod_name_len, name, nam_len, options);
+        if (!schild) {
+            str = strndup(path, (name + nam_len) - path);
+            LOGVAL(LYE_PATH_INNODE, LY_VLOG_STR, str);
+            free(str);
+            goto error;
+        }
+        if ((schild->nodetype == LYS_LEAF) && sparent && (sparent->nodetype == LYS_LIST)
+                && lys_is_key((struct lys_node_list *)sparent, (struct lys_node_leaf *)schild)) {
+            /* keys are created together with their list */
+            LOGVAL(LYE_PATH_INKEY, LY_VLOG_NONE, NULL, schild->name);
+            goto error;
+        }
+
+        steps = realloc(tmpl->steps, (tmpl->step_count + 1) * sizeof *tmpl->steps);
+        LY_CHECK_ERR_GOTO(!steps, LOGMEM, error);
+        tmpl->steps = steps;
+        tmpl->steps[tmpl->step_count++] = schild;
+        if (schild->nodetype == LYS_LIST) {
+            tmpl->key_count += ((struct lys_node_list *)schild)->keys_size;
+        }
+
+        if (!id[0]) {
+            break;
+        } else if (schild->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) {
+            LOGVAL(LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[0], id);
+            goto error;
+        } else if ((schild->nodetype == LYS_LIST) && !((struct lys_node_list *)schild)->keys_size) {
+            /* instances of a keyless list cannot be addressed */
+            LOGVAL(LYE_PATH_MISSKEY, LY_VLOG_NONE, NULL, schild->name);
+            goto error;
+        }
+
+        sparent = schild;
+        prev_mod = lys_node_module(schild);
+        if ((r = parse_schema_nodeid(id, &mod_name, &mod_name_len, &name, &nam_len, &is_relative, &has_predicate, NULL, 0)) < 1) {
+            LOGVAL(LYE_PATH_INCHAR, LY_VLOG_NONE, NULL, id[-r], &id[-r]);
+            goto error;
+        }
+    }
+
+    if (schild->nodetype == LYS_LEAFLIST) {
+        ++tmpl->key_count;
+    }
+    tmpl->path = lydict_insert(ctx, path, 0);
+
+    return tmpl;
+
+error:
+    lyd_path_tmpl_free(tmpl);
+    return NULL;
+}
+
+API unsigned int
+lyd_path_tmpl_key_count(const struct lyd_path_tmpl *tmpl)
+{
+    if (!tmpl) {
+        return 0;
+    }
+
+    return tmpl->key_count;
+}
+
+API void
+lyd_path_tmpl_free(struct lyd_path_tmpl *tmpl)
+{
+    if (!tmpl) {
+        return;
+    }
+
+    lydict_remove(tmpl->ctx, tmpl->path);
+    free(tmpl->steps);
+    free(tmpl);
+}
+
+/**
+ * @brief Compare a leaf (-list) value with a key value provided for a path template slot
+ * the same way resolve_partial_json_data_nodeid() compares predicate values.
+ *
+ * @return 1 if equal, 0 if not.
+ */
+static int
+lyd_path_tmpl_valeq(const struct lyd_node_leaf_list *leaf, const char *value)
+{
+    const char *val_str = leaf->value_str, *mod_name;
+    size_t len;
+
+    if (((leaf->value_type & LY_DATA_TYPE_MASK) == LY_TYPE_IDENT) && !strchr(value, ':')) {
+        /* make value canonical (remove module name prefix) */
+        mod_name = lyd_node_module((struct lyd_node *)leaf)->name;
+        len = strlen(mod_name);
+        if (!strncmp(val_str, mod_name, len) && (val_str[len] == ':')) {
+            val_str += len + 1;
+        }
+    }
+
+    return ly_strequal(val_str, value, 0);
+}
+
+/**
+ * @brief Find the instance of a path template step among siblings.
+ *
+ * @param[in] first First sibling to search.
+ * @param[in] schema Schema node of the step.
+ * @param[in] key_values Key values of the step.
+ * @return Matching instance, NULL if there is none.
+ */
+static struct lyd_node *
+lyd_path_tmpl_match(struct lyd_node *first, const struct lys_node *schema, const char **key_values)
+{
+    struct lyd_node *iter, *key;
+    const struct lys_node_list *slist;
+    uint8_t i;
+
+    LY_TREE_FOR(first, iter) {
+        if (iter->schema != schema) {
+            continue;
+        }
+
+        if (schema->nodetype == LYS_LIST) {
+            slist = (const struct lys_node_list *)schema;
+            for (i = 0, key = iter->child; i < slist->keys_size; ++i, key = key->next) {
+                if (!key || (key->schema != (struct lys_node *)slist->keys[i])
+                        || !lyd_path_tmpl_valeq((struct lyd_node_leaf_list *)key, key_values[i])) {
+                    break;
+                }
+            }
+            if (i < slist->keys_size) {
+                continue;
+            }
+        } else if ((schema->nodetype == LYS_LEAFLIST) && !lyd_path_tmpl_valeq((struct lyd_node_leaf_list *)iter, key_values[0])) {
+            continue;
+        }
+
+        return iter;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find the deepest existing node on the path of a path template.
+ *
+ * @param[in] data_tree Any node of the data tree.
+ * @param[in] tmpl Compiled path template.
+ * @param[in] key_values Key values for the template slots.
+ * @param[out] matched Number of matched template steps.
+ * @param[out] slot Number of used key values of the matched steps.
+ * @return The deepest existing node, NULL if not even the top-level node exists.
+ */
+static struct lyd_node *
+lyd_path_tmpl_resolve(const struct lyd_node *data_tree, const struct lyd_path_tmpl *tmpl, const char **key_values,
+                      uint16_t *matched, uint16_t *slot)
+{
+    struct lyd_node *start, *node, *last = NULL;
+    uint16_t i;
+
+    *matched = 0;
+    *slot = 0;
+    if (!data_tree) {
+        return NULL;
+    }
+
+    for (; data_tree->parent; data_tree = data_tree->parent);
+    start = lyd_first_sibling((struct lyd_node *)data_tree);
+
+    for (i = 0; i < tmpl->step_count; ++i) {
+        node = lyd_path_tmpl_match(start, tmpl->steps[i], key_values + *slot);
+        if (!node) {
+            break;
+        }
+
+        if (tmpl->steps[i]->nodetype == LYS_LIST) {
+            *slot += ((struct lys_node_list *)tmpl->steps[i])->keys_size;
+        } else if (tmpl->steps[i]->nodetype == LYS_LEAFLIST) {
+            ++(*slot);
+        }
+        last = node;
+        if (tmpl->steps[i]->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) {
+            /* the target node, it has no children */
+            ++i;
+            break;
+        }
+        start = node->child;
+    }
+    *matched = i;
+
+    return last;
+}
+
+/**
+ * @brief Check that the data tree and the key values can be used with the path template.
+ *
+ * @return EXIT_SUCCESS if they can, EXIT_FAILURE otherwise (ly_errno set).
+ */
+static int
+lyd_path_tmpl_check(const struct lyd_node *data_tree, const struct lyd_path_tmpl *tmpl, const char **key_values,
+                    const char *func)
+{
+    uint16_t i;
+
+    if (data_tree && (data_tree->schema->module->ctx != tmpl->ctx)) {
+        LOGERR(LY_EINVAL, "%s: The data tree and the path template are from different contexts.", func);
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i < tmpl->key_count; ++i) {
+        if (!key_values[i]) {
+            LOGERR(LY_EINVAL, "%s: Missing key value %u of the path template \"%s\".", func, i, tmpl->path);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+API struct lyd_node *
+lyd_path_tmpl_find(const struct lyd_node *data_tree, const struct lyd_path_tmpl *tmpl, const char **key_values)
+{
+    struct lyd_node *node;
+    uint16_t matched, slot;
+
+    if (!data_tree || !tmpl || (tmpl->key_count && !key_values)) {
+        ly_errno = LY_EINVAL;
+        return NULL;
+    }
+    if (lyd_path_tmpl_check(data_tree, tmpl, key_values, __func__)) {
+        return NULL;
+    }
+
+    node = lyd_path_tmpl_resolve(data_tree, tmpl, key_values, &matched, &slot);
+    if (matched < tmpl->step_count) {
+        return NULL;
+    }
+
+    return node;
+}
+
+API struct lyd_node *
+lyd_path_tmpl_new(struct lyd_node *data_tree, const struct lyd_path_tmpl *tmpl, const char **key_values, void *value,
+                  LYD_ANYDATA_VALUETYPE value_type, int options)
+{
+    struct lyd_node *ret = NULL, *node, *parent;
+    const struct lys_node *schema, *sparent;
+    const struct lys_node_list *slist;
+    uint16_t i, slot;
+    uint8_t k;
+    int dflt = (options & LYD_PATH_OPT_DFLT) ? 1 : 0;
+
+    if (!tmpl || (tmpl->key_count && !key_values)
+            || ((options & LYD_PATH_OPT_OUTPUT) != tmpl->options)) {
+        ly_errno = LY_EINVAL;
+        return NULL;
+    }
+    if (lyd_path_tmpl_check(data_tree, tmpl, key_values, __func__)) {
+        return NULL;
+    }
+
+    parent = lyd_path_tmpl_resolve(data_tree, tmpl, key_values, &i, &slot);
+    schema = tmpl->steps[tmpl->step_count - 1];
+    if ((i == tmpl->step_count) && (schema->nodetype == LYS_LIST) && !((struct lys_node_list *)schema)->keys_size) {
+        /* keyless list target, always create a new instance */
+        --i;
+        parent = parent->parent;
+    }
+    if (i == tmpl->step_count) {
+        /* the node exists, are we supposed to update it? */
+        if (!(options & LYD_PATH_OPT_UPDATE)) {
+            LOGVAL(LYE_PATH_EXISTS, LY_VLOG_STR, tmpl->path);
+            return NULL;
+        }
+
+        return lyd_new_path_update(parent, value, value_type);
+    } else if ((options & LYD_PATH_OPT_NOPARENT) && (i < tmpl->step_count - 1)) {
+        /* we were supposed to create only the target node */
+        LOGVAL(LYE_PATH_MISSPAR, LY_VLOG_STR, tmpl->path);
+        return NULL;
+    }
+
+    /* create the rest of the nodes */
+    for (; i < tmpl->step_count; ++i) {
+        schema = tmpl->steps[i];
+        switch (schema->nodetype) {
+        case LYS_CONTAINER:
+        case LYS_LIST:
+        case LYS_NOTIF:
+        case LYS_RPC:
+        case LYS_ACTION:
+            node = _lyd_new(parent, schema, dflt);
+            break;
+        case LYS_LEAF:
+            node = _lyd_new_leaf(parent, schema, value, dflt);
+            break;
+        case LYS_LEAFLIST:
+            node = _lyd_new_leaf(parent, schema, key_values[slot++], dflt);
+            break;
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+            if (value_type <= LYD_ANYDATA_STRING && !value) {
+                value_type = LYD_ANYDATA_CONSTSTRING;
+                value = "";
+            }
+            node = lyd_create_anydata(parent, schema, value, value_type);
+            break;
+        default:
+            LOGINT;
+            node = NULL;
+            break;
+        }
+
+        if (!node) {
+            if (parent) {
+                LOGVAL(LYE_SPEC, LY_VLOG_STR, tmpl->path, "Failed to create node \"%s\" as a child of \"%s\".",
+                       schema->name, parent->schema->name);
+            } else {
+                LOGVAL(LYE_SPEC, LY_VLOG_STR, tmpl->path, "Failed to create node \"%s\".", schema->name);
+            }
+            lyd_free(ret);
+            return NULL;
+        }
+
+        if (!ret) {
+            /* special case when we are creating a sibling of a top-level data node */
+            if (!parent && data_tree) {
+                for (; data_tree->parent; data_tree = data_tree->parent);
+                for (; data_tree->next; data_tree = data_tree->next);
+                if (lyd_insert_after(data_tree, node)) {
+                    lyd_free(node);
+                    return NULL;
+                }
+            }
+
+            /* sort if needed, but only when inserted somewhere */
+            sparent = schema;
+            do {
+                sparent = lys_parent(sparent);
+            } while (sparent && (sparent->nodetype != ((options & LYD_PATH_OPT_OUTPUT) ? LYS_OUTPUT : LYS_INPUT)));
+            if (sparent && lyd_schema_sort(node, 0)) {
+                lyd_free(node);
+                return NULL;
+            }
+            ret = node;
+        }
+
+        if (schema->nodetype == LYS_LIST) {
+            slist = (const struct lys_node_list *)schema;
+            for (k = 0; k < slist->keys_size; ++k) {
+                if (!_lyd_new_leaf(node, (struct lys_node *)slist->keys[k], key_values[slot++], 0)) {
+                    lyd_free(ret);
+                    return NULL;
+                }
+            }
+        }
+
+        parent = node;
+    }
+
+    return ret;
+}
+
 API unsigned int
 lyd_list_pos(const struct lyd_node *node)
 {
@@ -1751,11 +2538,21 @@ static void
 lyd_merge_node_update(struct lyd_node *target, struct lyd_node *source)
 {
     struct ly_ctx *ctx;
+    struct lyd_node *parent;
     struct lyd_node_leaf_list *trg_leaf, *src_leaf;
     struct lyd_node_anydata *trg_any, *src_any;
 
     assert(target->schema->nodetype & (LYS_LEAF | LYS_ANYDATA));
     ctx = target->schema->module->ctx;
+    LY_DATA_GEN_NEXT(ctx);
+
+    if ((target->schema->nodetype == LYS_LEAF) && (target->schema->flags & LYS_UNIQUE)) {
+        /* the value of a unique leaf changes, check its list instance again */
+        for (parent = target->parent; parent && (parent->schema->nodetype != LYS_LIST); parent = parent->parent);
+        if (parent) {
+            lyv_unique_invalidate(parent);
+        }
+    }
 
     if (ctx == source->schema->module->ctx) {
         /* source and targets are in the same context */
@@ -3319,7 +4116,7 @@ lyd_insert_setinvalid(struct lyd_node *node)
 
             if (elem->schema->nodetype == LYS_LEAF && (elem->schema->flags & LYS_UNIQUE)) {
                 /* set flag to list for future validation */
-                parent_list->validity |= LYD_VAL_UNIQUE;
+                lyv_unique_invalidate(parent_list);
                 break;
             }
 
@@ -3725,6 +4522,7 @@ lyd_insert_common(struct lyd_node *parent, struct lyd_node **sibling, struct lyd
         if (invalid) {
             lyd_insert_setinvalid(ins);
         }
+        lyv_unique_index_insert(ins, 1);
     }
     ly_set_free(llists);
 
@@ -3929,6 +4727,13 @@ lyd_insert_nextto(struct lyd_node *sibling, struct lyd_node *node, int before, i
         node->prev = sibling;
     }
 
+    LY_TREE_FOR(node, next1) {
+        lyv_unique_index_insert(next1, next1 == last);
+        if (next1 == last) {
+            break;
+        }
+    }
+
     if (invalidate) {
         LY_TREE_FOR(node, next1) {
             check_leaf_list_backlinks(next1, 0);
@@ -4162,6 +4967,9 @@ lyd_validate(struct lyd_node **node, int options, void *var_arg)
         return EXIT_FAILURE;
     }
 
+    /* initialize errno, the validation tells the removed nodes from the errors by it */
+    ly_errno = LY_SUCCESS;
+
     if (lyp_data_check_options(options, __func__)) {
         return EXIT_FAILURE;
     }
@@ -4385,11 +5193,11 @@ nextsiblings:
         goto cleanup;
     }
     if (act_notif) {
-        if (lyd_check_mandatory_tree(act_notif, ctx, options)) {
+        if (lyd_check_mandatory_tree(act_notif, ctx, options, NULL)) {
             goto cleanup;
         }
     } else {
-        if (lyd_check_mandatory_tree(*node, ctx, options)) {
+        if (lyd_check_mandatory_tree(*node, ctx, options, NULL)) {
             goto cleanup;
         }
     }
@@ -4520,6 +5328,21 @@ lyd_unlink_internal(struct lyd_node *node, int permanent)
         check_leaf_list_backlinks(node, 1);
     }
 
+    /* the node may be the target of a resolved instance-identifier or lead to it */
+    LY_DATA_GEN_NEXT(node->schema->module->ctx);
+
+    if (node->schema->nodetype & (LYS_LIST | LYS_LEAFLIST)) {
+        lyv_unique_index_unlink(node);
+        /* check it again if inserted back */
+        node->validity |= LYD_VAL_UNIQUE;
+    } else if (node->parent && (node->schema->nodetype == LYS_LEAF) && (node->schema->flags & LYS_UNIQUE)) {
+        /* the list instance may use a default value instead */
+        for (iter = node->parent; iter && iter->schema->nodetype != LYS_LIST; iter = iter->parent);
+        if (iter) {
+            lyv_unique_invalidate(iter);
+        }
+    }
+
     /* unlink from siblings */
     if (node->prev->next) {
         node->prev->next = node->next;
@@ -4609,9 +5432,26 @@ lyd_dup_common(struct lyd_node *parent, struct lyd_node *new, const struct lyd_n
     new->dflt = orig->dflt;
     new->when_status = orig->when_status & LYD_WHEN;
 
-    if (parent && lyd_insert(parent, new)) {
-        return EXIT_FAILURE;
+    if (!parent) {
+        return EXIT_SUCCESS;
+    } else if (ctx) {
+        /* the schema may differ in the target context, insert the node properly */
+        if (lyd_insert(parent, new)) {
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    /* the original siblings are already correctly ordered and a new node is not linked from anywhere,
+     * so just append it (lyd_insert() would search for its place and process all the siblings) */
+    if (parent->child) {
+        new->prev = parent->child->prev;
+        parent->child->prev->next = new;
+        parent->child->prev = new;
+    } else {
+        parent->child = new;
     }
+    new->parent = parent;
 
     return EXIT_SUCCESS;
 }
@@ -4623,6 +5463,7 @@ lyd_dup_to_ctx(const struct lyd_node *node, int recursive, struct ly_ctx *ctx)
     struct lyd_node *ret, *parent, *new_node = NULL;
     struct lyd_node_leaf_list *new_leaf;
     struct lyd_node_anydata *new_any, *old_any;
+    struct lys_type *type;
 
     if (!node) {
         ly_errno = LY_EINVAL;
@@ -4680,15 +5521,27 @@ lyd_dup_to_ctx(const struct lyd_node *node, int recursive, struct ly_ctx *ctx)
                                                        ((struct lyd_node_leaf_list *)elem)->value.string, 0);
                 break;
             case LY_TYPE_ENUM:
+            case LY_TYPE_IDENT:
                 if (!ctx) {
                     /* we are still in the same context - just copy the data */
                     new_leaf->value = ((struct lyd_node_leaf_list *)elem)->value;
                     break;
                 }
                 /* falls through */
-            case LY_TYPE_IDENT:
             case LY_TYPE_BITS:
-                /* in case of duplicating bits (no matter if in the same context or not) or enum and identityref into
+                if (!ctx && (((struct lys_node_leaf *)new_leaf->schema)->type.base == LY_TYPE_BITS)
+                        && ((struct lyd_node_leaf_list *)elem)->value.bit) {
+                    /* the same context and the bits are directly in the leaf's type, copy the bits array */
+                    for (type = &((struct lys_node_leaf *)new_leaf->schema)->type; !type->info.bits.count;
+                            type = &type->der->type);
+                    new_leaf->value.bit = malloc(type->info.bits.count * sizeof *new_leaf->value.bit);
+                    LY_CHECK_ERR_GOTO(!new_leaf->value.bit, LOGMEM, error);
+                    memcpy(new_leaf->value.bit, ((struct lyd_node_leaf_list *)elem)->value.bit,
+                           type->info.bits.count * sizeof *new_leaf->value.bit);
+                    break;
+                }
+                /* falls through */
+                /* in case of duplicating bits from a union or enum and identityref into
                  * a different context, searching for the type and duplicating the data is almost as same as resolving
                  * the string value, so due to a simplicity, parse the value for the duplicated leaf */
                 if (!lyp_parse_value(&((struct lys_node_leaf *)new_leaf->schema)->type, &new_leaf->value_str, NULL,
@@ -4754,6 +5607,7 @@ lyd_dup_to_ctx(const struct lyd_node *node, int recursive, struct ly_ctx *ctx)
             LOGINT;
             goto error;
         }
+        LY_STATS_INC(new_node->schema->module->ctx, node_allocs);
         if (!ret) {
             ret = new_node;
         }
@@ -6132,7 +6986,8 @@ lyd_wd_add_subtree(struct lyd_node **root, struct lyd_node *last_parent, struct
         return EXIT_SUCCESS;
     }
 
-    if (options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER | LYD_OPT_EDIT | LYD_OPT_GET | LYD_OPT_GETCONFIG)) {
+    if (options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER | LYD_OPT_EDIT | LYD_OPT_GET | LYD_OPT_GETCONFIG
+                   | LYD_OPT_SELECT)) {
         check_when_must = 0;
     } else {
         check_when_must = 1;
@@ -6475,6 +7330,8 @@ lyd_defaults_add_unres(struct lyd_node **root, int options, struct ly_ctx *ctx,
     struct lyd_node *msg_sibling, *msg_parent, *data_tree_sibling, *data_tree_parent;
     struct lys_node *msg_op;
     struct ly_set *set;
+    struct ly_ctx *stats_ctx;
+    uint64_t start;
     int ret = EXIT_FAILURE;
 
     assert(root && unres && !(options & LYD_OPT_ACT_NOTIF));
@@ -6513,9 +7370,13 @@ lyd_defaults_add_unres(struct lyd_node **root, int options, struct ly_ctx *ctx,
     }
 
     /* add missing default nodes */
+    stats_ctx = *root ? (*root)->schema->module->ctx : ctx;
+    LY_STATS_TIMER_START(stats_ctx, start);
     if (lyd_wd_add((act_notif ? &act_notif : root), ctx, unres, options)) {
+        LY_STATS_TIMER_STOP(stats_ctx, start, time_defaults);
         return EXIT_FAILURE;
     }
+    LY_STATS_TIMER_STOP(stats_ctx, start, time_defaults);
 
     /* check leafrefs and/or instids if any */
     if (unres && unres->count) {
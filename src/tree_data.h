@@ -146,6 +146,9 @@ struct lyd_attr {
                                       are checked for this node if flag #LYD_OPT_OBSOLETE is used. */
 #define LYD_VAL_LEAFREF  0x04    /**< Node is a leafref, which needs to be resolved (it is invalid, new possible
                                       resolvent, or something similar) */
+#define LYD_VAL_HIDDEN   0x40    /**< Internal flag for nodes temporarily excluded from the accessible tree of a when
+                                      condition (YANG 1.1 RFC section 7.21.5), should be used only internally and removed
+                                      before libyang returns the node to the caller */
 #define LYD_VAL_INUSE    0x80    /**< Internal flag for note about various processing on data, should be used only
                                       internally and removed before libyang returns the node to the caller */
 /**
@@ -219,6 +222,8 @@ struct lyd_node_leaf_list {
     uint16_t value_type;             /**< type of the value in the node, mainly for union to avoid repeating of type detection,
                                           if (schema->type.base == LY_TYPE_LEAFREF), then value_type may be
                                           (LY_TYPE_LEAFREF_UNRES | leafref target value_type) and (value.leafref == NULL) */
+    uint32_t value_gen;              /**< data generation (::ly_ctx#data_gen) the instance-identifier target in #value
+                                          was resolved in - internal use only, do not use this value! */
 };
 
 /**
@@ -474,6 +479,16 @@ char *lyd_path(const struct lyd_node *node);
 #define LYD_OPT_DATA_ADD_YANGLIB 0x20000 /**< Add missing ietf-yang-library data into the validated data tree. Applicable
                                               only with #LYD_OPT_DATA. If some ietf-yang-library data are present, they are
                                               preserved and option is ignored. */
+#define LYD_OPT_SELECT     0x40000 /**< Parse only instances of the selected schema nodes (passed in the last variable
+                                       argument as struct ::ly_set) with all their descendants, instances of their
+                                       ancestors and the keys of such lists. The rest of the input is skipped without
+                                       creating any data nodes (in XML without building the XML tree of the skipped
+                                       elements). The selection is a set of schema nodes, XPath expressions are not
+                                       supported (a schema path can be converted with ly_ctx_get_node()). The selected
+                                       subtrees are validated (values, keys, uniqueness, number of instances and
+                                       mandatory nodes), but the when, must, leafref and instance-identifier
+                                       constraints are not enforced since they may refer to the skipped data. The
+                                       ancestors with no selected node instance are removed from the result. */
 
 /**@} parseroptions */
 
@@ -507,6 +522,9 @@ char *lyd_path(const struct lyd_node *node);
  *                  - const struct ::lyd_node *data_tree - additional data tree that will be used
  *                    when checking any "when" or "must" conditions in the parsed tree that require
  *                    some nodes outside their subtree. It must be a list of top-level elements!
+ *
+ *                Additionally, if they include #LYD_OPT_SELECT, the last variable argument is:
+ *                  - const struct ::ly_set *select - set of the schema nodes selected to be parsed.
  * @return Pointer to the built data tree or NULL in case of empty \p data. To free the returned structure,
  *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
  *         #ly_errno contains appropriate error code (see #LY_ERR).
@@ -516,7 +534,8 @@ struct lyd_node *lyd_parse_mem(struct ly_ctx *ctx, const char *data, LYD_FORMAT
 /**
  * @brief Read (and validate) data from the given file descriptor.
  *
- * \note Current implementation supports only reading data from standard (disk) file, not from sockets, pipes, etc.
+ * Regular files are mapped into memory. XML data from other file descriptors (pipes, sockets) are read and
+ * parsed incrementally with the push parser, see lyd_parse_push_new(), JSON data are read completely first.
  *
  * In case of LY_XML format, the file content is parsed completely. It means that when it contains
  * a non well-formed XML with multiple root elements, all those sibling XML trees are parsed. The
@@ -545,6 +564,9 @@ struct lyd_node *lyd_parse_mem(struct ly_ctx *ctx, const char *data, LYD_FORMAT
  *                  - const struct ::lyd_node *data_tree - additional data tree that will be used
  *                    when checking any "when" or "must" conditions in the parsed tree that require
  *                    some nodes outside their subtree. It must be a list of top-level elements!
+ *
+ *                Additionally, if they include #LYD_OPT_SELECT, the last variable argument is:
+ *                  - const struct ::ly_set *select - set of the schema nodes selected to be parsed.
  * @return Pointer to the built data tree or NULL in case of empty file. To free the returned structure,
  *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
  *         #ly_errno contains appropriate error code (see #LY_ERR).
@@ -581,12 +603,74 @@ struct lyd_node *lyd_parse_fd(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int
  *                  - const struct ::lyd_node *data_tree - additional data tree that will be used
  *                    when checking any "when" or "must" conditions in the parsed tree that require
  *                    some nodes outside their subtree. It must be a list of top-level elements!
+ *
+ *                Additionally, if they include #LYD_OPT_SELECT, the last variable argument is:
+ *                  - const struct ::ly_set *select - set of the schema nodes selected to be parsed.
  * @return Pointer to the built data tree or NULL in case of empty file. To free the returned structure,
  *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
  *         #ly_errno contains appropriate error code (see #LY_ERR).
  */
 struct lyd_node *lyd_parse_path(struct ly_ctx *ctx, const char *path, LYD_FORMAT format, int options, ...);
 
+/**
+ * @brief Opaque context of the incremental (push) data parser, see lyd_parse_push_new().
+ */
+struct lyd_parse_push;
+
+/**
+ * @brief Create an incremental (push) data parser.
+ *
+ * The data are passed to the parser in chunks as they are available via lyd_parse_push_feed() and the
+ * complete data tree is returned by lyd_parse_push_finish(). The data tree is built as the chunks come,
+ * the parser keeps only the input not processed yet, which is (in addition to the last chunk) at most
+ * a single (the largest) leaf, leaf-list or anydata element. Only XML data can be parsed incrementally,
+ * JSON data are supposed to be parsed at once with lyd_parse_mem().
+ *
+ * The result is the same as when the whole input is parsed with lyd_parse_mem(). lyd_parse_fd() uses
+ * the push parser for XML data from file descriptors that cannot be mapped into memory (pipes, sockets).
+ *
+ * @param[in] ctx Context to connect with the data tree being built here.
+ * @param[in] format Format of the input data to be parsed, only #LYD_XML is supported.
+ * @param[in] options Parser options, see @ref parseroptions.
+ * @param[in] ... Variable arguments depend on \p options, see lyd_parse_mem().
+ * @return Parser context to be passed to the other lyd_parse_push_*() functions, NULL on error.
+ */
+struct lyd_parse_push *lyd_parse_push_new(struct ly_ctx *ctx, LYD_FORMAT format, int options, ...);
+
+/**
+ * @brief Pass another chunk of input data to the incremental parser.
+ *
+ * The chunk does not have to end on any boundary of the data (element, string, multibyte character)
+ * and it is copied, so the caller can reuse it.
+ *
+ * @param[in] push Incremental parser context.
+ * @param[in] data Chunk of input data, not NULL-terminated.
+ * @param[in] len Length of \p data.
+ * @return EXIT_SUCCESS or EXIT_FAILURE on error (invalid data), in such a case the parser refuses any
+ * further data and the parser context is supposed to be freed with lyd_parse_push_free().
+ */
+int lyd_parse_push_feed(struct lyd_parse_push *push, const char *data, size_t len);
+
+/**
+ * @brief Finish the input data of the incremental parser and get the parsed data tree.
+ *
+ * The parser context is freed by the function in any case.
+ *
+ * @param[in] push Incremental parser context.
+ * @return Pointer to the built data tree or NULL in case of empty input. To free the returned structure,
+ *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
+ *         #ly_errno contains appropriate error code (see #LY_ERR).
+ */
+struct lyd_node *lyd_parse_push_finish(struct lyd_parse_push *push);
+
+/**
+ * @brief Free the incremental parser context without finishing the input, the partially parsed
+ * data are freed as well.
+ *
+ * @param[in] push Incremental parser context to free.
+ */
+void lyd_parse_push_free(struct lyd_parse_push *push);
+
 /**
  * @brief Parse (and validate) XML tree.
  *
@@ -627,6 +711,9 @@ struct lyd_node *lyd_parse_path(struct ly_ctx *ctx, const char *path, LYD_FORMAT
  *                  - const struct ::lyd_node *data_tree - additional data tree that will be used
  *                    when checking any "when" or "must" conditions in the parsed tree that require
  *                    some nodes outside their subtree. It must be a list of top-level elements!
+ *
+ *                Additionally, if they include #LYD_OPT_SELECT, the last variable argument is:
+ *                  - const struct ::ly_set *select - set of the schema nodes selected to be parsed.
  * @return Pointer to the built data tree or NULL in case of empty \p root. To free the returned structure,
  *         use lyd_free(). In these cases, the function sets #ly_errno to LY_SUCCESS. In case of error,
  *         #ly_errno contains appropriate error code (see #LY_ERR).
@@ -796,6 +883,77 @@ struct lyd_node *lyd_new_output_anydata(struct lyd_node *parent, const struct ly
 struct lyd_node *lyd_new_path(struct lyd_node *data_tree, struct ly_ctx *ctx, const char *path, void *value,
                               LYD_ANYDATA_VALUETYPE value_type, int options);
 
+/**
+ * @brief Opaque compiled data path template, see lyd_path_tmpl_compile().
+ */
+struct lyd_path_tmpl;
+
+/**
+ * @brief Compile a data path template for repeated lyd_path_tmpl_new() and lyd_path_tmpl_find() calls.
+ *
+ * The \p path is an absolute simple data path (see @ref howtoxpath) without any predicates. Instead of predicates,
+ * every list on the path has a key value slot for each of its keys (in the schema order) and a leaf-list target
+ * node has one slot for its value. Concrete values are then passed to the template functions as a single array
+ * of strings, one for each slot in the order the nodes appear in the path. All the schema nodes are resolved
+ * here so the path string is never parsed again.
+ *
+ * @param[in] ctx Context with the schemas.
+ * @param[in] path Absolute data path without predicates, for example `/mod:cont/list/leaf`. List key leaves
+ * are created together with their list so they cannot be the target of the path.
+ * @param[in] options Bitmask of options flags, see @ref pathoptions. Only #LYD_PATH_OPT_OUTPUT is used.
+ * @return Compiled template, free it with lyd_path_tmpl_free(). NULL and ly_errno is set on error.
+ */
+struct lyd_path_tmpl *lyd_path_tmpl_compile(struct ly_ctx *ctx, const char *path, int options);
+
+/**
+ * @brief Learn the number of key value slots of a compiled path template.
+ *
+ * @param[in] tmpl Compiled path template.
+ * @return Number of strings expected in the key values array of lyd_path_tmpl_new() and lyd_path_tmpl_find().
+ */
+unsigned int lyd_path_tmpl_key_count(const struct lyd_path_tmpl *tmpl);
+
+/**
+ * @brief Create a new data node based on a compiled path template, the equivalent of lyd_new_path() with
+ * the key values filled into the template's slots.
+ *
+ * __PARTIAL CHANGE__ - validate after the final change on the data tree (see @ref howtodatamanipulators).
+ *
+ * Key values are compared with the existing instances in the same way as lyd_new_path() compares predicate
+ * values, they should be in the canonical form.
+ *
+ * @param[in] data_tree Existing data tree to add to/modify, any node of the tree can be used. Can be NULL.
+ * @param[in] tmpl Compiled path template.
+ * @param[in] key_values Array of the key values, lyd_path_tmpl_key_count() items. Can be NULL if there are no slots.
+ * @param[in] value Value of the new leaf or anydata, see lyd_new_path(). Leaf-list value is always taken from its slot.
+ * @param[in] value_type Type of the provided \p value parameter in case of creating anydata or anyxml node.
+ * @param[in] options Bitmask of options flags, see @ref pathoptions.
+ * @return First created (or updated with #LYD_PATH_OPT_UPDATE) node,
+ * NULL if #LYD_PATH_OPT_UPDATE was used and the full path exists or the leaf original value matches \p value,
+ * NULL and ly_errno is set on error.
+ */
+struct lyd_node *lyd_path_tmpl_new(struct lyd_node *data_tree, const struct lyd_path_tmpl *tmpl, const char **key_values,
+                                   void *value, LYD_ANYDATA_VALUETYPE value_type, int options);
+
+/**
+ * @brief Find the data node addressed by a compiled path template with the key values filled into its slots.
+ *
+ * @param[in] data_tree Data tree to search in, any node of the tree can be used.
+ * @param[in] tmpl Compiled path template.
+ * @param[in] key_values Array of the key values, lyd_path_tmpl_key_count() items. Can be NULL if there are no slots.
+ * @return Found data node (the first instance in case of a keyless list), NULL if there is none. In case of
+ * an error, ly_errno is set.
+ */
+struct lyd_node *lyd_path_tmpl_find(const struct lyd_node *data_tree, const struct lyd_path_tmpl *tmpl,
+                                    const char **key_values);
+
+/**
+ * @brief Free a compiled path template.
+ *
+ * @param[in] tmpl Compiled path template to free.
+ */
+void lyd_path_tmpl_free(struct lyd_path_tmpl *tmpl);
+
 /**
  * @brief Learn the relative instance position of a list or leaf-list within other instances of the
  * same schema node.
@@ -1224,6 +1382,51 @@ int lyd_print_file(FILE *f, const struct lyd_node *root, LYD_FORMAT format, int
 int lyd_print_clb(ssize_t (*writeclb)(void *arg, const void *buf, size_t count), void *arg,
                   const struct lyd_node *root, LYD_FORMAT format, int options);
 
+/**
+ * @brief Opaque state of the resumable data printer, see lyd_print_iter_new().
+ */
+struct lyd_print_iter;
+
+/**
+ * @brief Create a resumable printer of the data tree.
+ *
+ * Instead of writing the whole output at once as lyd_print_clb() does, the output is generated on demand by
+ * lyd_print_iter_next() in pieces of the caller-specified size, so the caller can stop between the calls and
+ * continue later (e.g. when the output socket becomes writable again). The tree must not be changed until
+ * the printer is freed. The memory used by the printer depends on the depth of the tree, not on the size
+ * of the output.
+ *
+ * @param[in] root Root node of the data tree to print. It can be actually any (not only real root)
+ * node of the data tree to print the specific subtree.
+ * @param[in] format Data output format, only #LYD_XML and #LYD_JSON are supported.
+ * @param[in] options [printer flags](@ref printerflags).
+ * @return Printer state to be passed to lyd_print_iter_next() and freed by lyd_print_iter_free(),
+ * NULL on error (#ly_errno is set).
+ */
+struct lyd_print_iter *lyd_print_iter_new(const struct lyd_node *root, LYD_FORMAT format, int options);
+
+/**
+ * @brief Get the next part of the output of the resumable data printer.
+ *
+ * The output concatenated from all the calls is the same as the output of lyd_print_mem() with the same
+ * parameters (without the terminating NULL byte).
+ *
+ * @param[in] iter Printer state created by lyd_print_iter_new().
+ * @param[out] buf Buffer to write the output into, it is not NULL-terminated.
+ * @param[in] size Size of the \p buf, the output fills it completely unless the end of the output is reached.
+ * It must not be 0.
+ * @return Number of bytes written into \p buf, 0 once the whole output was returned, -1 on error (#ly_errno is
+ * set, the printer cannot continue unless it was an invalid argument).
+ */
+ssize_t lyd_print_iter_next(struct lyd_print_iter *iter, char *buf, size_t size);
+
+/**
+ * @brief Free the resumable data printer.
+ *
+ * @param[in] iter Printer state created by lyd_print_iter_new().
+ */
+void lyd_print_iter_free(struct lyd_print_iter *iter);
+
 /**
  * @brief Get the double value of a decimal64 leaf/leaf-list.
  *
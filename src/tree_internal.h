@@ -62,6 +62,18 @@ struct lyd_node_pos {
     uint32_t pos;
 };
 
+/**
+ * @brief Compiled data path template, see lyd_path_tmpl_compile().
+ */
+struct lyd_path_tmpl {
+    struct ly_ctx *ctx;              /**< context of the schema nodes */
+    const char *path;                /**< original path (in dictionary), used for logging */
+    const struct lys_node **steps;   /**< data schema nodes from the top-level node to the target node */
+    uint16_t step_count;             /**< number of items in the #steps array */
+    uint16_t key_count;              /**< number of key value slots, sum of all the list keys and a leaf-list target */
+    int options;                     /**< compile options, only #LYD_PATH_OPT_OUTPUT is relevant */
+};
+
 /**
  * Macros to work with ::lyd_node#when_status
  * +--- bit 1 - some when-stmt connected with the node (resolve_applies_when() is true)
@@ -439,9 +451,11 @@ const char *lyd_get_unique_default(const char* unique_expr, struct lyd_node *lis
  * @param[in] root Data tree to validate.
  * @param[in] ctx libyang context (for the case when the data tree is empty - i.e. root == NULL).
  * @param[in] options Standard @ref parseroptions.
+ * @param[in] select Selection of the parsed schema nodes (#LYD_OPT_SELECT) to check only the selected subtrees,
+ * NULL to check the whole tree.
  * @return EXIT_SUCCESS or EXIT_FAILURE.
  */
-int lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, int options);
+int lyd_check_mandatory_tree(struct lyd_node *root, struct ly_ctx *ctx, int options, struct lyp_select *select);
 
 /**
  * @brief Check if the provided node is inside a grouping.
@@ -487,6 +501,15 @@ const struct lys_module *lys_parse_fd_(struct ly_ctx *ctx, int fd, LYS_INFORMAT
 const struct lys_module *lys_parse_mem_(struct ly_ctx *ctx, const char *data, LYS_INFORMAT format, const char *revision,
                                         int internal, int implement);
 
+struct lyp_preparsed;
+
+/**
+ * @brief Finish the module parsed in advance by lyp_preparse_modules(), the parsed data are consumed.
+ *
+ * @return The module from the context, NULL on error.
+ */
+struct lys_module *lys_parse_preparsed(struct ly_ctx *ctx, struct lyp_preparsed *pre, const char *revision, int implement);
+
 /**
  * @brief Get know if the \p leaf is a key of the \p list
  * @return 0 for false, position of the key otherwise
@@ -38,7 +38,7 @@
 #include "parser_yang.h"
 
 static int lys_type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new, struct lys_type *old,
-                        int in_grp, int shallow, struct unres_schema *unres);
+                        int in_grp, int shallow, int share, struct unres_schema *unres);
 
 API const struct lys_node *
 lys_is_disabled(const struct lys_node *node, int recursive)
@@ -920,6 +920,24 @@ lys_node_addchild(struct lys_node *parent, struct lys_module *module, struct lys
     return EXIT_SUCCESS;
 }
 
+/* hack for NETCONF's edit-config's operation attribute. It is not defined in the schema, but since libyang
+ * implements YANG metadata (annotations), we need its definition. Because the ietf-netconf schema is not the
+ * internal part of libyang, we cannot add the annotation into the schema source, but we do it here to have
+ * the anotation definitions available in the internal schema structure. There is another hack in schema
+ * printers to do not print this internally added annotation. */
+static int
+lys_parse_annotations(struct lys_module *mod)
+{
+    if (ly_strequal(mod->name, "ietf-netconf", 0)) {
+        if (lyp_add_ietf_netconf_annotations(mod)) {
+            lys_free(mod, NULL, 1, 1);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
 const struct lys_module *
 lys_parse_mem_(struct ly_ctx *ctx, const char *data, LYS_INFORMAT format, const char *revision, int internal, int implement)
 {
@@ -962,16 +980,40 @@ lys_parse_mem_(struct ly_ctx *ctx, const char *data, LYS_INFORMAT format, const
 
     free(enlarged_data);
 
-    /* hack for NETCONF's edit-config's operation attribute. It is not defined in the schema, but since libyang
-     * implements YANG metadata (annotations), we need its definition. Because the ietf-netconf schema is not the
-     * internal part of libyang, we cannot add the annotation into the schema source, but we do it here to have
-     * the anotation definitions available in the internal schema structure. There is another hack in schema
-     * printers to do not print this internally added annotation. */
-    if (mod && ly_strequal(mod->name, "ietf-netconf", 0)) {
-        if (lyp_add_ietf_netconf_annotations(mod)) {
-            lys_free(mod, NULL, 1, 1);
-            return NULL;
-        }
+    if (mod && lys_parse_annotations(mod)) {
+        return NULL;
+    }
+
+    /* reset parser context */
+    ly_parser_data.ctx = ctx_prev;
+
+    return mod;
+}
+
+struct lys_module *
+lys_parse_preparsed(struct ly_ctx *ctx, struct lyp_preparsed *pre, const char *revision, int implement)
+{
+    struct lys_module *mod;
+    struct ly_ctx *ctx_prev = ly_parser_data.ctx;
+
+    ly_err_clean(ctx, 1);
+
+    /* set parser context */
+    ly_parser_data.ctx = ctx;
+
+    if (pre->format == LYS_IN_YANG) {
+        mod = yang_read_module_parsed(ctx, pre->module, pre->unres, pre->node, revision, implement);
+        pre->module = NULL;
+        pre->unres = NULL;
+        pre->node = NULL;
+    } else {
+        mod = yin_read_module_(ctx, pre->yin, revision, implement);
+        lyxml_free(ctx, pre->yin);
+        pre->yin = NULL;
+    }
+
+    if (mod && lys_parse_annotations(mod)) {
+        return NULL;
     }
 
     /* reset parser context */
@@ -1344,13 +1386,97 @@ lys_iffeature_free(struct ly_ctx *ctx, struct lys_iffeature *iffeature, uint8_t
     free(iffeature);
 }
 
+/**
+ * @brief Share the type-specific information of a type instantiated from a grouping with the original
+ * type instead of duplicating it. Only the restrictions of the types which are not modified after
+ * the instantiation and which are not bound to their parent (extension instances) are shared.
+ *
+ * @param[in] old Original type in the grouping.
+ * @param[in] new Instantiated type.
+ * @param[in] base Base type.
+ *
+ * @return EXIT_SUCCESS if shared, EXIT_FAILURE if the information must be duplicated, -1 on error.
+ */
+static int
+type_share(struct lys_type *new, struct lys_type *old, LY_DATA_TYPE base)
+{
+    struct lys_restr *restr;
+    unsigned int u;
+
+    switch (base) {
+    case LY_TYPE_BINARY:
+        restr = old->info.binary.length;
+        break;
+    case LY_TYPE_DEC64:
+        restr = old->info.dec64.range;
+        break;
+    case LY_TYPE_INT8:
+    case LY_TYPE_INT16:
+    case LY_TYPE_INT32:
+    case LY_TYPE_INT64:
+    case LY_TYPE_UINT8:
+    case LY_TYPE_UINT16:
+    case LY_TYPE_UINT32:
+    case LY_TYPE_UINT64:
+        restr = old->info.num.range;
+        break;
+    case LY_TYPE_STRING:
+        restr = old->info.str.length;
+        for (u = 0; u < old->info.str.pat_count; u++) {
+            if (old->info.str.patterns[u].ext_size) {
+                return EXIT_FAILURE;
+            }
+        }
+#ifdef LY_ENABLED_CACHE
+        if (old->info.str.pat_count && !old->info.str.patterns_pcre) {
+            if (old->flags & LYS_TYPE_SHARED) {
+                /* the patterns do not belong to the original type, it cannot store the compiled ones */
+                return EXIT_FAILURE;
+            }
+
+            /* compile the patterns once in the original type (in grouping) to share them */
+            old->info.str.patterns_pcre = malloc(old->info.str.pat_count * 2 * sizeof *old->info.str.patterns_pcre);
+            LY_CHECK_ERR_RETURN(!old->info.str.patterns_pcre, LOGMEM, -1);
+            for (u = 0; u < old->info.str.pat_count; u++) {
+                if (lyp_precompile_pattern(&old->info.str.patterns[u].expr[1],
+                                          (pcre**)&old->info.str.patterns_pcre[2 * u],
+                                          (pcre_extra**)&old->info.str.patterns_pcre[2 * u + 1])) {
+                    free(old->info.str.patterns_pcre);
+                    old->info.str.patterns_pcre = NULL;
+                    return -1;
+                }
+            }
+        }
+#endif
+        break;
+    default:
+        /* the rest either has extension instances in its items or is modified when resolving the instance */
+        return EXIT_FAILURE;
+    }
+
+    if (restr && restr->ext_size) {
+        return EXIT_FAILURE;
+    }
+
+    new->info = old->info;
+    new->flags |= LYS_TYPE_SHARED;
+    return EXIT_SUCCESS;
+}
+
 static int
 type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new, struct lys_type *old,
-         LY_DATA_TYPE base, int in_grp, int shallow, struct unres_schema *unres)
+         LY_DATA_TYPE base, int in_grp, int shallow, int share, struct unres_schema *unres)
 {
     int i;
     unsigned int u;
 
+    if (share) {
+        i = type_share(new, old, base);
+        if (i != EXIT_FAILURE) {
+            return i;
+        }
+    }
+
     switch (base) {
     case LY_TYPE_BINARY:
         if (old->info.binary.length) {
@@ -1491,7 +1617,7 @@ type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new,
 
             for (u = 0; u < new->info.uni.count; u++) {
                 if (lys_type_dup(mod, parent, &(new->info.uni.types[u]), &(old->info.uni.types[u]), in_grp,
-                        shallow, unres)) {
+                        shallow, share, unres)) {
                     return -1;
                 }
             }
@@ -1522,7 +1648,7 @@ lys_yang_type_dup(struct lys_module *module, struct lys_node *parent, struct yan
         LOGMEM;
         goto error;
     }
-    if (type_dup(module, parent, type, old->type, new->base, in_grp, shallow, unres)) {
+    if (type_dup(module, parent, type, old->type, new->base, in_grp, shallow, 0, unres)) {
         new->type->base = new->base;
         lys_type_free(module->ctx, new->type, NULL);
         memset(&new->type->info, 0, sizeof new->type->info);
@@ -1606,7 +1732,7 @@ lys_copy_union_leafrefs(struct lys_module *mod, struct lys_node *parent, struct
             prev_new->der = type->der;
             break;
         default:
-            if (lys_type_dup(mod, parent, prev_new, type, 0, 0, unres)) {
+            if (lys_type_dup(mod, parent, prev_new, type, 0, 0, 0, unres)) {
                 return -1;
             }
             break;
@@ -1614,7 +1740,11 @@ lys_copy_union_leafrefs(struct lys_module *mod, struct lys_node *parent, struct
     }
 
     if (top_type) {
+        lyp_type_unprepare(mod->ctx, type);
         memcpy(type, prev_new, sizeof *type);
+        if (lyp_type_plan_move(mod->ctx, prev_new, type)) {
+            return -1;
+        }
     }
     return EXIT_SUCCESS;
 }
@@ -1906,7 +2036,7 @@ lys_ext_instance_substmt(const struct lys_ext_instance *ext)
 
 static int
 lys_type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *new, struct lys_type *old,
-            int in_grp, int shallow, struct unres_schema *unres)
+            int in_grp, int shallow, int share, struct unres_schema *unres)
 {
     int i;
 
@@ -1936,7 +2066,16 @@ lys_type_dup(struct lys_module *mod, struct lys_node *parent, struct lys_type *n
         return EXIT_SUCCESS;
     }
 
-    return type_dup(mod, parent, new, old, new->base, in_grp, shallow, unres);
+    if (type_dup(mod, parent, new, old, new->base, in_grp, shallow, share, unres)) {
+        return -1;
+    }
+
+    /* the duplicated type is already resolved, unless it is in a grouping, where it is never used for values */
+    if (!in_grp && lyp_type_prepare(new)) {
+        return -1;
+    }
+
+    return EXIT_SUCCESS;
 }
 
 void
@@ -1954,6 +2093,14 @@ lys_type_free(struct ly_ctx *ctx, struct lys_type *type,
 
     lys_extension_instances_free(ctx, type->ext, type->ext_size, private_destructor);
 
+    /* the plan always belongs to this type */
+    lyp_type_unprepare(ctx, type);
+
+    if (type->flags & LYS_TYPE_SHARED) {
+        /* the information belongs to the type in the grouping */
+        return;
+    }
+
     switch (type->base) {
     case LY_TYPE_BINARY:
         lys_restr_free(ctx, type->info.binary.length, private_destructor);
@@ -2960,7 +3107,8 @@ lys_node_dup_recursion(struct lys_module *module, struct lys_node *parent, const
         break;
 
     case LYS_LEAF:
-        if (lys_type_dup(module, retval, &(leaf->type), &(leaf_orig->type), lys_ingrouping(retval), shallow, unres)) {
+        if (lys_type_dup(module, retval, &(leaf->type), &(leaf_orig->type), lys_ingrouping(retval), shallow, !shallow,
+                         unres)) {
             goto error;
         }
         leaf->units = lydict_insert(module->ctx, leaf_orig->units, 0);
@@ -2982,7 +3130,8 @@ lys_node_dup_recursion(struct lys_module *module, struct lys_node *parent, const
         break;
 
     case LYS_LEAFLIST:
-        if (lys_type_dup(module, retval, &(llist->type), &(llist_orig->type), lys_ingrouping(retval), shallow, unres)) {
+        if (lys_type_dup(module, retval, &(llist->type), &(llist_orig->type), lys_ingrouping(retval), shallow, !shallow,
+                         unres)) {
             goto error;
         }
         llist->units = lydict_insert(module->ctx, llist_orig->units, 0);
@@ -3357,8 +3506,13 @@ lys_free(struct lys_module *module, void (*private_destructor)(const struct lys_
         return;
     }
 
-    /* remove schema from the context */
+    /* the cached ietf-yang-library data may refer to the module */
     ctx = module->ctx;
+    if (ctx->ylib_data) {
+        ly_ctx_ylib_data_free(ctx);
+    }
+
+    /* remove schema from the context */
     if (remove_from_ctx && ctx->models.used) {
         for (i = 0; i < ctx->models.used; i++) {
             if (ctx->models.list[i] == module) {
@@ -3432,6 +3586,9 @@ lys_features_change(const struct lys_module *module, const char *name, int op)
         return EXIT_FAILURE;
     }
 
+    /* ietf-yang-library data list the enabled features */
+    module->ctx->ylib_set_id = 0;
+
     if (!strcmp(name, "*")) {
         /* enable all */
         all = 1;
@@ -4463,6 +4620,11 @@ lys_set_implemented(const struct lys_module *module)
         module->inc[i].submodule->implemented = 1;
     }
 
+    /* the augments and deviations were applied, the mandatory nodes must be marked again */
+    module->ctx->models.mand_set_id = 0;
+    /* conformance-type changed */
+    module->ctx->ylib_set_id = 0;
+
     LOGVRB("Module \"%s%s%s\" now implemented.", module->name, (module->rev_size ? "@" : ""),
            (module->rev_size ? module->rev[0].date : ""));
     return EXIT_SUCCESS;
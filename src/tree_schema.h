@@ -918,6 +918,7 @@ struct lys_type {
     const char *module_name;         /**< module name of the type referenced in der pointer*/
     LY_DATA_TYPE base;               /**< base type */
     uint8_t ext_size;                /**< number of elements in #ext array */
+    uint8_t flags;                   /**< type flags, only #LYS_TYPE_SHARED is applicable */
     struct lys_ext_instance **ext;   /**< array of pointers to the extension instances */
     struct lys_tpdf *der;            /**< pointer to the superior typedef. If NULL,
                                           structure provides information about one of the built-in types */
@@ -1066,6 +1067,8 @@ struct lys_iffeature {
  *    11 LYS_LEAFREF_DEP  |x|x|x|x|x|x|x|x|x|x|x| |x|x| | | |r| |
  *                        +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  *    12 LYS_DFLTJSON     | | |x|x| | | | | | | | | | | |x| |r| |
+ *                        +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ *    13 LYS_MAND_SUBTREE |x|x|x|x|x|x|x|x|x|x|x| |x| | | | | | |
  *    --------------------+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
  *
  *    x - used
@@ -1107,8 +1110,14 @@ struct lys_iffeature {
                                           converted into JSON format, since it contains identityref value which is
                                           being used in JSON format (instead of module prefixes, we use the module
                                           names) */
+#define LYS_MAND_SUBTREE 0x1000      /**< flag marking data schema nodes whose subtree (including the node itself) has
+                                          a mandatory statement or min/max-elements, maintained internally for the data
+                                          validation */
 #define LYS_NOTAPPLIED   0x01        /**< flag for the not applied augments to allow keeping the resolved target */
 #define LYS_YINELEM      0x01        /**< yin-element true for extension's argument */
+#define LYS_TYPE_SHARED  0x01        /**< the type-specific information (restrictions and compiled patterns) is
+                                          shared with the type in the grouping the node was instantiated from,
+                                          applicable only to ::lys_type */
 /**
  * @}
  */
@@ -17,6 +17,7 @@
 #include <string.h>
 
 #include "common.h"
+#include "context.h"
 #include "validation.h"
 #include "libyang.h"
 #include "xpath.h"
@@ -82,8 +83,8 @@ lyv_data_context(const struct lyd_node *node, int options, struct unres_data *un
     }
 
     /* check all relevant when conditions */
-    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER | LYD_OPT_EDIT | LYD_OPT_GET | LYD_OPT_GETCONFIG))
-            && (node->when_status & LYD_WHEN)) {
+    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER | LYD_OPT_EDIT | LYD_OPT_GET | LYD_OPT_GETCONFIG
+                     | LYD_OPT_SELECT)) && (node->when_status & LYD_WHEN)) {
         if (unres_data_add(unres, (struct lyd_node *)node, UNRES_WHEN)) {
             return EXIT_FAILURE;
         }
@@ -115,64 +116,582 @@ lyv_data_context(const struct lyd_node *node, int options, struct unres_data *un
     return EXIT_SUCCESS;
 }
 
-struct eq_item {
-    struct lyd_node *node;
-    uint32_t hash;
-    uint32_t over;
+/**
+ * @brief Get the hash of a list/leaf-list instance values.
+ *
+ * @param[in] node List/leaf-list instance.
+ * @param[in] action 0 for the keys (value of a leaf-list), index + 1 of the list's unique statement otherwise.
+ * @param[out] hash Finished hash of the values.
+ * @return 0 on success, 1 if the keys or unique values are not complete, -1 on error.
+ */
+static int
+lyv_unique_hash(struct lyd_node *node, int action, uint32_t *hash)
+{
+    struct lys_node_list *slist;
+    struct lyd_node *diter;
+    const char *id = NULL;
+    int i;
+
+    *hash = 0;
+    if (node->schema->nodetype == LYS_LEAFLIST) {
+        id = ((struct lyd_node_leaf_list *)node)->value_str;
+        *hash = dict_hash_multi(0, id, strlen(id));
+    } else if (!action) {
+        slist = (struct lys_node_list *)node->schema;
+        for (i = 0, diter = node->child; i < slist->keys_size; i++, diter = diter->next) {
+            if (!diter || (diter->schema != (struct lys_node *)slist->keys[i])) {
+                /* the keys are not complete (yet) */
+                return 1;
+            }
+            id = ((struct lyd_node_leaf_list *)diter)->value_str;
+            *hash = dict_hash_multi(*hash, id, strlen(id));
+        }
+    } else {
+        slist = (struct lys_node_list *)node->schema;
+        for (i = 0; i < slist->unique[action - 1].expr_size; i++) {
+            diter = resolve_data_descendant_schema_nodeid(slist->unique[action - 1].expr[i], node->child);
+            if (diter) {
+                id = ((struct lyd_node_leaf_list *)diter)->value_str;
+            } else {
+                /* use default value */
+                id = lyd_get_unique_default(slist->unique[action - 1].expr[i], node);
+                if (ly_errno) {
+                    return -1;
+                }
+            }
+            if (!id) {
+                /* unique item not present nor has default value */
+                return 1;
+            }
+            *hash = dict_hash_multi(*hash, id, strlen(id));
+        }
+    }
+
+    /* finish the hash value */
+    *hash = dict_hash_multi(*hash, NULL, 0);
+    return 0;
+}
+
+/* no record in the chain, the record is not inserted into the value table */
+#define UIDX_END 0xffffffff
+#define UIDX_ABSENT 0xfffffffe
+
+/* initial number of records in an index, must be a power of 2 */
+#define UIDX_SIZE 16
+
+/**
+ * @brief Index of the instances of a list/leaf-list among siblings for the uniqueness checks.
+ *
+ * The index is built by the first check of more than 2 instances and then it is kept up to date by the changes
+ * of the data tree (lyv_unique_index_insert(), lyv_unique_index_unlink(), lyv_unique_invalidate()), so the
+ * following checks compare only the changed instances with the others. Every indexed instance is mapped to its
+ * index in ly_ctx#unique_idx, top-level instances are indexed the same way as the instances in a parent.
+ *
+ * There are a table of node pointers to find the records of instances and one table of values for the keys
+ * (leaf-list value) and each unique statement. All the tables use separate chaining in the arrays of records,
+ * the chains of value tables are indexed as [record * tables + table].
+ */
+struct lyd_unique_index {
+    const struct lys_node *schema;    /**< list/leaf-list of the indexed instances */
+    uint32_t size;                    /**< number of records and buckets of each table */
+    uint32_t tables;                  /**< number of value tables */
+    uint32_t free;                    /**< first free record */
+    uint32_t count;                   /**< number of indexed instances */
+    struct lyd_node **nodes;          /**< [size] indexed instances, NULL in free records */
+    uint32_t *node_next;              /**< [size] next record in the node chain (or in the free list) */
+    uint32_t *node_head;              /**< [size] buckets of the node table */
+    uint32_t *hash;                   /**< [size * tables] hashes of the record values */
+    uint32_t *val_next;               /**< [size * tables] next record in the value chain or #UIDX_ABSENT */
+    uint32_t *val_head;               /**< [size * tables] buckets of the value tables */
+    struct lyd_node **dirty;          /**< [dirty_count] added and changed (#LYD_VAL_UNIQUE) instances to be checked,
+                                           the ones removed from the index since are skipped */
+    uint32_t dirty_count;             /**< number of items in #dirty */
+    uint32_t dirty_size;              /**< allocated items of #dirty */
 };
 
-static int
-eq_table_insert(struct eq_item *table, struct lyd_node *node, uint32_t hash, uint32_t tablesize, int action)
+static uint32_t
+uidx_node_hash(const struct lyd_node *node)
+{
+    return (uint32_t)(((uintptr_t)node >> 4) * 2654435761U);
+}
+
+static void
+uidx_free(struct lyd_unique_index *idx)
+{
+    free(idx->nodes);
+    free(idx->node_next);
+    free(idx->node_head);
+    free(idx->hash);
+    free(idx->val_next);
+    free(idx->val_head);
+    free(idx->dirty);
+    free(idx);
+}
+
+/* (re)build the buckets after the index was resized */
+static void
+uidx_rehash(struct lyd_unique_index *idx)
 {
-    uint32_t i, c;
+    uint32_t r, j, b, mask = idx->size - 1;
 
-    if (table[hash].node) {
-        /* is it collision or is the cell just filled by an overflow item? */
-        for (i = hash; table[i].node && table[i].hash != hash; i = (i + 1) % tablesize);
-        if (!table[i].node) {
-            goto first;
+    memset(idx->node_head, 0xff, idx->size * sizeof *idx->node_head);
+    memset(idx->val_head, 0xff, idx->size * idx->tables * sizeof *idx->val_head);
+
+    idx->free = UIDX_END;
+    for (r = idx->size; r > 0; r--) {
+        if (!idx->nodes[r - 1]) {
+            idx->node_next[r - 1] = idx->free;
+            idx->free = r - 1;
+            continue;
         }
 
-        /* collision or instance duplication */
-        c = table[i].over;
-        do {
-            if (table[i].hash != hash) {
-                i = (i + 1) % tablesize;
+        b = uidx_node_hash(idx->nodes[r - 1]) & mask;
+        idx->node_next[r - 1] = idx->node_head[b];
+        idx->node_head[b] = r - 1;
+
+        for (j = 0; j < idx->tables; j++) {
+            if (idx->val_next[(r - 1) * idx->tables + j] == UIDX_ABSENT) {
                 continue;
             }
+            b = (idx->hash[(r - 1) * idx->tables + j] & mask) * idx->tables + j;
+            idx->val_next[(r - 1) * idx->tables + j] = idx->val_head[b];
+            idx->val_head[b] = r - 1;
+        }
+    }
+}
+
+static int
+uidx_resize(struct lyd_unique_index *idx, uint32_t size)
+{
+    struct lyd_node **nodes;
+    uint32_t *node_next, *node_head, *hash, *val_next, *val_head;
+
+    nodes = realloc(idx->nodes, size * sizeof *nodes);
+    LY_CHECK_ERR_RETURN(!nodes, LOGMEM, EXIT_FAILURE);
+    idx->nodes = nodes;
+    memset(nodes + idx->size, 0, (size - idx->size) * sizeof *nodes);
+
+    node_next = realloc(idx->node_next, size * sizeof *node_next);
+    LY_CHECK_ERR_RETURN(!node_next, LOGMEM, EXIT_FAILURE);
+    idx->node_next = node_next;
+    node_head = realloc(idx->node_head, size * sizeof *node_head);
+    LY_CHECK_ERR_RETURN(!node_head, LOGMEM, EXIT_FAILURE);
+    idx->node_head = node_head;
+    hash = realloc(idx->hash, size * idx->tables * sizeof *hash);
+    LY_CHECK_ERR_RETURN(!hash, LOGMEM, EXIT_FAILURE);
+    idx->hash = hash;
+    val_next = realloc(idx->val_next, size * idx->tables * sizeof *val_next);
+    LY_CHECK_ERR_RETURN(!val_next, LOGMEM, EXIT_FAILURE);
+    idx->val_next = val_next;
+    val_head = realloc(idx->val_head, size * idx->tables * sizeof *val_head);
+    LY_CHECK_ERR_RETURN(!val_head, LOGMEM, EXIT_FAILURE);
+    idx->val_head = val_head;
+
+    idx->size = size;
+    uidx_rehash(idx);
+    return EXIT_SUCCESS;
+}
 
-            /* compare nodes */
-            if (lyd_list_equal(node, table[i].node, action, 0, 1)) {
+static struct lyd_unique_index *
+uidx_new(const struct lys_node *schema)
+{
+    struct lyd_unique_index *idx;
+
+    idx = calloc(1, sizeof *idx);
+    LY_CHECK_ERR_RETURN(!idx, LOGMEM, NULL);
+    idx->schema = schema;
+    idx->tables = 1;
+    if (schema->nodetype == LYS_LIST) {
+        idx->tables += ((struct lys_node_list *)schema)->unique_size;
+    }
+    if (uidx_resize(idx, UIDX_SIZE)) {
+        uidx_free(idx);
+        return NULL;
+    }
+
+    return idx;
+}
+
+static uint32_t
+uidx_find(struct lyd_unique_index *idx, const struct lyd_node *node)
+{
+    uint32_t r;
+
+    for (r = idx->node_head[uidx_node_hash(node) & (idx->size - 1)]; r != UIDX_END; r = idx->node_next[r]) {
+        if (idx->nodes[r] == node) {
+            break;
+        }
+    }
+    return r;
+}
+
+/* remove the record from all the value chains */
+static void
+uidx_unhash(struct lyd_unique_index *idx, uint32_t r)
+{
+    uint32_t *link, j, mask = idx->size - 1;
+
+    for (j = 0; j < idx->tables; j++) {
+        if (idx->val_next[r * idx->tables + j] == UIDX_ABSENT) {
+            continue;
+        }
+        for (link = &idx->val_head[(idx->hash[r * idx->tables + j] & mask) * idx->tables + j];
+                *link != r;
+                link = &idx->val_next[*link * idx->tables + j]);
+        *link = idx->val_next[r * idx->tables + j];
+        idx->val_next[r * idx->tables + j] = UIDX_ABSENT;
+    }
+}
+
+/* compute the values of the record instance and add it into the value chains */
+static int
+uidx_hash(struct lyd_unique_index *idx, uint32_t r)
+{
+    uint32_t j, b, *hash = &idx->hash[r * idx->tables], mask = idx->size - 1;
+    int rc;
+
+    for (j = 0; j < idx->tables; j++) {
+        rc = lyv_unique_hash(idx->nodes[r], j, &hash[j]);
+        if (rc == -1) {
+            return EXIT_FAILURE;
+        } else if (rc) {
+            /* the unique values are not complete */
+            continue;
+        }
+
+        b = (hash[j] & mask) * idx->tables + j;
+        idx->val_next[r * idx->tables + j] = idx->val_head[b];
+        idx->val_head[b] = r;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/* remove the record from all the chains */
+static void
+uidx_remove(struct lyd_unique_index *idx, uint32_t r)
+{
+    uint32_t *link;
+
+    for (link = &idx->node_head[uidx_node_hash(idx->nodes[r]) & (idx->size - 1)]; *link != r; link = &idx->node_next[*link]);
+    *link = idx->node_next[r];
+    uidx_unhash(idx, r);
+
+    idx->nodes[r] = NULL;
+    idx->node_next[r] = idx->free;
+    idx->free = r;
+    --idx->count;
+}
+
+/* add the instance into the index, its values are hashed only if requested (they may be incomplete yet),
+ * returns the record */
+static uint32_t
+uidx_add(struct lyd_unique_index *idx, struct lyd_node *node, int hash)
+{
+    uint32_t r, j, b;
+
+    if ((idx->free == UIDX_END) && uidx_resize(idx, idx->size << 1)) {
+        return UIDX_END;
+    }
+
+    r = idx->free;
+    idx->free = idx->node_next[r];
+    idx->nodes[r] = node;
+    b = uidx_node_hash(node) & (idx->size - 1);
+    idx->node_next[r] = idx->node_head[b];
+    idx->node_head[b] = r;
+    ++idx->count;
+
+    for (j = 0; j < idx->tables; j++) {
+        idx->val_next[r * idx->tables + j] = UIDX_ABSENT;
+    }
+    if (hash && uidx_hash(idx, r)) {
+        uidx_remove(idx, r);
+        return UIDX_END;
+    }
+
+    return r;
+}
+
+/* compare the record instance with the other instances of the same values */
+static int
+uidx_check(struct lyd_unique_index *idx, uint32_t r)
+{
+    uint32_t i, j, hash, mask = idx->size - 1;
+
+    for (j = 0; j < idx->tables; j++) {
+        if (idx->val_next[r * idx->tables + j] == UIDX_ABSENT) {
+            continue;
+        }
+
+        hash = idx->hash[r * idx->tables + j];
+        for (i = idx->val_head[(hash & mask) * idx->tables + j]; i != UIDX_END; i = idx->val_next[i * idx->tables + j]) {
+            if ((i != r) && (idx->hash[i * idx->tables + j] == hash)
+                    && lyd_list_equal(idx->nodes[r], idx->nodes[i], j, 0, 1)) {
                 /* instance duplication */
                 return EXIT_FAILURE;
             }
-        } while (c--);
+        }
+    }
 
-        /* collision, insert item into next free cell */
-        table[hash].over++;
-        for (i = (i + 1) % tablesize; table[i].node; i = (i + 1) % tablesize);
-        table[i].hash = hash;
-        table[i].node = node;
-    } else {
-first:
-        /* first hash instance */
-        table[hash].node = node;
-        table[hash].hash = hash;
+    return EXIT_SUCCESS;
+}
+
+/* note the changed instance to be checked */
+static int
+uidx_dirty(struct lyd_unique_index *idx, struct lyd_node *node)
+{
+    struct lyd_node **dirty;
+
+    if (idx->dirty_count == idx->dirty_size) {
+        dirty = realloc(idx->dirty, (idx->dirty_size ? idx->dirty_size << 1 : UIDX_SIZE) * sizeof *dirty);
+        LY_CHECK_ERR_RETURN(!dirty, LOGMEM, EXIT_FAILURE);
+        idx->dirty = dirty;
+        idx->dirty_size = idx->dirty_size ? idx->dirty_size << 1 : UIDX_SIZE;
+    }
+    idx->dirty[idx->dirty_count++] = node;
+    return EXIT_SUCCESS;
+}
+
+static struct lyd_unique_index *
+uidx_get(const struct lyd_node *node)
+{
+    struct ly_ctx *ctx = node->schema->module->ctx;
+    struct lyd_unique_index *idx;
+
+    if (!__atomic_load_n(&ctx->unique_idx_used, __ATOMIC_RELAXED)) {
+        /* no index in the context, only this thread could have created the ones of its data */
+        return NULL;
+    }
+
+    pthread_mutex_lock(&ctx->unique_lock);
+    idx = ly_ptr_map_get(&ctx->unique_idx, node);
+    pthread_mutex_unlock(&ctx->unique_lock);
+    return idx;
+}
+
+/* map the instances to the index (idx) or remove them from the map (!idx), called with ly_ctx#unique_lock held */
+static int
+uidx_map(struct ly_ctx *ctx, struct lyd_node **nodes, uint32_t count, struct lyd_unique_index *idx)
+{
+    uint32_t u;
+    int ret = EXIT_SUCCESS;
+
+    for (u = 0; u < count; u++) {
+        if (!nodes[u]) {
+            continue;
+        }
+        if (!idx) {
+            ly_ptr_map_remove(&ctx->unique_idx, nodes[u]);
+        } else if (ly_ptr_map_set(&ctx->unique_idx, nodes[u], idx)) {
+            ret = EXIT_FAILURE;
+            break;
+        }
+    }
+    __atomic_store_n(&ctx->unique_idx_used, ctx->unique_idx.used, __ATOMIC_RELAXED);
+    return ret;
+}
+
+/* drop the index after an error, the instances are marked to be all checked again */
+static void
+uidx_drop(struct ly_ctx *ctx, struct lyd_unique_index *idx)
+{
+    uint32_t r;
+
+    pthread_mutex_lock(&ctx->unique_lock);
+    uidx_map(ctx, idx->nodes, idx->size, NULL);
+    pthread_mutex_unlock(&ctx->unique_lock);
+
+    for (r = 0; r < idx->size; r++) {
+        if (idx->nodes[r]) {
+            idx->nodes[r]->validity |= LYD_VAL_UNIQUE;
+        }
+    }
+    uidx_free(idx);
+}
+
+/* index all the instances, they are checked while being added */
+static int
+uidx_build(struct ly_set *set)
+{
+    struct ly_ctx *ctx = set->set.d[0]->schema->module->ctx;
+    struct lyd_unique_index *idx;
+    uint32_t u, r;
+    int ret;
+
+    idx = uidx_new(set->set.d[0]->schema);
+    if (!idx) {
+        return EXIT_FAILURE;
+    }
+    for (u = 0; u < set->number; u++) {
+        r = uidx_add(idx, set->set.d[u], 1);
+        if ((r == UIDX_END) || uidx_check(idx, r)) {
+            uidx_free(idx);
+            return EXIT_FAILURE;
+        }
+    }
+
+    pthread_mutex_lock(&ctx->unique_lock);
+    ret = uidx_map(ctx, set->set.d, set->number, idx);
+    if (ret) {
+        uidx_map(ctx, set->set.d, set->number, NULL);
     }
+    pthread_mutex_unlock(&ctx->unique_lock);
+    if (ret) {
+        uidx_free(idx);
+    }
+    return ret;
+}
+
+/* check the changed instances, the failed one and the following ones are kept to be checked next time */
+static int
+uidx_check_dirty(struct lyd_unique_index *idx)
+{
+    struct lyd_node *node;
+    uint32_t u, r;
+
+    for (u = 0; u < idx->dirty_count; u++) {
+        node = idx->dirty[u];
+        r = uidx_find(idx, node);
+        if (r == UIDX_END) {
+            /* removed since */
+            continue;
+        }
+
+        /* the values may have changed */
+        uidx_unhash(idx, r);
+        if (uidx_hash(idx, r) || uidx_check(idx, r)) {
+            idx->dirty_count -= u;
+            memmove(idx->dirty, idx->dirty + u, idx->dirty_count * sizeof *idx->dirty);
+            return EXIT_FAILURE;
+        }
+        node->validity &= ~LYD_VAL_UNIQUE;
+    }
+    idx->dirty_count = 0;
 
     return EXIT_SUCCESS;
 }
 
+void
+lyv_unique_index_insert(struct lyd_node *node, int next_known)
+{
+    struct ly_ctx *ctx = node->schema->module->ctx;
+    struct lyd_unique_index *idx = NULL;
+    struct lyd_node *iter;
+
+    if (!(node->schema->nodetype & (LYS_LIST | LYS_LEAFLIST))) {
+        return;
+    }
+
+    /* the node may have been moved from other siblings without being unlinked */
+    lyv_unique_index_unlink(node);
+
+    if (!__atomic_load_n(&ctx->unique_idx_used, __ATOMIC_RELAXED)) {
+        /* no index to add into */
+        return;
+    }
+
+    /* all or none of the instances are indexed, so a neighbor instance tells it */
+    if ((node->prev != node) && (node->prev->schema == node->schema)) {
+        idx = uidx_get(node->prev);
+    } else if (next_known && node->next && (node->next->schema == node->schema)) {
+        idx = uidx_get(node->next);
+    } else {
+        /* look for any indexed instance */
+        pthread_mutex_lock(&ctx->unique_lock);
+        for (iter = lyd_first_sibling(node); iter && !idx; iter = iter->next) {
+            if ((iter != node) && (iter->schema == node->schema)) {
+                idx = ly_ptr_map_get(&ctx->unique_idx, iter);
+            }
+        }
+        pthread_mutex_unlock(&ctx->unique_lock);
+    }
+    if (!idx) {
+        return;
+    }
+
+    /* the instance is hashed and checked with the others by the next check */
+    if ((uidx_add(idx, node, 0) == UIDX_END) || uidx_dirty(idx, node)) {
+        goto error;
+    }
+    pthread_mutex_lock(&ctx->unique_lock);
+    if (uidx_map(ctx, &node, 1, idx)) {
+        pthread_mutex_unlock(&ctx->unique_lock);
+        goto error;
+    }
+    pthread_mutex_unlock(&ctx->unique_lock);
+    return;
+
+error:
+    uidx_drop(ctx, idx);
+    node->validity |= LYD_VAL_UNIQUE;
+}
+
+void
+lyv_unique_index_unlink(struct lyd_node *node)
+{
+    struct ly_ctx *ctx = node->schema->module->ctx;
+    struct lyd_unique_index *idx;
+
+    if (!__atomic_load_n(&ctx->unique_idx_used, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    pthread_mutex_lock(&ctx->unique_lock);
+    idx = ly_ptr_map_remove(&ctx->unique_idx, node);
+    __atomic_store_n(&ctx->unique_idx_used, ctx->unique_idx.used, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&ctx->unique_lock);
+    if (!idx) {
+        return;
+    }
+
+    uidx_remove(idx, uidx_find(idx, node));
+    if (!idx->count) {
+        uidx_free(idx);
+    }
+}
+
+void
+lyv_unique_invalidate(struct lyd_node *node)
+{
+    struct lyd_unique_index *idx;
+
+    if (node->validity & LYD_VAL_UNIQUE) {
+        /* already noted */
+        return;
+    }
+
+    node->validity |= LYD_VAL_UNIQUE;
+    idx = uidx_get(node);
+    if (idx && uidx_dirty(idx, node)) {
+        uidx_drop(node->schema->module->ctx, idx);
+    }
+}
+
 int
 lyv_data_unique(struct lyd_node *node, struct lyd_node *start)
 {
-    struct lyd_node *diter, *key;
-    struct lys_node_list *slist;
+    struct lyd_node *diter;
+    struct lyd_unique_index *idx;
     struct ly_set *set;
-    int i, j, n = 0, ret = EXIT_SUCCESS;
-    uint32_t hash, u, usize = 0, hashmask;
-    struct eq_item *keystable = NULL, **uniquetables = NULL;
-    const char *id;
+    int ret = EXIT_SUCCESS;
+    struct ly_ctx *ctx = node->schema->module->ctx;
+    uint64_t start_time;
+
+    LY_STATS_TIMER_START(ctx, start_time);
+
+    idx = uidx_get(node);
+    if (idx) {
+        /* only the changed instances are checked */
+        if ((node->validity & LYD_VAL_UNIQUE) && uidx_dirty(idx, node)) {
+            uidx_drop(ctx, idx);
+            idx = NULL;
+        } else {
+            ret = uidx_check_dirty(idx);
+            LY_STATS_TIMER_STOP(ctx, start_time, time_unique);
+            return ret;
+        }
+    }
 
     /* get the first list/leaflist instance sibling */
     if (!start) {
@@ -198,126 +717,24 @@ lyv_data_unique(struct lyd_node *node, struct lyd_node *start)
         /* simple comparison */
         if (lyd_list_equal(set->set.d[0], set->set.d[1], -1, 0, 1)) {
             /* instance duplication */
-            ly_set_free(set);
-            return EXIT_FAILURE;
-        }
-    } else if (set->number > 2) {
-        /* use hashes for comparison */
-        /* first, allocate the table, the size depends on number of items in the set */
-        for (u = 31; u > 0; u--) {
-            usize = set->number << u;
-            usize = usize >> u;
-            if (usize == set->number) {
-                break;
-            }
-        }
-        if (u == 0) {
-            usize = hashmask = 0xffffffff;
-        } else {
-            u = 32 - u;
-            usize = 1 << u;
-            hashmask = usize - 1;
-        }
-        keystable = calloc(usize, sizeof *keystable);
-        if (!keystable) {
-            LOGMEM;
             ret = EXIT_FAILURE;
-            goto unique_cleanup;
         }
-        n = 0;
-        if (node->schema->nodetype == LYS_LIST) {
-            n = ((struct lys_node_list *)node->schema)->unique_size;
-            uniquetables = malloc(n * sizeof *uniquetables);
-            if (!uniquetables) {
-                LOGMEM;
-                ret = EXIT_FAILURE;
-                n = 0;
-                goto unique_cleanup;
-            }
-            for (j = 0; j < n; j++) {
-                uniquetables[j] = calloc(usize, sizeof **uniquetables);
-                if (!uniquetables[j]) {
-                    LOGMEM;
-                    ret = EXIT_FAILURE;
-                    goto unique_cleanup;
-                }
-            }
-        }
-
-        for (u = 0; u < set->number; u++) {
-            /* get the hash for the instance - keys */
-            if (node->schema->nodetype == LYS_LEAFLIST) {
-                id = ((struct lyd_node_leaf_list *)set->set.d[u])->value_str;
-                hash = dict_hash_multi(0, id, strlen(id));
-            } else { /* LYS_LIST */
-                for (hash = i = 0, key = set->set.d[u]->child;
-                        i < ((struct lys_node_list *)set->set.d[u]->schema)->keys_size;
-                        i++, key = key->next) {
-                    id = ((struct lyd_node_leaf_list *)key)->value_str;
-                    hash = dict_hash_multi(hash, id, strlen(id));
-                }
-            }
-            /* finish the hash value */
-            hash = dict_hash_multi(hash, NULL, 0) & hashmask;
-
-            /* insert into the hashtable */
-            if (eq_table_insert(keystable, set->set.d[u], hash, usize, 0)) {
-                ret = EXIT_FAILURE;
-                goto unique_cleanup;
-            }
-
-            /* and the same loop for unique (n is !0 only in case of list) - get the hash for the instances */
-            for (j = 0; j < n; j++) {
-                slist = (struct lys_node_list *)node->schema;
-                id = NULL;
-                for (i = hash = 0; i < slist->unique[j].expr_size; i++) {
-                    diter = resolve_data_descendant_schema_nodeid(slist->unique[j].expr[i], set->set.d[u]->child);
-                    if (diter) {
-                        id = ((struct lyd_node_leaf_list *)diter)->value_str;
-                    } else {
-                        /* use default value */
-                        id = lyd_get_unique_default(slist->unique[j].expr[i], set->set.d[u]);
-                        if (ly_errno) {
-                            ret = EXIT_FAILURE;
-                            goto unique_cleanup;
-                        }
-                    }
-                    if (!id) {
-                        /* unique item not present nor has default value */
-                        break;
-                    }
-                    hash = dict_hash_multi(hash, id, strlen(id));
-                }
-                if (!id) {
-                    /* skip this list instance since its unique set is incomplete */
-                    continue;
-                }
-
-                /* finish the hash value */
-                hash = dict_hash_multi(hash, NULL, 0) & hashmask;
+    } else if (set->number > 2) {
+        /* index the instances, so that following checks compare only the changed ones */
+        ret = uidx_build(set);
+    }
 
-                /* insert into the hashtable */
-                if (eq_table_insert(uniquetables[j], set->set.d[u], hash, usize, j + 1)) {
-                    ret = EXIT_FAILURE;
-                    goto unique_cleanup;
-                }
+    if (ret) {
+        /* check them all again next time */
+        for (diter = start; diter; diter = diter->next) {
+            if (diter->schema == node->schema) {
+                diter->validity |= LYD_VAL_UNIQUE;
             }
         }
     }
-
-unique_cleanup:
-    /* cleanup */
     ly_set_free(set);
-    free(keystable);
-    for (j = 0; j < n; j++) {
-        if (!uniquetables[j]) {
-            /* failed when allocating uniquetables[j], following j are not allocated */
-            break;
-        }
-        free(uniquetables[j]);
-    }
-    free(uniquetables);
 
+    LY_STATS_TIMER_STOP(ctx, start_time, time_unique);
     return ret;
 }
 
@@ -438,6 +855,10 @@ lyv_data_content(struct lyd_node *node, int options, struct unres_data *unres)
         /* skip key uniqueness check in case of get/get-config data */
         if (schema->nodetype & (LYS_LIST | LYS_CONTAINER)) {
             LY_TREE_FOR(schema->child, siter) {
+                if (unres->select && (lyp_data_selected(unres->select, siter) != 2)) {
+                    /* only the keys of the ancestors of the selected nodes are parsed */
+                    continue;
+                }
                 if (siter->nodetype & (LYS_LIST | LYS_LEAFLIST)) {
                     LY_TREE_FOR(node->child, diter) {
                         if (diter->schema == siter && (diter->validity & LYD_VAL_UNIQUE)) {
@@ -506,8 +927,9 @@ nextbit:
         }
     }
 
-    /* check must conditions */
-    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER | LYD_OPT_EDIT | LYD_OPT_GET | LYD_OPT_GETCONFIG))) {
+    /* check must conditions, they can refer to the data skipped by the parser (LYD_OPT_SELECT) */
+    if (!(options & (LYD_OPT_TRUSTED | LYD_OPT_NOTIF_FILTER | LYD_OPT_EDIT | LYD_OPT_GET | LYD_OPT_GETCONFIG
+                     | LYD_OPT_SELECT))) {
         i = resolve_applies_must(node);
         if ((i & 0x1) && (unres_data_add(unres, node, UNRES_MUST) == -1)) {
             return EXIT_FAILURE;
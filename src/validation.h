@@ -55,7 +55,9 @@ int lyv_data_content(struct lyd_node *node, int options, struct unres_data *unre
  * @brief check for list/leaflist uniqueness.
  *
  * Function is used by lyv_data_context for inner lists/leaflists. Due to optimization, the function
- * is used separatedly for the top-level lists/leaflists.
+ * is used separatedly for the top-level lists/leaflists. The first check of more than 2 instances indexes
+ * them, the index is then kept up to date by the changes of the data tree, so the following checks compare
+ * only the instances changed (#LYD_VAL_UNIQUE) since with the others.
  *
  * @param[in] node List/leaflist node to be checked.
  * @param[in] start First sibling of the \p node for searching for other instances of the same list/leaflist.
@@ -63,6 +65,35 @@ int lyv_data_content(struct lyd_node *node, int options, struct unres_data *unre
  */
 int lyv_data_unique(struct lyd_node *node, struct lyd_node *start);
 
+/**
+ * @brief Add the list/leaflist instance into the index of its siblings' instances, if they are indexed.
+ *
+ * Must be called whenever a node is linked among siblings, other nodes than list/leaflist instances are ignored.
+ * The added instance is checked by the next lyv_data_unique() of its siblings.
+ *
+ * @param[in] node Linked node.
+ * @param[in] next_known Whether the next sibling of the \p node was already added into the index, if needed
+ *                       (0 when inserting several nodes at once in the order).
+ */
+void lyv_unique_index_insert(struct lyd_node *node, int next_known);
+
+/**
+ * @brief Remove the list/leaflist instance from the index of its siblings' instances, if any.
+ *
+ * Must be called whenever the instance is being removed from its siblings.
+ *
+ * @param[in] node List/leaflist instance.
+ */
+void lyv_unique_index_unlink(struct lyd_node *node);
+
+/**
+ * @brief Note that the values (keys, unique leaves, leaf-list value) of the list/leaflist instance changed,
+ * so it is checked by the next lyv_data_unique().
+ *
+ * @param[in] node List/leaflist instance.
+ */
+void lyv_unique_invalidate(struct lyd_node *node);
+
 /**
  * @brief Validate if the \p node has a sibling from another choice's case. It can report an error or automatically
  * remove the nodes from other case than \p node.
@@ -33,10 +33,9 @@
 #include "tree_schema.h"
 #include "xml_internal.h"
 
+/* needs the end of the parsed data in the scope */
 #define ign_xmlws(p)                                                    \
-    while (is_xmlws(*p)) {                                              \
-        p++;                                                            \
-    }
+    p += lyp_ws_span(p, end - (p))
 
 static struct lyxml_attr *lyxml_dup_attr(struct ly_ctx *ctx, struct lyxml_elem *parent, struct lyxml_attr *attr);
 
@@ -482,8 +481,15 @@ lyxml_getutf8(const char *buf, unsigned int *read)
     }
     *read = 1;
 
-    /* process character byte(s) */
-    if ((c & 0xf8) == 0xf0) {
+    /* process character byte(s), the most common ASCII first */
+    if (!(c & 0x80)) {
+        /* one byte character */
+        if (c < 0x20 && c != 0x9 && c != 0xa && c != 0xd) {
+            /* invalid character */
+            LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "input character");
+            return 0;
+        }
+    } else if ((c & 0xf8) == 0xf0) {
         /* four bytes character */
         *read = 4;
 
@@ -536,13 +542,6 @@ lyxml_getutf8(const char *buf, unsigned int *read)
             LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "input character");
             return 0;
         }
-    } else if (!(c & 0x80)) {
-        /* one byte character */
-        if (c < 0x20 && c != 0x9 && c != 0xa && c != 0xd) {
-            /* invalid character */
-            LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "input character");
-            return 0;
-        }
     } else {
         /* invalid character */
         LOGVAL(LYE_XML_INVAL, LY_VLOG_NONE, NULL, "input character");
@@ -574,9 +573,9 @@ parse_ignore(const char *data, const char *endstr, unsigned int *len)
     return EXIT_SUCCESS;
 }
 
-/* logs directly */
+/* logs directly, end is the terminating NULL byte of the data */
 static char *
-parse_text(const char *data, char delim, unsigned int *len)
+parse_text(const char *data, const char *end, char delim, unsigned int *len)
 {
 #define BUFSIZE 1024
 
@@ -586,6 +585,7 @@ parse_text(const char *data, char delim, unsigned int *len)
     int o, size = 0;
     int cdsect = 0;
     int32_t n;
+    const char stop[] = {delim, '<', '&', ']', '\0'};
 
     for (*len = o = 0; cdsect || data[*len] != delim; o++) {
         if (!data[*len] || (!cdsect && !strncmp(&data[*len], "]]>", 3))) {
@@ -617,13 +617,29 @@ loop:
                 cdsect = 1;
                 *len += 9;
             }
-            if (data[*len] && !strncmp(&data[*len], "]]>", 3)) {
+            if (!data[*len]) {
+                /* unterminated CDSect */
+                LOGVAL(LYE_EOF, LY_VLOG_NONE, NULL);
+                goto error;
+            } else if (!strncmp(&data[*len], "]]>", 3)) {
                 *len += 3;
                 cdsect = 0;
                 o--;            /* we don't write any data in this iteration */
             } else {
-                buf[o] = data[*len];
-                (*len)++;
+                /* copy the run of plain characters at once, any other byte is copied as it is */
+                r = end - &data[*len];
+                if (r > (unsigned int)(BUFSIZE - o)) {
+                    r = BUFSIZE - o;
+                }
+                r = lyp_ascii_span(&data[*len], r, "]", 1);
+                if (r) {
+                    memcpy(&buf[o], &data[*len], r);
+                } else {
+                    buf[o] = data[*len];
+                    r = 1;
+                }
+                o += r - 1;     /* o is ++ in for loop */
+                (*len) += r;
             }
         } else if (data[*len] == '&') {
             (*len)++;
@@ -684,9 +700,19 @@ loop:
                 (*len)++;
             }
         } else {
-            r = copyutf8(&buf[o], &data[*len]);
-            if (!r) {
-                goto error;
+            /* copy the run of plain ASCII characters at once, the rest by the UTF-8 character */
+            r = end - &data[*len];
+            if (r > (unsigned int)(BUFSIZE - o)) {
+                r = BUFSIZE - o;
+            }
+            r = lyp_ascii_span(&data[*len], r, stop, 1);
+            if (r) {
+                memcpy(&buf[o], &data[*len], r);
+            } else {
+                r = copyutf8(&buf[o], &data[*len]);
+                if (!r) {
+                    goto error;
+                }
             }
 
             o += r - 1;     /* o is ++ in for loop */
@@ -729,7 +755,7 @@ error:
 
 /* logs directly */
 static struct lyxml_attr *
-parse_attr(struct ly_ctx *ctx, const char *data, unsigned int *len, struct lyxml_elem *parent)
+parse_attr(struct ly_ctx *ctx, const char *data, const char *end, unsigned int *len, struct lyxml_elem *parent)
 {
     const char *c = data, *start, *delim;
     char prefix[32], xml_flag;
@@ -814,7 +840,7 @@ equal:
         goto error;
     }
     delim = c;
-    attr->value = lydict_insert_zc(ctx, parse_text(++c, *delim, &size));
+    attr->value = lydict_insert_zc(ctx, parse_text(++c, end, *delim, &size));
     if (ly_errno) {
         goto error;
     }
@@ -841,7 +867,8 @@ error:
 
 /* logs directly */
 struct lyxml_elem *
-lyxml_parse_elem(struct ly_ctx *ctx, const char *data, unsigned int *len, struct lyxml_elem *parent, int options)
+lyxml_parse_elem(struct ly_ctx *ctx, const char *data, const char *end, unsigned int *len, struct lyxml_elem *parent,
+                 int options)
 {
     const char *c = data, *start, *e;
     const char *lws;    /* leading white space for handling mixed content */
@@ -1035,7 +1062,7 @@ process:
                     lyxml_add_child(ctx, elem, child);
                     elem->flags |= LYXML_ELEM_MIXED;
                 }
-                child = lyxml_parse_elem(ctx, c, &size, elem, options);
+                child = lyxml_parse_elem(ctx, c, end, &size, elem, options);
                 if (!child) {
                     goto error;
                 }
@@ -1051,7 +1078,7 @@ store_content:
                     c = lws;
                     lws = NULL;
                 }
-                elem->content = lydict_insert_zc(ctx, parse_text(c, '<', &size));
+                elem->content = lydict_insert_zc(ctx, parse_text(c, end, '<', &size));
                 if (ly_errno) {
                     goto error;
                 }
@@ -1074,7 +1101,7 @@ store_content:
         }
     } else {
         /* process attribute */
-        attr = parse_attr(ctx, c, &size, elem);
+        attr = parse_attr(ctx, c, end, &size, elem);
         if (!attr) {
             goto error;
         }
@@ -1123,17 +1150,18 @@ error:
 API struct lyxml_elem *
 lyxml_parse_mem(struct ly_ctx *ctx, const char *data, int options)
 {
-    const char *c = data;
+    const char *c = data, *end;
     unsigned int len;
     struct lyxml_elem *root, *first = NULL, *next;
     struct ly_ctx *ctx_prev = ly_parser_data.ctx;
 
     ly_err_clean(ctx, 1);
 
-    if (!ctx) {
+    if (!ctx || !data) {
         LOGERR(LY_EINVAL, "%s: Invalid parameter.", __func__);
         return NULL;
     }
+    end = data + strlen(data);
 
     /* set parser context */
     ly_parser_data.ctx = ctx;
@@ -1177,7 +1205,7 @@ repeat:
         }
     }
 
-    root = lyxml_parse_elem(ctx, c, &len, NULL, options);
+    root = lyxml_parse_elem(ctx, c, end, &len, NULL, options);
     if (!root) {
         goto error;
     } else if (!first) {
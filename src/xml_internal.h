@@ -76,6 +76,21 @@ struct lyxml_elem *lyxml_dup_elem(struct ly_ctx *ctx, struct lyxml_elem *elem,
  */
 void lyxml_free_attr(struct ly_ctx *ctx, struct lyxml_elem *parent, struct lyxml_attr *attr);
 
+/**
+ * @brief Parse a single XML element (including all its descendants).
+ *
+ * @param[in] ctx libyang context to use.
+ * @param[in] data Input data starting with the element's start tag.
+ * @param[in] end Terminating NULL byte of \p data.
+ * @param[out] len Number of bytes of \p data the element occupies.
+ * @param[in] parent Parent element, if set, the new element is added as its last child and
+ * namespaces are resolved also in the parent's scope.
+ * @param[in] options Parser options, see @ref xmlreadoptions.
+ * @return Parsed element, NULL on error.
+ */
+struct lyxml_elem *lyxml_parse_elem(struct ly_ctx *ctx, const char *data, const char *end, unsigned int *len,
+                                    struct lyxml_elem *parent, int options);
+
 /**
  * @brief Free (and unlink from their element) all attributes (including
  * namespace definitions) of the specified element.
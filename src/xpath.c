@@ -348,7 +348,8 @@ cast_string_recursive(struct lyd_node *node, struct lys_module *local_mod, int f
     struct lyd_node *child;
     struct lyd_node_anydata *any;
 
-    if ((root_type == LYXP_NODE_ROOT_CONFIG) && (node->schema->flags & LYS_CONFIG_R)) {
+    if (((root_type == LYXP_NODE_ROOT_CONFIG) && (node->schema->flags & LYS_CONFIG_R))
+            || (node->validity & LYD_VAL_HIDDEN)) {
         return;
     }
 
@@ -4126,6 +4127,9 @@ xpath_re_match(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyd_no
     if (lyp_check_pattern(args[1]->val.str, &precomp)) {
         return -1;
     }
+    if (local_mod) {
+        LY_STATS_INC(local_mod->ctx, pattern_execs);
+    }
     if (pcre_exec(precomp, NULL, args[0]->val.str, strlen(args[0]->val.str), 0, 0, NULL, 0)) {
         set_fill_boolean(set, 0);
     } else {
@@ -5033,6 +5037,11 @@ static int
 moveto_node_check(struct lyd_node *node, enum lyxp_node_type root_type, const char *node_name,
                   struct lys_module *moveto_mod, int options)
 {
+    /* accessible tree check */
+    if (node->validity & LYD_VAL_HIDDEN) {
+        return -1;
+    }
+
     /* module check */
     if (moveto_mod && (lyd_node_module(node) != moveto_mod)) {
         return -1;
@@ -5172,8 +5181,16 @@ moveto_node(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname,
         moveto_mod = lyd_node_module(cur_node);
     }
 
-    /* name */
-    name_dict = lydict_insert(ctx, qname, qname_len);
+    /* name, only looked up so that the dictionary does not change, if it is not there, no node can match */
+    if ((qname_len == 1) && (qname[0] == '*')) {
+        name_dict = "*";
+    } else {
+        name_dict = lydict_find(ctx, qname, qname_len);
+        if (!name_dict) {
+            lyxp_set_cast(set, LYXP_SET_EMPTY, cur_node, NULL, options);
+            return EXIT_SUCCESS;
+        }
+    }
 
     for (i = 0; i < set->used; ) {
         replaced = 0;
@@ -5186,7 +5203,6 @@ moveto_node(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname,
                     moveto_node_add(set, sub, 0, i, &replaced);
                     ++i;
                 } else if (ret == EXIT_FAILURE) {
-                    lydict_remove(ctx, name_dict);
                     return EXIT_FAILURE;
                 }
             }
@@ -5201,7 +5217,6 @@ moveto_node(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname,
                     moveto_node_add(set, sub, 0, i, &replaced);
                     ++i;
                 } else if (ret == EXIT_FAILURE) {
-                    lydict_remove(ctx, name_dict);
                     return EXIT_FAILURE;
                 }
             }
@@ -5212,7 +5227,6 @@ moveto_node(struct lyxp_set *set, struct lyd_node *cur_node, const char *qname,
             set_remove_node(set, i);
         }
     }
-    lydict_remove(ctx, name_dict);
 
     return EXIT_SUCCESS;
 }
@@ -5254,8 +5268,12 @@ moveto_snode(struct lyxp_set *set, struct lys_node *cur_node, const char *qname,
         moveto_mod = NULL;
     }
 
-    /* name */
-    name_dict = lydict_insert(ctx, qname, qname_len);
+    /* name, only looked up as in moveto_node(), the names of all the schema nodes are in the dictionary */
+    if ((qname_len == 1) && (qname[0] == '*')) {
+        name_dict = "*";
+    } else {
+        name_dict = lydict_find(ctx, qname, qname_len);
+    }
 
     orig_used = set->used;
     for (i = 0; i < orig_used; ++i) {
@@ -5264,6 +5282,11 @@ moveto_snode(struct lyxp_set *set, struct lys_node *cur_node, const char *qname,
         }
         set->val.snodes[i].in_ctx = 0;
 
+        if (!name_dict) {
+            /* no node can match */
+            continue;
+        }
+
         start_parent = set->val.snodes[i].snode;
 
         if ((set->val.snodes[i].type == LYXP_NODE_ROOT_CONFIG) || (set->val.snodes[i].type == LYXP_NODE_ROOT)) {
@@ -5314,7 +5337,6 @@ get_next_augment:
             }
         }
     }
-    lydict_remove(ctx, name_dict);
 
     /* correct temporary in_ctx values */
     if (temp_ctx) {
@@ -5394,8 +5416,9 @@ moveto_node_alldesc(struct lyxp_set *set, struct lyd_node *cur_node, const char
         replace = 0;
         for (elem = next = start; elem; elem = next) {
 
-            /* dummy and context check */
-            if ((elem->validity & LYD_VAL_INUSE) || ((root_type == LYXP_NODE_ROOT_CONFIG) && (elem->schema->flags & LYS_CONFIG_R))) {
+            /* dummy, accessible tree and context check */
+            if ((elem->validity & (LYD_VAL_INUSE | LYD_VAL_HIDDEN))
+                    || ((root_type == LYXP_NODE_ROOT_CONFIG) && (elem->schema->flags & LYS_CONFIG_R))) {
                 goto skip_children;
             }
 
@@ -5910,8 +5933,9 @@ moveto_self(struct lyxp_set *set, struct lyd_node *cur_node, int all_desc, int o
         /* add all the children ... */
         if (!(set->val.nodes[i].node->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST))) {
             LY_TREE_FOR(set->val.nodes[i].node->child, sub) {
-                /* context check */
-                if ((root_type == LYXP_NODE_ROOT_CONFIG) && (sub->schema->flags & LYS_CONFIG_R)) {
+                /* accessible tree and context check */
+                if ((sub->validity & LYD_VAL_HIDDEN)
+                        || ((root_type == LYXP_NODE_ROOT_CONFIG) && (sub->schema->flags & LYS_CONFIG_R))) {
                     continue;
                 }
 
@@ -8014,6 +8038,7 @@ lyxp_eval(const char *expr, const struct lyd_node *cur_node, enum lyxp_node_type
           const struct lys_module *local_mod, struct lyxp_set *set, int options)
 {
     struct lyxp_expr *exp;
+    struct ly_ctx *ctx;
     uint16_t exp_idx = 0;
     int rc = -1;
 
@@ -8022,6 +8047,12 @@ lyxp_eval(const char *expr, const struct lyd_node *cur_node, enum lyxp_node_type
         return EXIT_FAILURE;
     }
 
+    ctx = local_mod ? local_mod->ctx : (cur_node ? cur_node->schema->module->ctx : NULL);
+    if (ctx) {
+        LY_STATS_INC(ctx, xpath_parses);
+        LY_STATS_INC(ctx, xpath_evals);
+    }
+
     exp = lyxp_parse_expr(expr);
     if (!exp) {
         rc = -1;
@@ -8349,6 +8380,8 @@ lyxp_atomize(const char *expr, const struct lys_node *cur_snode, enum lyxp_node_
     uint16_t exp_idx = 0;
     int rc = -1;
 
+    LY_STATS_INC(cur_snode->module->ctx, xpath_parses);
+
     exp = lyxp_parse_expr(expr);
     if (!exp) {
         rc = -1;
@@ -204,12 +204,73 @@ test_lydict_remove(void **state)
     lydict_remove(ctx, str);
 }
 
+static void
+test_lydict_grow(void **state)
+{
+    (void) state; /* unused */
+    const char *strings[10000], *str;
+    char buf[32];
+    int i;
+
+    /* enough strings to make the dictionary enlarge several times */
+    for (i = 0; i < 10000; i++) {
+        sprintf(buf, "value%d", i);
+        strings[i] = lydict_insert(ctx, buf, 0);
+        assert_ptr_not_equal(strings[i], NULL);
+    }
+
+    /* all the records are still found */
+    for (i = 0; i < 10000; i++) {
+        sprintf(buf, "value%d", i);
+        str = lydict_insert(ctx, buf, 0);
+        assert_ptr_equal(str, strings[i]);
+        assert_string_equal(str, buf);
+    }
+
+    for (i = 0; i < 10000; i++) {
+        lydict_remove(ctx, strings[i]);
+        lydict_remove(ctx, strings[i]);
+    }
+
+    /* the records were removed */
+    str = lydict_insert(ctx, "value1", 0);
+    assert_string_equal(str, "value1");
+    lydict_remove(ctx, str);
+}
+
+static void
+test_lydict_find(void **state)
+{
+    (void) state; /* unused */
+    const char *string, *str;
+
+    /* not present */
+    assert_ptr_equal(lydict_find(ctx, "find_me", 0), NULL);
+
+    string = lydict_insert(ctx, "find_me", 0);
+    assert_ptr_not_equal(string, NULL);
+
+    /* found, with or without the length */
+    assert_ptr_equal(lydict_find(ctx, "find_me", 0), string);
+    assert_ptr_equal(lydict_find(ctx, "find_me_not", 7), string);
+    assert_ptr_equal(lydict_find(ctx, "find_m", 0), NULL);
+
+    /* the reference counter was not changed by searching */
+    str = lydict_insert(ctx, "find_me", 0);
+    assert_ptr_equal(str, string);
+    lydict_remove(ctx, str);
+    lydict_remove(ctx, string);
+    assert_ptr_equal(lydict_find(ctx, "find_me", 0), NULL);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(test_lydict_insert, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lydict_insert_zc, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lydict_remove, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lydict_grow, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lydict_find, setup_f, teardown_f),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
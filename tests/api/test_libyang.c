@@ -248,6 +248,97 @@ test_ly_ctx_info(void **state)
     lyd_free_withsiblings(node);
 }
 
+static void
+test_ly_ctx_info_cache(void **state)
+{
+    struct lyd_node *node1, *node2;
+    char *str1, *str2;
+    (void) state; /* unused */
+
+    /* repeated calls return separate copies of the same data */
+    node1 = ly_ctx_info(ctx);
+    node2 = ly_ctx_info(ctx);
+    assert_ptr_not_equal(node1, NULL);
+    assert_ptr_not_equal(node2, NULL);
+    assert_ptr_not_equal(node1, node2);
+    assert_int_equal(LYD_VAL_OK, node2->validity);
+
+    lyd_print_mem(&str1, node1, LYD_XML, LYP_WITHSIBLINGS);
+    lyd_print_mem(&str2, node2, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(str1, str2);
+    free(str2);
+    lyd_free_withsiblings(node2);
+
+    /* changing a feature is reflected */
+    assert_int_equal(0, lys_features_enable(module, "foo"));
+    node2 = ly_ctx_info(ctx);
+    assert_ptr_not_equal(node2, NULL);
+    lyd_print_mem(&str2, node2, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_not_equal(str1, str2);
+    assert_ptr_not_equal(strstr(str2, "<feature>foo</feature>"), NULL);
+    free(str1);
+    free(str2);
+    lyd_free_withsiblings(node1);
+    lyd_free_withsiblings(node2);
+
+    /* loading a module is reflected */
+    node1 = ly_ctx_info(ctx);
+    assert_ptr_not_equal(ly_ctx_load_module(ctx, "c", NULL), NULL);
+    node2 = ly_ctx_info(ctx);
+    assert_ptr_not_equal(node1, NULL);
+    assert_ptr_not_equal(node2, NULL);
+    lyd_print_mem(&str1, node1, LYD_XML, LYP_WITHSIBLINGS);
+    lyd_print_mem(&str2, node2, LYD_XML, LYP_WITHSIBLINGS);
+    assert_ptr_equal(strstr(str1, "<name>c</name>"), NULL);
+    assert_ptr_not_equal(strstr(str2, "<name>c</name>"), NULL);
+    free(str1);
+    free(str2);
+    lyd_free_withsiblings(node1);
+    lyd_free_withsiblings(node2);
+}
+
+static void
+test_ly_ctx_info_cache_remove(void **state)
+{
+    const struct lys_module *mod;
+    struct lyd_node *node;
+    char *str;
+    (void) state; /* unused */
+
+    /* ietf-yang-library is not internal, so it can be removed together with the data cached from it */
+    ctx = ly_ctx_new_old(TESTS_DIR"/../models", LY_CTX_NOYANGLIBRARY);
+    assert_ptr_not_equal(ctx, NULL);
+    mod = ly_ctx_load_module(ctx, "ietf-yang-library", NULL);
+    assert_ptr_not_equal(mod, NULL);
+
+    node = ly_ctx_info(ctx);
+    assert_ptr_not_equal(node, NULL);
+    lyd_free_withsiblings(node);
+
+    assert_int_equal(0, ly_ctx_remove_module(mod, NULL));
+    assert_ptr_equal(ly_ctx_info(ctx), NULL);
+
+    mod = ly_ctx_load_module(ctx, "ietf-yang-library", NULL);
+    assert_ptr_not_equal(mod, NULL);
+    node = ly_ctx_info(ctx);
+    assert_ptr_not_equal(node, NULL);
+    assert_ptr_equal(node->schema->module, mod);
+    lyd_print_mem(&str, node, LYD_XML, LYP_WITHSIBLINGS);
+    assert_ptr_not_equal(strstr(str, "<name>ietf-yang-library</name>"), NULL);
+    free(str);
+    lyd_free_withsiblings(node);
+
+    /* the same after cleaning the context */
+    ly_ctx_clean(ctx, NULL);
+    assert_ptr_equal(ly_ctx_info(ctx), NULL);
+    mod = ly_ctx_load_module(ctx, "ietf-yang-library", NULL);
+    assert_ptr_not_equal(mod, NULL);
+    node = ly_ctx_info(ctx);
+    assert_ptr_not_equal(node, NULL);
+    assert_ptr_equal(node->schema->module, mod);
+    lyd_free_withsiblings(node);
+}
+
 static void
 test_ly_ctx_new_ylmem(void **state)
 {
@@ -1176,12 +1267,14 @@ test_ly_path_data2schema(void **state)
 int main(void)
 {
     const struct CMUnitTest tests[] = {
-        cmocka_unit_test(test_ly_ctx_new),
+        cmocka_unit_test(test_ly_ctx_new_old),
         cmocka_unit_test(test_ly_ctx_new_invalid),
         cmocka_unit_test(test_ly_ctx_get_searchdirs),
         cmocka_unit_test(test_ly_ctx_set_searchdir),
         cmocka_unit_test(test_ly_ctx_set_searchdir_invalid),
         cmocka_unit_test_setup_teardown(test_ly_ctx_info, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_info_cache, setup_f, teardown_f),
+        cmocka_unit_test_teardown(test_ly_ctx_info_cache_remove, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_new_ylmem, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_module_clb, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_ly_ctx_get_module, setup_f, teardown_f),
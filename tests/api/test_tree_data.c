@@ -391,6 +391,215 @@ error:
     fail();
 }
 
+static void
+test_lyd_parse_push(void **state)
+{
+    (void) state; /* unused */
+    const char *data = "<?xml version=\"1.0\"?>\n<!-- <x> -->\n<x xmlns=\"urn:a\">\n  <bubba>test</bubba>\n</x>\n";
+    const char *invalid[] = {
+        /* duplicate instance */
+        "<top xmlns=\"urn:it\"><l><k>1</k></l><l><k>1</k></l></top>",
+        /* missing key */
+        "<top xmlns=\"urn:it\"><l><k>1</k></l><l><v>a</v></l></top>",
+        /* too many instances */
+        "<top xmlns=\"urn:it\"><l><k>1</k></l><l><k>2</k></l><l><k>3</k></l></top>",
+        /* duplicate top-level instance */
+        "<top xmlns=\"urn:it\"/><top xmlns=\"urn:it\"/>"
+    };
+    const char *json = "{\"a:x\":{\"bubba\":\"test\"}}";
+    struct lyd_parse_push *push;
+    struct lyd_node *node;
+    char *str1 = NULL, *str2 = NULL;
+    size_t chunk, i, j, len = strlen(data);
+    int fd[2], r;
+
+    node = lyd_parse_mem(ctx, data, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(node, NULL);
+    lyd_print_mem(&str1, node, LYD_XML, LYP_WITHSIBLINGS);
+    lyd_free_withsiblings(node);
+
+    /* any split of the input gives the same tree */
+    for (chunk = 1; chunk <= len; chunk *= 2) {
+        push = lyd_parse_push_new(ctx, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+        assert_ptr_not_equal(push, NULL);
+        for (i = 0; i < len; i += chunk) {
+            assert_int_equal(lyd_parse_push_feed(push, data + i, (len - i < chunk) ? len - i : chunk), 0);
+        }
+        node = lyd_parse_push_finish(push);
+        assert_ptr_not_equal(node, NULL);
+        lyd_print_mem(&str2, node, LYD_XML, LYP_WITHSIBLINGS);
+        assert_string_equal(str1, str2);
+        free(str2);
+        str2 = NULL;
+        lyd_free_withsiblings(node);
+    }
+
+    /* incomplete input */
+    push = lyd_parse_push_new(ctx, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(push, NULL);
+    assert_int_equal(lyd_parse_push_feed(push, data, len - 3), 0);
+    assert_ptr_equal(lyd_parse_push_finish(push), NULL);
+    assert_int_not_equal(ly_errno, LY_SUCCESS);
+
+    /* invalid input is refused as soon as it comes */
+    push = lyd_parse_push_new(ctx, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    assert_ptr_not_equal(push, NULL);
+    assert_int_not_equal(lyd_parse_push_feed(push, "<x xmlns=\"urn:a\"><bubba>test</bub>", 34), 0);
+    assert_int_not_equal(lyd_parse_push_feed(push, "</x>", 4), 0);
+    lyd_parse_push_free(push);
+
+    /* invalid data, the nodes removed on the error must not be accessed (freed) again */
+    assert_ptr_not_equal(lys_parse_mem(ctx, "module it { namespace \"urn:it\"; prefix i; container top { presence p;"
+                                       "list l { key k; max-elements 2; leaf k { type string; } leaf v { type string; } } } }",
+                                       LYS_IN_YANG), NULL);
+    for (j = 0; j < sizeof invalid / sizeof *invalid; j++) {
+        for (chunk = 1; chunk <= strlen(invalid[j]); chunk *= 4) {
+            push = lyd_parse_push_new(ctx, LYD_XML, LYD_OPT_CONFIG);
+            assert_ptr_not_equal(push, NULL);
+            for (i = 0, r = 0; !r && (i < strlen(invalid[j])); i += chunk) {
+                r = lyd_parse_push_feed(push, invalid[j] + i, (strlen(invalid[j]) - i < chunk) ? strlen(invalid[j]) - i : chunk);
+            }
+            if (r) {
+                lyd_parse_push_free(push);
+            } else {
+                node = lyd_parse_push_finish(push);
+                assert_ptr_equal(node, NULL);
+            }
+            assert_int_not_equal(ly_errno, LY_SUCCESS);
+        }
+    }
+
+    /* no input at all, only the default nodes are created */
+    push = lyd_parse_push_new(ctx, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(push, NULL);
+    node = lyd_parse_push_finish(push);
+    assert_int_equal(ly_errno, LY_SUCCESS);
+    lyd_free_withsiblings(node);
+
+    /* JSON cannot be parsed incrementally */
+    push = lyd_parse_push_new(ctx, LYD_JSON, LYD_OPT_CONFIG);
+    assert_ptr_equal(push, NULL);
+    assert_int_equal(ly_errno, LY_EINVAL);
+
+    /* file descriptor that cannot be mapped */
+    assert_int_equal(pipe(fd), 0);
+    assert_int_equal(write(fd[1], data, len), len);
+    close(fd[1]);
+    node = lyd_parse_fd(ctx, fd[0], LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    close(fd[0]);
+    assert_ptr_not_equal(node, NULL);
+    lyd_print_mem(&str2, node, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(str1, str2);
+    free(str2);
+    lyd_free_withsiblings(node);
+
+    /* JSON from a file descriptor that cannot be mapped is read at once */
+    assert_int_equal(pipe(fd), 0);
+    assert_int_equal(write(fd[1], json, strlen(json)), strlen(json));
+    close(fd[1]);
+    node = lyd_parse_fd(ctx, fd[0], LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_STRICT);
+    close(fd[0]);
+    assert_ptr_not_equal(node, NULL);
+    lyd_print_mem(&str2, node, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(str1, str2);
+    free(str2);
+    lyd_free_withsiblings(node);
+
+    free(str1);
+}
+
+static void
+test_lyd_parse_select(void **state)
+{
+    (void) state; /* unused */
+    const char *data = "<x xmlns=\"urn:a\"><bubba>test</bubba><number32>1</number32></x><y xmlns=\"urn:a\">val</y>";
+    const char *json = "{\"a:x\":{\"bubba\":\"test\",\"number32\":1},\"a:y\":\"val\"}";
+    struct ly_set *select;
+    struct lyd_node *node;
+    char *str = NULL;
+
+    select = ly_set_new();
+    assert_ptr_not_equal(select, NULL);
+    ly_set_add(select, (void *)ly_ctx_get_node(ctx, NULL, "/a:x/a:bubba", 0), 0);
+
+    node = lyd_parse_mem(ctx, data, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_SELECT, select);
+    assert_ptr_not_equal(node, NULL);
+    lyd_print_mem(&str, node, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(str, "<x xmlns=\"urn:a\"><bubba>test</bubba></x>");
+    free(str);
+    str = NULL;
+    lyd_free_withsiblings(node);
+
+    node = lyd_parse_mem(ctx, json, LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_SELECT, select);
+    assert_ptr_not_equal(node, NULL);
+    lyd_print_mem(&str, node, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(str, "<x xmlns=\"urn:a\"><bubba>test</bubba></x>");
+    free(str);
+    lyd_free_withsiblings(node);
+
+    /* the selection is required */
+    assert_ptr_equal(lyd_parse_mem(ctx, data, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_SELECT, NULL), NULL);
+
+    ly_set_free(select);
+}
+
+static void
+test_lyd_parse_select_validate(void **state)
+{
+    (void) state; /* unused */
+    const char *yang = "module sel { namespace \"urn:sel\"; prefix s;"
+        "container c { leaf mc { type string; mandatory true; } leaf other { type string; must \"false()\"; }"
+        "  list l { key k; leaf k { type string; } leaf m { type string; mandatory true; }"
+        "    leaf-list ll { type uint8; max-elements 2; } } }"
+        "container d { leaf v { type uint8; must \"../../c/other\"; } leaf r { type leafref { path \"/c/l/k\"; } } } }";
+    struct ly_set *select;
+    struct lyd_node *node;
+    char *str = NULL;
+
+    assert_ptr_not_equal(lys_parse_mem(ctx, yang, LYS_IN_YANG), NULL);
+
+    select = ly_set_new();
+    assert_ptr_not_equal(select, NULL);
+    ly_set_add(select, (void *)ly_ctx_get_node(ctx, NULL, "/sel:c/sel:l", 0), 0);
+
+    /* the invalid skipped data and the mandatory leaf of the (not selected) parent do not matter */
+    node = lyd_parse_mem(ctx, "<c xmlns=\"urn:sel\"><other>x</other><l><k>a</k><m>x</m><ll>1</ll></l></c>"
+                         "<d xmlns=\"urn:sel\"><v>abc</v></d>", LYD_XML, LYD_OPT_CONFIG | LYD_OPT_SELECT, select);
+    assert_ptr_not_equal(node, NULL);
+    lyd_print_mem(&str, node, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(str, "<c xmlns=\"urn:sel\"><l><k>a</k><m>x</m><ll>1</ll></l></c>");
+    free(str);
+    str = NULL;
+    lyd_free_withsiblings(node);
+
+    /* but the selected subtrees are validated */
+    assert_ptr_equal(lyd_parse_mem(ctx, "<c xmlns=\"urn:sel\"><l><k>a</k></l></c>", LYD_XML,
+                                   LYD_OPT_CONFIG | LYD_OPT_SELECT, select), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_ptr_equal(lyd_parse_mem(ctx, "<c xmlns=\"urn:sel\"><l><k>a</k><m>x</m></l><l><k>a</k><m>y</m></l></c>",
+                                   LYD_XML, LYD_OPT_CONFIG | LYD_OPT_SELECT, select), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_ptr_equal(lyd_parse_mem(ctx, "<c xmlns=\"urn:sel\"><l><k>a</k><m>x</m><ll>1</ll><ll>2</ll><ll>3</ll></l></c>",
+                                   LYD_XML, LYD_OPT_CONFIG | LYD_OPT_SELECT, select), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_ptr_equal(lyd_parse_mem(ctx, "{\"sel:c\":{\"l\":[{\"k\":\"a\"}]}}", LYD_JSON,
+                                   LYD_OPT_CONFIG | LYD_OPT_SELECT, select), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+
+    /* the must and leafref constraints may refer to the skipped data, so they are not enforced */
+    ly_set_clean(select);
+    ly_set_add(select, (void *)ly_ctx_get_node(ctx, NULL, "/sel:d", 0), 0);
+    node = lyd_parse_mem(ctx, "<d xmlns=\"urn:sel\"><v>1</v><r>b</r></d>", LYD_XML,
+                         LYD_OPT_CONFIG | LYD_OPT_SELECT, select);
+    assert_ptr_not_equal(node, NULL);
+    lyd_free_withsiblings(node);
+    assert_ptr_equal(lyd_parse_mem(ctx, "<d xmlns=\"urn:sel\"><v>300</v></d>", LYD_XML,
+                                   LYD_OPT_CONFIG | LYD_OPT_SELECT, select), NULL);
+    assert_int_equal(ly_errno, LY_EVALID);
+
+    ly_set_free(select);
+}
+
 static void
 test_lyd_parse_xml(void **state)
 {
@@ -660,6 +869,101 @@ test_lyd_new_path(void **state)
     lyd_free_withsiblings(root);
 }
 
+static void
+test_lyd_path_tmpl(void **state)
+{
+    (void) state; /* unused */
+    struct lyd_path_tmpl *tmpl;
+    struct lyd_node *node, *root;
+    const char *keys[2];
+    struct ly_ctx *ctx2;
+    const struct lys_module *mod;
+
+    tmpl = lyd_path_tmpl_compile(ctx, "/a:l[key1='1']/value", 0);
+    assert_null(tmpl);
+    tmpl = lyd_path_tmpl_compile(ctx, "/a:l/key1", 0);
+    assert_null(tmpl);
+    tmpl = lyd_path_tmpl_compile(ctx, "/a:l/nonexisting", 0);
+    assert_null(tmpl);
+
+    tmpl = lyd_path_tmpl_compile(ctx, "/a:l/value", 0);
+    assert_non_null(tmpl);
+    assert_int_equal(lyd_path_tmpl_key_count(tmpl), 2);
+
+    keys[0] = "1";
+    keys[1] = "2";
+    root = lyd_path_tmpl_new(NULL, tmpl, keys, "val", 0, 0);
+    assert_non_null(root);
+    assert_string_equal(root->schema->name, "l");
+    assert_string_equal(root->child->schema->name, "key1");
+    assert_string_equal(((struct lyd_node_leaf_list *)root->child)->value_str, "1");
+    assert_string_equal(root->child->next->schema->name, "key2");
+    assert_string_equal(root->child->next->next->schema->name, "value");
+
+    /* the same instance exists */
+    node = lyd_path_tmpl_new(root, tmpl, keys, "val", 0, 0);
+    assert_null(node);
+    node = lyd_path_tmpl_new(root, tmpl, keys, "val2", 0, LYD_PATH_OPT_UPDATE);
+    assert_non_null(node);
+    assert_string_equal(((struct lyd_node_leaf_list *)node)->value_str, "val2");
+
+    /* new instance as a sibling */
+    keys[1] = "22";
+    node = lyd_path_tmpl_new(root, tmpl, keys, "val3", 0, 0);
+    assert_non_null(node);
+    assert_ptr_equal(root->next, node);
+    assert_string_equal(((struct lyd_node_leaf_list *)node->child->next)->value_str, "22");
+
+    node = lyd_path_tmpl_find(root, tmpl, keys);
+    assert_non_null(node);
+    assert_string_equal(((struct lyd_node_leaf_list *)node)->value_str, "val3");
+    keys[1] = "2";
+    node = lyd_path_tmpl_find(root->next, tmpl, keys);
+    assert_non_null(node);
+    assert_string_equal(((struct lyd_node_leaf_list *)node)->value_str, "val2");
+    keys[0] = "3";
+    assert_null(lyd_path_tmpl_find(root, tmpl, keys));
+
+    /* missing key value */
+    keys[1] = NULL;
+    ly_errno = LY_SUCCESS;
+    assert_null(lyd_path_tmpl_find(root, tmpl, keys));
+    assert_int_equal(ly_errno, LY_EINVAL);
+    ly_errno = LY_SUCCESS;
+    assert_null(lyd_path_tmpl_new(root, tmpl, keys, "val4", 0, 0));
+    assert_int_equal(ly_errno, LY_EINVAL);
+
+    /* data tree from another context */
+    keys[1] = "2";
+    ctx2 = ly_ctx_new_old(NULL, 0);
+    assert_non_null(ctx2);
+    mod = lys_parse_mem(ctx2, "module x {namespace urn:x; prefix x; container c;}", LYS_IN_YANG);
+    assert_non_null(mod);
+    node = lyd_new(NULL, mod, "c");
+    assert_non_null(node);
+    ly_errno = LY_SUCCESS;
+    assert_null(lyd_path_tmpl_find(node, tmpl, keys));
+    assert_int_equal(ly_errno, LY_EINVAL);
+    ly_errno = LY_SUCCESS;
+    assert_null(lyd_path_tmpl_new(node, tmpl, keys, "val4", 0, 0));
+    assert_int_equal(ly_errno, LY_EINVAL);
+    lyd_free(node);
+    ly_ctx_destroy(ctx2, NULL);
+
+    lyd_path_tmpl_free(tmpl);
+    lyd_free_withsiblings(root);
+
+    tmpl = lyd_path_tmpl_compile(ctx, "/a:rpc1/rpc-container/output-leaf3", LYD_PATH_OPT_OUTPUT);
+    assert_non_null(tmpl);
+    assert_int_equal(lyd_path_tmpl_key_count(tmpl), 0);
+    root = lyd_path_tmpl_new(NULL, tmpl, NULL, "cc", 0, LYD_PATH_OPT_OUTPUT);
+    assert_non_null(root);
+    assert_string_equal(root->schema->name, "rpc1");
+    assert_string_equal(root->child->child->schema->name, "output-leaf3");
+    lyd_path_tmpl_free(tmpl);
+    lyd_free(root);
+}
+
 static void
 test_lyd_dup(void **state)
 {
@@ -1486,6 +1790,159 @@ test_lyd_print_clb_json(void **state)
     free(buf);
 }
 
+static void
+test_lyd_print_iter(void **state)
+{
+    (void) state; /* unused */
+    struct lyd_print_iter *iter;
+    const char *results[] = {result_xml, result_xml_format, result_json};
+    LYD_FORMAT formats[] = {LYD_XML, LYD_XML, LYD_JSON};
+    int options[] = {0, LYP_FORMAT, LYP_FORMAT};
+    size_t sizes[] = {1, 5, 1024}, len;
+    char result[4096];
+    ssize_t r;
+    int i, j;
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            iter = lyd_print_iter_new(root, formats[i], options[i]);
+            assert_ptr_not_equal(iter, NULL);
+
+            len = 0;
+            do {
+                assert_true(len + sizes[j] < sizeof result);
+                r = lyd_print_iter_next(iter, result + len, sizes[j]);
+                assert_true(r >= 0);
+                len += r;
+            } while (r);
+            result[len] = '\0';
+            assert_string_equal(results[i], result);
+
+            /* the output is over */
+            assert_int_equal(lyd_print_iter_next(iter, result, sizes[j]), 0);
+            lyd_print_iter_free(iter);
+        }
+    }
+
+    /* empty tree */
+    iter = lyd_print_iter_new(NULL, LYD_JSON, 0);
+    assert_ptr_not_equal(iter, NULL);
+    assert_int_equal(lyd_print_iter_next(iter, result, sizeof result), 0);
+    lyd_print_iter_free(iter);
+
+    assert_ptr_equal(lyd_print_iter_new(root, LYD_UNKNOWN, 0), NULL);
+
+    /* no space for the output */
+    iter = lyd_print_iter_new(root, LYD_XML, 0);
+    assert_ptr_not_equal(iter, NULL);
+    assert_int_equal(lyd_print_iter_next(iter, result, 0), -1);
+    assert_int_equal(ly_errno, LY_EINVAL);
+    lyd_print_iter_free(iter);
+}
+
+/* concatenate the whole output of the resumable printer */
+static char *
+print_iter_all(const struct lyd_node *node, LYD_FORMAT format, int options, size_t size)
+{
+    struct lyd_print_iter *iter;
+    char *str = NULL;
+    size_t len = 0;
+    ssize_t r;
+
+    iter = lyd_print_iter_new(node, format, options);
+    assert_ptr_not_equal(iter, NULL);
+    do {
+        str = realloc(str, len + size + 1);
+        assert_ptr_not_equal(str, NULL);
+        r = lyd_print_iter_next(iter, str + len, size);
+        assert_true(r >= 0);
+        len += r;
+    } while (r);
+    str[len] = '\0';
+    lyd_print_iter_free(iter);
+
+    return str;
+}
+
+static void
+test_lyd_print_iter_options(void **state)
+{
+    struct ly_ctx *ctx = *state;
+    const char *schema = "module pi { namespace \"urn:pi\"; prefix p;"
+                         "leaf d { type string; default \"dflt\"; }"
+                         "leaf s { type string; }"
+                         "container np { leaf nd { type uint8; default 1; } }"
+                         "list l { key k; leaf k { type string; } leaf ld { type string; default \"x\"; } }"
+                         "rpc r { output { leaf o { type string; } } } }";
+    const char *data = "<d xmlns=\"urn:pi\">dflt</d><s xmlns=\"urn:pi\">v</s><np xmlns=\"urn:pi\"><nd>1</nd></np>"
+                       "<l xmlns=\"urn:pi\"><k>a</k></l><l xmlns=\"urn:pi\"><k>b</k><ld>y</ld></l>";
+    const int options[] = {0, LYP_WD_TRIM, LYP_WD_ALL, LYP_WD_ALL_TAG, LYP_WD_IMPL_TAG, LYP_NETCONF, LYP_KEEPEMPTYCONT,
+                           LYP_WD_TRIM | LYP_KEEPEMPTYCONT, LYP_NETCONF | LYP_WD_ALL_TAG};
+    const LYD_FORMAT formats[] = {LYD_XML, LYD_JSON};
+    struct lyd_node *tree, *node, *reply;
+    char *str1, *str2;
+    size_t i, j, k, m;
+    int opts;
+
+    assert_ptr_not_equal(lys_parse_mem(ctx, schema, LYS_IN_YANG), NULL);
+    tree = lyd_parse_mem(ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(tree, NULL);
+
+    /* the output is the same as of lyd_print_mem() for each node, each format and all the options */
+    for (node = tree; node; node = node->next) {
+        for (i = 0; i < sizeof formats / sizeof *formats; i++) {
+            for (j = 0; j < sizeof options / sizeof *options; j++) {
+                for (k = 0; k < 4; k++) {
+                    opts = options[j] | ((k & 1) ? LYP_WITHSIBLINGS : 0) | ((k & 2) ? LYP_FORMAT : 0);
+                    str1 = NULL;
+                    assert_int_equal(lyd_print_mem(&str1, node, formats[i], opts), 0);
+                    for (m = 1; m <= 64; m *= 8) {
+                        str2 = print_iter_all(node, formats[i], opts, m);
+                        assert_string_equal(str1 ? str1 : "", str2);
+                        free(str2);
+                    }
+                    free(str1);
+                }
+            }
+        }
+    }
+
+    /* the first node is skipped by the trim mode, so nothing is printed (not its next sibling) */
+    assert_string_equal(tree->schema->name, "d");
+    str1 = print_iter_all(tree, LYD_JSON, LYP_WD_TRIM, 64);
+    assert_ptr_equal(strstr(str1, "p:"), NULL);
+    free(str1);
+    str1 = NULL;
+    assert_int_equal(lyd_print_mem(&str1, tree, LYD_JSON, LYP_WD_TRIM), 0);
+    assert_true(!str1 || !strstr(str1, "p:"));
+    free(str1);
+
+    /* NETCONF mode of a subtree ending with a leaf must not read it as an inner node */
+    node = tree->next->next;
+    assert_string_equal(node->schema->name, "np");
+    str1 = NULL;
+    assert_int_equal(lyd_print_mem(&str1, node, LYD_XML, LYP_NETCONF), 0);
+    assert_string_equal(str1, "<np xmlns=\"urn:pi\"><nd>1</nd></np>");
+    free(str1);
+    str1 = print_iter_all(node->child, LYD_XML, LYP_NETCONF, 64);
+    assert_string_equal(str1, "<nd xmlns=\"urn:pi\">1</nd>");
+    free(str1);
+
+    /* RPC reply in the NETCONF mode is printed without the RPC element */
+    reply = lyd_new_path(NULL, ctx, "/pi:r/o", "out", 0, LYD_PATH_OPT_OUTPUT);
+    assert_ptr_not_equal(reply, NULL);
+    str1 = NULL;
+    assert_int_equal(lyd_print_mem(&str1, reply, LYD_XML, LYP_NETCONF), 0);
+    assert_string_equal(str1, "<o xmlns=\"urn:pi\">out</o>");
+    str2 = print_iter_all(reply, LYD_XML, LYP_NETCONF, 1);
+    assert_string_equal(str1, str2);
+    free(str1);
+    free(str2);
+    lyd_free(reply);
+
+    lyd_free_withsiblings(tree);
+}
+
 static void
 test_lyd_path(void **state)
 {
@@ -1542,6 +1999,39 @@ test_lyd_leaf_type(void **state)
     lyd_free_withsiblings(data);
 }
 
+static void
+test_ly_ctx_stats(void **state)
+{
+    (void) state; /* unused */
+    const struct ly_ctx_stats *stats;
+    struct lyd_node *data;
+
+    stats = ly_ctx_get_stats(ctx);
+    assert_ptr_not_equal(stats, NULL);
+    assert_int_equal(stats->node_allocs, 0);
+
+    ly_ctx_set_stats(ctx);
+    data = lyd_parse_mem(ctx, a_data_xml, LYD_XML, LYD_OPT_NOSIBLINGS | LYD_OPT_STRICT);
+    assert_ptr_not_equal(data, NULL);
+    assert_int_not_equal(stats->node_allocs, 0);
+    assert_int_not_equal(stats->dict_hits + stats->dict_misses, 0);
+    assert_int_not_equal(stats->time_parse, 0);
+    lyd_free_withsiblings(data);
+
+    ly_ctx_reset_stats(ctx);
+    assert_int_equal(stats->node_allocs, 0);
+    assert_int_equal(stats->time_parse, 0);
+
+    ly_ctx_unset_stats(ctx);
+    data = lyd_parse_mem(ctx, a_data_xml, LYD_XML, LYD_OPT_NOSIBLINGS | LYD_OPT_STRICT);
+    assert_ptr_not_equal(data, NULL);
+    assert_int_equal(stats->node_allocs, 0);
+    assert_int_equal(stats->dict_hits, 0);
+    lyd_free_withsiblings(data);
+
+    assert_ptr_equal(ly_ctx_get_stats(NULL), NULL);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -1549,11 +2039,16 @@ int main(void)
         cmocka_unit_test(test_lyd_parse_fd),
         cmocka_unit_test(test_lyd_parse_path),
         cmocka_unit_test(test_lyd_parse_xml),
+        cmocka_unit_test_setup_teardown(test_lyd_parse_push, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_parse_select, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_parse_select_validate, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_new, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_new_leaf, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_change_leaf, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_output_new_leaf, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_new_path, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_path_tmpl, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_ly_ctx_stats, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_dup, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_insert, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_insert_sibling, setup_f, teardown_f),
@@ -1580,6 +2075,8 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_lyd_print_clb_xml, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_print_clb_xml_format, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_print_clb_json, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_print_iter, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_lyd_print_iter_options, setup_f2, teardown_f2),
         cmocka_unit_test_setup_teardown(test_lyd_path, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyd_leaf_type, setup_f2, teardown_f2),
     };
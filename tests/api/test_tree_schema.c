@@ -24,6 +24,7 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #include <string.h>
+#include <limits.h>
 
 #include "tests/config.h"
 #include "libyang.h"
@@ -1309,6 +1310,60 @@ test_lys_path(void **state)
     free(path);
 }
 
+static void
+write_module(const char *dir, const char *file, const char *name)
+{
+    char path[PATH_MAX];
+    FILE *f;
+
+    snprintf(path, PATH_MAX, "%s/%s", dir, file);
+    f = fopen(path, "w");
+    assert_ptr_not_equal(f, NULL);
+    fprintf(f, "module %s { namespace urn:%s; prefix p; }", name, name);
+    fclose(f);
+}
+
+static void
+test_ly_ctx_searchdir_index(void **state)
+{
+    (void) state; /* unused */
+    char dir[] = TMP_TEMPLATE;
+    char path[PATH_MAX];
+    const struct lys_module *module;
+
+    assert_ptr_not_equal(mkdtemp(dir), NULL);
+    ctx = ly_ctx_new_old(dir, 0);
+    assert_ptr_not_equal(ctx, NULL);
+
+    /* the directory was indexed empty */
+    assert_ptr_equal(ly_ctx_load_module(ctx, "idx", NULL), NULL);
+
+    /* the index is rebuilt after adding files */
+    write_module(dir, "idx.yang", "idx");
+    write_module(dir, "idx-other.yang", "idx-other");
+    module = ly_ctx_load_module(ctx, "idx", NULL);
+    assert_ptr_not_equal(module, NULL);
+    assert_string_equal(module->name, "idx");
+
+    /* new subdirectory is searched as well */
+    snprintf(path, PATH_MAX, "%s/sub", dir);
+    assert_int_equal(mkdir(path, 0700), 0);
+    write_module(path, "idx-sub.yang", "idx-sub");
+    module = ly_ctx_load_module(ctx, "idx-sub", NULL);
+    assert_ptr_not_equal(module, NULL);
+    assert_string_equal(module->name, "idx-sub");
+
+    snprintf(path, PATH_MAX, "%s/sub/idx-sub.yang", dir);
+    unlink(path);
+    snprintf(path, PATH_MAX, "%s/sub", dir);
+    rmdir(path);
+    snprintf(path, PATH_MAX, "%s/idx.yang", dir);
+    unlink(path);
+    snprintf(path, PATH_MAX, "%s/idx-other.yang", dir);
+    unlink(path);
+    rmdir(dir);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -1337,6 +1392,7 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_lys_print_file_info, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lys_find_path, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lys_path, setup_f, teardown_f),
+        cmocka_unit_test_teardown(test_ly_ctx_searchdir_index, teardown_f),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
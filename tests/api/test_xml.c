@@ -29,6 +29,8 @@
 
 #include "tests/config.h"
 #include "libyang.h"
+#include "common.h"
+#include "parser.h"
 
 #define TMP_TEMPLATE "/tmp/libyang-XXXXXX"
 
@@ -436,6 +438,113 @@ test_lyxml_get_ns(void **state)
     lyxml_free(ctx, xml);
 }
 
+/* scalar versions of the internal text scanning functions */
+static unsigned int
+span_ascii_ref(const char *data, size_t len, const char *stop, int ws)
+{
+    unsigned int i;
+    unsigned char c;
+
+    for (i = 0; (i < len) && data[i]; ++i) {
+        c = data[i];
+        if ((c < 0x20) || (c & 0x80)) {
+            if (!ws || ((c != 0x09) && (c != 0x0a) && (c != 0x0d))) {
+                break;
+            }
+        } else if (strchr(stop, c)) {
+            break;
+        }
+    }
+    return i;
+}
+
+static unsigned int
+span_ws_ref(const char *data, size_t len)
+{
+    unsigned int i;
+
+    for (i = 0; (i < len) && ((data[i] == ' ') || (data[i] == '\t') || (data[i] == '\n') || (data[i] == '\r')); ++i);
+    return i;
+}
+
+static void
+test_lyp_span(void **state)
+{
+    (void) state; /* unused */
+    const char specials[] = {'\0', '<', '&', '\t', '\n', 0x01, 0x1f, 0x7f, (char)0x80, (char)0xc3, (char)0xff};
+    char *buf;
+    size_t size, off, pos, i;
+
+    /* buffers of the exact size (so any read behind them is caught by valgrind or the address sanitizer) with
+     * the terminating NULL byte at every offset modulo the vector size, scanned from every start offset */
+    for (size = 1; size <= 80; ++size) {
+        buf = malloc(size);
+        assert_non_null(buf);
+
+        for (i = 0; i <= sizeof specials; ++i) {
+            for (pos = 0; pos < size; ++pos) {
+                memset(buf, 'a', size - 1);
+                buf[size - 1] = '\0';
+                if (i < sizeof specials) {
+                    /* a byte ending the run at pos */
+                    buf[pos] = specials[i];
+                }
+                for (off = 0; (off < 8) && (off < size); ++off) {
+                    assert_int_equal(lyp_ascii_span(buf + off, size - off, "<&", 1),
+                                     span_ascii_ref(buf + off, size - off, "<&", 1));
+                    assert_int_equal(lyp_ascii_span(buf + off, size - off, "\"\\", 0),
+                                     span_ascii_ref(buf + off, size - off, "\"\\", 0));
+                    /* the length may end the scan before the NULL byte */
+                    assert_int_equal(lyp_ascii_span(buf + off, (size - off) / 2, "<&", 1),
+                                     span_ascii_ref(buf + off, (size - off) / 2, "<&", 1));
+                }
+
+                memset(buf, ' ', size - 1);
+                buf[size - 1] = '\0';
+                if (i < sizeof specials) {
+                    buf[pos] = specials[i];
+                }
+                for (off = 0; (off < 8) && (off < size); ++off) {
+                    assert_int_equal(lyp_ws_span(buf + off, size - off), span_ws_ref(buf + off, size - off));
+                    assert_int_equal(lyp_ws_span(buf + off, (size - off) / 2), span_ws_ref(buf + off, (size - off) / 2));
+                }
+            }
+        }
+
+        free(buf);
+    }
+}
+
+static void
+test_lyxml_parse_mem_content(void **state)
+{
+    (void) state; /* unused */
+    struct lyxml_elem *xml;
+    char *data, *content;
+    size_t len, i;
+
+    /* element content of every length up to several vectors, ending right before the end of the data */
+    for (len = 0; len < 100; ++len) {
+        data = malloc(len + 8);
+        content = malloc(len + 1);
+        assert_non_null(data);
+        assert_non_null(content);
+        for (i = 0; i < len; ++i) {
+            content[i] = (i % 10 == 9) ? '\n' : 'a' + (i % 26);
+        }
+        content[len] = '\0';
+        sprintf(data, "<x>%s</x>", content);
+
+        xml = lyxml_parse_mem(ctx, data, 0);
+        assert_non_null(xml);
+        assert_string_equal(xml->content, content);
+        lyxml_free(ctx, xml);
+
+        free(data);
+        free(content);
+    }
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -449,6 +558,8 @@ int main(void)
         cmocka_unit_test_setup_teardown(test_lyxml_unlink, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyxml_get_attr, setup_f, teardown_f),
         cmocka_unit_test_setup_teardown(test_lyxml_get_ns, setup_f, teardown_f),
+        cmocka_unit_test(test_lyp_span),
+        cmocka_unit_test_setup_teardown(test_lyxml_parse_mem_content, setup_f, teardown_f),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
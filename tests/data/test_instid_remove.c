@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <setjmp.h>
 #include <cmocka.h>
 
@@ -91,10 +92,45 @@ test_instid_unlink(void **state)
     assert_int_equal(r, 0);
 }
 
+static void
+test_instid_revalidate(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node_leaf_list *link;
+    struct lyd_node *target;
+    int r;
+
+    r = lyd_validate(&(st->data), LYD_OPT_CONFIG, NULL);
+    assert_int_equal(r, 0);
+    link = (struct lyd_node_leaf_list *)st->data->child;
+    assert_string_equal(link->schema->name, "link-req");
+    assert_ptr_not_equal(link->value.instance, NULL);
+
+    /* the key value is compared in the canonical form */
+    r = lyd_change_leaf(link, "/instance:insttests/target[id='03']/name");
+    assert_int_equal(r, 0);
+    r = lyd_validate(&(st->data), LYD_OPT_CONFIG, NULL);
+    assert_int_equal(r, 0);
+    assert_ptr_not_equal(link->value.instance, NULL);
+    assert_string_equal(((struct lyd_node_leaf_list *)link->value.instance)->value_str, "tri");
+
+    /* the already resolved target is still valid */
+    r = lyd_validate(&(st->data), LYD_OPT_CONFIG, NULL);
+    assert_int_equal(r, 0);
+    assert_string_equal(((struct lyd_node_leaf_list *)link->value.instance)->value_str, "tri");
+
+    /* the removed target must not be used */
+    target = link->value.instance->parent;
+    lyd_free(target);
+    r = lyd_validate(&(st->data), LYD_OPT_CONFIG, NULL);
+    assert_int_not_equal(r, 0);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
-                    cmocka_unit_test_setup_teardown(test_instid_unlink, setup_f, teardown_f) };
+                    cmocka_unit_test_setup_teardown(test_instid_unlink, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_instid_revalidate, setup_f, teardown_f) };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -161,10 +161,42 @@ test_mandatory(void **state)
     assert_int_equal(ly_errno, LY_SUCCESS);
 }
 
+static void
+test_mandatory_augment(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    const char valid[] = "<top xmlns=\"urn:libyang:tests:mandatory\">"
+                           "<leaf1>a</leaf1><llist1>1</llist1><llist1>2</llist1>"
+                           "<cont1><cont2><cont3><leaf2>5</leaf2></cont3></cont2></cont1>"
+                           "<leaf3>c</leaf3><leaf5>d</leaf5><leaf6/><leaf7/>"
+                         "</top><topleaf xmlns=\"urn:libyang:tests:mandatory\"/>";
+    const char aug[] = "module aug {"
+                         "  namespace \"urn:libyang:tests:aug\";"
+                         "  prefix aug;"
+                         "  import mandatory { prefix m; }"
+                         "  augment /m:top { when \"m:leaf1 = 'a'\"; leaf augleaf { type string; mandatory true; } }"
+                       "}";
+
+    st->dt = lyd_parse_mem(st->ctx, valid, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    /* the mandatory nodes change with the modules in the context */
+    mod = lys_parse_mem(st->ctx, aug, LYS_IN_YANG);
+    assert_ptr_not_equal(mod, NULL);
+    assert_int_not_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(ly_vecode, LYVE_MISSELEM);
+    assert_string_equal(ly_errpath(), "/mandatory:top");
+
+    assert_int_equal(lys_set_disabled(mod), 0);
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
-                    cmocka_unit_test_setup_teardown(test_mandatory, setup_f, teardown_f)
+                    cmocka_unit_test_setup_teardown(test_mandatory, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_mandatory_augment, setup_f, teardown_f)
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,462 @@
+/**
+ * @file test_threads.c
+ * @author CESNET, z.s.p.o.
+ * @brief Cmocka tests for parsing and validating data in many threads sharing a single context and for loading
+ *        schemas parsed in many threads.
+ *
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "tests/config.h"
+#include "libyang.h"
+
+#define THREAD_COUNT 8
+#define ROUND_COUNT 20
+#define ITEM_COUNT 50
+
+struct state {
+    struct ly_ctx *ctx;
+    pthread_barrier_t barrier;
+    struct lyd_node *dt;
+    char *xml, *json;
+    unsigned int blue;
+};
+
+struct worker {
+    struct state *st;
+    int id;
+    int failed;
+};
+
+static const char *schema =
+    "module threads {"
+    "  namespace \"urn:libyang:tests:threads\";"
+    "  prefix t;"
+    "  typedef name {"
+    "    type string { length \"1..32\"; pattern \"[a-z][a-z0-9-]*\"; }"
+    "  }"
+    "  typedef short-name {"
+    "    type name { length \"1..12\"; pattern \"[a-z0-9-]*\"; }"
+    "  }"
+    "  container top {"
+    "    list item {"
+    "      key id;"
+    "      leaf id { type uint16 { range \"1..1000\"; } }"
+    "      leaf name { type short-name; mandatory true; }"
+    "      leaf color { type enumeration { enum red; enum green; enum blue; } }"
+    "      leaf flags { type bits { bit a; bit b; bit c; } }"
+    "    }"
+    "    leaf ref { type instance-identifier; }"
+    "  }"
+    "}";
+
+static int
+setup_f(void **state)
+{
+    struct state *st;
+
+    (*state) = st = calloc(1, sizeof *st);
+    if (!st) {
+        fprintf(stderr, "Memory allocation error");
+        return -1;
+    }
+
+    /* libyang context */
+    st->ctx = ly_ctx_new_old(NULL, 0);
+    if (!st->ctx) {
+        fprintf(stderr, "Failed to create context.\n");
+        goto error;
+    }
+
+    if (!lys_parse_mem(st->ctx, schema, LYS_IN_YANG)) {
+        fprintf(stderr, "Failed to load the schema.\n");
+        goto error;
+    }
+
+    pthread_barrier_init(&st->barrier, NULL, THREAD_COUNT);
+
+    return 0;
+
+error:
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return -1;
+}
+
+static int
+teardown_f(void **state)
+{
+    struct state *st = (*state);
+
+    pthread_barrier_destroy(&st->barrier);
+    lyd_free_withsiblings(st->dt);
+    free(st->xml);
+    free(st->json);
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st);
+    (*state) = NULL;
+
+    return 0;
+}
+
+static char *
+worker_data(int id, const char *name)
+{
+    static const char *colors[] = {"red", "green", "blue"};
+    char *data, *ptr;
+    int i;
+
+    data = malloc(128 + ITEM_COUNT * 160);
+    if (!data) {
+        return NULL;
+    }
+
+    ptr = data + sprintf(data, "<top xmlns=\"urn:libyang:tests:threads\">");
+    for (i = 1; i <= ITEM_COUNT; i++) {
+        ptr += sprintf(ptr, "<item><id>%d</id><name>%s%d-%d</name><color>%s</color><flags>%s</flags></item>",
+                       i, name, id, i, colors[(i + id) % 3], (i % 2) ? "a c" : "b");
+    }
+    sprintf(ptr, "<ref xmlns:t=\"urn:libyang:tests:threads\">/t:top/t:item[t:id='%d']/t:name</ref></top>",
+            id + 1);
+
+    return data;
+}
+
+static int
+worker_round(struct worker *w)
+{
+    struct lyd_node *root, *node;
+    struct ly_set *set;
+    char *data;
+    unsigned int count;
+    int i, ret = 1;
+
+    /* valid data */
+    data = worker_data(w->id, "n");
+    if (!data) {
+        return 1;
+    }
+    root = lyd_parse_mem(w->st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    free(data);
+    if (!root) {
+        return 1;
+    }
+
+    /* the blue items */
+    for (i = 1, count = 0; i <= ITEM_COUNT; i++) {
+        count += ((i + w->id) % 3 == 2) ? 1 : 0;
+    }
+    set = lyd_find_path(root, "/threads:top/item[color='blue']");
+    if (!set || (set->number != count)) {
+        ly_set_free(set);
+        goto cleanup;
+    }
+    ly_set_free(set);
+
+    /* change a value and revalidate the whole tree */
+    set = lyd_find_path(root, "/threads:top/item[id='2']/name");
+    if (!set || (set->number != 1)) {
+        ly_set_free(set);
+        goto cleanup;
+    }
+    node = set->set.d[0];
+    ly_set_free(set);
+    if (lyd_change_leaf((struct lyd_node_leaf_list *)node, "changed")) {
+        goto cleanup;
+    }
+    if (lyd_validate(&root, LYD_OPT_CONFIG, NULL)) {
+        goto cleanup;
+    }
+    if (strcmp(((struct lyd_node_leaf_list *)node)->value_str, "changed")) {
+        goto cleanup;
+    }
+    lyd_free_withsiblings(root);
+
+    /* invalid data, the name does not match the patterns of the typedefs */
+    data = worker_data(w->id, "N");
+    if (!data) {
+        return 1;
+    }
+    root = lyd_parse_mem(w->st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    free(data);
+    if (root || (ly_errno != LY_EVALID) || (ly_vecode != LYVE_NOCONSTR)) {
+        goto cleanup;
+    }
+
+    ret = 0;
+
+cleanup:
+    lyd_free_withsiblings(root);
+    return ret;
+}
+
+static void *
+worker_main(void *arg)
+{
+    struct worker *w = arg;
+    struct lyd_node *info;
+    int i;
+
+    /* start all the threads at once so that they build the schema caches concurrently */
+    pthread_barrier_wait(&w->st->barrier);
+
+    for (i = 0; i < ROUND_COUNT; i++) {
+        if (worker_round(w)) {
+            w->failed = 1;
+            break;
+        }
+        if (i == w->id) {
+            info = ly_ctx_info(w->st->ctx);
+            if (!info) {
+                w->failed = 1;
+                break;
+            }
+            lyd_free_withsiblings(info);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * every thread parses, changes and validates its own data trees of the schema shared in the single context
+ */
+static void
+test_parallel_parse(void **state)
+{
+    struct state *st = (*state);
+    struct worker workers[THREAD_COUNT];
+    pthread_t threads[THREAD_COUNT];
+    int i;
+
+    ly_verb(LY_LLSILENT);
+
+    for (i = 0; i < THREAD_COUNT; i++) {
+        workers[i].st = st;
+        workers[i].id = i;
+        workers[i].failed = 0;
+        assert_int_equal(pthread_create(&threads[i], NULL, worker_main, &workers[i]), 0);
+    }
+    for (i = 0; i < THREAD_COUNT; i++) {
+        assert_int_equal(pthread_join(threads[i], NULL), 0);
+    }
+
+    ly_verb(LY_LLERR);
+
+    for (i = 0; i < THREAD_COUNT; i++) {
+        assert_int_equal(workers[i].failed, 0);
+    }
+}
+
+static void *
+worker_query(void *arg)
+{
+    struct worker *w = arg;
+    struct ly_set *set;
+    char *str;
+    int i;
+
+    pthread_barrier_wait(&w->st->barrier);
+
+    for (i = 0; i < ROUND_COUNT; i++) {
+        set = lyd_find_path(w->st->dt, "/threads:top/item[color='blue']/name");
+        if (!set || (set->number != w->st->blue)) {
+            ly_set_free(set);
+            goto error;
+        }
+        ly_set_free(set);
+
+        set = lyd_find_path(w->st->dt, "/threads:top/*");
+        if (!set || (set->number != ITEM_COUNT + 1)) {
+            ly_set_free(set);
+            goto error;
+        }
+        ly_set_free(set);
+
+        /* a name that is not in the dictionary */
+        set = lyd_find_path(w->st->dt, "/threads:top/item/threads-no-such-node");
+        if (set && set->number) {
+            ly_set_free(set);
+            goto error;
+        }
+        ly_set_free(set);
+
+        /* the instance-identifier is transformed into XML */
+        if (lyd_print_mem(&str, w->st->dt, LYD_XML, LYP_WITHSIBLINGS)) {
+            goto error;
+        }
+        if (strcmp(str, w->st->xml)) {
+            free(str);
+            goto error;
+        }
+        free(str);
+
+        if (lyd_print_mem(&str, w->st->dt, LYD_JSON, LYP_WITHSIBLINGS)) {
+            goto error;
+        }
+        if (strcmp(str, w->st->json)) {
+            free(str);
+            goto error;
+        }
+        free(str);
+    }
+
+    return NULL;
+
+error:
+    w->failed = 1;
+    return NULL;
+}
+
+/*
+ * all the threads query and print the same data tree, which changes neither the tree nor the dictionary
+ */
+static void
+test_parallel_query(void **state)
+{
+    struct state *st = (*state);
+    struct worker workers[THREAD_COUNT];
+    pthread_t threads[THREAD_COUNT];
+    uint64_t evals;
+    char *data;
+    int i;
+
+    data = worker_data(0, "n");
+    assert_ptr_not_equal(data, NULL);
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    free(data);
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_int_equal(lyd_print_mem(&st->xml, st->dt, LYD_XML, LYP_WITHSIBLINGS), 0);
+    assert_int_equal(lyd_print_mem(&st->json, st->dt, LYD_JSON, LYP_WITHSIBLINGS), 0);
+    for (i = 1, st->blue = 0; i <= ITEM_COUNT; i++) {
+        st->blue += (i % 3 == 2) ? 1 : 0;
+    }
+
+    /* the counters are updated by all the threads, so the evaluations of a single worker are counted first */
+    ly_ctx_set_stats(st->ctx);
+    pthread_barrier_destroy(&st->barrier);
+    pthread_barrier_init(&st->barrier, NULL, 1);
+    workers[0].st = st;
+    workers[0].failed = 0;
+    worker_query(&workers[0]);
+    assert_int_equal(workers[0].failed, 0);
+    evals = ly_ctx_get_stats(st->ctx)->xpath_evals;
+    assert_int_not_equal(evals, 0);
+    ly_ctx_reset_stats(st->ctx);
+    pthread_barrier_destroy(&st->barrier);
+    pthread_barrier_init(&st->barrier, NULL, THREAD_COUNT);
+
+    for (i = 0; i < THREAD_COUNT; i++) {
+        workers[i].st = st;
+        workers[i].id = i;
+        workers[i].failed = 0;
+        assert_int_equal(pthread_create(&threads[i], NULL, worker_query, &workers[i]), 0);
+    }
+    for (i = 0; i < THREAD_COUNT; i++) {
+        assert_int_equal(pthread_join(threads[i], NULL), 0);
+    }
+
+    for (i = 0; i < THREAD_COUNT; i++) {
+        assert_int_equal(workers[i].failed, 0);
+    }
+    assert_ptr_equal(lydict_find(st->ctx, "threads-no-such-node", 0), NULL);
+    assert_int_equal(ly_ctx_get_stats(st->ctx)->xpath_evals, THREAD_COUNT * evals);
+}
+
+static const char *load_names[] = {
+    "ietf-interfaces", "ietf-ip", "ietf-system", "ietf-snmp", "ietf-netconf", "ietf-netconf-acm",
+    "ietf-netconf-monitoring", "ietf-netconf-with-defaults", "ietf-ipfix-psamp", "iana-if-type"
+};
+#define LOAD_COUNT (sizeof load_names / sizeof *load_names)
+
+/*
+ * the modules (with their imports, parsed in advance as well, and includes) loaded by ly_ctx_load_modules() are
+ * the same as the ones loaded one by one
+ */
+static void
+test_parallel_load(const char *dir)
+{
+    struct ly_ctx *ctx_seq, *ctx_par;
+    const struct lys_module *mod_seq, *mod_par;
+    char *str_seq, *str_par;
+    uint32_t i;
+    unsigned int u;
+
+    ctx_seq = ly_ctx_new_old(dir, 0);
+    assert_ptr_not_equal(ctx_seq, NULL);
+    ctx_par = ly_ctx_new_old(dir, 0);
+    assert_ptr_not_equal(ctx_par, NULL);
+
+    for (u = 0; u < LOAD_COUNT; u++) {
+        assert_ptr_not_equal(ly_ctx_load_module(ctx_seq, load_names[u], NULL), NULL);
+    }
+    assert_int_equal(ly_ctx_load_modules(ctx_par, load_names, NULL, LOAD_COUNT, 4), EXIT_SUCCESS);
+
+    for (i = 0, mod_seq = NULL; (mod_seq = ly_ctx_get_module_iter(ctx_seq, &i)); ) {
+        mod_par = ly_ctx_get_module(ctx_par, mod_seq->name, mod_seq->rev_size ? mod_seq->rev[0].date : NULL, 0);
+        assert_ptr_not_equal(mod_par, NULL);
+        assert_int_equal(mod_par->implemented, mod_seq->implemented);
+
+        assert_int_equal(lys_print_mem(&str_seq, mod_seq, LYS_OUT_YANG, NULL), 0);
+        assert_int_equal(lys_print_mem(&str_par, mod_par, LYS_OUT_YANG, NULL), 0);
+        assert_string_equal(str_par, str_seq);
+        free(str_seq);
+        free(str_par);
+    }
+
+    /* nothing more is loaded */
+    for (i = 0, u = 0; ly_ctx_get_module_iter(ctx_par, &i); u++);
+    for (i = 0; ly_ctx_get_module_iter(ctx_seq, &i); u--);
+    assert_int_equal(u, 0);
+
+    /* a missing module */
+    load_names[0] = "ietf-missing";
+    assert_int_equal(ly_ctx_load_modules(ctx_par, load_names, NULL, LOAD_COUNT, 4), EXIT_FAILURE);
+    load_names[0] = "ietf-interfaces";
+
+    ly_ctx_destroy(ctx_seq, NULL);
+    ly_ctx_destroy(ctx_par, NULL);
+}
+
+static void
+test_parallel_load_yang(void **state)
+{
+    (void)state;
+    test_parallel_load(TESTS_DIR"/schema/yang/ietf");
+}
+
+static void
+test_parallel_load_yin(void **state)
+{
+    (void)state;
+    test_parallel_load(TESTS_DIR"/schema/yin/ietf");
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_parallel_parse, setup_f, teardown_f),
+        cmocka_unit_test_setup_teardown(test_parallel_query, setup_f, teardown_f),
+        cmocka_unit_test(test_parallel_load_yang),
+        cmocka_unit_test(test_parallel_load_yin),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
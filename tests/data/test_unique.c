@@ -143,6 +143,93 @@ test_un_empty(void **state)
     assert_ptr_not_equal(st->dt, NULL);
 }
 
+static void
+test_un_revalidate(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *node;
+    const char *xml = "<un xmlns=\"urn:libyang:tests:unique\">"
+                        "<list><name>x</name><value>1</value></list>"
+                        "<list><name>y</name><value>2</value></list>"
+                        "<list><name>z</name><value>3</value></list>"
+                      "</un>";
+
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    /* new instance */
+    node = lyd_new_path(st->dt, NULL, "/unique:un/list[name='w']/value", "1", 0, 0);
+    assert_ptr_not_equal(node, NULL);
+    assert_int_not_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(ly_vecode, LYVE_NOUNIQ);
+    assert_int_equal(lyd_change_leaf((struct lyd_node_leaf_list *)node->child->next, "4"), 0);
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+
+    /* changed instance */
+    assert_int_equal(lyd_change_leaf((struct lyd_node_leaf_list *)st->dt->child->child->next, "3"), 0);
+    assert_int_not_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(ly_vecode, LYVE_NOUNIQ);
+
+    /* removed instance */
+    lyd_free(st->dt->child->prev);
+    assert_int_not_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+    lyd_free(st->dt->child->next->next);
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+}
+
+static void
+test_un_toplevel(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *node, *root;
+    const char *sch = "module unique3 {"
+                      "  namespace \"urn:libyang:tests:unique3\";"
+                      "  prefix un3;"
+                      "  list l {"
+                      "    key k;"
+                      "    unique v;"
+                      "    leaf k { type string; }"
+                      "    leaf v { type string; }"
+                      "} }";
+    const char *xml = "<l xmlns=\"urn:libyang:tests:unique3\"><k>a</k><v>1</v></l>"
+                      "<l xmlns=\"urn:libyang:tests:unique3\"><k>b</k><v>2</v></l>"
+                      "<l xmlns=\"urn:libyang:tests:unique3\"><k>c</k><v>3</v></l>"
+                      "<l xmlns=\"urn:libyang:tests:unique3\"><k>d</k><v>4</v></l>";
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, sch, LYS_IN_YANG), NULL);
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    /* new top-level instance with a duplicate unique value */
+    node = lyd_new_path(st->dt, NULL, "/unique3:l[k='e']/v", "2", 0, 0);
+    assert_ptr_not_equal(node, NULL);
+    assert_int_not_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(ly_vecode, LYVE_NOUNIQ);
+    assert_int_equal(lyd_change_leaf((struct lyd_node_leaf_list *)node->child->next, "5"), 0);
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+
+    /* moved to the beginning and changed to duplicate the last one */
+    assert_int_equal(lyd_insert_before(st->dt, node), 0);
+    st->dt = node;
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(lyd_change_leaf((struct lyd_node_leaf_list *)node->child->next, "4"), 0);
+    assert_int_not_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(ly_vecode, LYVE_NOUNIQ);
+
+    /* the duplicate (d) removed */
+    lyd_free(node->next->next->next->next);
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+
+    /* duplicate key in an instance moved from another tree */
+    root = lyd_new_path(NULL, st->ctx, "/unique3:l[k='b']/v", "6", 0, 0);
+    assert_ptr_not_equal(root, NULL);
+    assert_int_equal(lyd_insert_sibling(&st->dt, root), 0);
+    assert_int_not_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+    assert_int_equal(ly_vecode, LYVE_DUPLIST);
+    lyd_free(root);
+    assert_int_equal(lyd_validate(&st->dt, LYD_OPT_CONFIG, NULL), 0);
+}
+
 static void
 test_schema_inpath(void **state)
 {
@@ -169,6 +256,8 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_un_correct, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_un_defaults, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_un_empty, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_un_revalidate, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_un_toplevel, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_schema_inpath, setup_f, teardown_f),
     };
 
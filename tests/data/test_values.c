@@ -12,8 +12,10 @@
  *     https://opensource.org/licenses/BSD-3-Clause
  */
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <setjmp.h>
 #include <cmocka.h>
 
@@ -389,6 +391,375 @@ test_validate_value(void **state)
     assert_int_equal(lyd_validate_value(node, "9.223372036854775807"), EXIT_SUCCESS); /* ok */
 }
 
+/*
+ * ranges of derived types, the value must match the restrictions of all the types
+ */
+static void
+test_validate_range(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    struct lys_node *node;
+    const char *yang = "module x {"
+                    "  namespace urn:x;"
+                    "  prefix x;"
+                    "  typedef base {"
+                    "    type int32 {"
+                    "      range \"min..-100 | 0 | 10..20 | 30..max\" {"
+                    "        error-app-tag base-range;"
+                    "      }"
+                    "    }"
+                    "  }"
+                    "  typedef derived {"
+                    "    type base {"
+                    "      range \"-200..-150 | 0 | 12..15 | 17 | 40..50\" {"
+                    "        error-app-tag derived-range;"
+                    "      }"
+                    "    }"
+                    "  }"
+                    "  leaf a {"
+                    "    type derived;"
+                    "  }"
+                    "  leaf b {"
+                    "    type string {"
+                    "      length \"1 | 3..4 | 6..max\";"
+                    "    }"
+                    "  }"
+                    "  leaf c {"
+                    "    type decimal64 {"
+                    "      fraction-digits 2;"
+                    "      range \"-1.5..-0.5 | 0.25 | 1..2.75\";"
+                    "    }"
+                    "  }"
+                    "}";
+
+    mod = lys_parse_mem(st->ctx, yang, LYS_IN_YANG);
+    assert_ptr_not_equal(mod, NULL);
+
+    /* a */
+    node = mod->data;
+    assert_int_equal(lyd_validate_value(node, "-200"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "-150"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "0"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "14"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "17"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "50"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "-201"), EXIT_FAILURE);
+    assert_string_equal(ly_errapptag(), "derived-range");
+    assert_int_equal(lyd_validate_value(node, "16"), EXIT_FAILURE);
+    assert_string_equal(ly_errapptag(), "derived-range");
+    assert_int_equal(lyd_validate_value(node, "51"), EXIT_FAILURE);
+    assert_string_equal(ly_errapptag(), "derived-range");
+    assert_int_equal(lyd_validate_value(node, "1"), EXIT_FAILURE); /* not in the base type */
+    assert_string_equal(ly_errapptag(), "base-range");
+    assert_int_equal(lyd_validate_value(node, "2147483647"), EXIT_FAILURE);
+
+    /* b */
+    node = node->next;
+    assert_int_equal(lyd_validate_value(node, ""), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "a"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "aa"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "aaa"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "aaaaa"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "aaaaaaaaaa"), EXIT_SUCCESS);
+
+    /* c */
+    node = node->next;
+    assert_int_equal(lyd_validate_value(node, "-1.51"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "-1.5"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "-0.49"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "0.25"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "0.26"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "2.75"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "2.76"), EXIT_FAILURE);
+}
+
+/*
+ * enumeration and bits names, including restricted types and names disabled by a feature
+ */
+static void
+test_validate_enum_bits(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    struct lys_node *node;
+    const char *yang = "module x {"
+                    "  yang-version 1.1;"
+                    "  namespace urn:x;"
+                    "  prefix x;"
+                    "  feature f;"
+                    "  typedef colors {"
+                    "    type enumeration {"
+                    "      enum red; enum orange; enum yellow; enum green; enum blue; enum indigo; enum violet;"
+                    "      enum black { if-feature f; }"
+                    "    }"
+                    "  }"
+                    "  leaf a {"
+                    "    type colors;"
+                    "  }"
+                    "  leaf b {"
+                    "    type colors {"
+                    "      enum red; enum green; enum blue;"
+                    "    }"
+                    "  }"
+                    "  leaf c {"
+                    "    type bits {"
+                    "      bit zero; bit one; bit two; bit three;"
+                    "      bit four { if-feature f; }"
+                    "    }"
+                    "  }"
+                    "  grouping g {"
+                    "    leaf d {"
+                    "      type enumeration { enum x; enum y; }"
+                    "    }"
+                    "  }"
+                    "  uses g;"
+                    "}";
+
+    mod = lys_parse_mem(st->ctx, yang, LYS_IN_YANG);
+    assert_ptr_not_equal(mod, NULL);
+
+    /* d, the names of a type instantiated from a grouping */
+    node = (struct lys_node *)ly_ctx_get_node(st->ctx, NULL, "/x:d", 0);
+    assert_ptr_not_equal(node, NULL);
+    assert_int_equal(lyd_validate_value(node, "y"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "z"), EXIT_FAILURE);
+
+    /* a */
+    node = mod->data;
+    assert_int_equal(lyd_validate_value(node, "red"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "violet"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "viole"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "violets"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, ""), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "black"), EXIT_FAILURE);
+    assert_int_equal(lys_features_enable(mod, "f"), 0);
+    assert_int_equal(lyd_validate_value(node, "black"), EXIT_SUCCESS);
+    assert_int_equal(lys_features_disable(mod, "f"), 0);
+
+    /* b */
+    node = node->next;
+    assert_int_equal(lyd_validate_value(node, "green"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "orange"), EXIT_FAILURE);
+
+    /* c */
+    node = node->next;
+    assert_int_equal(lyd_validate_value(node, "three one"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, " zero  two "), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "one one"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "one on"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "four"), EXIT_FAILURE);
+    assert_int_equal(lys_features_enable(mod, "f"), 0);
+    assert_int_equal(lyd_validate_value(node, "four zero"), EXIT_SUCCESS);
+}
+
+static void
+test_union_dispatch(void **state)
+{
+    struct state *st = (*state);
+    struct lyd_node *node;
+    const char *yang = "module x {"
+                    "  yang-version 1.1;"
+                    "  namespace urn:x;"
+                    "  prefix x;"
+                    "  typedef u {"
+                    "    type union {"
+                    "      type uint8;"
+                    "      type decimal64 { fraction-digits 2; }"
+                    "      type boolean;"
+                    "      type enumeration { enum one; enum two; }"
+                    "      type empty;"
+                    "      type string { pattern '[a-z]*'; }"
+                    "    }"
+                    "  }"
+                    "  leaf-list r {"
+                    "    type string;"
+                    "  }"
+                    "  list l {"
+                    "    key k;"
+                    "    leaf k { type uint8; }"
+                    "    leaf a { type u; }"
+                    "    leaf b {"
+                    "      type union {"
+                    "        type leafref { path /x:r; }"
+                    "        type u;"
+                    "      }"
+                    "    }"
+                    "  }"
+                    "}";
+    const char *xml = "<l xmlns=\"urn:x\"><k>1</k><a>200</a><b>200</b></l>"
+                    "<l xmlns=\"urn:x\"><k>2</k><a>-1</a><b>-1</b></l>"
+                    "<l xmlns=\"urn:x\"><k>3</k><a>true</a><b>true</b></l>"
+                    "<l xmlns=\"urn:x\"><k>4</k><a>two</a><b>two</b></l>"
+                    "<l xmlns=\"urn:x\"><k>5</k><a/><b/></l>"
+                    "<l xmlns=\"urn:x\"><k>6</k><a>three</a><b>three</b></l>"
+                    "<l xmlns=\"urn:x\"><k>7</k><a>300</a><b>300</b></l>"
+                    "<r xmlns=\"urn:x\">two</r>";
+    const LY_DATA_TYPE types[][2] = {
+        {LY_TYPE_UINT8, LY_TYPE_UINT8},
+        {LY_TYPE_DEC64, LY_TYPE_DEC64},
+        {LY_TYPE_BOOL, LY_TYPE_BOOL},
+        {LY_TYPE_ENUM, LY_TYPE_LEAFREF},
+        {LY_TYPE_EMPTY, LY_TYPE_EMPTY},
+        {LY_TYPE_STRING, LY_TYPE_STRING},
+        {LY_TYPE_DEC64, LY_TYPE_DEC64}
+    };
+    const struct lys_node_leaf *leaf;
+    int i;
+
+    assert_ptr_not_equal(lys_parse_mem(st->ctx, yang, LYS_IN_YANG), NULL);
+
+    leaf = (const struct lys_node_leaf *)ly_ctx_get_node(st->ctx, NULL, "/x:l/x:b", 0);
+    assert_ptr_not_equal(leaf, NULL);
+
+    st->dt = lyd_parse_mem(st->ctx, xml, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    for (i = 0, node = st->dt; i < 7; i++, node = node->next) {
+        assert_string_equal(node->schema->name, "l");
+        assert_int_equal(((struct lyd_node_leaf_list *)node->child->next)->value_type, types[i][0]);
+        assert_int_equal(((struct lyd_node_leaf_list *)node->child->next->next)->value_type, types[i][1]);
+    }
+
+    assert_int_equal(lyd_validate_value(st->dt->child->next->schema, "3.14"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(st->dt->child->next->schema, "TWO"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(st->dt->child->next->schema, "3.141"), EXIT_FAILURE);
+}
+
+static void
+test_validate_typedef_chain(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    struct lys_node *node;
+    const char *yang = "module x {"
+                    "  yang-version 1.1;"
+                    "  namespace urn:x;"
+                    "  prefix x;"
+                    "  typedef a {"
+                    "    type string { length 1..10; pattern '[a-z0-9]*'; }"
+                    "  }"
+                    "  typedef b {"
+                    "    type a { pattern '[a-z].*'; }"
+                    "  }"
+                    "  typedef e {"
+                    "    type enumeration { enum one; enum two; enum three; }"
+                    "  }"
+                    "  typedef f {"
+                    "    type e;"
+                    "  }"
+                    "  leaf s {"
+                    "    type b { pattern '.*[0-9]' { error-app-tag \"digit\"; } }"
+                    "  }"
+                    "  leaf g {"
+                    "    type f { enum two; enum three; }"
+                    "  }"
+                    "  grouping gr {"
+                    "    leaf t { type b { length 2..5; } }"
+                    "  }"
+                    "  container c {"
+                    "    uses gr;"
+                    "  }"
+                    "}";
+
+    mod = lys_parse_mem(st->ctx, yang, LYS_IN_YANG);
+    assert_ptr_not_equal(mod, NULL);
+
+    /* t, a chain instantiated from a grouping */
+    node = (struct lys_node *)lys_getnext(NULL, mod->data->prev, NULL, 0);
+    assert_string_equal(node->name, "t");
+    assert_int_equal(lyd_validate_value(node, "ab1"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "a1"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "abcde1"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "a"), EXIT_FAILURE);
+
+    /* s */
+    node = mod->data;
+    assert_int_equal(lyd_validate_value(node, "ab1"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "ABC1"), EXIT_FAILURE);
+    assert_ptr_not_equal(strstr(ly_errmsg(), "[a-z0-9]*"), NULL);
+    assert_int_equal(lyd_validate_value(node, "1ab1"), EXIT_FAILURE);
+    assert_ptr_not_equal(strstr(ly_errmsg(), "[a-z].*"), NULL);
+    assert_int_equal(lyd_validate_value(node, "abc"), EXIT_FAILURE);
+    assert_string_equal(ly_errapptag(), "digit");
+    assert_int_equal(lyd_validate_value(node, "abcdefghij1"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "abcdefghi1"), EXIT_SUCCESS);
+
+    /* g */
+    node = node->next;
+    assert_int_equal(lyd_validate_value(node, "three"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "one"), EXIT_FAILURE);
+}
+
+static void
+test_validate_numbers(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    struct lys_node *node;
+    struct lyd_node_leaf_list *leaf;
+    const char *yang = "module x {"
+                    "  namespace urn:x;"
+                    "  prefix x;"
+                    "  leaf a { type int8; }"
+                    "  leaf b { type int64; }"
+                    "  leaf c { type uint64; }"
+                    "  leaf d { type decimal64 { fraction-digits 2; } }"
+                    "}";
+
+    mod = lys_parse_mem(st->ctx, yang, LYS_IN_YANG);
+    assert_ptr_not_equal(mod, NULL);
+
+    /* a */
+    node = mod->data;
+    assert_int_equal(lyd_validate_value(node, "-128"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "127"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "-129"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "128"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, " 12 "), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "1x"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "-"), EXIT_FAILURE);
+
+    /* b */
+    node = node->next;
+    assert_int_equal(lyd_validate_value(node, "-9223372036854775808"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "9223372036854775807"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "-9223372036854775809"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "9223372036854775808"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "99999999999999999999999"), EXIT_FAILURE);
+
+    /* c */
+    node = node->next;
+    assert_int_equal(lyd_validate_value(node, "18446744073709551615"), EXIT_SUCCESS);
+    assert_int_equal(lyd_validate_value(node, "18446744073709551616"), EXIT_FAILURE);
+    assert_int_equal(lyd_validate_value(node, "-5"), EXIT_FAILURE);
+
+    /* canonical forms */
+    st->dt = lyd_new_leaf(NULL, mod, "b", "-0");
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_string_equal(((struct lyd_node_leaf_list *)st->dt)->value_str, "0");
+    lyd_free(st->dt);
+    st->dt = lyd_new_leaf(NULL, mod, "b", "-9223372036854775808");
+    assert_ptr_not_equal(st->dt, NULL);
+    leaf = (struct lyd_node_leaf_list *)st->dt;
+    assert_string_equal(leaf->value_str, "-9223372036854775808");
+    assert_true(leaf->value.int64 == INT64_MIN);
+    lyd_free(st->dt);
+    st->dt = lyd_new_leaf(NULL, mod, "d", "-0.0");
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_string_equal(((struct lyd_node_leaf_list *)st->dt)->value_str, "0.0");
+    lyd_free(st->dt);
+    st->dt = lyd_new_leaf(NULL, mod, "d", "-0.50");
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_string_equal(((struct lyd_node_leaf_list *)st->dt)->value_str, "-0.5");
+    lyd_free(st->dt);
+    st->dt = lyd_new_leaf(NULL, mod, "d", "10.0");
+    assert_ptr_not_equal(st->dt, NULL);
+    assert_string_equal(((struct lyd_node_leaf_list *)st->dt)->value_str, "10.0");
+    lyd_free(st->dt);
+    st->dt = NULL;
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -397,7 +768,12 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_xmltojson_identityref2, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_xmltojson_instanceid, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_canonical, setup_f, teardown_f),
-                    cmocka_unit_test_setup_teardown(test_validate_value, setup_f, teardown_f),};
+                    cmocka_unit_test_setup_teardown(test_validate_value, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_validate_range, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_validate_enum_bits, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_union_dispatch, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_validate_typedef_chain, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_validate_numbers, setup_f, teardown_f),};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
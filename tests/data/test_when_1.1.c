@@ -234,6 +234,43 @@ test_unlink_all(void **state)
     assert_string_equal(st->xml, "<a xmlns=\"urn:libyang:tests:when-unlinkall\">val_a</a>");
 }
 
+static void
+test_augment_instances(void **state)
+{
+    struct state *st = (struct state *)*state;
+    const char *schema =
+    "module when-augment {"
+    "  yang-version 1.1; namespace urn:libyang:tests:when-augment; prefix wa;"
+    "  container top { list iface { key name; leaf name { type string; } leaf type { type string; } } }"
+    "  augment /top/iface {"
+    "    when \"type = 'eth' and not(mtu > 9000)\";"
+    "    leaf mtu { type uint16; }"
+    "    leaf speed { type uint32; }"
+    "  }"
+    "}";
+    const char *data =
+    "<top xmlns=\"urn:libyang:tests:when-augment\">"
+    "<iface><name>a</name><mtu>1500</mtu><type>eth</type><speed>10</speed></iface>"
+    "<iface><name>b</name><mtu>1500</mtu><type>ppp</type><speed>20</speed></iface>"
+    "<iface><name>c</name><type>eth</type><speed>30</speed><mtu>9600</mtu></iface>"
+    "</top>";
+
+    /* schema */
+    st->mod = lys_parse_mem(st->ctx, schema, LYS_IN_YANG);
+    assert_ptr_not_equal(st->mod, NULL);
+
+    /* the augment's own nodes are not accessible from its when, the condition is evaluated for every list instance */
+    st->dt = lyd_parse_mem(st->ctx, data, LYD_XML, LYD_OPT_CONFIG);
+    assert_ptr_not_equal(st->dt, NULL);
+
+    lyd_print_mem(&(st->xml), st->dt, LYD_XML, LYP_WITHSIBLINGS);
+    assert_string_equal(st->xml, "<top xmlns=\"urn:libyang:tests:when-augment\">"
+                        "<iface><name>a</name><mtu>1500</mtu><type>eth</type><speed>10</speed></iface>"
+                        "<iface><name>b</name><type>ppp</type></iface>"
+                        "<iface><name>c</name><type>eth</type><speed>30</speed><mtu>9600</mtu></iface>"
+                        "</top>");
+}
+
 int main(void)
 {
     const struct CMUnitTest tests[] = {
@@ -244,7 +281,8 @@ int main(void)
                     cmocka_unit_test_setup_teardown(test_dummy, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_dependency_autodel, setup_f, teardown_f),
                     cmocka_unit_test_setup_teardown(test_dependency_circular, setup_f, teardown_f),
-                    cmocka_unit_test_setup_teardown(test_unlink_all, setup_f, teardown_f)
+                    cmocka_unit_test_setup_teardown(test_unlink_all, setup_f, teardown_f),
+                    cmocka_unit_test_setup_teardown(test_augment_instances, setup_f, teardown_f)
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
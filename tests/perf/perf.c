@@ -0,0 +1,481 @@
+/**
+ * @file perf.c
+ * @author CESNET, z.s.p.o.
+ * @brief libyang performance benchmark on synthetic data of various sizes.
+ *
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+
+#include <getopt.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "tests/config.h"
+#include "libyang.h"
+
+#define PERF_FILES TESTS_DIR "/callgrind/files/"
+#define PERF_MAX_SCALES 16
+
+/* the same as the default PERF_SCALES of the perf target, the defaults stop at 1M nodes because a 10M nodes
+ * tree needs several GB of memory and minutes per operation, request it explicitly with "-s 10000000" */
+static const unsigned int perf_default_scales[] = {1000, 10000, 100000, 1000000};
+#define PERF_DEFAULT_SCALE_COUNT (sizeof perf_default_scales / sizeof *perf_default_scales)
+
+struct perf_dataset;
+
+/**
+ * @brief Generator of the synthetic data, prints one list item (\p idx) into the buffer.
+ * Returns the number of data nodes the item consists of.
+ */
+typedef unsigned int (*perf_item_clb)(struct perf_dataset *ds, unsigned int idx, int json);
+
+struct perf_dataset {
+    const char *name;
+    const char *schemas[4];      /* schema files in PERF_FILES, NULL terminated */
+    const char *xml_open;        /* XML document start */
+    const char *xml_close;       /* XML document end */
+    const char *json_open;       /* JSON document start */
+    const char *json_close;      /* JSON document end */
+    const char *xpath_key;       /* XPath selecting a single list instance, %u is replaced by the item index */
+    const char *xpath_scan;      /* XPath that has to visit all the list instances */
+    const char *change_path;     /* lyd_new_path() path of a leaf changed for lyd_diff()/lyd_merge(), %u is the index */
+    perf_item_clb item;
+
+    /* output buffer */
+    char *buf;
+    size_t size;
+    size_t used;
+};
+
+struct perf_opts {
+    unsigned int scales[PERF_MAX_SCALES];
+    unsigned int scale_count;
+    unsigned int repeat;
+    const char *dataset;
+    const char *ops;
+    FILE *out;
+    int first_result;
+};
+
+static double
+perf_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long
+perf_maxrss(void)
+{
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage)) {
+        return -1;
+    }
+    return usage.ru_maxrss;
+}
+
+static void
+perf_buf_print(struct perf_dataset *ds, const char *format, ...)
+{
+    va_list ap;
+    int len;
+
+    while (1) {
+        va_start(ap, format);
+        len = vsnprintf(ds->buf + ds->used, ds->size - ds->used, format, ap);
+        va_end(ap);
+
+        if ((size_t)len < ds->size - ds->used) {
+            break;
+        }
+
+        ds->size = ds->size ? ds->size * 2 : 4096;
+        ds->buf = realloc(ds->buf, ds->size);
+        if (!ds->buf) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    ds->used += len;
+}
+
+static unsigned int
+perf_lists_item(struct perf_dataset *ds, unsigned int idx, int json)
+{
+    if (json) {
+        perf_buf_print(ds, "%s{\"key1\":\"k%u\",\"leaf1\":%u}", idx ? "," : "", idx, idx);
+    } else {
+        perf_buf_print(ds, "<list1><key1>k%u</key1><leaf1>%u</leaf1></list1>", idx, idx);
+    }
+    return 3;
+}
+
+static unsigned int
+perf_interfaces_item(struct perf_dataset *ds, unsigned int idx, int json)
+{
+    if (json) {
+        perf_buf_print(ds, "%s{\"name\":\"eth%u\",\"description\":\"Ethernet interface %u\","
+                       "\"type\":\"iana-if-type:ethernetCsmacd\",\"enabled\":%s,"
+                       "\"ietf-ip:ipv4\":{\"enabled\":true,\"mtu\":1500,"
+                       "\"address\":[{\"ip\":\"10.%u.%u.%u\",\"prefix-length\":24}]}}",
+                       idx ? "," : "", idx, idx, idx % 2 ? "true" : "false",
+                       (idx >> 16) & 0xff, (idx >> 8) & 0xff, idx & 0xff);
+    } else {
+        perf_buf_print(ds, "<interface><name>eth%u</name><description>Ethernet interface %u</description>"
+                       "<type xmlns:ianaift=\"urn:ietf:params:xml:ns:yang:iana-if-type\">ianaift:ethernetCsmacd</type>"
+                       "<enabled>%s</enabled><ipv4 xmlns=\"urn:ietf:params:xml:ns:yang:ietf-ip\"><enabled>true</enabled>"
+                       "<mtu>1500</mtu><address><ip>10.%u.%u.%u</ip><prefix-length>24</prefix-length></address></ipv4>"
+                       "</interface>",
+                       idx, idx, idx % 2 ? "true" : "false", (idx >> 16) & 0xff, (idx >> 8) & 0xff, idx & 0xff);
+    }
+    return 11;
+}
+
+static unsigned int
+perf_counters_item(struct perf_dataset *ds, unsigned int idx, int json)
+{
+    unsigned long long octets = 4096ULL * idx * 1000003;
+
+    if (json) {
+        perf_buf_print(ds, "%s{\"name\":\"e%u\",\"in-octets\":\"%llu\",\"out-octets\":\"%llu\",\"errors\":%u,"
+                       "\"offset\":\"-%u\",\"temperature\":\"%u.%02u\",\"load\":\"%u.%06u\"}",
+                       idx ? "," : "", idx, octets, octets / 3, idx % 7, idx * 13, 20 + idx % 60, idx % 100,
+                       idx % 100, idx % 999983);
+    } else {
+        perf_buf_print(ds, "<entry><name>e%u</name><in-octets>%llu</in-octets><out-octets>%llu</out-octets>"
+                       "<errors>%u</errors><offset>-%u</offset><temperature>%u.%02u</temperature>"
+                       "<load>%u.%06u</load></entry>",
+                       idx, octets, octets / 3, idx % 7, idx * 13, 20 + idx % 60, idx % 100, idx % 100, idx % 999983);
+    }
+    return 8;
+}
+
+static struct perf_dataset datasets[] = {
+    {"lists", {"lists.yang", NULL},
+     "<cont xmlns=\"urn:libyang:test:lists\">", "</cont>",
+     "{\"lists:cont\":{\"list1\":[", "]}}",
+     "/lists:cont/list1[key1='k%u']", "/lists:cont/list1[leaf1='0']",
+     "/lists:cont/list1[key1='k%u']/leaf1",
+     perf_lists_item, NULL, 0, 0},
+    {"interfaces", {"ietf-interfaces.yang", "ietf-ip.yang", "iana-if-type.yang", NULL},
+     "<interfaces xmlns=\"urn:ietf:params:xml:ns:yang:ietf-interfaces\">", "</interfaces>",
+     "{\"ietf-interfaces:interfaces\":{\"interface\":[", "]}}",
+     "/ietf-interfaces:interfaces/interface[name='eth%u']", "/ietf-interfaces:interfaces/interface[description='none']",
+     "/ietf-interfaces:interfaces/interface[name='eth%u']/description",
+     perf_interfaces_item, NULL, 0, 0},
+    {"counters", {"counters.yang", NULL},
+     "<stats xmlns=\"urn:libyang:test:counters\">", "</stats>",
+     "{\"counters:stats\":{\"entry\":[", "]}}",
+     "/counters:stats/entry[name='e%u']", "/counters:stats/entry[errors='9']",
+     "/counters:stats/entry[name='e%u']/errors",
+     perf_counters_item, NULL, 0, 0},
+    {NULL, {NULL}, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, 0, 0}
+};
+
+static struct lyd_node *
+perf_dup(struct lyd_node *tree)
+{
+    struct lyd_node *first = NULL, *iter, *dup;
+
+    LY_TREE_FOR(tree, iter) {
+        dup = lyd_dup(iter, 1);
+        if (!dup || (first && lyd_insert_after(first->prev, dup))) {
+            lyd_free_withsiblings(dup);
+            lyd_free_withsiblings(first);
+            return NULL;
+        }
+        if (!first) {
+            first = dup;
+        }
+    }
+
+    return first;
+}
+
+/**
+ * @brief Generate the document with (at least) \p scale data nodes.
+ *
+ * @return Number of list items generated.
+ */
+static unsigned int
+perf_generate(struct perf_dataset *ds, unsigned int scale, int json, unsigned int *nodes)
+{
+    unsigned int idx;
+
+    ds->used = 0;
+    perf_buf_print(ds, "%s", json ? ds->json_open : ds->xml_open);
+    for (idx = 0, *nodes = 1; *nodes < scale; ++idx) {
+        *nodes += ds->item(ds, idx, json);
+    }
+    perf_buf_print(ds, "%s", json ? ds->json_close : ds->xml_close);
+
+    return idx;
+}
+
+static int
+perf_selected(struct perf_opts *opts, const char *op)
+{
+    const char *ptr;
+    size_t len = strlen(op);
+
+    if (!opts->ops) {
+        return 1;
+    }
+
+    for (ptr = strstr(opts->ops, op); ptr; ptr = strstr(ptr + 1, op)) {
+        if (((ptr == opts->ops) || (ptr[-1] == ',')) && (!ptr[len] || (ptr[len] == ','))) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void
+perf_result(struct perf_opts *opts, struct perf_dataset *ds, unsigned int nodes, const char *op, double *times)
+{
+    unsigned int i;
+    double min = times[0], sum = 0;
+
+    for (i = 0; i < opts->repeat; ++i) {
+        sum += times[i];
+        if (times[i] < min) {
+            min = times[i];
+        }
+    }
+
+    fprintf(opts->out, "%s\n    {\"dataset\": \"%s\", \"nodes\": %u, \"op\": \"%s\", \"repeat\": %u, "
+            "\"min_s\": %.9f, \"mean_s\": %.9f}",
+            opts->first_result ? "" : ",", ds->name, nodes, op, opts->repeat, min, sum / opts->repeat);
+    fflush(opts->out);
+    opts->first_result = 0;
+
+    fprintf(stderr, "  %-10s %10u nodes  %-14s %12.6f s\n", ds->name, nodes, op, min);
+}
+
+/* run \p STMT opts->repeat times measuring each run, PREPARE and CLEANUP are not measured */
+#define PERF_RUN(OP, PREPARE, STMT, CLEANUP) \
+    if (perf_selected(opts, OP)) { \
+        for (r = 0; r < opts->repeat; ++r) { \
+            PREPARE; \
+            start = perf_now(); \
+            STMT; \
+            times[r] = perf_now() - start; \
+            CLEANUP; \
+        } \
+        perf_result(opts, ds, nodes, OP, times); \
+    }
+
+static int
+perf_dataset_run(struct perf_opts *opts, struct perf_dataset *ds, struct ly_ctx *ctx, unsigned int scale)
+{
+    struct lyd_node *tree = NULL, *data = NULL, *copy = NULL;
+    struct lyd_difflist *diff = NULL;
+    struct ly_set *set = NULL;
+    char *xml = NULL, *str = NULL, path[256];
+    unsigned int nodes, items, r, i;
+    double start, *times;
+    int ret = 1;
+
+    times = malloc(opts->repeat * sizeof *times);
+    if (!times) {
+        return 1;
+    }
+
+    /* JSON input */
+    perf_generate(ds, scale, 1, &nodes);
+    PERF_RUN("parse_json", , data = lyd_parse_mem(ctx, ds->buf, LYD_JSON, LYD_OPT_CONFIG | LYD_OPT_STRICT),
+             if (!data) { goto cleanup; } lyd_free_withsiblings(data); data = NULL);
+
+    /* XML input, kept for the following operations */
+    items = perf_generate(ds, scale, 0, &nodes);
+    xml = strndup(ds->buf, ds->used);
+    if (!xml) {
+        goto cleanup;
+    }
+    PERF_RUN("parse_xml", , data = lyd_parse_mem(ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT),
+             if (!data) { goto cleanup; } lyd_free_withsiblings(data); data = NULL);
+    PERF_RUN("parse_trusted", , data = lyd_parse_mem(ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT | LYD_OPT_TRUSTED),
+             if (!data) { goto cleanup; } lyd_free_withsiblings(data); data = NULL);
+
+    tree = lyd_parse_mem(ctx, xml, LYD_XML, LYD_OPT_CONFIG | LYD_OPT_STRICT | LYD_OPT_TRUSTED);
+    if (!tree) {
+        goto cleanup;
+    }
+
+    PERF_RUN("validate", data = perf_dup(tree), if (lyd_validate(&data, LYD_OPT_CONFIG, NULL)) { goto cleanup; },
+             lyd_free_withsiblings(data); data = NULL);
+    PERF_RUN("print_xml", , lyd_print_mem(&str, tree, LYD_XML, LYP_WITHSIBLINGS), free(str); str = NULL);
+    PERF_RUN("print_json", , lyd_print_mem(&str, tree, LYD_JSON, LYP_WITHSIBLINGS), free(str); str = NULL);
+
+    sprintf(path, ds->xpath_key, items / 2);
+    PERF_RUN("xpath_key", , set = lyd_find_path(tree, path),
+             if (!set || (set->number != 1)) { goto cleanup; } ly_set_free(set); set = NULL);
+    PERF_RUN("xpath_scan", , set = lyd_find_path(tree, ds->xpath_scan), if (!set) { goto cleanup; } ly_set_free(set); set = NULL);
+
+    PERF_RUN("dup", , data = perf_dup(tree), if (!data) { goto cleanup; } lyd_free_withsiblings(data); data = NULL);
+
+    /* second tree with every 100th item changed */
+    copy = perf_dup(tree);
+    if (!copy) {
+        goto cleanup;
+    }
+    for (i = 0; i < items; i += 100) {
+        sprintf(path, ds->change_path, i);
+        if (!lyd_new_path(copy, NULL, path, "42", 0, LYD_PATH_OPT_UPDATE)) {
+            goto cleanup;
+        }
+    }
+
+    PERF_RUN("diff", , diff = lyd_diff(tree, copy, 0), if (!diff) { goto cleanup; } lyd_free_diff(diff); diff = NULL);
+    PERF_RUN("merge", data = perf_dup(tree), if (lyd_merge(data, copy, 0)) { goto cleanup; },
+             lyd_free_withsiblings(data); data = NULL);
+    PERF_RUN("free", data = perf_dup(tree), lyd_free_withsiblings(data), data = NULL);
+
+    ret = 0;
+
+cleanup:
+    if (ret) {
+        fprintf(stderr, "Benchmark of dataset \"%s\" with %u nodes failed (%s).\n", ds->name, scale, ly_errmsg());
+    }
+    lyd_free_withsiblings(tree);
+    lyd_free_withsiblings(copy);
+    lyd_free_withsiblings(data);
+    lyd_free_diff(diff);
+    ly_set_free(set);
+    free(str);
+    free(xml);
+    free(times);
+    return ret;
+}
+
+static void
+perf_help(void)
+{
+    unsigned int i;
+
+    printf("Usage: lyperf [-s SCALE]... [-d DATASET] [-t OP[,OP...]] [-r REPEAT] [-o FILE]\n\n"
+           "  -s SCALE    Number of data nodes to generate, can be repeated (default");
+    for (i = 0; i < PERF_DEFAULT_SCALE_COUNT; ++i) {
+        printf("%s %u", i ? "," : "", perf_default_scales[i]);
+    }
+    printf(").\n"
+           "              Larger trees are not measured by default, use e.g. \"-s 10000000\" for 10M nodes.\n"
+           "  -d DATASET  Run only the specified dataset (lists, interfaces, counters).\n"
+           "  -t OPS      Comma-separated list of operations to measure (parse_json, parse_xml, parse_trusted,\n"
+           "              validate, print_xml, print_json, xpath_key, xpath_scan, dup, diff, merge, free).\n"
+           "  -r REPEAT   Number of measured runs of each operation (default 3), the minimum and mean are reported.\n"
+           "  -o FILE     Write JSON results into FILE instead of stdout.\n");
+}
+
+int
+main(int argc, char **argv)
+{
+    struct perf_opts opts;
+    struct perf_dataset *ds;
+    struct ly_ctx *ctx;
+    char *path;
+    int opt, i, ret = 0;
+    unsigned int s;
+
+    memset(&opts, 0, sizeof opts);
+    opts.repeat = 3;
+    opts.out = stdout;
+    opts.first_result = 1;
+
+    while ((opt = getopt(argc, argv, "hs:d:t:r:o:")) != -1) {
+        switch (opt) {
+        case 's':
+            if (opts.scale_count == PERF_MAX_SCALES) {
+                fprintf(stderr, "Too many scales.\n");
+                return 1;
+            }
+            opts.scales[opts.scale_count++] = strtoul(optarg, NULL, 10);
+            break;
+        case 'd':
+            opts.dataset = optarg;
+            break;
+        case 't':
+            opts.ops = optarg;
+            break;
+        case 'r':
+            opts.repeat = strtoul(optarg, NULL, 10);
+            if (!opts.repeat) {
+                opts.repeat = 1;
+            }
+            break;
+        case 'o':
+            opts.out = fopen(optarg, "w");
+            if (!opts.out) {
+                fprintf(stderr, "Unable to open \"%s\".\n", optarg);
+                return 1;
+            }
+            break;
+        default:
+            perf_help();
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (!opts.scale_count) {
+        memcpy(opts.scales, perf_default_scales, sizeof perf_default_scales);
+        opts.scale_count = PERF_DEFAULT_SCALE_COUNT;
+    }
+
+    fprintf(opts.out, "{\n  \"libyang\": \"%d.%d.%d\",\n  \"timestamp\": %ld,\n  \"results\": [",
+            LY_VERSION_MAJOR, LY_VERSION_MINOR, LY_VERSION_MICRO, (long)time(NULL));
+
+    for (ds = datasets; ds->name; ++ds) {
+        if (opts.dataset && strcmp(opts.dataset, ds->name)) {
+            continue;
+        }
+
+        ctx = ly_ctx_new_old(PERF_FILES, 0);
+        if (!ctx) {
+            ret = 1;
+            break;
+        }
+        for (i = 0; ds->schemas[i]; ++i) {
+            if (asprintf(&path, "%s%s", PERF_FILES, ds->schemas[i]) == -1) {
+                ret = 1;
+                break;
+            }
+            if (!lys_parse_path(ctx, path, LYS_IN_YANG)) {
+                ret = 1;
+            }
+            free(path);
+        }
+
+        for (s = 0; !ret && (s < opts.scale_count); ++s) {
+            ret = perf_dataset_run(&opts, ds, ctx, opts.scales[s]);
+        }
+
+        ly_ctx_destroy(ctx, NULL);
+        free(ds->buf);
+        ds->buf = NULL;
+        ds->size = 0;
+        if (ret) {
+            break;
+        }
+    }
+
+    /* the peak of the whole process, it cannot be attributed to the single operations */
+    fprintf(opts.out, "\n  ],\n  \"maxrss_kb\": %ld\n}\n", perf_maxrss());
+    if (opts.out != stdout) {
+        fclose(opts.out);
+    }
+    return ret;
+}
@@ -2,10 +2,10 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "../../src/tree_schema.h"
-#include "../../src/tree_data.h"
+#include "libyang.h"
 
-int main(int argc, char *argv[])
+int
+main(void)
 {
     unsigned long x, suma = 0;
 
@@ -0,0 +1,224 @@
+/**
+ * \file test_forward_ref.c
+ * \author CESNET, z.s.p.o.
+ * \brief libyang tests - resolving long chains of forward references in schemas
+ *
+ * Copyright (c) 2026 CESNET, z.s.p.o.
+ *
+ * This source code is licensed under BSD 3-Clause License (the "License").
+ * You may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     https://opensource.org/licenses/BSD-3-Clause
+ */
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#include "libyang.h"
+
+/* every item refers to the next one, which is defined after it, so the items can be resolved only in the reverse
+ * order of their definitions */
+#define CHAIN_LEN 200
+
+struct state {
+    struct ly_ctx *ctx;
+    struct lyd_node *dt;
+    char *schema;
+    size_t size, used;
+};
+
+static int
+setup_ctx(void **state)
+{
+    struct state *st;
+
+    (*state) = st = calloc(1, sizeof *st);
+    if (!st) {
+        fprintf(stderr, "Memory allocation error");
+        return -1;
+    }
+
+    st->ctx = ly_ctx_new_old(NULL, 0);
+    if (!st->ctx) {
+        fprintf(stderr, "Failed to create context.\n");
+        free(st);
+        (*state) = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+static int
+teardown_ctx(void **state)
+{
+    struct state *st = (*state);
+
+    lyd_free_withsiblings(st->dt);
+    ly_ctx_destroy(st->ctx, NULL);
+    free(st->schema);
+    free(st);
+    (*state) = NULL;
+
+    return 0;
+}
+
+static void
+schema_print(struct state *st, const char *format, ...)
+{
+    va_list ap;
+    int len;
+
+    while (1) {
+        va_start(ap, format);
+        len = vsnprintf(st->schema + st->used, st->size - st->used, format, ap);
+        va_end(ap);
+        assert_true(len >= 0);
+
+        if ((size_t)len < st->size - st->used) {
+            break;
+        }
+        st->size = st->size * 2 + len + 1;
+        st->schema = realloc(st->schema, st->size);
+        assert_non_null(st->schema);
+    }
+    st->used += len;
+}
+
+static void
+test_typedef_chain(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    const struct lys_node *leaf;
+    int i;
+
+    schema_print(st, "module fwd { namespace \"urn:fwd\"; prefix f;");
+    for (i = 0; i < CHAIN_LEN - 1; ++i) {
+        schema_print(st, "typedef t%d { type t%d; }", i, i + 1);
+    }
+    schema_print(st, "typedef t%d { type uint8 { range \"1..100\"; } }", CHAIN_LEN - 1);
+    /* the same in the scope of a container */
+    schema_print(st, "container c {");
+    for (i = 0; i < CHAIN_LEN - 1; ++i) {
+        schema_print(st, "typedef c%d { type c%d; }", i, i + 1);
+    }
+    schema_print(st, "typedef c%d { type t0 { range \"10..20\"; } }", CHAIN_LEN - 1);
+    schema_print(st, "leaf a { type t0; } leaf b { type c0; } } }");
+
+    mod = lys_parse_mem(st->ctx, st->schema, LYS_IN_YANG);
+    assert_non_null(mod);
+
+    leaf = mod->data->child->next;
+    assert_string_equal(leaf->name, "b");
+    assert_int_equal(((struct lys_node_leaf *)leaf)->type.base, LY_TYPE_UINT8);
+
+    /* the restrictions of the whole chain are applied */
+    st->dt = lyd_parse_mem(st->ctx, "<c xmlns=\"urn:fwd\"><a>50</a><b>15</b></c>", LYD_XML, LYD_OPT_CONFIG);
+    assert_non_null(st->dt);
+    assert_null(lyd_parse_mem(st->ctx, "<c xmlns=\"urn:fwd\"><a>150</a></c>", LYD_XML, LYD_OPT_CONFIG));
+    assert_null(lyd_parse_mem(st->ctx, "<c xmlns=\"urn:fwd\"><b>50</b></c>", LYD_XML, LYD_OPT_CONFIG));
+}
+
+static void
+test_grouping_chain(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    const struct lys_node *node;
+    char name[16];
+    int i;
+
+    schema_print(st, "module fwd { namespace \"urn:fwd\"; prefix f; container c { uses g0; }");
+    for (i = 0; i < CHAIN_LEN - 1; ++i) {
+        schema_print(st, "grouping g%d { leaf l%d { type t%d; } uses g%d; }", i, i, i, i + 1);
+        schema_print(st, "typedef t%d { type t%d; }", i, i + 1);
+    }
+    schema_print(st, "grouping g%d { leaf l%d { type t%d; } }", CHAIN_LEN - 1, CHAIN_LEN - 1, CHAIN_LEN - 1);
+    schema_print(st, "typedef t%d { type string; } }", CHAIN_LEN - 1);
+
+    mod = lys_parse_mem(st->ctx, st->schema, LYS_IN_YANG);
+    assert_non_null(mod);
+
+    /* all the leaves are instantiated in the container in the order of the groupings */
+    i = 0;
+    node = NULL;
+    while ((node = lys_getnext(node, mod->data, NULL, 0))) {
+        sprintf(name, "l%d", i++);
+        assert_string_equal(node->name, name);
+        assert_int_equal(((struct lys_node_leaf *)node)->type.base, LY_TYPE_STRING);
+    }
+    assert_int_equal(i, CHAIN_LEN);
+}
+
+static void
+test_identity_chain(void **state)
+{
+    struct state *st = (*state);
+    const struct lys_module *mod;
+    int i;
+
+    schema_print(st, "module fwd { namespace \"urn:fwd\"; prefix f;"
+                 "leaf l { type identityref { base i%d; } }", CHAIN_LEN - 1);
+    for (i = 0; i < CHAIN_LEN - 1; ++i) {
+        schema_print(st, "identity i%d { base i%d; }", i, i + 1);
+    }
+    schema_print(st, "identity i%d; }", CHAIN_LEN - 1);
+
+    mod = lys_parse_mem(st->ctx, st->schema, LYS_IN_YANG);
+    assert_non_null(mod);
+
+    /* i0 is derived from the last identity through the whole chain */
+    assert_int_equal(mod->ident[0].base_size, 1);
+    assert_ptr_equal(mod->ident[0].base[0], &mod->ident[1]);
+    st->dt = lyd_parse_mem(st->ctx, "<l xmlns=\"urn:fwd\">i0</l>", LYD_XML, LYD_OPT_CONFIG);
+    assert_non_null(st->dt);
+}
+
+static void
+test_missing_in_chain(void **state)
+{
+    struct state *st = (*state);
+    int i;
+
+    /* the last typedef refers to a missing one, so none of the chain can be resolved */
+    schema_print(st, "module fwd { namespace \"urn:fwd\"; prefix f; leaf l { type t0; }");
+    for (i = 0; i < CHAIN_LEN; ++i) {
+        schema_print(st, "typedef t%d { type t%d; }", i, i + 1);
+    }
+    schema_print(st, "}");
+
+    assert_null(lys_parse_mem(st->ctx, st->schema, LYS_IN_YANG));
+    assert_int_equal(ly_errno, LY_EVALID);
+    assert_ptr_equal(ly_ctx_get_module(st->ctx, "fwd", NULL, 0), NULL);
+
+    /* the same with a grouping */
+    st->used = 0;
+    schema_print(st, "module fwd { namespace \"urn:fwd\"; prefix f; container c { uses g0; }");
+    for (i = 0; i < CHAIN_LEN; ++i) {
+        schema_print(st, "grouping g%d { uses g%d; }", i, i + 1);
+    }
+    schema_print(st, "}");
+
+    assert_null(lys_parse_mem(st->ctx, st->schema, LYS_IN_YANG));
+    assert_int_equal(ly_errno, LY_EVALID);
+}
+
+int
+main(void)
+{
+    const struct CMUnitTest cmut[] = {
+        cmocka_unit_test_setup_teardown(test_typedef_chain, setup_ctx, teardown_ctx),
+        cmocka_unit_test_setup_teardown(test_grouping_chain, setup_ctx, teardown_ctx),
+        cmocka_unit_test_setup_teardown(test_identity_chain, setup_ctx, teardown_ctx),
+        cmocka_unit_test_setup_teardown(test_missing_in_chain, setup_ctx, teardown_ctx),
+    };
+
+    return cmocka_run_group_tests(cmut, NULL, NULL);
+}
@@ -1144,7 +1144,7 @@ test_typedef_patterns_optimizations_schema(struct state *st, const struct lys_mo
     const char *invalid2 = "<b xmlns=\"urn:libyang:tests:patterns\">b</b>";
     const char *invalid3 = "<c xmlns=\"urn:libyang:tests:patterns\">c</c>";
     struct lys_node_grp *grp = NULL;
-    struct lys_node_leaf *leaf = NULL;
+    struct lys_node_leaf *leaf = NULL, *orig;
     struct lys_node *iter;
     struct lyd_node *data;
 
@@ -1174,7 +1174,7 @@ test_typedef_patterns_optimizations_schema(struct state *st, const struct lys_mo
     assert_ptr_not_equal(grp->tpdf[0].type.info.str.patterns_pcre, NULL);
 #endif
 
-    /* 3. grouping's leaf does not have PCRE data */
+    /* 3. grouping's leaf has PCRE data since the grouping is used */
     LY_TREE_FOR(mod->data, iter) {
         if (iter->nodetype == LYS_GROUPING && !strcmp(iter->name, "b")) {
             leaf = (struct lys_node_leaf*)iter->child;
@@ -1184,12 +1184,14 @@ test_typedef_patterns_optimizations_schema(struct state *st, const struct lys_mo
     assert_ptr_not_equal(leaf, NULL);
     assert_int_equal(leaf->type.base, LY_TYPE_STRING);
     assert_int_equal(leaf->type.info.str.pat_count, 1);
+    assert_false(leaf->type.flags & LYS_TYPE_SHARED);
 #ifdef LY_ENABLED_CACHE
-    assert_ptr_equal(leaf->type.info.str.patterns_pcre, NULL);
+    assert_ptr_not_equal(leaf->type.info.str.patterns_pcre, NULL);
 #endif
+    orig = leaf;
     leaf = NULL;
 
-    /* 4. but it's instantiated copy does have PCRE data */
+    /* 4. and its instantiated copy shares the patterns with it */
     LY_TREE_FOR(mod->data, iter) {
         if (iter->nodetype == LYS_USES && !strcmp(iter->name, "b")) {
             leaf = (struct lys_node_leaf*)iter->child;
@@ -1199,8 +1201,10 @@ test_typedef_patterns_optimizations_schema(struct state *st, const struct lys_mo
     assert_ptr_not_equal(leaf, NULL);
     assert_int_equal(leaf->type.base, LY_TYPE_STRING);
     assert_int_equal(leaf->type.info.str.pat_count, 1);
+    assert_true(leaf->type.flags & LYS_TYPE_SHARED);
+    assert_ptr_equal(leaf->type.info.str.patterns, orig->type.info.str.patterns);
 #ifdef LY_ENABLED_CACHE
-    assert_ptr_not_equal(leaf->type.info.str.patterns_pcre, NULL);
+    assert_ptr_equal(leaf->type.info.str.patterns_pcre, orig->type.info.str.patterns_pcre);
 #endif
 
     /* check data */
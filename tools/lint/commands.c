@@ -16,6 +16,7 @@
 #include <stdio.h>
 #include <errno.h>
 #include <ctype.h>
+#include <inttypes.h>
 #include <assert.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -138,6 +139,14 @@ cmd_verb_help(void)
     printf("verb (error/0 | warning/1 | verbose/2 | debug/3)\n");
 }
 
+void
+cmd_stats_help(void)
+{
+    printf("stats [on | off | reset]\n");
+    printf("\t Without argument, print the performance counters and phase timers of the context.\n");
+    printf("\t Arguments switch on/off collecting the statistics or reset the collected values.\n");
+}
+
 #ifndef NDEBUG
 
 void
@@ -947,6 +956,29 @@ cleanup:
     return ret;
 }
 
+int
+print_stats(FILE *out, struct ly_ctx *ctx)
+{
+    const struct ly_ctx_stats *stats;
+
+    stats = ly_ctx_get_stats(ctx);
+    if (!stats) {
+        return 1;
+    }
+
+    fprintf(out, "Dictionary:       %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " lock waits\n",
+            stats->dict_hits, stats->dict_misses, stats->dict_lock_waits);
+    fprintf(out, "XPath:            %" PRIu64 " parsed, %" PRIu64 " evaluated\n", stats->xpath_parses, stats->xpath_evals);
+    fprintf(out, "Patterns:         %" PRIu64 " executed\n", stats->pattern_execs);
+    fprintf(out, "Data nodes:       %" PRIu64 " allocated\n", stats->node_allocs);
+    fprintf(out, "Unresolved data:  %" PRIu64 " items in %" PRIu64 " rounds\n", stats->unres_data_items,
+            stats->unres_data_rounds);
+    fprintf(out, "Time [ms]:        parse %.3f, defaults %.3f, unres %.3f, unique %.3f\n",
+            stats->time_parse / 1e6, stats->time_defaults / 1e6, stats->time_unres / 1e6, stats->time_unique / 1e6);
+
+    return 0;
+}
+
 int
 print_list(FILE *out, struct ly_ctx *ctx, LYD_FORMAT outformat)
 {
@@ -1337,6 +1369,28 @@ cmd_verb(const char *arg)
     return 0;
 }
 
+int
+cmd_stats(const char *arg)
+{
+    const char *ptr;
+
+    for (ptr = arg + 5; isspace(ptr[0]); ptr++);
+    if (!ptr[0]) {
+        return print_stats(stdout, ctx);
+    } else if (!strcmp(ptr, "on")) {
+        ly_ctx_set_stats(ctx);
+    } else if (!strcmp(ptr, "off")) {
+        ly_ctx_unset_stats(ctx);
+    } else if (!strcmp(ptr, "reset")) {
+        ly_ctx_reset_stats(ctx);
+    } else {
+        cmd_stats_help();
+        return 1;
+    }
+
+    return 0;
+}
+
 #ifndef NDEBUG
 
 int
@@ -1444,6 +1498,7 @@ COMMAND commands[] = {
         {"searchpath", cmd_searchpath, cmd_searchpath_help, "Set the search path for models"},
         {"clear", cmd_clear, cmd_clear_help, "Clear the context - remove all the loaded models"},
         {"verb", cmd_verb, cmd_verb_help, "Change verbosity"},
+        {"stats", cmd_stats, cmd_stats_help, "Print/enable/disable context performance statistics"},
 #ifndef NDEBUG
         {"debug", cmd_debug, cmd_debug_help, "Display specific debug message groups"},
 #endif
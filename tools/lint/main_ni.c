@@ -31,6 +31,7 @@ volatile int verbose = 0;
 
 /* from commands.c */
 int print_list(FILE *out, struct ly_ctx *ctx, LYD_FORMAT outformat);
+int print_stats(FILE *out, struct ly_ctx *ctx);
 
 void
 help(int shortout)
@@ -61,6 +62,8 @@ help(int shortout)
         "                        Current working directory and path of the module being added is used implicitly.\n\n"
         "  -s, --strict          Strict data parsing (do not skip unknown data),\n"
         "                        has no effect for schemas.\n\n"
+        "  -S, --stats           Print performance counters and phase timers of the context\n"
+        "                        to stderr when finished.\n\n"
         "  -m, --merge           Merge input data files into a single tree and validate at once,\n"
         "                        has no effect for the auto, rpc, rpcreply and notif TYPEs.\n\n"
         "  -f FORMAT, --format=FORMAT\n"
@@ -249,6 +252,7 @@ main_ni(int argc, char* argv[])
         {"path",             required_argument, NULL, 'p'},
         {"running",          required_argument, NULL, 'r'},
         {"strict",           no_argument,       NULL, 's'},
+        {"stats",            no_argument,       NULL, 'S'},
         {"version",          no_argument,       NULL, 'v'},
         {"verbose",          no_argument,       NULL, 'V'},
 #ifndef NDEBUG
@@ -270,6 +274,7 @@ main_ni(int argc, char* argv[])
     struct stat st;
     uint32_t u;
     int options_dflt = 0, options_parser = 0, options_ctx = 0, envelope = 0, autodetection = 0, merge = 0, list = 0;
+    int stats = 0;
     struct dataitem {
         const char *filename;
         struct lyxml_elem *xml;
@@ -286,9 +291,9 @@ main_ni(int argc, char* argv[])
 
     opterr = 0;
 #ifndef NDEBUG
-    while ((opt = getopt_long(argc, argv, "ad:f:F:ghHilmo:p:r:st:vVG:y:", options, &opt_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "ad:f:F:ghHilmo:p:r:sSt:vVG:y:", options, &opt_index)) != -1)
 #else
-    while ((opt = getopt_long(argc, argv, "ad:f:F:ghHilmo:p:r:st:vVy:", options, &opt_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "ad:f:F:ghHilmo:p:r:sSt:vVy:", options, &opt_index)) != -1)
 #endif
     {
         switch (opt) {
@@ -413,6 +418,10 @@ main_ni(int argc, char* argv[])
         case 's':
             options_parser |= LYD_OPT_STRICT;
             break;
+        case 'S':
+            options_ctx |= LY_CTX_STATS;
+            stats = 1;
+            break;
         case 't':
             if (!strcmp(optarg, "auto")) {
                 options_parser = (options_parser & ~LYD_OPT_TYPEMASK);
@@ -955,6 +964,10 @@ parse_reply:
         print_list(out, ctx, outformat_d);
     }
 
+    if (stats) {
+        print_stats(stderr, ctx);
+    }
+
     ret = EXIT_SUCCESS;
 
 cleanup: